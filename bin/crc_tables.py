@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+#
+# Generate the slice-by-8 lookup tables in src/hash/crc_tables.i.
+#
+
+import sys
+import argparse
+
+
+HEADER = '''/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+/* This file was generated by bin/crc_tables.py. Do not edit. */
+'''
+
+
+def crc32_tables():
+    '''Tables for the reflected CRC-32 polynomial 0xedb88320. Entry n in
+    table k is the CRC of byte n followed by k zero bytes.
+
+    '''
+
+    tables = [[]]
+
+    for n in range(256):
+        crc = n
+
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1))
+
+        tables[0].append(crc)
+
+    for k in range(1, 8):
+        tables.append([(tables[k - 1][n] >> 8) ^ tables[0][tables[k - 1][n] & 0xff]
+                       for n in range(256)])
+
+    return tables
+
+
+def ccitt_tables():
+    '''Tables for the CCITT polynomial 0x1021. Entry n in table k is the
+    CRC of byte n followed by k zero bytes.
+
+    '''
+
+    tables = [[]]
+
+    for n in range(256):
+        crc = (n << 8)
+
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xffff
+            else:
+                crc = (crc << 1) & 0xffff
+
+        tables[0].append(crc)
+
+    for k in range(1, 8):
+        tables.append([((tables[k - 1][n] << 8) & 0xffff)
+                       ^ tables[0][tables[k - 1][n] >> 8]
+                       for n in range(256)])
+
+    return tables
+
+
+def format_table(name, ctype, tables, digits, per_line):
+    lines = ['static FAR const {} {}[7][256] = {{'.format(ctype, name)]
+
+    # The first table is the byte-at-a-time table in crc.c.
+    for table in tables[1:]:
+        lines.append('    {')
+
+        for i in range(0, 256, per_line):
+            values = ', '.join(['0x{:0{}x}'.format(value, digits)
+                                for value in table[i:i + per_line]])
+            lines.append('        {},'.format(values))
+
+        lines[-1] = lines[-1][:-1]
+        lines.append('    },')
+
+    lines[-1] = lines[-1][:-1]
+    lines.append('};')
+
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('outfile', nargs='?', default='src/hash/crc_tables.i')
+    args = parser.parse_args()
+
+    with open(args.outfile, 'w') as fout:
+        fout.write(HEADER)
+        fout.write('\n')
+        fout.write(format_table('crc32_slice_tab',
+                                'uint32_t',
+                                crc32_tables(),
+                                8,
+                                6))
+        fout.write('\n\n')
+        fout.write(format_table('ccitt_slice_tab',
+                                'uint16_t',
+                                ccitt_tables(),
+                                4,
+                                8))
+        fout.write('\n')
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -39,103 +39,344 @@ struct heap_buffer_header_t {
     int count;
 };
 
-static void *alloc_fixed_size(struct heap_t *self_p,
-                              size_t size)
+/**
+ * Header of a block in the dynamic part of the heap.
+ */
+struct heap_dynamic_header_t {
+    /* Size of the block before this one in memory, including its
+       header, or zero(0) if this is the first block. */
+    size_t prev_size;
+    /* Size is the block payload size and count is zero(0) when the
+       block is free. */
+    struct heap_buffer_header_t header;
+};
+
+/**
+ * Free list links, stored in the payload of free blocks.
+ */
+struct heap_dynamic_links_t {
+    struct heap_dynamic_header_t *next_p;
+    struct heap_dynamic_header_t *prev_p;
+};
+
+#define DYNAMIC_ALIGNMENT                                       \
+    ((CONFIG_ALIGNMENT > sizeof(void *)) ? CONFIG_ALIGNMENT : sizeof(void *))
+
+#define DYNAMIC_HEADER_SIZE sizeof(struct heap_dynamic_header_t)
+
+#define DYNAMIC_MIN_SIZE sizeof(struct heap_dynamic_links_t)
+
+/**
+ * Get the first fixed size buffer pool with buffers of at least
+ * given size.
+ */
+static struct heap_fixed_t *fixed_size_pool(struct heap_t *self_p,
+                                            size_t size)
+{
+    struct heap_fixed_t *fixed_p;
+
+    fixed_p = self_p->fixed;
+
+    while (size > fixed_p->size) {
+        fixed_p++;
+    }
+
+    return (fixed_p);
+}
+
+/**
+ * Allocate a buffer from given fixed size buffer pool, or from the
+ * unallocated memory if the pool is empty.
+ */
+static struct heap_buffer_header_t *alloc_fixed_block(
+    struct heap_t *self_p,
+    struct heap_fixed_t *fixed_p)
 {
     struct heap_buffer_header_t *header_p;
-    struct heap_fixed_t *fixed_p = self_p->fixed;
     size_t left;
     char *next_p;
 
-    while (fixed_p != &self_p->fixed[HEAP_FIXED_SIZES_MAX]) {
-        if (size <= fixed_p->size) {
-            if (fixed_p->free_p != NULL) {
-                header_p = fixed_p->free_p;
-                fixed_p->free_p = header_p->u.next_p;
-            } else {
-                next_p = self_p->next_p;
+    if (fixed_p->free_p != NULL) {
+        header_p = fixed_p->free_p;
+        fixed_p->free_p = header_p->u.next_p;
+    } else {
+        next_p = self_p->next_p;
 
-                /* Out of memory?. */
-                left = (self_p->size - (next_p - (char *)self_p->buf_p));
+        /* Out of memory?. */
+        left = ((char *)self_p->dynamic.begin_p - next_p);
 
-                if (left < (sizeof(*header_p) + fixed_p->size)) {
-                    break;
-                }
+        if (left < (sizeof(*header_p) + fixed_p->size)) {
+            return (NULL);
+        }
 
-                header_p = self_p->next_p;
-                next_p += (sizeof(*header_p) + fixed_p->size);
-                self_p->next_p = next_p;
-            }
+        header_p = self_p->next_p;
+        next_p += (sizeof(*header_p) + fixed_p->size);
+        self_p->next_p = next_p;
+    }
 
-            /* Initialize the allocated buffer. */
-            header_p->u.fixed_p = fixed_p;
-            header_p->size = size;
-            header_p->count = 1;
+    return (header_p);
+}
 
-            return (&header_p[1]);
+static void *alloc_fixed_size(struct heap_t *self_p,
+                              size_t size)
+{
+    struct heap_buffer_header_t *header_p;
+    struct heap_fixed_t *fixed_p;
 
-        }
+    fixed_p = fixed_size_pool(self_p, size);
+    header_p = alloc_fixed_block(self_p, fixed_p);
 
-        fixed_p++;
+    if (header_p == NULL) {
+        return (NULL);
     }
 
-    return (NULL);
+    /* Initialize the allocated buffer. */
+    header_p->u.fixed_p = fixed_p;
+    header_p->size = size;
+    header_p->count = 1;
+
+    return (&header_p[1]);
 }
 
-static void *alloc_dynamic_size(struct heap_t *self_p,
-                                size_t size)
+static struct heap_dynamic_links_t *dynamic_links(
+    struct heap_dynamic_header_t *block_p)
+{
+    return ((struct heap_dynamic_links_t *)&block_p[1]);
+}
+
+static int dynamic_bin(size_t size)
+{
+    int bin;
+
+    bin = (8 * sizeof(unsigned long) - __builtin_clzl(size) - 5);
+
+    if (bin < 0) {
+        bin = 0;
+    } else if (bin >= HEAP_DYNAMIC_BINS_MAX) {
+        bin = (HEAP_DYNAMIC_BINS_MAX - 1);
+    }
+
+    return (bin);
+}
+
+/**
+ * Get the block after given block in memory, or NULL if given block
+ * is the last block.
+ */
+static struct heap_dynamic_header_t *dynamic_next(
+    struct heap_t *self_p,
+    struct heap_dynamic_header_t *block_p)
 {
-    struct heap_buffer_header_t *header_p, *prev_p;
-    size_t left;
     char *next_p;
 
-#if CONFIG_ALIGNMENT != 0
-    size |= CONFIG_ALIGNMENT;
-    size &= (-1 & ~(CONFIG_ALIGNMENT - 1));
-#endif
+    next_p = ((char *)block_p + DYNAMIC_HEADER_SIZE + block_p->header.size);
 
-    /* Allocate from the free list. */
-    header_p = self_p->dynamic.free_p;
-    prev_p = NULL;
+    if (next_p == self_p->dynamic.end_p) {
+        return (NULL);
+    }
 
-    while (header_p != NULL) {
-        if (size <= header_p->size) {
-            header_p->count = 1;
+    return ((struct heap_dynamic_header_t *)next_p);
+}
 
-            if (prev_p != NULL) {
-                prev_p->u.next_p = header_p->u.next_p;
-            } else {
-                self_p->dynamic.free_p = header_p->u.next_p;
-            }
+/**
+ * Get the block before given block in memory, or NULL if given block
+ * is the first block.
+ */
+static struct heap_dynamic_header_t *dynamic_prev(
+    struct heap_dynamic_header_t *block_p)
+{
+    if (block_p->prev_size == 0) {
+        return (NULL);
+    }
+
+    return ((struct heap_dynamic_header_t *)((char *)block_p
+                                              - block_p->prev_size));
+}
+
+static void dynamic_insert(struct heap_t *self_p,
+                           struct heap_dynamic_header_t *block_p)
+{
+    struct heap_dynamic_links_t *links_p;
+    struct heap_dynamic_header_t *head_p;
+    int bin;
+
+    bin = dynamic_bin(block_p->header.size);
+    head_p = self_p->dynamic.free_p[bin];
+    links_p = dynamic_links(block_p);
+    links_p->next_p = head_p;
+    links_p->prev_p = NULL;
+
+    if (head_p != NULL) {
+        dynamic_links(head_p)->prev_p = block_p;
+    }
+
+    self_p->dynamic.free_p[bin] = block_p;
+    self_p->dynamic.bins_bitmap |= (1UL << bin);
+    block_p->header.count = 0;
+}
 
-            header_p->u.fixed_p = NULL;
+static void dynamic_remove(struct heap_t *self_p,
+                           struct heap_dynamic_header_t *block_p)
+{
+    struct heap_dynamic_links_t *links_p;
+    int bin;
+
+    bin = dynamic_bin(block_p->header.size);
+    links_p = dynamic_links(block_p);
+
+    if (links_p->prev_p != NULL) {
+        dynamic_links(links_p->prev_p)->next_p = links_p->next_p;
+    } else {
+        self_p->dynamic.free_p[bin] = links_p->next_p;
 
-            return (&header_p[1]);
+        if (links_p->next_p == NULL) {
+            self_p->dynamic.bins_bitmap &= ~(1UL << bin);
         }
+    }
 
-        prev_p = header_p;
-        header_p = header_p->u.next_p;
+    if (links_p->next_p != NULL) {
+        dynamic_links(links_p->next_p)->prev_p = links_p->prev_p;
     }
+}
+
+/**
+ * Find the smallest free block in given free list that is at least
+ * given size.
+ */
+static struct heap_dynamic_header_t *dynamic_best_fit(
+    struct heap_t *self_p,
+    int bin,
+    size_t size)
+{
+    struct heap_dynamic_header_t *block_p;
+    struct heap_dynamic_header_t *best_p;
+
+    best_p = NULL;
+    block_p = self_p->dynamic.free_p[bin];
 
-    next_p = self_p->next_p;
+    while (block_p != NULL) {
+        if (block_p->header.size >= size) {
+            if ((best_p == NULL)
+                || (block_p->header.size < best_p->header.size)) {
+                best_p = block_p;
+
+                if (block_p->header.size == size) {
+                    break;
+                }
+            }
+        }
+
+        block_p = dynamic_links(block_p)->next_p;
+    }
+
+    return (best_p);
+}
+
+/**
+ * Allocate a new block from the unallocated memory between the fixed
+ * size buffers and the dynamic part.
+ */
+static struct heap_dynamic_header_t *dynamic_grow(struct heap_t *self_p,
+                                                  size_t size)
+{
+    struct heap_dynamic_header_t *block_p;
+    struct heap_dynamic_header_t *first_p;
+    size_t left;
 
-    /* Allocate new memory. */
-    left = (self_p->size - (next_p - (char *)self_p->buf_p));
+    first_p = self_p->dynamic.begin_p;
+    left = ((char *)first_p - (char *)self_p->next_p);
 
-    if (left < (sizeof(*header_p) + size)) {
+    if (left < (DYNAMIC_HEADER_SIZE + size)) {
         return (NULL);
     }
 
-    header_p = self_p->next_p;
-    next_p += (sizeof(*header_p) + size);
-    self_p->next_p = next_p;
+    block_p = (struct heap_dynamic_header_t *)
+        ((char *)first_p - DYNAMIC_HEADER_SIZE - size);
+
+    if (first_p != self_p->dynamic.end_p) {
+        first_p->prev_size = (DYNAMIC_HEADER_SIZE + size);
+    }
+
+    self_p->dynamic.begin_p = block_p;
+    block_p->prev_size = 0;
+    block_p->header.size = size;
+
+    return (block_p);
+}
+
+/**
+ * Split given block if the remainder is big enough to be a block of
+ * its own, and add the remainder to the free lists.
+ */
+static void dynamic_split(struct heap_t *self_p,
+                          struct heap_dynamic_header_t *block_p,
+                          size_t size)
+{
+    struct heap_dynamic_header_t *rest_p;
+    struct heap_dynamic_header_t *next_p;
+
+    if (block_p->header.size
+        < (size + DYNAMIC_HEADER_SIZE + DYNAMIC_MIN_SIZE)) {
+        return;
+    }
+
+    rest_p = (struct heap_dynamic_header_t *)
+        ((char *)block_p + DYNAMIC_HEADER_SIZE + size);
+    rest_p->prev_size = (DYNAMIC_HEADER_SIZE + size);
+    rest_p->header.u.fixed_p = NULL;
+    rest_p->header.size = (block_p->header.size - size - DYNAMIC_HEADER_SIZE);
+    block_p->header.size = size;
+    next_p = dynamic_next(self_p, rest_p);
+
+    if (next_p != NULL) {
+        next_p->prev_size = (DYNAMIC_HEADER_SIZE + rest_p->header.size);
+    }
+
+    dynamic_insert(self_p, rest_p);
+}
+
+static void *alloc_dynamic_size(struct heap_t *self_p,
+                                size_t size)
+{
+    struct heap_dynamic_header_t *block_p;
+    uint32_t bitmap;
+    int bin;
+
+    size = ((size + DYNAMIC_ALIGNMENT - 1) & ~(DYNAMIC_ALIGNMENT - 1));
+
+    if (size < DYNAMIC_MIN_SIZE) {
+        size = DYNAMIC_MIN_SIZE;
+    }
+
+    /* Best fit in the free list of given size, or in the first non
+       empty free list of bigger blocks. */
+    bin = dynamic_bin(size);
+    block_p = dynamic_best_fit(self_p, bin, size);
+
+    if (block_p == NULL) {
+        bitmap = (self_p->dynamic.bins_bitmap & ~((2UL << bin) - 1));
+
+        if (bitmap != 0) {
+            block_p = dynamic_best_fit(self_p, __builtin_ctzl(bitmap), size);
+        }
+    }
+
+    if (block_p != NULL) {
+        dynamic_remove(self_p, block_p);
+        dynamic_split(self_p, block_p, size);
+    } else {
+        block_p = dynamic_grow(self_p, size);
+
+        if (block_p == NULL) {
+            return (NULL);
+        }
+    }
 
     /* Initialize the allocated buffer. */
-    header_p->u.fixed_p = NULL;
-    header_p->size = size;
-    header_p->count = 1;
+    block_p->header.u.fixed_p = NULL;
+    block_p->header.count = 1;
 
-    return (&header_p[1]);
+    return (&block_p->header + 1);
 }
 
 static int free_fixed_size(struct heap_t *self_p,
@@ -154,12 +395,534 @@ static int free_fixed_size(struct heap_t *self_p,
 static int free_dynamic_buffer(struct heap_t *self_p,
                                struct heap_buffer_header_t *header_p)
 {
-    header_p->u.next_p = self_p->dynamic.free_p;
-    self_p->dynamic.free_p = header_p;
+    struct heap_dynamic_header_t *block_p;
+    struct heap_dynamic_header_t *next_p;
+    struct heap_dynamic_header_t *prev_p;
+
+    block_p = container_of(header_p, struct heap_dynamic_header_t, header);
+
+    /* Coalesce with free neighbours. */
+    next_p = dynamic_next(self_p, block_p);
+
+    if ((next_p != NULL) && (next_p->header.count == 0)) {
+        dynamic_remove(self_p, next_p);
+        block_p->header.size += (DYNAMIC_HEADER_SIZE + next_p->header.size);
+        next_p = dynamic_next(self_p, block_p);
+    }
+
+    prev_p = dynamic_prev(block_p);
+
+    if ((prev_p != NULL) && (prev_p->header.count == 0)) {
+        dynamic_remove(self_p, prev_p);
+        prev_p->header.size += (DYNAMIC_HEADER_SIZE + block_p->header.size);
+        block_p = prev_p;
+    }
+
+    if (block_p == self_p->dynamic.begin_p) {
+        /* Give the first block back to the unallocated memory. */
+        if (next_p != NULL) {
+            next_p->prev_size = 0;
+            self_p->dynamic.begin_p = next_p;
+        } else {
+            self_p->dynamic.begin_p = self_p->dynamic.end_p;
+        }
+    } else {
+        if (next_p != NULL) {
+            next_p->prev_size = (DYNAMIC_HEADER_SIZE + block_p->header.size);
+        }
+
+        dynamic_insert(self_p, block_p);
+    }
+
+    return (0);
+}
+
+#if CONFIG_HEAP_MAGAZINES > 0
+
+/* Only the owner of a cache pops and pushes buffers, while other
+   threads take whole free lists by exchanging them with NULL. The
+   owner's compare-and-swap fails if its list was taken meanwhile, and
+   as nobody else pushes there is no ABA problem. */
+#if CONFIG_HEAP_MAGAZINES_LOCK_FREE == 1
+
+#define LOAD(value_p) __atomic_load_n(value_p, __ATOMIC_ACQUIRE)
+#define CAS(value_p, expected_p, desired)                               \
+    __atomic_compare_exchange_n(value_p,                                \
+                                expected_p,                             \
+                                desired,                                \
+                                0,                                      \
+                                __ATOMIC_ACQ_REL,                       \
+                                __ATOMIC_ACQUIRE)
+#define EXCHANGE(value_p, value)                                \
+    __atomic_exchange_n(value_p, value, __ATOMIC_ACQ_REL)
+
+#else
+
+#define LOAD(value_p) (*(void * volatile *)(value_p))
+#define CAS(value_p, expected_p, desired) cas(value_p, expected_p, desired)
+#define EXCHANGE(value_p, value) exchange(value_p, value)
+
+static int cas(void **value_pp, void **expected_pp, void *desired_p)
+{
+    int res;
+
+    sys_lock();
+
+    if (*value_pp == *expected_pp) {
+        *value_pp = desired_p;
+        res = 1;
+    } else {
+        *expected_pp = *value_pp;
+        res = 0;
+    }
+
+    sys_unlock();
+
+    return (res);
+}
+
+static void *exchange(void **value_pp, void *value_p)
+{
+    void *old_p;
+
+    sys_lock();
+    old_p = *value_pp;
+    *value_pp = value_p;
+    sys_unlock();
+
+    return (old_p);
+}
+
+#endif
+
+/**
+ * Get the cache of given thread, or NULL if it has none.
+ */
+static struct heap_magazine_t *magazine_get(struct heap_t *self_p,
+                                            struct thrd_t *thrd_p)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_HEAP_MAGAZINES; i++) {
+        if (self_p->magazines[i].thrd_p == thrd_p) {
+            return (&self_p->magazines[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+/**
+ * Pop a buffer with given index from given cache, or NULL if
+ * empty. Only called by the owner of the cache.
+ */
+static struct heap_buffer_header_t *magazine_pop(
+    struct heap_magazine_t *magazine_p,
+    int index)
+{
+    struct heap_buffer_header_t *header_p;
+    void *free_p;
+
+    free_p = LOAD(&magazine_p->fixed[index].free_p);
+
+    while (free_p != NULL) {
+        header_p = free_p;
+
+        /* The next pointer is garbage if another thread took the
+           list meanwhile, but then the swap fails. */
+        if (CAS(&magazine_p->fixed[index].free_p,
+                &free_p,
+                header_p->u.next_p)) {
+            magazine_p->fixed[index].length--;
+
+            return (header_p);
+        }
+    }
+
+    /* Empty, or another thread took the buffers. */
+    magazine_p->fixed[index].length = 0;
+
+    return (NULL);
+}
+
+/**
+ * Push given buffer with given index to given cache. Only called by
+ * the owner of the cache.
+ */
+static void magazine_push(struct heap_magazine_t *magazine_p,
+                          int index,
+                          struct heap_buffer_header_t *header_p)
+{
+    void *free_p;
+
+    free_p = LOAD(&magazine_p->fixed[index].free_p);
+
+    do {
+        header_p->u.next_p = free_p;
+    } while (!CAS(&magazine_p->fixed[index].free_p, &free_p, header_p));
+
+    /* Another thread may have taken the buffers. */
+    if (free_p == NULL) {
+        magazine_p->fixed[index].length = 0;
+    }
+
+    magazine_p->fixed[index].length++;
+}
+
+/**
+ * Move up to half a cache of buffers from the shared pool with given
+ * index to given cache. Buffers are allocated from the unallocated
+ * memory one at a time. The heap mutex must be taken.
+ */
+static void magazine_refill(struct heap_t *self_p,
+                            struct heap_magazine_t *magazine_p,
+                            int index)
+{
+    struct heap_fixed_t *fixed_p;
+    struct heap_buffer_header_t *header_p;
+    int i;
+
+    fixed_p = &self_p->fixed[index];
+
+    for (i = 0; i < CONFIG_HEAP_MAGAZINE_SIZE / 2; i++) {
+        if ((fixed_p->free_p == NULL) && (i > 0)) {
+            break;
+        }
+
+        header_p = alloc_fixed_block(self_p, fixed_p);
+
+        if (header_p == NULL) {
+            break;
+        }
+
+        magazine_push(magazine_p, index, header_p);
+    }
+
+    self_p->statistics.refills++;
+}
+
+/**
+ * Move up to given number of buffers from given cache to the shared
+ * pool with given index. Only called by the owner of the cache. The
+ * heap mutex must be taken.
+ */
+static void magazine_flush(struct heap_t *self_p,
+                           struct heap_magazine_t *magazine_p,
+                           int index,
+                           int length)
+{
+    struct heap_buffer_header_t *header_p;
+    struct heap_fixed_t *fixed_p;
+
+    fixed_p = &self_p->fixed[index];
+
+    while (length > 0) {
+        header_p = magazine_pop(magazine_p, index);
+
+        if (header_p == NULL) {
+            break;
+        }
+
+        header_p->u.next_p = fixed_p->free_p;
+        fixed_p->free_p = header_p;
+        length--;
+    }
+
+    self_p->statistics.flushes++;
+}
+
+/**
+ * Move all buffers with given index in given cache to the shared
+ * pool. May be called by any thread, as the free list is taken in
+ * one atomic exchange. The owner notices that its list is gone on
+ * its next pop or push. The heap mutex must be taken.
+ */
+static void magazine_take(struct heap_t *self_p,
+                          struct heap_magazine_t *magazine_p,
+                          int index)
+{
+    struct heap_buffer_header_t *header_p;
+    struct heap_buffer_header_t *next_p;
+    struct heap_fixed_t *fixed_p;
+
+    header_p = EXCHANGE(&magazine_p->fixed[index].free_p, NULL);
+
+    if (header_p == NULL) {
+        return;
+    }
+
+    fixed_p = &self_p->fixed[index];
+
+    while (header_p != NULL) {
+        next_p = header_p->u.next_p;
+        header_p->u.next_p = fixed_p->free_p;
+        fixed_p->free_p = header_p;
+        header_p = next_p;
+    }
+
+    self_p->statistics.flushes++;
+}
+
+/**
+ * Move all buffers in given cache to the shared pools and release the
+ * cache. The heap mutex must be taken, and the owner of the cache
+ * must be the calling thread or terminating.
+ */
+static void magazine_release(struct heap_t *self_p,
+                             struct heap_magazine_t *magazine_p)
+{
+    int i;
+
+    for (i = 0; i < HEAP_FIXED_SIZES_MAX; i++) {
+        magazine_take(self_p, magazine_p, i);
+        magazine_p->fixed[i].length = 0;
+    }
+
+    magazine_p->thrd_p = NULL;
+}
+
+/**
+ * Assign a free cache to given thread, or NULL if all are in use. The
+ * cache is added to the thread's list of caches, which is released
+ * when the thread terminates. The heap mutex must be taken.
+ */
+static struct heap_magazine_t *magazine_claim(struct heap_t *self_p,
+                                              struct thrd_t *thrd_p)
+{
+    struct heap_magazine_t *magazine_p;
+
+    magazine_p = magazine_get(self_p, NULL);
+
+    if (magazine_p != NULL) {
+        magazine_p->thrd_p = thrd_p;
+        magazine_p->heap_p = self_p;
+        magazine_p->next_p = thrd_p->heap_magazines_p;
+        thrd_p->heap_magazines_p = magazine_p;
+    }
+
+    return (magazine_p);
+}
+
+/**
+ * Remove given cache from the list of caches of given thread.
+ */
+static void magazine_unlink(struct thrd_t *thrd_p,
+                            struct heap_magazine_t *magazine_p)
+{
+    struct heap_magazine_t **next_pp;
+
+    next_pp = &thrd_p->heap_magazines_p;
+
+    while (*next_pp != NULL) {
+        if (*next_pp == magazine_p) {
+            *next_pp = magazine_p->next_p;
+            break;
+        }
+
+        next_pp = &(*next_pp)->next_p;
+    }
+}
+
+/**
+ * Move all buffers with given index in the caches of other threads
+ * than the owner of given cache to the shared pool. Called when the
+ * shared pool is empty to not fail allocations while other threads
+ * have free buffers in their caches. The heap mutex must be taken.
+ */
+static void magazines_reclaim(struct heap_t *self_p,
+                              struct heap_magazine_t *magazine_p,
+                              int index)
+{
+    struct heap_magazine_t *other_p;
+    int i;
+
+    for (i = 0; i < CONFIG_HEAP_MAGAZINES; i++) {
+        other_p = &self_p->magazines[i];
+
+        if ((other_p == magazine_p) || (other_p->thrd_p == NULL)) {
+            continue;
+        }
+
+        magazine_take(self_p, other_p, index);
+    }
+
+    self_p->statistics.reclaims++;
+}
+
+/**
+ * Allocate a fixed size buffer from the calling thread's cache,
+ * refilling it from the shared pool if empty. Threads without a
+ * cache allocate from the shared pool.
+ */
+static void *alloc_fixed_size_magazine(struct heap_t *self_p,
+                                       size_t size)
+{
+    struct heap_magazine_t *magazine_p;
+    struct heap_buffer_header_t *header_p;
+    struct thrd_t *thrd_p;
+    void *buf_p;
+    int index;
+
+    index = (fixed_size_pool(self_p, size) - &self_p->fixed[0]);
+    thrd_p = thrd_self();
+    magazine_p = NULL;
+
+    header_p = NULL;
+
+    if (thrd_p != NULL) {
+        magazine_p = magazine_get(self_p, thrd_p);
+    }
+
+    if (magazine_p != NULL) {
+        header_p = magazine_pop(magazine_p, index);
+    }
+
+    if (header_p == NULL) {
+        mutex_lock(&self_p->mutex);
+
+        if ((magazine_p == NULL) && (thrd_p != NULL)) {
+            magazine_p = magazine_claim(self_p, thrd_p);
+        }
+
+        if (magazine_p == NULL) {
+            buf_p = alloc_fixed_size(self_p, size);
+
+            if (buf_p == NULL) {
+                magazines_reclaim(self_p, NULL, index);
+                buf_p = alloc_fixed_size(self_p, size);
+            }
+
+            if (buf_p != NULL) {
+                self_p->statistics.allocs++;
+            } else {
+                self_p->statistics.failed_allocs++;
+            }
+
+            mutex_unlock(&self_p->mutex);
+
+            return (buf_p);
+        }
+
+        magazine_refill(self_p, magazine_p, index);
+
+        if (magazine_p->fixed[index].length == 0) {
+            magazines_reclaim(self_p, magazine_p, index);
+            magazine_refill(self_p, magazine_p, index);
+        }
+
+        /* No other thread takes the buffers while the mutex is
+           taken. */
+        header_p = magazine_pop(magazine_p, index);
+
+        if (header_p == NULL) {
+            self_p->statistics.failed_allocs++;
+            mutex_unlock(&self_p->mutex);
+
+            return (NULL);
+        }
+
+        mutex_unlock(&self_p->mutex);
+    }
+
+    magazine_p->statistics.allocs++;
+
+    /* Initialize the allocated buffer. */
+    header_p->u.fixed_p = &self_p->fixed[index];
+    header_p->size = size;
+    header_p->count = 1;
+
+    return (&header_p[1]);
+}
+
+/**
+ * Free given unshared fixed size buffer to given cache, flushing half
+ * of the cache to the shared pool if full.
+ */
+static int free_fixed_size_magazine(struct heap_t *self_p,
+                                    struct heap_magazine_t *magazine_p,
+                                    struct heap_buffer_header_t *header_p)
+{
+    int index;
+
+    index = (header_p->u.fixed_p - &self_p->fixed[0]);
+
+    if (magazine_p->fixed[index].length == CONFIG_HEAP_MAGAZINE_SIZE) {
+        mutex_lock(&self_p->mutex);
+        magazine_flush(self_p,
+                       magazine_p,
+                       index,
+                       CONFIG_HEAP_MAGAZINE_SIZE / 2);
+        mutex_unlock(&self_p->mutex);
+    }
+
+    header_p->count = 0;
+    magazine_push(magazine_p, index, header_p);
+    magazine_p->statistics.frees++;
+
+    return (0);
+}
+
+#endif
+
+#if CONFIG_HEAP_FS_COMMAND_STATS == 1
+
+static int cmd_stats_cb(int argc,
+                        const char *argv[],
+                        void *chout_p,
+                        void *chin_p,
+                        void *arg_p,
+                        void *call_arg_p)
+{
+    struct heap_t *self_p;
+    uint32_t magazine_allocs;
+    uint32_t magazine_frees;
+    int magazines;
+#if CONFIG_HEAP_MAGAZINES > 0
+    int i;
+#endif
+
+    self_p = arg_p;
+    magazine_allocs = 0;
+    magazine_frees = 0;
+    magazines = 0;
+
+#if CONFIG_HEAP_MAGAZINES > 0
+    for (i = 0; i < CONFIG_HEAP_MAGAZINES; i++) {
+        magazine_allocs += self_p->magazines[i].statistics.allocs;
+        magazine_frees += self_p->magazines[i].statistics.frees;
+
+        if (self_p->magazines[i].thrd_p != NULL) {
+            magazines++;
+        }
+    }
+#endif
+
+    std_fprintf(chout_p,
+                OSTR("mutex_allocs: %lu\r\n"
+                     "mutex_frees: %lu\r\n"
+                     "magazine_allocs: %lu\r\n"
+                     "magazine_frees: %lu\r\n"
+                     "refills: %lu\r\n"
+                     "flushes: %lu\r\n"
+                     "reclaims: %lu\r\n"
+                     "failed_allocs: %lu\r\n"
+                     "magazines: %d/%d\r\n"),
+                (unsigned long)self_p->statistics.allocs,
+                (unsigned long)self_p->statistics.frees,
+                (unsigned long)magazine_allocs,
+                (unsigned long)magazine_frees,
+                (unsigned long)self_p->statistics.refills,
+                (unsigned long)self_p->statistics.flushes,
+                (unsigned long)self_p->statistics.reclaims,
+                (unsigned long)self_p->statistics.failed_allocs,
+                magazines,
+                CONFIG_HEAP_MAGAZINES);
 
     return (0);
 }
 
+#endif
+
 int heap_init(struct heap_t *self_p,
               void *buf_p,
               size_t size,
@@ -180,7 +943,27 @@ int heap_init(struct heap_t *self_p,
         self_p->fixed[i].size = sizes[i];
     }
 
-    self_p->dynamic.free_p = NULL;
+    /* The dynamic part grows downwards from the aligned end of the
+       buffer. */
+    self_p->dynamic.end_p = (void *)((uintptr_t)((char *)buf_p + size)
+                                     & ~(DYNAMIC_ALIGNMENT - 1));
+
+    if ((char *)self_p->dynamic.end_p < (char *)buf_p) {
+        self_p->dynamic.end_p = buf_p;
+    }
+
+    self_p->dynamic.begin_p = self_p->dynamic.end_p;
+    self_p->dynamic.bins_bitmap = 0;
+
+    for (i = 0; i < HEAP_DYNAMIC_BINS_MAX; i++) {
+        self_p->dynamic.free_p[i] = NULL;
+    }
+
+#if CONFIG_HEAP_MAGAZINES > 0
+    memset(&self_p->magazines[0], 0, sizeof(self_p->magazines));
+#endif
+
+    memset(&self_p->statistics, 0, sizeof(self_p->statistics));
 
     return (mutex_init(&self_p->mutex));
 }
@@ -193,6 +976,12 @@ void *heap_alloc(struct heap_t *self_p,
 
     void *buf_p = NULL;
 
+#if CONFIG_HEAP_MAGAZINES > 0
+    if (size <= self_p->fixed[HEAP_FIXED_SIZES_MAX - 1].size) {
+        return (alloc_fixed_size_magazine(self_p, size));
+    }
+#endif
+
     mutex_lock(&self_p->mutex);
 
     if (size <= self_p->fixed[HEAP_FIXED_SIZES_MAX - 1].size) {
@@ -201,6 +990,12 @@ void *heap_alloc(struct heap_t *self_p,
         buf_p = alloc_dynamic_size(self_p, size);
     }
 
+    if (buf_p != NULL) {
+        self_p->statistics.allocs++;
+    } else {
+        self_p->statistics.failed_allocs++;
+    }
+
     mutex_unlock(&self_p->mutex);
 
     return (buf_p);
@@ -214,9 +1009,31 @@ int heap_free(struct heap_t *self_p,
 
     int count;
     struct heap_buffer_header_t *header_p;
+#if CONFIG_HEAP_MAGAZINES > 0
+    struct heap_magazine_t *magazine_p;
+    struct thrd_t *thrd_p;
+#endif
 
     header_p = &((struct heap_buffer_header_t *)buf_p)[-1];
 
+#if CONFIG_HEAP_MAGAZINES > 0
+    /* Only the caller has a reference to an unshared buffer, so it
+       can be freed to the caller's cache without the mutex. */
+    if ((header_p->count == 1) && (header_p->u.fixed_p != NULL)) {
+        thrd_p = thrd_self();
+
+        if (thrd_p != NULL) {
+            magazine_p = magazine_get(self_p, thrd_p);
+
+            if (magazine_p != NULL) {
+                return (free_fixed_size_magazine(self_p,
+                                                 magazine_p,
+                                                 header_p));
+            }
+        }
+    }
+#endif
+
     mutex_lock(&self_p->mutex);
 
     if (header_p->count > 0) {
@@ -225,6 +1042,8 @@ int heap_free(struct heap_t *self_p,
 
         /* Free when count is zero. */
         if (count == 0) {
+            self_p->statistics.frees++;
+
             if (header_p->u.fixed_p != NULL) {
                 count = free_fixed_size(self_p, header_p);
             } else {
@@ -258,3 +1077,76 @@ int heap_share(struct heap_t *self_p,
 
     return (0);
 }
+
+int heap_flush(struct heap_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+#if CONFIG_HEAP_MAGAZINES > 0
+    struct heap_magazine_t *magazine_p;
+    struct thrd_t *thrd_p;
+
+    thrd_p = thrd_self();
+
+    if (thrd_p == NULL) {
+        return (0);
+    }
+
+    mutex_lock(&self_p->mutex);
+
+    magazine_p = magazine_get(self_p, thrd_p);
+
+    if (magazine_p != NULL) {
+        magazine_release(self_p, magazine_p);
+        magazine_unlink(thrd_p, magazine_p);
+    }
+
+    mutex_unlock(&self_p->mutex);
+#endif
+
+    return (0);
+}
+
+int heap_release_magazines(struct thrd_t *thrd_p)
+{
+    ASSERTN(thrd_p != NULL, EINVAL);
+
+#if CONFIG_HEAP_MAGAZINES > 0
+    struct heap_magazine_t *magazine_p;
+    struct heap_magazine_t *next_p;
+    struct heap_t *heap_p;
+
+    magazine_p = thrd_p->heap_magazines_p;
+
+    while (magazine_p != NULL) {
+        next_p = magazine_p->next_p;
+        heap_p = magazine_p->heap_p;
+        mutex_lock(&heap_p->mutex);
+        magazine_release(heap_p, magazine_p);
+        mutex_unlock(&heap_p->mutex);
+        magazine_p = next_p;
+    }
+
+    thrd_p->heap_magazines_p = NULL;
+#endif
+
+    return (0);
+}
+
+int heap_stats_register(struct heap_t *self_p,
+                        far_string_t path_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(path_p != NULL, EINVAL);
+
+#if CONFIG_HEAP_FS_COMMAND_STATS == 1
+    fs_command_init(&self_p->cmd_stats,
+                    path_p,
+                    cmd_stats_cb,
+                    self_p);
+
+    return (fs_command_register(&self_p->cmd_stats));
+#else
+    return (-ENOSYS);
+#endif
+}
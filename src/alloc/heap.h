@@ -43,8 +43,45 @@ struct heap_fixed_t {
     size_t size;
 };
 
+/**
+ * Number of size segregated free lists in the dynamic part of the
+ * heap. Free list ``i`` holds blocks of 2^(``i`` + 4) to 2^(``i`` +
+ * 5) - 1 bytes, except the last which holds all bigger blocks.
+ */
+#define HEAP_DYNAMIC_BINS_MAX 16
+
+/**
+ * The dynamic part of the heap grows downwards from the end of the
+ * heap memory buffer, while fixed size buffers are allocated from
+ * the beginning of it. Freed blocks are coalesced with free
+ * neighbours, and the block at the dynamic part boundary is given
+ * back to the unallocated memory.
+ */
 struct heap_dynamic_t {
-    void *free_p;
+    void *begin_p;
+    void *end_p;
+    uint32_t bins_bitmap;
+    void *free_p[HEAP_DYNAMIC_BINS_MAX];
+};
+
+/**
+ * A per-thread cache of fixed size buffers. Only the owner thread
+ * pushes buffers to the free lists, while other threads may take
+ * whole lists at any time.
+ */
+struct heap_magazine_t {
+    struct thrd_t *thrd_p;
+    struct heap_t *heap_p;
+    /* Next cache of the same thread. */
+    struct heap_magazine_t *next_p;
+    struct {
+        void *free_p;
+        uint8_t length;
+    } fixed[HEAP_FIXED_SIZES_MAX];
+    struct {
+        uint32_t allocs;
+        uint32_t frees;
+    } statistics;
 };
 
 /**
@@ -56,7 +93,21 @@ struct heap_t {
     void *next_p;
     struct heap_fixed_t fixed[HEAP_FIXED_SIZES_MAX];
     struct heap_dynamic_t dynamic;
+#if CONFIG_HEAP_MAGAZINES > 0
+    struct heap_magazine_t magazines[CONFIG_HEAP_MAGAZINES];
+#endif
     struct mutex_t mutex;
+    struct {
+        uint32_t allocs;
+        uint32_t frees;
+        uint32_t failed_allocs;
+        uint32_t refills;
+        uint32_t flushes;
+        uint32_t reclaims;
+    } statistics;
+#if CONFIG_HEAP_FS_COMMAND_STATS == 1
+    struct fs_command_t cmd_stats;
+#endif
 };
 
 /**
@@ -79,6 +130,11 @@ int heap_init(struct heap_t *self_p,
  * if the requested buffer size is greater than the biggest fixed size
  * buffer.
  *
+ * Fixed size buffers are allocated from the calling thread's cache
+ * without taking the heap mutex, if the thread has a cache and it is
+ * not empty. Buffers in the caches of other threads are moved back to
+ * the shared pool before an allocation fails.
+ *
  * @param[in] self_p Heap to allocate from.
  * @param[in] size Number of bytes to allocate.
  *
@@ -113,4 +169,40 @@ int heap_share(struct heap_t *self_p,
                const void *buf_p,
                int count);
 
+/**
+ * Move all buffers in the calling thread's cache back to the shared
+ * fixed size pools and release the cache for use by other
+ * threads. The caches of a thread are released when it terminates,
+ * so a thread only has to call this before the memory of a heap it
+ * allocated from is reused.
+ *
+ * @param[in] self_p Heap to flush.
+ *
+ * @return zero(0) or negative error code.
+ */
+int heap_flush(struct heap_t *self_p);
+
+/**
+ * Move all buffers in the caches of given thread in all heaps back
+ * to the shared fixed size pools and release the caches. Called by
+ * the kernel when given thread terminates.
+ *
+ * @param[in] thrd_p Thread to release the caches of.
+ *
+ * @return zero(0) or negative error code.
+ */
+int heap_release_magazines(struct thrd_t *thrd_p);
+
+/**
+ * Register a file system command at given path that prints
+ * allocation statistics of given heap.
+ *
+ * @param[in] self_p Heap to print statistics of.
+ * @param[in] path_p Path to register.
+ *
+ * @return zero(0) or negative error code.
+ */
+int heap_stats_register(struct heap_t *self_p,
+                        far_string_t path_p);
+
 #endif
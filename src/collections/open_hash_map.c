@@ -0,0 +1,621 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+/* Hash values with special meaning. */
+#define HASH_EMPTY                                          0
+#define HASH_REMOVED                                        1
+
+/* Number of slots of the old table to move on each modification of
+   a resizing map. */
+#define MIGRATE_SLOTS                                       8
+
+/**
+ * Get given short key zero padded to 64 bits.
+ */
+static uint64_t short_key(const void *key_p, size_t key_size)
+{
+    uint64_t value;
+    uint32_t value32;
+
+    /* Load common key sizes into registers instead of into memory
+       with memcpy(). */
+    switch (key_size) {
+
+    case 8:
+        memcpy(&value, key_p, sizeof(value));
+        break;
+
+    case 4:
+        memcpy(&value32, key_p, sizeof(value32));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = ((uint64_t)value32 << 32);
+#else
+        value = value32;
+#endif
+        break;
+
+    default:
+        value = 0;
+        memcpy(&value, key_p, key_size);
+        break;
+    }
+
+    return (value);
+}
+
+/**
+ * Short keys are hashed with a single multiplication by the 64 bits
+ * golden ratio, keeping the well mixed high bits. Longer keys are
+ * hashed with MurmurHash3 (x86, 32 bits) with seed zero.
+ */
+static uint32_t default_hash(const void *key_p, size_t size)
+{
+    const uint8_t *buf_p;
+    uint64_t value;
+    uint32_t hash;
+    uint32_t block;
+    size_t length;
+
+    if (size <= OPEN_HASH_MAP_INLINE_KEY_SIZE_MAX) {
+        value = ((short_key(key_p, size) ^ size)
+                 * 0x9e3779b97f4a7c15ULL);
+
+        return ((uint32_t)(value >> 32));
+    }
+
+    buf_p = key_p;
+    hash = 0;
+    length = size;
+
+    while (length >= 4) {
+        memcpy(&block, buf_p, sizeof(block));
+        block *= 0xcc9e2d51UL;
+        block = ((block << 15) | (block >> 17));
+        block *= 0x1b873593UL;
+        hash ^= block;
+        hash = ((hash << 13) | (hash >> 19));
+        hash = (hash * 5 + 0xe6546b64UL);
+        buf_p += 4;
+        length -= 4;
+    }
+
+    if (length > 0) {
+        block = 0;
+
+        while (length > 0) {
+            length--;
+            block = ((block << 8) | buf_p[length]);
+        }
+
+        block *= 0xcc9e2d51UL;
+        block = ((block << 15) | (block >> 17));
+        block *= 0x1b873593UL;
+        hash ^= block;
+    }
+
+    hash ^= (uint32_t)size;
+    hash ^= (hash >> 16);
+    hash *= 0x85ebca6bUL;
+    hash ^= (hash >> 13);
+    hash *= 0xc2b2ae35UL;
+    hash ^= (hash >> 16);
+
+    return (hash);
+}
+
+static uint32_t key_hash(struct open_hash_map_t *self_p,
+                         const void *key_p,
+                         size_t key_size)
+{
+    uint32_t hash;
+
+    hash = self_p->hash(key_p, key_size);
+
+    /* Zero and one are reserved. */
+    if (hash <= HASH_REMOVED) {
+        hash += 2;
+    }
+
+    return (hash);
+}
+
+/**
+ * Compare given entry's key to given key. A short key is one 64 bits
+ * comparison of the zero padded keys in the slot and in `value`.
+ */
+static int entry_key_equal(struct open_hash_map_entry_t *entry_p,
+                           const void *key_p,
+                           size_t key_size,
+                           uint64_t value)
+{
+    uint64_t entry_value;
+
+    if (entry_p->key_size != key_size) {
+        return (0);
+    }
+
+    if (key_size <= OPEN_HASH_MAP_INLINE_KEY_SIZE_MAX) {
+        memcpy(&entry_value, &entry_p->key.buf[0], sizeof(entry_value));
+
+        return (entry_value == value);
+    }
+
+    return (memcmp(entry_p->key.key_p, key_p, key_size) == 0);
+}
+
+/**
+ * Get the zero padded short key to compare slots to, or zero(0) for
+ * long keys.
+ */
+static uint64_t lookup_value(const void *key_p, size_t key_size)
+{
+    if (key_size > OPEN_HASH_MAP_INLINE_KEY_SIZE_MAX) {
+        return (0);
+    }
+
+    return (short_key(key_p, key_size));
+}
+
+static int is_power_of_two(size_t value)
+{
+    return ((value > 0) && ((value & (value - 1)) == 0));
+}
+
+/**
+ * Maximum number of entries in a table with given number of slots.
+ */
+static size_t max_length(size_t entries_max)
+{
+    return (entries_max - entries_max / 8);
+}
+
+/**
+ * Get the distance between given slot and the slot its entry hashes
+ * to.
+ */
+static size_t probe_distance(struct open_hash_map_table_t *table_p,
+                             size_t index)
+{
+    return ((index - table_p->entries_p[index].hash) & table_p->mask);
+}
+
+static void table_init(struct open_hash_map_table_t *table_p,
+                       struct open_hash_map_entry_t *entries_p,
+                       size_t entries_max)
+{
+    size_t i;
+
+    table_p->entries_p = entries_p;
+    table_p->mask = (entries_max - 1);
+
+    for (i = 0; i < entries_max; i++) {
+        entries_p[i].hash = HASH_EMPTY;
+    }
+}
+
+/**
+ * Find the slot of given key, or NULL if missing. Removed slots only
+ * exist in the old table of a resizing map.
+ */
+static struct open_hash_map_entry_t *table_find(
+    struct open_hash_map_table_t *table_p,
+    uint32_t hash,
+    const void *key_p,
+    size_t key_size,
+    uint64_t value)
+{
+    struct open_hash_map_entry_t *entry_p;
+    size_t index;
+    size_t distance;
+
+    index = (hash & table_p->mask);
+
+    for (distance = 0; distance <= table_p->mask; distance++) {
+        entry_p = &table_p->entries_p[index];
+
+        /* Compare the stored hash first, as it rarely matches unless
+           the keys are equal. */
+        if (entry_p->hash == hash) {
+            if (entry_key_equal(entry_p, key_p, key_size, value) == 1) {
+                return (entry_p);
+            }
+        } else if (entry_p->hash == HASH_EMPTY) {
+            break;
+        } else if (entry_p->hash != HASH_REMOVED) {
+            /* Robin Hood invariant: the key would have been placed
+               here. */
+            if (probe_distance(table_p, index) < distance) {
+                break;
+            }
+        }
+
+        index = ((index + 1) & table_p->mask);
+    }
+
+    return (NULL);
+}
+
+/**
+ * Insert given entry, which must not already be in the table, at
+ * given slot and probe distance. Rich entries are displaced by poor
+ * entries, keeping probe sequences short.
+ */
+static void table_insert_at(struct open_hash_map_table_t *table_p,
+                            struct open_hash_map_entry_t *entry_p,
+                            size_t index,
+                            size_t distance)
+{
+    struct open_hash_map_entry_t entry;
+    struct open_hash_map_entry_t tmp;
+    size_t slot_distance;
+
+    entry = *entry_p;
+
+    while (table_p->entries_p[index].hash != HASH_EMPTY) {
+        slot_distance = probe_distance(table_p, index);
+
+        if (slot_distance < distance) {
+            tmp = table_p->entries_p[index];
+            table_p->entries_p[index] = entry;
+            entry = tmp;
+            distance = slot_distance;
+        }
+
+        index = ((index + 1) & table_p->mask);
+        distance++;
+    }
+
+    table_p->entries_p[index] = entry;
+}
+
+static void table_insert(struct open_hash_map_table_t *table_p,
+                         struct open_hash_map_entry_t *entry_p)
+{
+    table_insert_at(table_p, entry_p, entry_p->hash & table_p->mask, 0);
+}
+
+/**
+ * Remove given entry by shifting following displaced entries one
+ * slot backwards, leaving no tombstones behind.
+ */
+static void table_remove(struct open_hash_map_table_t *table_p,
+                         struct open_hash_map_entry_t *entry_p)
+{
+    size_t index;
+    size_t next;
+
+    index = (entry_p - table_p->entries_p);
+    next = ((index + 1) & table_p->mask);
+
+    while ((table_p->entries_p[next].hash != HASH_EMPTY)
+           && (probe_distance(table_p, next) > 0)) {
+        table_p->entries_p[index] = table_p->entries_p[next];
+        index = next;
+        next = ((next + 1) & table_p->mask);
+    }
+
+    table_p->entries_p[index].hash = HASH_EMPTY;
+}
+
+/**
+ * Move up to given number of slots from the old table to the current
+ * table of a resizing map.
+ */
+static void migrate(struct open_hash_map_t *self_p, size_t slots)
+{
+    struct open_hash_map_entry_t *entry_p;
+
+    if (self_p->old.entries_p == NULL) {
+        return;
+    }
+
+    while (slots > 0) {
+        entry_p = &self_p->old.entries_p[self_p->migrate_index];
+
+        if (entry_p->hash > HASH_REMOVED) {
+            table_insert(&self_p->table, entry_p);
+        }
+
+        /* Keep probing past moved entries. */
+        entry_p->hash = HASH_REMOVED;
+        self_p->migrate_index++;
+
+        if (self_p->migrate_index > self_p->old.mask) {
+            self_p->old.entries_p = NULL;
+            break;
+        }
+
+        slots--;
+    }
+}
+
+int open_hash_map_init(struct open_hash_map_t *self_p,
+                       struct open_hash_map_entry_t *entries_p,
+                       size_t entries_max,
+                       open_hash_map_hash_t hash)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(entries_p != NULL, EINVAL);
+    ASSERTN(is_power_of_two(entries_max), EINVAL);
+
+    if (hash == NULL) {
+        hash = default_hash;
+    }
+
+    table_init(&self_p->table, entries_p, entries_max);
+    self_p->old.entries_p = NULL;
+    self_p->migrate_index = 0;
+    self_p->length = 0;
+    self_p->hash = hash;
+
+    return (0);
+}
+
+int open_hash_map_add(struct open_hash_map_t *self_p,
+                      const void *key_p,
+                      size_t key_size,
+                      void *value_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(key_p != NULL, EINVAL);
+
+    struct open_hash_map_table_t *table_p;
+    struct open_hash_map_entry_t *entry_p;
+    struct open_hash_map_entry_t entry;
+    uint64_t value;
+    uint32_t hash;
+    size_t index;
+    size_t distance;
+
+    migrate(self_p, MIGRATE_SLOTS);
+    hash = key_hash(self_p, key_p, key_size);
+    value = lookup_value(key_p, key_size);
+
+    if (self_p->old.entries_p != NULL) {
+        entry_p = table_find(&self_p->old, hash, key_p, key_size, value);
+
+        if (entry_p != NULL) {
+            entry_p->value_p = value_p;
+
+            return (0);
+        }
+    }
+
+    /* Look for the key and its insert position in one pass. */
+    table_p = &self_p->table;
+    index = (hash & table_p->mask);
+    distance = 0;
+
+    while (1) {
+        entry_p = &table_p->entries_p[index];
+
+        if (entry_p->hash == HASH_EMPTY) {
+            break;
+        }
+
+        if ((entry_p->hash == hash)
+            && (entry_key_equal(entry_p, key_p, key_size, value) == 1)) {
+            entry_p->value_p = value_p;
+
+            return (0);
+        }
+
+        if (probe_distance(table_p, index) < distance) {
+            break;
+        }
+
+        index = ((index + 1) & table_p->mask);
+        distance++;
+    }
+
+    if (self_p->length >= max_length(table_p->mask + 1)) {
+        return (-ENOMEM);
+    }
+
+    entry.hash = hash;
+    entry.key_size = key_size;
+
+    if (key_size <= OPEN_HASH_MAP_INLINE_KEY_SIZE_MAX) {
+        memcpy(&entry.key.buf[0], &value, sizeof(entry.key.buf));
+    } else {
+        entry.key.key_p = key_p;
+    }
+
+    entry.value_p = value_p;
+    table_insert_at(table_p, &entry, index, distance);
+    self_p->length++;
+
+    return (0);
+}
+
+int open_hash_map_remove(struct open_hash_map_t *self_p,
+                         const void *key_p,
+                         size_t key_size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(key_p != NULL, EINVAL);
+
+    struct open_hash_map_entry_t *entry_p;
+    uint64_t value;
+    uint32_t hash;
+
+    migrate(self_p, MIGRATE_SLOTS);
+    hash = key_hash(self_p, key_p, key_size);
+    value = lookup_value(key_p, key_size);
+    entry_p = table_find(&self_p->table, hash, key_p, key_size, value);
+
+    if (entry_p != NULL) {
+        table_remove(&self_p->table, entry_p);
+    } else {
+        if (self_p->old.entries_p == NULL) {
+            return (-ENODATA);
+        }
+
+        entry_p = table_find(&self_p->old, hash, key_p, key_size, value);
+
+        if (entry_p == NULL) {
+            return (-ENODATA);
+        }
+
+        entry_p->hash = HASH_REMOVED;
+    }
+
+    self_p->length--;
+
+    return (0);
+}
+
+void *open_hash_map_get(struct open_hash_map_t *self_p,
+                        const void *key_p,
+                        size_t key_size)
+{
+    ASSERTNRN(self_p != NULL, EINVAL);
+    ASSERTNRN(key_p != NULL, EINVAL);
+
+    struct open_hash_map_entry_t *entry_p;
+    uint64_t value;
+    uint32_t hash;
+
+    hash = key_hash(self_p, key_p, key_size);
+    value = lookup_value(key_p, key_size);
+    entry_p = table_find(&self_p->table, hash, key_p, key_size, value);
+
+    if ((entry_p == NULL) && (self_p->old.entries_p != NULL)) {
+        entry_p = table_find(&self_p->old, hash, key_p, key_size, value);
+    }
+
+    if (entry_p == NULL) {
+        return (NULL);
+    }
+
+    return (entry_p->value_p);
+}
+
+size_t open_hash_map_length(struct open_hash_map_t *self_p)
+{
+    ASSERTNR(self_p != NULL, EINVAL, 0);
+
+    return (self_p->length);
+}
+
+int open_hash_map_resize(struct open_hash_map_t *self_p,
+                         struct open_hash_map_entry_t *entries_p,
+                         size_t entries_max)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(entries_p != NULL, EINVAL);
+    ASSERTN(is_power_of_two(entries_max), EINVAL);
+
+    if (self_p->old.entries_p != NULL) {
+        return (-EBUSY);
+    }
+
+    if (self_p->length > max_length(entries_max)) {
+        return (-ENOMEM);
+    }
+
+    self_p->old = self_p->table;
+    self_p->migrate_index = 0;
+    table_init(&self_p->table, entries_p, entries_max);
+
+    return (0);
+}
+
+int open_hash_map_resize_finish(struct open_hash_map_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    migrate(self_p, self_p->old.mask + 1);
+
+    return (0);
+}
+
+int open_hash_map_is_resizing(struct open_hash_map_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (self_p->old.entries_p != NULL);
+}
+
+int open_hash_map_iter_init(struct open_hash_map_iter_t *self_p,
+                            struct open_hash_map_t *map_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(map_p != NULL, EINVAL);
+
+    self_p->map_p = map_p;
+    self_p->table_p = &map_p->table;
+    self_p->index = 0;
+
+    return (0);
+}
+
+struct open_hash_map_entry_t *open_hash_map_iter_next(
+    struct open_hash_map_iter_t *self_p)
+{
+    ASSERTNRN(self_p != NULL, EINVAL);
+
+    struct open_hash_map_entry_t *entry_p;
+
+    while (self_p->table_p != NULL) {
+        while (self_p->index <= self_p->table_p->mask) {
+            entry_p = &self_p->table_p->entries_p[self_p->index];
+            self_p->index++;
+
+            if (entry_p->hash > HASH_REMOVED) {
+                return (entry_p);
+            }
+        }
+
+        /* Continue with the old table of a resizing map. */
+        if ((self_p->table_p == &self_p->map_p->table)
+            && (self_p->map_p->old.entries_p != NULL)) {
+            self_p->table_p = &self_p->map_p->old;
+            self_p->index = 0;
+        } else {
+            self_p->table_p = NULL;
+        }
+    }
+
+    return (NULL);
+}
+
+const void *open_hash_map_entry_key(struct open_hash_map_entry_t *entry_p)
+{
+    ASSERTNRN(entry_p != NULL, EINVAL);
+
+    if (entry_p->key_size <= OPEN_HASH_MAP_INLINE_KEY_SIZE_MAX) {
+        return (&entry_p->key.buf[0]);
+    }
+
+    return (entry_p->key.key_p);
+}
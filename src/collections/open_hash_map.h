@@ -0,0 +1,228 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __COLLECTIONS_OPEN_HASH_MAP_H__
+#define __COLLECTIONS_OPEN_HASH_MAP_H__
+
+#include "simba.h"
+
+typedef uint32_t (*open_hash_map_hash_t)(const void *key_p, size_t size);
+
+/**
+ * Keys of at most this number of bytes are copied into the slots,
+ * so probing for them never follows a pointer.
+ */
+#define OPEN_HASH_MAP_INLINE_KEY_SIZE_MAX 8
+
+/**
+ * A slot in the open addressing table. The hash is zero(0) in empty
+ * slots. Use `open_hash_map_entry_key()` to get the key.
+ */
+struct open_hash_map_entry_t {
+    uint32_t hash;
+    uint32_t key_size;
+    union {
+        /* Zero padded copy of a short key. */
+        uint8_t buf[OPEN_HASH_MAP_INLINE_KEY_SIZE_MAX];
+        const void *key_p;
+    } key;
+    void *value_p;
+};
+
+struct open_hash_map_table_t {
+    struct open_hash_map_entry_t *entries_p;
+    size_t mask;
+};
+
+/**
+ * Robin Hood hashing map with byte string keys. Entries are stored
+ * in a caller supplied array of slots.
+ */
+struct open_hash_map_t {
+    struct open_hash_map_table_t table;
+    /* Table being migrated into the table above during a resize, or
+       NULL entries if no resize is ongoing. */
+    struct open_hash_map_table_t old;
+    size_t migrate_index;
+    size_t length;
+    open_hash_map_hash_t hash;
+};
+
+/**
+ * Hash map iterator.
+ */
+struct open_hash_map_iter_t {
+    struct open_hash_map_t *map_p;
+    struct open_hash_map_table_t *table_p;
+    size_t index;
+};
+
+/**
+ * Initialize given hash map.
+ *
+ * @param[in,out] self_p Hash map to initialize.
+ * @param[in] entries_p Array of entries.
+ * @param[in] entries_max Number of entries in `entries_p`. Must be a
+ *                        power of two. At most 7/8 of the entries
+ *                        can be used.
+ * @param[in] hash Hash function, or NULL to use the default hash
+ *                 function.
+ *
+ * @return zero(0) or negative error code.
+ */
+int open_hash_map_init(struct open_hash_map_t *self_p,
+                       struct open_hash_map_entry_t *entries_p,
+                       size_t entries_max,
+                       open_hash_map_hash_t hash);
+
+/**
+ * Add given key-value pair into hash map. Overwrites old value if the
+ * key is already present in map.
+ *
+ * Keys of at most `OPEN_HASH_MAP_INLINE_KEY_SIZE_MAX` bytes are
+ * copied into the map. Only a reference to longer keys is stored, and
+ * they must not be modified or freed until removed from the map.
+ *
+ * @param[in] self_p Initialized hash map.
+ * @param[in] key_p Key to add.
+ * @param[in] key_size Key size in bytes.
+ * @param[in] value_p Value to insert for key.
+ *
+ * @return zero(0) or negative error code.
+ */
+int open_hash_map_add(struct open_hash_map_t *self_p,
+                      const void *key_p,
+                      size_t key_size,
+                      void *value_p);
+
+/**
+ * Remove given key from hash map.
+ *
+ * @param[in] self_p Initialized hash map.
+ * @param[in] key_p Key to remove.
+ * @param[in] key_size Key size in bytes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int open_hash_map_remove(struct open_hash_map_t *self_p,
+                         const void *key_p,
+                         size_t key_size);
+
+/**
+ * Get value for given key.
+ *
+ * @param[in] self_p Initialized hash map.
+ * @param[in] key_p Key to find.
+ * @param[in] key_size Key size in bytes.
+ *
+ * @return Value for given key, or NULL if the key was not found.
+ */
+void *open_hash_map_get(struct open_hash_map_t *self_p,
+                        const void *key_p,
+                        size_t key_size);
+
+/**
+ * Get the number of entries in given hash map.
+ *
+ * @param[in] self_p Initialized hash map.
+ *
+ * @return Number of entries.
+ */
+size_t open_hash_map_length(struct open_hash_map_t *self_p);
+
+/**
+ * Start moving all entries in given hash map to given array of
+ * entries. Entries are moved a few at a time by each call to
+ * `open_hash_map_add()` and `open_hash_map_remove()`, and the map
+ * can be used as usual meanwhile. The current array of entries is
+ * in use until `open_hash_map_is_resizing()` returns false.
+ *
+ * @param[in] self_p Initialized hash map.
+ * @param[in] entries_p New array of entries.
+ * @param[in] entries_max Number of entries in `entries_p`. Must be a
+ *                        power of two.
+ *
+ * @return zero(0) or negative error code.
+ */
+int open_hash_map_resize(struct open_hash_map_t *self_p,
+                         struct open_hash_map_entry_t *entries_p,
+                         size_t entries_max);
+
+/**
+ * Move all remaining entries of an ongoing resize.
+ *
+ * @param[in] self_p Initialized hash map.
+ *
+ * @return zero(0) or negative error code.
+ */
+int open_hash_map_resize_finish(struct open_hash_map_t *self_p);
+
+/**
+ * Check if given hash map is resizing.
+ *
+ * @param[in] self_p Initialized hash map.
+ *
+ * @return true(1) if the previous array of entries is still in use,
+ *         otherwise false(0).
+ */
+int open_hash_map_is_resizing(struct open_hash_map_t *self_p);
+
+/**
+ * Initialize given iterator. The map must not be modified while
+ * iterating.
+ *
+ * @param[in] self_p Iterator to initialize.
+ * @param[in] map_p Hash map to iterate over.
+ *
+ * @return zero(0) or negative error code.
+ */
+int open_hash_map_iter_init(struct open_hash_map_iter_t *self_p,
+                            struct open_hash_map_t *map_p);
+
+/**
+ * Get the next entry from given iterator.
+ *
+ * @param[in] self_p Iterator.
+ *
+ * @return Next entry, or NULL if all entries have been iterated over.
+ */
+struct open_hash_map_entry_t *open_hash_map_iter_next(
+    struct open_hash_map_iter_t *self_p);
+
+/**
+ * Get the key of given entry.
+ *
+ * @param[in] entry_p Entry returned by `open_hash_map_iter_next()`.
+ *
+ * @return The key, which is `entry_p->key_size` bytes long.
+ */
+const void *open_hash_map_entry_key(struct open_hash_map_entry_t *entry_p);
+
+#endif
@@ -0,0 +1,284 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+
+#include "simba.h"
+
+/* The producer publishes written data with a release store of the
+   write index, and the consumer returns the space with a release
+   store of the read index. Each side loads the index of the other
+   side with acquire semantics before touching the buffer. */
+#define LOAD_OWN(index_p) __atomic_load_n(index_p, __ATOMIC_RELAXED)
+#define LOAD_OTHER(index_p) __atomic_load_n(index_p, __ATOMIC_ACQUIRE)
+#define STORE(index_p, value) __atomic_store_n(index_p, value, __ATOMIC_RELEASE)
+
+static size_t get_capacity(struct spsc_ring_t *self_p)
+{
+    return ((size_t)self_p->mask + 1);
+}
+
+static size_t get_used_size(spsc_ring_index_t writepos,
+                            spsc_ring_index_t readpos)
+{
+    return ((spsc_ring_index_t)(writepos - readpos));
+}
+
+/**
+ * Get the first or second array of at most given size starting at
+ * given position in the buffer, where available is the number of
+ * bytes in both arrays.
+ */
+static size_t get_array(struct spsc_ring_t *self_p,
+                        spsc_ring_index_t pos,
+                        size_t available,
+                        size_t size,
+                        int index,
+                        void **buf_pp)
+{
+    size_t offset;
+    size_t first_chunk_size;
+
+    offset = (pos & self_p->mask);
+    first_chunk_size = MIN(available, get_capacity(self_p) - offset);
+
+    if (index == 0) {
+        size = MIN(size, first_chunk_size);
+        *buf_pp = &self_p->buf_p[offset];
+    } else {
+        size = MIN(size, available - first_chunk_size);
+        *buf_pp = &self_p->buf_p[0];
+    }
+
+    return (size);
+}
+
+/**
+ * The second arrays are calculated from the index of the other side
+ * loaded when the first array was calculated, as the other side may
+ * have moved its index in between.
+ */
+static size_t get_write_array(struct spsc_ring_t *self_p,
+                              size_t size,
+                              int index,
+                              void **buf_pp)
+{
+    spsc_ring_index_t writepos;
+
+    if (index == 0) {
+        self_p->producer.readpos = LOAD_OTHER(&self_p->consumer.readpos);
+    }
+
+    writepos = LOAD_OWN(&self_p->producer.writepos);
+
+    return (get_array(self_p,
+                      writepos,
+                      (get_capacity(self_p)
+                       - get_used_size(writepos, self_p->producer.readpos)),
+                      size,
+                      index,
+                      buf_pp));
+}
+
+static size_t get_read_array(struct spsc_ring_t *self_p,
+                             size_t size,
+                             int index,
+                             void **buf_pp)
+{
+    spsc_ring_index_t readpos;
+
+    if (index == 0) {
+        self_p->consumer.writepos = LOAD_OTHER(&self_p->producer.writepos);
+    }
+
+    readpos = LOAD_OWN(&self_p->consumer.readpos);
+
+    return (get_array(self_p,
+                      readpos,
+                      get_used_size(self_p->consumer.writepos, readpos),
+                      size,
+                      index,
+                      buf_pp));
+}
+
+int spsc_ring_init(struct spsc_ring_t *self_p,
+                   void *buf_p,
+                   size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    /* The used size must be representable by the index type. */
+    if ((size == 0)
+        || ((size & (size - 1)) != 0)
+        || (size - 1 > (spsc_ring_index_t)-1 / 2)) {
+        return (-EINVAL);
+    }
+
+    self_p->buf_p = buf_p;
+    self_p->mask = (size - 1);
+    self_p->producer.writepos = 0;
+    self_p->producer.readpos = 0;
+    self_p->consumer.readpos = 0;
+    self_p->consumer.writepos = 0;
+
+    return (0);
+}
+
+ssize_t spsc_ring_write(struct spsc_ring_t *self_p,
+                        const void *buf_p,
+                        size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    size_t first_chunk_size;
+    size_t second_chunk_size;
+    void *array_p;
+
+    first_chunk_size = get_write_array(self_p, size, 0, &array_p);
+    memcpy(array_p, buf_p, first_chunk_size);
+    second_chunk_size = get_write_array(self_p,
+                                        size - first_chunk_size,
+                                        1,
+                                        &array_p);
+    memcpy(array_p,
+           &((const char *)buf_p)[first_chunk_size],
+           second_chunk_size);
+    size = (first_chunk_size + second_chunk_size);
+    spsc_ring_write_commit(self_p, size);
+
+    return (size);
+}
+
+ssize_t spsc_ring_read(struct spsc_ring_t *self_p,
+                       void *buf_p,
+                       size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    size_t first_chunk_size;
+    size_t second_chunk_size;
+    void *array_p;
+
+    first_chunk_size = get_read_array(self_p, size, 0, &array_p);
+    memcpy(buf_p, array_p, first_chunk_size);
+    second_chunk_size = get_read_array(self_p,
+                                       size - first_chunk_size,
+                                       1,
+                                       &array_p);
+    memcpy(&((char *)buf_p)[first_chunk_size],
+           array_p,
+           second_chunk_size);
+    size = (first_chunk_size + second_chunk_size);
+    spsc_ring_read_commit(self_p, size);
+
+    return (size);
+}
+
+ssize_t spsc_ring_used_size(struct spsc_ring_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    spsc_ring_index_t readpos;
+
+    readpos = LOAD_OTHER(&self_p->consumer.readpos);
+
+    return (get_used_size(LOAD_OTHER(&self_p->producer.writepos), readpos));
+}
+
+ssize_t spsc_ring_unused_size(struct spsc_ring_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (get_capacity(self_p) - spsc_ring_used_size(self_p));
+}
+
+ssize_t spsc_ring_write_array_one(struct spsc_ring_t *self_p,
+                                  void **buf_pp,
+                                  size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    return (get_write_array(self_p, size, 0, buf_pp));
+}
+
+ssize_t spsc_ring_write_array_two(struct spsc_ring_t *self_p,
+                                  void **buf_pp,
+                                  size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    return (get_write_array(self_p, size, 1, buf_pp));
+}
+
+int spsc_ring_write_commit(struct spsc_ring_t *self_p,
+                           size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    STORE(&self_p->producer.writepos,
+          LOAD_OWN(&self_p->producer.writepos) + size);
+
+    return (0);
+}
+
+ssize_t spsc_ring_read_array_one(struct spsc_ring_t *self_p,
+                                 void **buf_pp,
+                                 size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    return (get_read_array(self_p, size, 0, buf_pp));
+}
+
+ssize_t spsc_ring_read_array_two(struct spsc_ring_t *self_p,
+                                 void **buf_pp,
+                                 size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    return (get_read_array(self_p, size, 1, buf_pp));
+}
+
+int spsc_ring_read_commit(struct spsc_ring_t *self_p,
+                          size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    STORE(&self_p->consumer.readpos,
+          LOAD_OWN(&self_p->consumer.readpos) + size);
+
+    return (0);
+}
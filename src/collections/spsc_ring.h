@@ -0,0 +1,213 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __COLLECTIONS_SPSC_RING_H__
+#define __COLLECTIONS_SPSC_RING_H__
+
+#include "simba.h"
+
+/* The indices must be read and written atomically, which limits them
+   to the native word size on 8-bit architectures. */
+#if defined(ARCH_AVR)
+typedef uint8_t spsc_ring_index_t;
+#else
+typedef size_t spsc_ring_index_t;
+#endif
+
+/**
+ * Wait-free single producer, single consumer byte ring. The producer
+ * only writes the write index and the consumer only writes the read
+ * index, so one of them may be an interrupt service routine without
+ * taking the system lock.
+ */
+struct spsc_ring_t {
+    char *buf_p;
+    spsc_ring_index_t mask;
+    struct {
+        spsc_ring_index_t writepos;
+        /* Read index loaded by the last write_array_one() call. */
+        spsc_ring_index_t readpos;
+    } producer;
+    struct {
+        spsc_ring_index_t readpos;
+        /* Write index loaded by the last read_array_one() call. */
+        spsc_ring_index_t writepos;
+    } consumer;
+};
+
+/**
+ * Initialize given ring.
+ *
+ * @param[in] self_p Ring to initialize.
+ * @param[in] buf_p Memory buffer.
+ * @param[in] size Size of the memory buffer. Must be a power of two,
+ *                 and at most 128 bytes on AVR.
+ *
+ * @return zero(0) or negative error code.
+ */
+int spsc_ring_init(struct spsc_ring_t *self_p,
+                   void *buf_p,
+                   size_t size);
+
+/**
+ * Write data to given ring. Must only be called by the producer.
+ *
+ * @param[in] self_p Ring.
+ * @param[in] buf_p Memory buffer to write.
+ * @param[in] size Size of the memory buffer.
+ *
+ * @return Number of bytes written, which is less than size if the
+ *         ring is full, or negative error code.
+ */
+ssize_t spsc_ring_write(struct spsc_ring_t *self_p,
+                        const void *buf_p,
+                        size_t size);
+
+/**
+ * Read data from given ring. Must only be called by the consumer.
+ *
+ * @param[in] self_p Ring.
+ * @param[in] buf_p Memory buffer to read into.
+ * @param[in] size Size of the memory buffer.
+ *
+ * @return Number of bytes read or negative error code. The ring is
+ *         empty if zero(0) is returned.
+ */
+ssize_t spsc_ring_read(struct spsc_ring_t *self_p,
+                       void *buf_p,
+                       size_t size);
+
+/**
+ * Returns the number of used bytes in given ring.
+ *
+ * @param[in] self_p Ring.
+ *
+ * @return Number of used bytes or negative error code.
+ */
+ssize_t spsc_ring_used_size(struct spsc_ring_t *self_p);
+
+/**
+ * Returns the number of unused bytes in given ring.
+ *
+ * @param[in] self_p Ring.
+ *
+ * @return Number of unused bytes or negative error code.
+ */
+ssize_t spsc_ring_unused_size(struct spsc_ring_t *self_p);
+
+/**
+ * Get a pointer to the next unused byte in the ring. Use
+ * `spsc_ring_write_array_two()` to get the second array, if there is
+ * a wrap around. Must only be called by the producer.
+ *
+ * @param[in] self_p Ring.
+ * @param[out] buf_pp A pointer to the start of the array. Only valid
+ *                    if the return value is greater than zero(0).
+ * @param[in] size Number of bytes asked for.
+ *
+ * @return Number of bytes in array or negative error code.
+ */
+ssize_t spsc_ring_write_array_one(struct spsc_ring_t *self_p,
+                                  void **buf_pp,
+                                  size_t size);
+
+/**
+ * Get a pointer to the next unused byte in the ring, following a
+ * wrap around. Must only be called by the producer.
+ *
+ * @param[in] self_p Ring.
+ * @param[out] buf_pp A pointer to the start of the array. Only valid
+ *                    if the return value is greater than zero(0).
+ * @param[in] size Number of bytes asked for.
+ *
+ * @return Number of bytes in array or negative error code.
+ */
+ssize_t spsc_ring_write_array_two(struct spsc_ring_t *self_p,
+                                  void **buf_pp,
+                                  size_t size);
+
+/**
+ * Make given number of bytes written to the arrays returned by
+ * `spsc_ring_write_array_one()` and `spsc_ring_write_array_two()`
+ * available to the consumer. Must only be called by the producer.
+ *
+ * @param[in] self_p Ring.
+ * @param[in] size Number of written bytes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int spsc_ring_write_commit(struct spsc_ring_t *self_p,
+                           size_t size);
+
+/**
+ * Get a pointer to the next byte to read from the ring. Use
+ * `spsc_ring_read_array_two()` to get the second array, if there is
+ * a wrap around. Must only be called by the consumer.
+ *
+ * @param[in] self_p Ring.
+ * @param[out] buf_pp A pointer to the start of the array. Only valid
+ *                    if the return value is greater than zero(0).
+ * @param[in] size Number of bytes asked for.
+ *
+ * @return Number of bytes in array or negative error code.
+ */
+ssize_t spsc_ring_read_array_one(struct spsc_ring_t *self_p,
+                                 void **buf_pp,
+                                 size_t size);
+
+/**
+ * Get a pointer to the next byte to read from the ring, following a
+ * wrap around. Must only be called by the consumer.
+ *
+ * @param[in] self_p Ring.
+ * @param[out] buf_pp A pointer to the start of the array. Only valid
+ *                    if the return value is greater than zero(0).
+ * @param[in] size Number of bytes asked for.
+ *
+ * @return Number of bytes in array or negative error code.
+ */
+ssize_t spsc_ring_read_array_two(struct spsc_ring_t *self_p,
+                                 void **buf_pp,
+                                 size_t size);
+
+/**
+ * Release given number of bytes read from the arrays returned by
+ * `spsc_ring_read_array_one()` and `spsc_ring_read_array_two()` to
+ * the producer. Must only be called by the consumer.
+ *
+ * @param[in] self_p Ring.
+ * @param[in] size Number of read bytes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int spsc_ring_read_commit(struct spsc_ring_t *self_p,
+                          size_t size);
+
+#endif
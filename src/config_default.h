@@ -715,6 +715,16 @@
 #    endif
 #endif
 
+/**
+ * Use a lock-free single producer, single consumer queue for received
+ * data. The receive interrupt only takes the system lock to resume a
+ * reader waiting for data. The receive buffer size given to
+ * `uart_init()` must be a power of two.
+ */
+#ifndef CONFIG_UART_RX_SPSC
+#    define CONFIG_UART_RX_SPSC                             0
+#endif
+
 /**
  * Enable the uart_soft driver.
  */
@@ -1455,6 +1465,71 @@
 #    endif
 #endif
 
+/**
+ * Format and write log entries in a separate thread. Log entries are
+ * written in binary form to a buffer, which is much faster than
+ * formatting them in the calling thread.
+ */
+#ifndef CONFIG_LOG_ASYNC
+#    define CONFIG_LOG_ASYNC                                0
+#endif
+
+/**
+ * Asynchronous log buffer size in bytes. Must be a power of two if
+ * ``CONFIG_LOG_ASYNC_LOCK_FREE`` is enabled.
+ */
+#ifndef CONFIG_LOG_ASYNC_BUFFER_SIZE
+#    define CONFIG_LOG_ASYNC_BUFFER_SIZE                    1024
+#endif
+
+/**
+ * Reserve and publish asynchronous log records with atomic
+ * operations instead of in short system lock critical sections. A
+ * writer only takes the system lock to wake the log thread when it
+ * is waiting. Requires lock-free compare-and-swap of pointer sized
+ * integers.
+ */
+#ifndef CONFIG_LOG_ASYNC_LOCK_FREE
+#    if defined(ARCH_AVR) || (__GCC_ATOMIC_POINTER_LOCK_FREE != 2)
+#        define CONFIG_LOG_ASYNC_LOCK_FREE                  0
+#    else
+#        define CONFIG_LOG_ASYNC_LOCK_FREE                  1
+#    endif
+#endif
+
+/**
+ * Maximum size in bytes of a log entry in the asynchronous log
+ * buffer, including string arguments.
+ */
+#ifndef CONFIG_LOG_ASYNC_RECORD_SIZE_MAX
+#    define CONFIG_LOG_ASYNC_RECORD_SIZE_MAX                128
+#endif
+
+/**
+ * Maximum length of a formatted asynchronous log entry.
+ */
+#ifndef CONFIG_LOG_ASYNC_LINE_SIZE_MAX
+#    define CONFIG_LOG_ASYNC_LINE_SIZE_MAX                  256
+#endif
+
+/**
+ * Asynchronous log thread stack size.
+ */
+#ifndef CONFIG_LOG_ASYNC_STACK_SIZE
+#    if defined(ARCH_ESP32) || defined(ARCH_LINUX)
+#        define CONFIG_LOG_ASYNC_STACK_SIZE                 4096
+#    else
+#        define CONFIG_LOG_ASYNC_STACK_SIZE                 1536
+#    endif
+#endif
+
+/**
+ * Asynchronous log thread priority.
+ */
+#ifndef CONFIG_LOG_ASYNC_PRIO
+#    define CONFIG_LOG_ASYNC_PRIO                           60
+#endif
+
 /**
  * Debug file system command to list all network interfaces.
  */
@@ -1722,6 +1797,51 @@
 #    endif
 #endif
 
+/**
+ * Maximum number of QoS 1 and QoS 2 messages the MQTT client may
+ * have in flight at the same time, in each direction.
+ */
+#ifndef CONFIG_MQTT_CLIENT_INFLIGHT_MAX
+#    if defined(ARCH_AVR)
+#        define CONFIG_MQTT_CLIENT_INFLIGHT_MAX                 2
+#    else
+#        define CONFIG_MQTT_CLIENT_INFLIGHT_MAX                 4
+#    endif
+#endif
+
+/**
+ * Size of the MQTT client transmit buffer and of each in-flight
+ * packet buffer. Larger packets are written in chunks, and QoS 1 and
+ * QoS 2 publish calls of larger packets block until the packet is
+ * acknowledged.
+ */
+#ifndef CONFIG_MQTT_CLIENT_PACKET_SIZE_MAX
+#    if defined(ARCH_AVR)
+#        define CONFIG_MQTT_CLIENT_PACKET_SIZE_MAX             32
+#    else
+#        define CONFIG_MQTT_CLIENT_PACKET_SIZE_MAX            128
+#    endif
+#endif
+
+/**
+ * Time in milliseconds the MQTT client waits for an acknowledgement
+ * before an in-flight packet is retransmitted.
+ */
+#ifndef CONFIG_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS
+#    define CONFIG_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS        10000
+#endif
+
+/**
+ * Size of the MQTT client receive topic buffer, including the null
+ * termination. Received messages with longer topics are acknowledged
+ * and discarded. The buffer is allocated on the client thread
+ * stack. Use ``mqtt_client_set_topic_buffer()`` to receive longer
+ * topics.
+ */
+#ifndef CONFIG_MQTT_CLIENT_TOPIC_SIZE_MAX
+#    define CONFIG_MQTT_CLIENT_TOPIC_SIZE_MAX               128
+#endif
+
 /**
  * Start the monitor thread to gather statistics of the scheulder.
  */
@@ -1807,6 +1927,19 @@
 #    define CONFIG_SHELL_PROMPT "$ "
 #endif
 
+/**
+ * Size of the buffer used to encode SLIP frames on the stack. Frames
+ * that fit in it after escaping are written to the output channel
+ * in a single write.
+ */
+#ifndef CONFIG_SLIP_OUTPUT_BUFFER_SIZE
+#    if defined(ARCH_LINUX)
+#        define CONFIG_SLIP_OUTPUT_BUFFER_SIZE              512
+#    else
+#        define CONFIG_SLIP_OUTPUT_BUFFER_SIZE              64
+#    endif
+#endif
+
 /**
  * Raw socket support.
  */
@@ -1839,6 +1972,44 @@
 #    endif
 #endif
 
+/**
+ * Initialize the fat16 module at system startup.
+ */
+#ifndef CONFIG_MODULE_INIT_FAT16
+#    if CONFIG_FAT16 == 1
+#        define CONFIG_MODULE_INIT_FAT16                    1
+#    else
+#        define CONFIG_MODULE_INIT_FAT16                    0
+#    endif
+#endif
+
+/**
+ * Number of blocks in the FAT16 block cache. Each block uses 512
+ * bytes of RAM. Modified blocks are written to the device when
+ * replaced, and on file sync and unmount.
+ */
+#ifndef CONFIG_FAT16_CACHE_BLOCKS
+#    if defined(ARCH_AVR)
+#        define CONFIG_FAT16_CACHE_BLOCKS                   1
+#    else
+#        define CONFIG_FAT16_CACHE_BLOCKS                   4
+#    endif
+#endif
+
+/**
+ * Number of blocks in the FAT16 block cache reserved for FAT
+ * blocks. FAT blocks and other blocks only replace blocks of their
+ * own kind, so file data does not push the FAT out of the
+ * cache. Zero(0) to share all blocks.
+ */
+#ifndef CONFIG_FAT16_CACHE_FAT_BLOCKS
+#    if CONFIG_FAT16_CACHE_BLOCKS > 1
+#        define CONFIG_FAT16_CACHE_FAT_BLOCKS               1
+#    else
+#        define CONFIG_FAT16_CACHE_FAT_BLOCKS               0
+#    endif
+#endif
+
 /**
  * Generic file system.
  */
@@ -2184,6 +2355,31 @@
 #    define CONFIG_STD_OUTPUT_BUFFER_MAX                   16
 #endif
 
+/**
+ * Cache parsed format strings of the print functions, keyed by the
+ * format string address. Only enable if format strings are never
+ * changed once used, which is true for string literals and `FSTR()`
+ * and `OSTR()` strings, but not for format strings in buffers.
+ */
+#ifndef CONFIG_STD_FORMAT_CACHE
+#    define CONFIG_STD_FORMAT_CACHE                         0
+#endif
+
+/**
+ * Number of entries in the format string cache.
+ */
+#ifndef CONFIG_STD_FORMAT_CACHE_ENTRIES
+#    define CONFIG_STD_FORMAT_CACHE_ENTRIES                16
+#endif
+
+/**
+ * Maximum number of conversion specifications in a cached format
+ * string.
+ */
+#ifndef CONFIG_STD_FORMAT_CACHE_DIRECTIVES_MAX
+#    define CONFIG_STD_FORMAT_CACHE_DIRECTIVES_MAX          8
+#endif
+
 /**
  * Use floating point numbers instead of intergers where applicable.
  */
@@ -2206,6 +2402,53 @@
 #    endif
 #endif
 
+/**
+ * Number of per-thread caches of fixed size buffers in each heap. A
+ * thread allocates and frees fixed size buffers from its own cache
+ * without taking the heap mutex. Zero(0) to disable.
+ */
+#ifndef CONFIG_HEAP_MAGAZINES
+#    if defined(ARCH_AVR)
+#        define CONFIG_HEAP_MAGAZINES                       0
+#    else
+#        define CONFIG_HEAP_MAGAZINES                       4
+#    endif
+#endif
+
+/**
+ * Maximum number of buffers of each fixed size in a per-thread
+ * heap cache. Half of it is moved to or from the shared pool at a
+ * time.
+ */
+#ifndef CONFIG_HEAP_MAGAZINE_SIZE
+#    define CONFIG_HEAP_MAGAZINE_SIZE                       8
+#endif
+
+/**
+ * Pop and push buffers in per-thread heap caches with atomic
+ * operations instead of in short system lock critical
+ * sections. Requires lock-free compare-and-swap of pointer sized
+ * integers.
+ */
+#ifndef CONFIG_HEAP_MAGAZINES_LOCK_FREE
+#    if defined(ARCH_AVR) || (__GCC_ATOMIC_POINTER_LOCK_FREE != 2)
+#        define CONFIG_HEAP_MAGAZINES_LOCK_FREE             0
+#    else
+#        define CONFIG_HEAP_MAGAZINES_LOCK_FREE             1
+#    endif
+#endif
+
+/**
+ * Debug file system command to print heap statistics.
+ */
+#ifndef CONFIG_HEAP_FS_COMMAND_STATS
+#    if defined(BOARD_ARDUINO_NANO) || defined(BOARD_ARDUINO_UNO) || defined(BOARD_ARDUINO_PRO_MICRO) || defined(CONFIG_MINIMAL_SYSTEM)
+#        define CONFIG_HEAP_FS_COMMAND_STATS                0
+#    else
+#        define CONFIG_HEAP_FS_COMMAND_STATS                1
+#    endif
+#endif
+
 /**
  * System tick frequency in Hertz.
  */
@@ -2213,6 +2456,15 @@
 #    define CONFIG_SYSTEM_TICK_FREQUENCY                  100
 #endif
 
+/**
+ * Stop the periodic system tick when the system is idle, and program
+ * the next tick from the first timer to expire instead. Elapsed ticks
+ * are processed when the system wakes up. Only supported on Linux.
+ */
+#ifndef CONFIG_SYSTEM_TICKLESS
+#    define CONFIG_SYSTEM_TICKLESS                          0
+#endif
+
 /**
  * Use interrupts.
  */
@@ -2300,6 +2552,33 @@
 #    endif
 #endif
 
+/**
+ * Support priority inheritance in mutexes initialized with
+ * `MUTEX_PRIORITY_INHERITANCE`.
+ */
+#ifndef CONFIG_MUTEX_PRIORITY_INHERITANCE
+#    if defined(ARCH_AVR)
+#        define CONFIG_MUTEX_PRIORITY_INHERITANCE           0
+#    else
+#        define CONFIG_MUTEX_PRIORITY_INHERITANCE           1
+#    endif
+#endif
+
+/**
+ * Use a bitmap indexed ready queue in the scheduler, with one FIFO
+ * per thread priority. Push, pop and remove are constant time, at
+ * the cost of one pointer per priority level in RAM. Set to 0 to use
+ * the sorted linked list instead, which is linear in the number of
+ * ready threads.
+ */
+#ifndef CONFIG_THRD_READY_QUEUE_BITMAP
+#    if defined(ARCH_AVR)
+#        define CONFIG_THRD_READY_QUEUE_BITMAP              0
+#    else
+#        define CONFIG_THRD_READY_QUEUE_BITMAP              1
+#    endif
+#endif
+
 /**
  * Count the number of times each thread has been scheduled.
  */
@@ -2336,6 +2615,21 @@
 #    endif
 #endif
 
+/**
+ * Record scheduler events in a ring, and the run, ready and suspended
+ * times of each thread. See `thrd_trace_start()`.
+ */
+#ifndef CONFIG_THRD_TRACE
+#    define CONFIG_THRD_TRACE                               0
+#endif
+
+/**
+ * Number of events in the scheduler trace ring.
+ */
+#ifndef CONFIG_THRD_TRACE_EVENTS_MAX
+#    define CONFIG_THRD_TRACE_EVENTS_MAX                  128
+#endif
+
 /**
  * USB device vendor id.
  */
@@ -2465,13 +2759,56 @@
 #endif
 
 /**
- * Size of the HTTP server request buffer. This buffer is used when
- * parsing received HTTP request headers.
+ * Size of the HTTP server per connection receive buffer. Received
+ * HTTP request headers are parsed in place in this buffer, so it is
+ * also the maximum length of the request line and of each header
+ * line.
  */
 #ifndef CONFIG_HTTP_SERVER_REQUEST_BUFFER_SIZE
 #    define CONFIG_HTTP_SERVER_REQUEST_BUFFER_SIZE        128
 #endif
 
+/**
+ * Close a HTTP server connection if no request has been received
+ * within this many milliseconds. Idle persistent connections would
+ * otherwise occupy a connection thread until the client closes them.
+ */
+#ifndef CONFIG_HTTP_SERVER_IDLE_TIMEOUT_MS
+#    define CONFIG_HTTP_SERVER_IDLE_TIMEOUT_MS          10000
+#endif
+
+/**
+ * Maximum number of requests handled on a persistent HTTP server
+ * connection before it is closed.
+ */
+#ifndef CONFIG_HTTP_SERVER_KEEP_ALIVE_REQUESTS_MAX
+#    define CONFIG_HTTP_SERVER_KEEP_ALIVE_REQUESTS_MAX    100
+#endif
+
+/**
+ * Maximum number of unread request body bytes the HTTP server
+ * discards to keep a persistent connection open. The connection is
+ * closed instead if the route callback left more of the body unread.
+ */
+#ifndef CONFIG_HTTP_SERVER_BODY_DISCARD_SIZE_MAX
+#    define CONFIG_HTTP_SERVER_BODY_DISCARD_SIZE_MAX     1024
+#endif
+
+/**
+ * Maximum number of nodes in the HTTP server route trie. Each unique
+ * route path segment is a node, plus one for the root.
+ */
+#ifndef CONFIG_HTTP_SERVER_ROUTE_NODES_MAX
+#    define CONFIG_HTTP_SERVER_ROUTE_NODES_MAX             64
+#endif
+
+/**
+ * Maximum number of path parameters in a HTTP server route.
+ */
+#ifndef CONFIG_HTTP_SERVER_ROUTE_PARAMS_MAX
+#    define CONFIG_HTTP_SERVER_ROUTE_PARAMS_MAX             4
+#endif
+
 /**
  * Use lookup tables for CRC calculations. It is faster, but uses more
  * memory.
@@ -2480,6 +2817,38 @@
 #    define CONFIG_CRC_TABLE_LOOKUP                         1
 #endif
 
+/**
+ * Calculate CRC-32 and CCITT CRCs eight bytes at a time using
+ * additional lookup tables, requires `CONFIG_CRC_TABLE_LOOKUP`. It is
+ * about four times faster than one byte at a time, but the tables
+ * use another 10.5 kB of memory.
+ */
+#ifndef CONFIG_CRC_SLICE_BY_8
+#    if defined(ARCH_LINUX)
+#        define CONFIG_CRC_SLICE_BY_8                       1
+#    else
+#        define CONFIG_CRC_SLICE_BY_8                       0
+#    endif
+#endif
+
+/**
+ * Use the SHA extensions for SHA1 hashing, and AVX2 for
+ * `sha1_update_multi()`, when supported by the CPU. Only used on
+ * x86-64 Linux.
+ */
+#ifndef CONFIG_SHA1_SIMD
+#    define CONFIG_SHA1_SIMD                                1
+#endif
+
+/**
+ * Maximum number of buffers hashed in parallel by
+ * `sha1_update_multi()`. More buffers are hashed in batches of this
+ * size.
+ */
+#ifndef CONFIG_SHA1_MULTI_LANES_MAX
+#    define CONFIG_SHA1_MULTI_LANES_MAX                     8
+#endif
+
 /**
  */
 #ifndef CONFIG_SPC5_BOOT_ENTRY_RCHW
@@ -2504,6 +2873,20 @@
 #    define CONFIG_SPC5_WATCHDOG_DISABLE                    1
 #endif
 
+/**
+ * Keep system tick timers in a hierarchical timing wheel instead of
+ * a sorted delta list. Starting and stopping a timer is constant
+ * time and the work per tick is bounded, at the cost of 256 list
+ * heads in RAM. Preferred when many timers are active.
+ */
+#ifndef CONFIG_TIMER_WHEEL
+#    if defined(ARCH_LINUX)
+#        define CONFIG_TIMER_WHEEL                          1
+#    else
+#        define CONFIG_TIMER_WHEEL                          0
+#    endif
+#endif
+
 /**
  * Include the function time_unix_time_to_date().
  */
@@ -31,15 +31,90 @@
 #include "simba.h"
 #include <stdarg.h>
 
+#if CONFIG_LOG_ASYNC == 1
+
+#if defined(FAR_SPECIAL_ADDRESS)
+#    error "Asynchronous logging is not supported on this architecture."
+#endif
+
+#define RECORD_STATE_RESERVED                               0
+#define RECORD_STATE_COMMITTED                              1
+#define RECORD_STATE_PADDING                                2
+
+/* Record and argument alignment. */
+#define ALIGN(size) (((size) + sizeof(union arg_t) - 1)         \
+                     & ~(sizeof(union arg_t) - 1))
+
+/**
+ * A log entry in binary form. The format string arguments follows
+ * the header. Numbers are stored in an argument union each, and
+ * strings are copied as they may not outlive the call.
+ */
+struct record_t {
+    uint16_t size;
+    uint8_t state;
+    uint8_t level;
+    struct time_t now;
+    const char *thrd_name_p;
+    const char *name_p;
+    const char *fmt_p;
+};
+
+union arg_t {
+    int i;
+    long l;
+    const char *s_p;
+#if CONFIG_FLOAT == 1
+    double f;
+#endif
+};
+
+#endif
+
 struct module_t {
     int8_t initialized;
     struct log_handler_t handler;
     struct log_object_t object;
     struct mutex_t mutex;
+#if CONFIG_LOG_ASYNC == 1
+    struct {
+#if CONFIG_LOG_ASYNC_LOCK_FREE == 1
+        /* Free running byte positions. Producers reserve records by
+           advancing head with compare-and-swap, and publish each
+           record by storing its position in its mark. The log thread,
+           and producers dropping the oldest records, consume them by
+           advancing tail the same way. */
+        size_t head;
+        size_t tail;
+        int data_waiting;
+        int space_waiting;
+        int flush_waiting;
+        size_t marks[CONFIG_LOG_ASYNC_BUFFER_SIZE / sizeof(union arg_t)];
+#else
+        /* Producers reserve records at head and the drain thread
+           consumes them at tail. The indexes are only updated with
+           the system lock taken, but records are written and read
+           outside of it. */
+        size_t head;
+        size_t tail;
+        size_t used;
+#endif
+        int formatting;
+        int policy;
+        struct sem_t data_sem;
+        struct sem_t space_sem;
+        struct sem_t flush_sem;
+        struct log_async_stats_t stats;
+        union arg_t buf[CONFIG_LOG_ASYNC_BUFFER_SIZE / sizeof(union arg_t)];
+    } async;
+#endif
 #if CONFIG_LOG_FS_COMMANDS == 1
     struct fs_command_t cmd_print;
     struct fs_command_t cmd_list;
     struct fs_command_t cmd_set_log_mask;
+#    if CONFIG_LOG_ASYNC == 1
+    struct fs_command_t cmd_async_stats;
+#    endif
 #endif
 };
 
@@ -61,6 +136,10 @@ static const char FAR *level_as_string[] = {
 /* The module state. */
 static struct module_t module;
 
+#if CONFIG_LOG_ASYNC == 1
+static THRD_STACK(async_stack, CONFIG_LOG_ASYNC_STACK_SIZE);
+#endif
+
 #if CONFIG_LOG_FS_COMMANDS == 1
 
 /**
@@ -179,6 +258,955 @@ static int cmd_set_log_mask_cb(int argc,
     return (0);
 }
 
+#    if CONFIG_LOG_ASYNC == 1
+
+/**
+ * The shell command callback for "/debug/log/async/stats".
+ */
+static int cmd_async_stats_cb(int argc,
+                              const char *argv[],
+                              void *out_p,
+                              void *in_p,
+                              void *arg_p,
+                              void *call_arg_p)
+{
+    struct log_async_stats_t stats;
+
+    log_async_get_stats(&stats);
+
+    std_fprintf(out_p,
+                OSTR("records: %lu\r\n"
+                     "dropped_newest: %lu\r\n"
+                     "dropped_oldest: %lu\r\n"
+                     "blocked: %lu\r\n"
+                     "truncated: %lu\r\n"),
+                (unsigned long)stats.records,
+                (unsigned long)stats.dropped_newest,
+                (unsigned long)stats.dropped_oldest,
+                (unsigned long)stats.blocked,
+                (unsigned long)stats.truncated);
+
+    return (0);
+}
+
+#    endif
+
+#endif
+
+#if CONFIG_LOG_ASYNC == 1
+
+static struct record_t *record_at(size_t offset)
+{
+    return ((struct record_t *)((char *)&module.async.buf[0] + offset));
+}
+
+#if CONFIG_LOG_ASYNC_LOCK_FREE == 1
+
+#if (CONFIG_LOG_ASYNC_BUFFER_SIZE & (CONFIG_LOG_ASYNC_BUFFER_SIZE - 1)) != 0
+#    error "The asynchronous log buffer size must be a power of two."
+#endif
+
+#define LOAD(value_p) __atomic_load_n(value_p, __ATOMIC_ACQUIRE)
+#define STORE(value_p, value) __atomic_store_n(value_p, value, __ATOMIC_RELEASE)
+#define CAS(value_p, expected_p, desired)                               \
+    __atomic_compare_exchange_n(value_p,                                \
+                                expected_p,                             \
+                                desired,                                \
+                                0,                                      \
+                                __ATOMIC_ACQ_REL,                       \
+                                __ATOMIC_ACQUIRE)
+#define INCREMENT(value_p, value)                               \
+    __atomic_fetch_add(value_p, value, __ATOMIC_RELAXED)
+#define FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define OFFSET(position) ((position) % sizeof(module.async.buf))
+#define MARK(position)                                                  \
+    module.async.marks[OFFSET(position) / sizeof(union arg_t)]
+
+/**
+ * Returns true(1) if the record at given position is committed,
+ * otherwise false(0). A mark holds the position of the last record
+ * committed at its offset, so marks of earlier laps never match.
+ */
+static int async_is_committed(size_t position)
+{
+    return (LOAD(&MARK(position)) == position);
+}
+
+/**
+ * Move tail past given record, unless another thread already did.
+ *
+ * @return true(1) if tail was moved by this call, otherwise false(0).
+ */
+static int async_free(size_t tail, size_t size)
+{
+    if (CAS(&module.async.tail, &tail, tail + size) == 0) {
+        return (0);
+    }
+
+    /* Wake blocked writers. */
+    FENCE();
+
+    if (LOAD(&module.async.space_waiting) > 0) {
+        sem_give(&module.async.space_sem, 1);
+    }
+
+    return (1);
+}
+
+/**
+ * Drop the record at given tail position to make room for a new
+ * record.
+ *
+ * @return true(1) if the tail moved, otherwise false(0).
+ */
+static int async_drop_oldest(size_t tail)
+{
+    struct record_t *record_p;
+    uint8_t state;
+
+    /* A record being written cannot be dropped. */
+    if (async_is_committed(tail) == 0) {
+        return (0);
+    }
+
+    record_p = record_at(OFFSET(tail));
+    state = record_p->state;
+
+    if (async_free(tail, record_p->size) == 1) {
+        if (state != RECORD_STATE_PADDING) {
+            INCREMENT(&module.async.stats.dropped_oldest, 1);
+        }
+    }
+
+    return (1);
+}
+
+/**
+ * Reserve a record of given size in the ring. The record is
+ * contiguous, so a padding record is inserted if it does not fit
+ * before the end of the buffer.
+ */
+static struct record_t *async_reserve(size_t size, size_t *position_p)
+{
+    struct record_t *record_p;
+    size_t head;
+    size_t tail;
+    size_t padding;
+    int blocked;
+
+    blocked = 0;
+    head = LOAD(&module.async.head);
+
+    while (1) {
+        tail = LOAD(&module.async.tail);
+
+        if (OFFSET(head) + size > sizeof(module.async.buf)) {
+            padding = (sizeof(module.async.buf) - OFFSET(head));
+        } else {
+            padding = 0;
+        }
+
+        if (head + padding + size - tail <= sizeof(module.async.buf)) {
+            if (CAS(&module.async.head, &head, head + padding + size) == 1) {
+                break;
+            }
+
+            continue;
+        }
+
+        if (module.async.policy == LOG_OVERFLOW_POLICY_DROP_OLDEST) {
+            if (async_drop_oldest(tail) == 1) {
+                head = LOAD(&module.async.head);
+                continue;
+            }
+        }
+
+        if (module.async.policy != LOG_OVERFLOW_POLICY_BLOCK) {
+            INCREMENT(&module.async.stats.dropped_newest, 1);
+
+            return (NULL);
+        }
+
+        /* Tell the log thread to wake this writer, and check for room
+           once more before waiting. */
+        if (blocked == 0) {
+            INCREMENT(&module.async.stats.blocked, 1);
+            INCREMENT(&module.async.space_waiting, 1);
+            FENCE();
+            blocked = 1;
+        } else {
+            sem_take(&module.async.space_sem, NULL);
+        }
+
+        head = LOAD(&module.async.head);
+    }
+
+    if (blocked == 1) {
+        /* Let the next blocked writer check for room. */
+        if (__atomic_sub_fetch(&module.async.space_waiting,
+                               1,
+                               __ATOMIC_SEQ_CST) > 0) {
+            sem_give(&module.async.space_sem, 1);
+        }
+    }
+
+    if (padding > 0) {
+        record_p = record_at(OFFSET(head));
+        record_p->size = padding;
+        record_p->state = RECORD_STATE_PADDING;
+        STORE(&MARK(head), head);
+        head += padding;
+    }
+
+    *position_p = head;
+
+    return (record_at(OFFSET(head)));
+}
+
+/**
+ * Publish the record at given position to the log thread.
+ */
+static void async_commit(size_t position, int truncated)
+{
+    INCREMENT(&module.async.stats.records, 1);
+    INCREMENT(&module.async.stats.truncated, truncated);
+    STORE(&MARK(position), position);
+
+    /* Only wake the log thread if it is waiting, as it takes the
+       system lock. */
+    FENCE();
+
+    if (__atomic_exchange_n(&module.async.data_waiting,
+                            0,
+                            __ATOMIC_SEQ_CST) == 1) {
+        sem_give(&module.async.data_sem, 1);
+    }
+}
+
+/**
+ * Copy the oldest committed record from the ring and free its space.
+ *
+ * @return true(1) if a record was read, otherwise false(0).
+ */
+static int async_read(union arg_t *buf_p)
+{
+    struct record_t *record_p;
+    size_t tail;
+    size_t size;
+    size_t length;
+    size_t offset;
+    uint8_t state;
+
+    while (1) {
+        tail = LOAD(&module.async.tail);
+
+        if (tail == LOAD(&module.async.head)) {
+            STORE(&module.async.formatting, 0);
+            FENCE();
+
+            if (__atomic_exchange_n(&module.async.flush_waiting,
+                                    0,
+                                    __ATOMIC_SEQ_CST) == 1) {
+                sem_give(&module.async.flush_sem, 1);
+            }
+
+            return (0);
+        }
+
+        /* Wait for the writer to commit it. */
+        if (async_is_committed(tail) == 0) {
+            return (0);
+        }
+
+        offset = OFFSET(tail);
+        record_p = record_at(offset);
+        size = record_p->size;
+        state = record_p->state;
+        STORE(&module.async.formatting, 1);
+
+        /* Copy the record before freeing it. A writer may drop it
+           meanwhile, and then the copy is discarded. The size is
+           only garbage in that case, but must still be bounded. */
+        if (state != RECORD_STATE_PADDING) {
+            length = size;
+
+            if (length > CONFIG_LOG_ASYNC_RECORD_SIZE_MAX) {
+                length = CONFIG_LOG_ASYNC_RECORD_SIZE_MAX;
+            }
+
+            if (length > sizeof(module.async.buf) - offset) {
+                length = (sizeof(module.async.buf) - offset);
+            }
+
+            memcpy(buf_p, record_p, length);
+        }
+
+        if (async_free(tail, size) == 0) {
+            continue;
+        }
+
+        if (state == RECORD_STATE_PADDING) {
+            continue;
+        }
+
+        return (1);
+    }
+}
+
+static int async_is_readable(void)
+{
+    size_t tail;
+
+    tail = LOAD(&module.async.tail);
+
+    return ((tail != LOAD(&module.async.head))
+            && (async_is_committed(tail) == 1));
+}
+
+/**
+ * Wait for the next record to be committed.
+ */
+static void async_wait(void)
+{
+    __atomic_store_n(&module.async.data_waiting, 1, __ATOMIC_SEQ_CST);
+
+    if (async_is_readable() == 0) {
+        sem_take(&module.async.data_sem, NULL);
+    }
+}
+
+/**
+ * Wait until all records are formatted and written.
+ */
+static void async_flush(void)
+{
+    while (1) {
+        __atomic_store_n(&module.async.flush_waiting, 1, __ATOMIC_SEQ_CST);
+
+        if ((LOAD(&module.async.tail) == LOAD(&module.async.head))
+            && (LOAD(&module.async.formatting) == 0)) {
+            break;
+        }
+
+        sem_take(&module.async.flush_sem, NULL);
+    }
+}
+
+static void async_get_stats(struct log_async_stats_t *stats_p)
+{
+    stats_p->records = LOAD(&module.async.stats.records);
+    stats_p->dropped_newest = LOAD(&module.async.stats.dropped_newest);
+    stats_p->dropped_oldest = LOAD(&module.async.stats.dropped_oldest);
+    stats_p->blocked = LOAD(&module.async.stats.blocked);
+    stats_p->truncated = LOAD(&module.async.stats.truncated);
+}
+
+#else
+
+/**
+ * Drop the record at tail to make room for a new record. Called with
+ * the system lock taken.
+ *
+ * @return true(1) if a record was dropped, otherwise false(0).
+ */
+static int async_drop_oldest_isr(void)
+{
+    struct record_t *record_p;
+
+    record_p = record_at(module.async.tail);
+
+    /* A record being written cannot be dropped. */
+    if (record_p->state == RECORD_STATE_RESERVED) {
+        return (0);
+    }
+
+    if (record_p->state == RECORD_STATE_COMMITTED) {
+        module.async.stats.dropped_oldest++;
+    }
+
+    module.async.tail += record_p->size;
+    module.async.used -= record_p->size;
+
+    if (module.async.tail == sizeof(module.async.buf)) {
+        module.async.tail = 0;
+    }
+
+    return (1);
+}
+
+/**
+ * Reserve a record of given size in the ring. The record is
+ * contiguous, so a padding record is inserted if it does not fit
+ * before the end of the buffer.
+ */
+static struct record_t *async_reserve(size_t size, size_t *position_p)
+{
+    struct record_t *record_p;
+    size_t padding;
+    int blocked;
+
+    blocked = 0;
+
+    while (1) {
+        sys_lock();
+
+        while (1) {
+            /* Start over at the beginning of the buffer when empty to
+               avoid padding. */
+            if (module.async.used == 0) {
+                module.async.head = 0;
+                module.async.tail = 0;
+            }
+
+            if (module.async.head + size > sizeof(module.async.buf)) {
+                padding = (sizeof(module.async.buf) - module.async.head);
+            } else {
+                padding = 0;
+            }
+
+            if (module.async.used + padding + size <= sizeof(module.async.buf)) {
+                goto reserve;
+            }
+
+            if (module.async.policy != LOG_OVERFLOW_POLICY_DROP_OLDEST) {
+                break;
+            }
+
+            if (async_drop_oldest_isr() == 0) {
+                break;
+            }
+        }
+
+        if (module.async.policy != LOG_OVERFLOW_POLICY_BLOCK) {
+            module.async.stats.dropped_newest++;
+            sys_unlock();
+
+            return (NULL);
+        }
+
+        if (blocked == 0) {
+            module.async.stats.blocked++;
+            blocked = 1;
+        }
+
+        sys_unlock();
+
+        /* Wait for the log thread to free some space. */
+        sem_take(&module.async.space_sem, NULL);
+    }
+
+ reserve:
+    if (padding > 0) {
+        record_p = record_at(module.async.head);
+        record_p->size = padding;
+        record_p->state = RECORD_STATE_PADDING;
+        module.async.head = 0;
+        module.async.used += padding;
+    }
+
+    *position_p = module.async.head;
+    record_p = record_at(module.async.head);
+    record_p->size = size;
+    record_p->state = RECORD_STATE_RESERVED;
+    module.async.head += size;
+    module.async.used += size;
+
+    if (module.async.head == sizeof(module.async.buf)) {
+        module.async.head = 0;
+    }
+
+    /* Let the next blocked writer check for space. */
+    if (blocked == 1) {
+        sem_give_isr(&module.async.space_sem, 1);
+    }
+
+    sys_unlock();
+
+    return (record_p);
+}
+
+/**
+ * Publish the record at given position to the log thread.
+ */
+static void async_commit(size_t position, int truncated)
+{
+    sys_lock();
+    record_at(position)->state = RECORD_STATE_COMMITTED;
+    module.async.stats.records++;
+    module.async.stats.truncated += truncated;
+    sem_give_isr(&module.async.data_sem, 1);
+    sys_unlock();
+}
+
+/**
+ * Copy the oldest committed record from the ring and free its space.
+ *
+ * @return true(1) if a record was read, otherwise false(0).
+ */
+static int async_read(union arg_t *buf_p)
+{
+    struct record_t *record_p;
+    uint32_t dropped_oldest;
+    size_t size;
+
+    while (1) {
+        sys_lock();
+
+        if (module.async.used == 0) {
+            module.async.formatting = 0;
+            sem_give_isr(&module.async.flush_sem, 1);
+            sys_unlock();
+
+            return (0);
+        }
+
+        record_p = record_at(module.async.tail);
+        size = record_p->size;
+
+        if (record_p->state == RECORD_STATE_RESERVED) {
+            /* Wait for the writer to commit it. */
+            sys_unlock();
+
+            return (0);
+        }
+
+        if (record_p->state == RECORD_STATE_PADDING) {
+            module.async.tail = 0;
+            module.async.used -= size;
+            sys_unlock();
+            continue;
+        }
+
+        module.async.formatting = 1;
+        dropped_oldest = module.async.stats.dropped_oldest;
+        sys_unlock();
+
+        /* Copy the record without the lock. A writer may drop it
+           meanwhile, and then the copy is discarded. */
+        memcpy(buf_p, record_p, size);
+
+        sys_lock();
+
+        if (module.async.stats.dropped_oldest != dropped_oldest) {
+            sys_unlock();
+            continue;
+        }
+
+        module.async.tail += size;
+        module.async.used -= size;
+
+        if (module.async.tail == sizeof(module.async.buf)) {
+            module.async.tail = 0;
+        }
+
+        sem_give_isr(&module.async.space_sem, 1);
+        sys_unlock();
+
+        return (1);
+    }
+}
+
+/**
+ * Wait for the next record to be committed.
+ */
+static void async_wait(void)
+{
+    sem_take(&module.async.data_sem, NULL);
+}
+
+/**
+ * Wait until all records are formatted and written.
+ */
+static void async_flush(void)
+{
+    while (1) {
+        sys_lock();
+
+        if ((module.async.used == 0) && (module.async.formatting == 0)) {
+            sys_unlock();
+            break;
+        }
+
+        sys_unlock();
+        sem_take(&module.async.flush_sem, NULL);
+    }
+}
+
+static void async_get_stats(struct log_async_stats_t *stats_p)
+{
+    sys_lock();
+    *stats_p = module.async.stats;
+    sys_unlock();
+}
+
+#endif
+
+/**
+ * Write given log entry as a record to the ring.
+ *
+ * @return true(1) if the record was written, false(0) if it was
+ *         dropped.
+ */
+static int async_write(int level,
+                       const char *name_p,
+                       const char *fmt_p,
+                       va_list *ap_p)
+{
+    union arg_t buf[CONFIG_LOG_ASYNC_RECORD_SIZE_MAX / sizeof(union arg_t)];
+    struct record_t *header_p;
+    struct record_t *record_p;
+    size_t position;
+    const char *f_p;
+    const char *s_p;
+    char *dst_p;
+    size_t size;
+    size_t left;
+    size_t length;
+    char c;
+    char long_length;
+    int truncated;
+
+    truncated = 0;
+    header_p = (struct record_t *)&buf[0];
+    header_p->level = level;
+    header_p->thrd_name_p = thrd_get_name();
+    header_p->name_p = name_p;
+    header_p->fmt_p = fmt_p;
+    time_get(&header_p->now);
+    size = ALIGN(sizeof(*header_p));
+    f_p = fmt_p;
+
+    /* Save the arguments, parsing the format string like
+       std_vfprintf() does. */
+    while ((c = *f_p++) != '\0') {
+        if (c != '%') {
+            continue;
+        }
+
+        c = *f_p++;
+
+        if ((c == '0') || (c == '-')) {
+            c = *f_p++;
+        }
+
+        while ((c >= '0') && (c <= '9')) {
+            c = *f_p++;
+        }
+
+        long_length = 0;
+
+        if (c == 'l') {
+            long_length = 1;
+            c = *f_p++;
+        }
+
+        if (c == '\0') {
+            break;
+        }
+
+        left = (sizeof(buf) - size);
+
+        switch (c) {
+
+        case 'S':
+        case 's':
+            s_p = va_arg(*ap_p, const char *);
+
+            if (s_p == NULL) {
+                s_p = "(null)";
+            }
+
+            if (left < sizeof(union arg_t)) {
+                goto truncated;
+            }
+
+            length = strlen(s_p);
+
+            if (length >= left) {
+                length = (left - 1);
+                truncated = 1;
+            }
+
+            dst_p = ((char *)&buf[0] + size);
+            memcpy(dst_p, s_p, length);
+            dst_p[length] = '\0';
+            size += ALIGN(length + 1);
+            break;
+
+        case 'c':
+        case 'i':
+        case 'd':
+        case 'u':
+        case 'x':
+            if (left < sizeof(union arg_t)) {
+                goto truncated;
+            }
+
+            if (long_length == 0) {
+                ((union arg_t *)((char *)&buf[0] + size))->i = va_arg(*ap_p, int);
+            } else {
+                ((union arg_t *)((char *)&buf[0] + size))->l = va_arg(*ap_p, long);
+            }
+
+            size += sizeof(union arg_t);
+            break;
+
+#if CONFIG_FLOAT == 1
+        case 'f':
+            if (left < sizeof(union arg_t)) {
+                goto truncated;
+            }
+
+            ((union arg_t *)((char *)&buf[0] + size))->f = va_arg(*ap_p, double);
+            size += sizeof(union arg_t);
+            break;
+#endif
+
+        default:
+            break;
+        }
+    }
+
+    goto write;
+
+ truncated:
+    /* Arguments that did not fit are left out when formatting. */
+    truncated = 1;
+
+ write:
+    header_p->size = size;
+    record_p = async_reserve(size, &position);
+
+    if (record_p == NULL) {
+        return (0);
+    }
+
+    header_p->state = RECORD_STATE_RESERVED;
+    memcpy(record_p, header_p, size);
+    async_commit(position, truncated);
+
+    return (1);
+}
+
+/**
+ * Format given record into given buffer.
+ *
+ * @return Formatted length.
+ */
+static size_t async_format(struct record_t *record_p,
+                           char *line_p,
+                           size_t size)
+{
+    const char *fmt_p;
+    const char *arg_p;
+    const char *end_p;
+    char spec[16];
+    size_t length;
+    size_t offset;
+    ssize_t res;
+    char c;
+    char long_length;
+
+    res = std_snprintf(line_p,
+                       size,
+                       FSTR("%lu.%03lu:%S:%s:%s: "),
+                       record_p->now.seconds,
+                       record_p->now.nanoseconds / 1000000ul,
+                       level_as_string[record_p->level],
+                       record_p->thrd_name_p,
+                       record_p->name_p);
+
+    if (res < 0) {
+        return (size - 1);
+    }
+
+    offset = res;
+    fmt_p = record_p->fmt_p;
+    arg_p = ((const char *)record_p + ALIGN(sizeof(*record_p)));
+    end_p = ((const char *)record_p + record_p->size);
+
+    while ((c = *fmt_p) != '\0') {
+        if (offset == size - 1) {
+            break;
+        }
+
+        if (c != '%') {
+            line_p[offset++] = c;
+            fmt_p++;
+            continue;
+        }
+
+        /* Copy the conversion specification and format its argument
+           with it. */
+        length = 0;
+        spec[length++] = *fmt_p++;
+        c = *fmt_p++;
+
+        if ((c == '0') || (c == '-')) {
+            spec[length++] = c;
+            c = *fmt_p++;
+        }
+
+        while ((c >= '0') && (c <= '9')) {
+            if (length < sizeof(spec) - 3) {
+                spec[length++] = c;
+            }
+
+            c = *fmt_p++;
+        }
+
+        long_length = 0;
+
+        if (c == 'l') {
+            spec[length++] = c;
+            long_length = 1;
+            c = *fmt_p++;
+        }
+
+        if (c == '\0') {
+            break;
+        }
+
+        spec[length++] = c;
+        spec[length] = '\0';
+
+        switch (c) {
+
+        case 'S':
+        case 's':
+            spec[length - 1] = 's';
+
+            if (arg_p >= end_p) {
+                arg_p = "";
+            }
+
+            res = std_snprintf(&line_p[offset], size - offset, spec, arg_p);
+            arg_p += ALIGN(strlen(arg_p) + 1);
+            break;
+
+        case 'c':
+        case 'i':
+        case 'd':
+        case 'u':
+        case 'x':
+            if (arg_p >= end_p) {
+                res = 0;
+            } else if (long_length == 0) {
+                res = std_snprintf(&line_p[offset],
+                                   size - offset,
+                                   spec,
+                                   ((const union arg_t *)arg_p)->i);
+            } else {
+                res = std_snprintf(&line_p[offset],
+                                   size - offset,
+                                   spec,
+                                   ((const union arg_t *)arg_p)->l);
+            }
+
+            arg_p += sizeof(union arg_t);
+            break;
+
+#if CONFIG_FLOAT == 1
+        case 'f':
+            if (arg_p >= end_p) {
+                res = 0;
+            } else {
+                res = std_snprintf(&line_p[offset],
+                                   size - offset,
+                                   spec,
+                                   ((const union arg_t *)arg_p)->f);
+            }
+
+            arg_p += sizeof(union arg_t);
+            break;
+#endif
+
+        default:
+            line_p[offset] = c;
+            res = 1;
+            break;
+        }
+
+        if (res < 0) {
+            return (size - 1);
+        }
+
+        offset += res;
+    }
+
+    return (offset);
+}
+
+/**
+ * The log thread formats each record once and writes it to all
+ * handlers.
+ */
+static void *async_main(void *arg_p)
+{
+    union arg_t buf[CONFIG_LOG_ASYNC_RECORD_SIZE_MAX / sizeof(union arg_t)];
+    char line[CONFIG_LOG_ASYNC_LINE_SIZE_MAX];
+    struct log_handler_t *handler_p;
+    size_t size;
+
+    thrd_set_name("log");
+
+    while (1) {
+        async_wait();
+
+        while (async_read(&buf[0]) == 1) {
+            size = async_format((struct record_t *)&buf[0],
+                                &line[0],
+                                sizeof(line));
+
+            mutex_lock(&module.mutex);
+
+            handler_p = &module.handler;
+
+            while (handler_p != NULL) {
+                if (handler_p->chout_p != NULL) {
+                    chan_control(handler_p->chout_p, CHAN_CONTROL_LOG_BEGIN);
+                    chan_write(handler_p->chout_p, &line[0], size);
+                    chan_control(handler_p->chout_p, CHAN_CONTROL_LOG_END);
+                }
+
+                handler_p = handler_p->next_p;
+            }
+
+            mutex_unlock(&module.mutex);
+        }
+    }
+
+    return (NULL);
+}
+
+static void async_init(void)
+{
+    module.async.head = 0;
+    module.async.tail = 0;
+#if CONFIG_LOG_ASYNC_LOCK_FREE == 1
+    module.async.data_waiting = 0;
+    module.async.space_waiting = 0;
+    module.async.flush_waiting = 0;
+    memset(&module.async.marks[0], -1, sizeof(module.async.marks));
+#else
+    module.async.used = 0;
+#endif
+    module.async.formatting = 0;
+    module.async.policy = LOG_OVERFLOW_POLICY_DROP_NEWEST;
+    memset(&module.async.stats, 0, sizeof(module.async.stats));
+    sem_init(&module.async.data_sem, 1, 1);
+    sem_init(&module.async.space_sem, 1, 1);
+    sem_init(&module.async.flush_sem, 1, 1);
+
+    thrd_module_init();
+    thrd_spawn(async_main,
+               NULL,
+               CONFIG_LOG_ASYNC_PRIO,
+               async_stack,
+               sizeof(async_stack));
+}
+
 #endif
 
 int log_module_init()
@@ -199,6 +1227,10 @@ int log_module_init()
     module.object.mask = LOG_UPTO(INFO);
     module.object.next_p = NULL;
 
+#if CONFIG_LOG_ASYNC == 1
+    async_init();
+#endif
+
 #if CONFIG_LOG_FS_COMMANDS == 1
     fs_command_init(&module.cmd_print,
                     CSTR("/debug/log/print"),
@@ -217,6 +1249,14 @@ int log_module_init()
                     cmd_set_log_mask_cb,
                     NULL);
     fs_command_register(&module.cmd_set_log_mask);
+
+#    if CONFIG_LOG_ASYNC == 1
+    fs_command_init(&module.cmd_async_stats,
+                    CSTR("/debug/log/async/stats"),
+                    cmd_async_stats_cb,
+                    NULL);
+    fs_command_register(&module.cmd_async_stats);
+#    endif
 #endif
 
     return (0);
@@ -372,11 +1412,15 @@ int log_object_print(struct log_object_t *self_p,
     ASSERTN(fmt_p != NULL, EINVAL);
 
     va_list ap;
-    struct time_t now;
     struct log_handler_t *handler_p;
-    void *chout_p;
     int count;
     const char *name_p;
+#if CONFIG_LOG_ASYNC == 1
+    int res;
+#else
+    struct time_t now;
+    void *chout_p;
+#endif
 
     /* Level filtering. */
     if (self_p == NULL) {
@@ -394,6 +1438,29 @@ int log_object_print(struct log_object_t *self_p,
         name_p = self_p->name_p;
     }
 
+#if CONFIG_LOG_ASYNC == 1
+    /* Write a record for the drain thread to format, and return the
+       number of handlers it will be written to. */
+    va_start(ap, fmt_p);
+    res = async_write(level, name_p, fmt_p, &ap);
+    va_end(ap);
+
+    count = 0;
+
+    if (res == 1) {
+        handler_p = &module.handler;
+
+        while (handler_p != NULL) {
+            if (handler_p->chout_p != NULL) {
+                count++;
+            }
+
+            handler_p = handler_p->next_p;
+        }
+    }
+
+    return (count);
+#else
     /* Print the formatted log entry to all handlers. */
     count = 0;
     handler_p = &module.handler;
@@ -433,4 +1500,36 @@ int log_object_print(struct log_object_t *self_p,
     mutex_unlock(&module.mutex);
 
     return (count);
+#endif
 }
+
+#if CONFIG_LOG_ASYNC == 1
+
+int log_async_set_overflow_policy(int policy)
+{
+    ASSERTN((policy == LOG_OVERFLOW_POLICY_DROP_NEWEST)
+            || (policy == LOG_OVERFLOW_POLICY_DROP_OLDEST)
+            || (policy == LOG_OVERFLOW_POLICY_BLOCK), EINVAL);
+
+    module.async.policy = policy;
+
+    return (0);
+}
+
+int log_async_flush(void)
+{
+    async_flush();
+
+    return (0);
+}
+
+int log_async_get_stats(struct log_async_stats_t *stats_p)
+{
+    ASSERTN(stats_p != NULL, EINVAL);
+
+    async_get_stats(stats_p);
+
+    return (0);
+}
+
+#endif
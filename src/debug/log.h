@@ -58,6 +58,18 @@
 /** Clear all levels. */
 #define LOG_NONE        0x00
 
+/** Discard the entry being written if the asynchronous log buffer
+    is full. */
+#define LOG_OVERFLOW_POLICY_DROP_NEWEST                     0
+
+/** Discard the oldest entries in the asynchronous log buffer to make
+    room for the entry being written. */
+#define LOG_OVERFLOW_POLICY_DROP_OLDEST                     1
+
+/** Wait for the log thread to make room in the asynchronous log
+    buffer. */
+#define LOG_OVERFLOW_POLICY_BLOCK                           2
+
 struct log_handler_t {
     void *chout_p;
     struct log_handler_t *next_p;
@@ -69,6 +81,23 @@ struct log_object_t {
     struct log_object_t *next_p;
 };
 
+/**
+ * Asynchronous logging statistics.
+ */
+struct log_async_stats_t {
+    /** Number of entries written to the buffer. */
+    uint32_t records;
+    /** Number of entries discarded as the buffer was full. */
+    uint32_t dropped_newest;
+    /** Number of buffered entries discarded to make room for new
+        entries. */
+    uint32_t dropped_oldest;
+    /** Number of times a writer waited for room in the buffer. */
+    uint32_t blocked;
+    /** Number of entries with truncated arguments. */
+    uint32_t truncated;
+};
+
 /**
  * Initialize the logging module. This function must be called before
  * calling any other function in this module.
@@ -133,12 +162,18 @@ int log_object_is_enabled_for(struct log_object_t *self_p,
  * ``self_p`` may be NULL, and in that case the current thread's log
  * mask is used instead of the log object mask.
  *
+ * If ``CONFIG_LOG_ASYNC`` is enabled the format string and its
+ * arguments are written to a buffer, and the log thread formats the
+ * entry once and writes it to all log handlers. The format string
+ * must then be valid until the entry has been written.
+ *
  * @param[in] self_p Log object, or NULL to use the thread's log mask.
  * @param[in] level Log level.
  * @param[in] fmt_p Log format string.
  * @param[in] ... Variable argument list.
  *
- * @return zero(0) or negative error code.
+ * @return Number of log handlers the entry is written to, or
+ *         negative error code.
  */
 int log_object_print(struct log_object_t *self_p,
                      int level,
@@ -206,4 +241,36 @@ int log_remove_object(struct log_object_t *object_p);
  */
 int log_set_default_handler_output_channel(void *chout_p);
 
+#if CONFIG_LOG_ASYNC == 1
+
+/**
+ * Set what to do when the asynchronous log buffer is full. The
+ * default policy is ``LOG_OVERFLOW_POLICY_DROP_NEWEST``.
+ *
+ * @param[in] policy One of ``LOG_OVERFLOW_POLICY_DROP_NEWEST``,
+ *                   ``LOG_OVERFLOW_POLICY_DROP_OLDEST`` and
+ *                   ``LOG_OVERFLOW_POLICY_BLOCK``.
+ *
+ * @return zero(0) or negative error code.
+ */
+int log_async_set_overflow_policy(int policy);
+
+/**
+ * Wait for all buffered entries to be written to the log handlers.
+ *
+ * @return zero(0) or negative error code.
+ */
+int log_async_flush(void);
+
+/**
+ * Get asynchronous logging statistics.
+ *
+ * @param[out] stats_p Read statistics.
+ *
+ * @return zero(0) or negative error code.
+ */
+int log_async_get_stats(struct log_async_stats_t *stats_p);
+
+#endif
+
 #endif
@@ -68,7 +68,13 @@ int uart_init(struct uart_driver_t *self_p,
     mutex_init(&self_p->mutex);
 
     /* The base channel is used for both TX and RX. */
+#if CONFIG_UART_RX_SPSC == 1
+    if (queue_init_spsc(&self_p->base, rxbuf_p, size) != 0) {
+        return (-EINVAL);
+    }
+#else
     queue_init(&self_p->base, rxbuf_p, size);
+#endif
     chan_set_write_cb(&self_p->base.base, uart_port_write_cb);
     chan_set_write_isr_cb(&self_p->base.base, uart_port_write_cb_isr);
 
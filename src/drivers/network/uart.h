@@ -104,7 +104,8 @@ int uart_module_init(void);
  * @param[in] dev_p Device to use.
  * @param[in] baudrate Baudrate.
  * @param[in] rxbuf_p Reception buffer.
- * @param[in] size Reception buffer size.
+ * @param[in] size Reception buffer size. Must be a power of two if
+ *                 `CONFIG_UART_RX_SPSC` is enabled.
  *
  * @return zero(0) or negative error code.
  */
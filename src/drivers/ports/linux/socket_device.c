@@ -136,6 +136,9 @@ static void *uart_client_main(void *arg_p)
     struct uart_client_t *client_p;
     ssize_t size;
     uint8_t byte;
+#if CONFIG_UART_RX_SPSC == 1
+    struct uart_driver_t *drv_p;
+#endif
 
     client_p = arg_p;
 
@@ -150,6 +153,13 @@ static void *uart_client_main(void *arg_p)
             break;
         }
 
+#if CONFIG_UART_RX_SPSC == 1
+        drv_p = client_p->dev_p->drv_p;
+
+        if (drv_p != NULL) {
+            queue_write_spsc_isr(&drv_p->base, &byte, sizeof(byte));
+        }
+#else
         sys_lock();
 
         if (client_p->dev_p->drv_p != NULL) {
@@ -159,6 +169,7 @@ static void *uart_client_main(void *arg_p)
         }
 
         sys_unlock();
+#endif
     }
 
     close(client_p->socket);
@@ -119,7 +119,7 @@ struct command_t {
     uint8_t index;
     uint32_t arg;
     uint8_t crc;
-};
+} PACKED;
 
 /** Internal timeout periods. */
 #define WRITE_TIMEOUT      2000
@@ -183,17 +183,15 @@ static int wait_not_busy(struct sd_driver_t *self_p,
 }
 
 /**
- * Send command index with given argument to SD card.
+ * Send command index with given argument to SD card without waiting
+ * for the card to be idle.
  */
-static int command_write(struct sd_driver_t *self_p,
-                         uint8_t index,
-                         uint32_t arg)
+static int command_send(struct sd_driver_t *self_p,
+                        uint8_t index,
+                        uint32_t arg)
 {
     struct command_t command;
 
-    /* Wait for the card to be idle. */
-    wait_not_busy(self_p, 300);
-
     /* Initiate the command. */
     command.index = (0x40 | index);
     command.arg = htonl(arg);
@@ -209,19 +207,25 @@ static int command_write(struct sd_driver_t *self_p,
 }
 
 /**
- * Send command index with given argument to SD card and wait for the
- * response a response with only the idle bit set.
+ * Send command index with given argument to SD card.
  */
-static int command_call(struct sd_driver_t *self_p,
-                        uint8_t index,
-                        uint32_t arg,
-                        uint8_t *response_p)
+static int command_write(struct sd_driver_t *self_p,
+                         uint8_t index,
+                         uint32_t arg)
 {
-    int i;
+    /* Wait for the card to be idle. */
+    wait_not_busy(self_p, 300);
 
-    if (command_write(self_p, index, arg) != 0) {
-        return (-1);
-    }
+    return (command_send(self_p, index, arg));
+}
+
+/**
+ * Wait for a command response.
+ */
+static int wait_for_response(struct sd_driver_t *self_p,
+                             uint8_t *response_p)
+{
+    int i;
 
     /* Wait for the response. If bit 7 is one(1) the slave did not
        answer. */
@@ -242,6 +246,22 @@ static int command_call(struct sd_driver_t *self_p,
     return (-1);
 }
 
+/**
+ * Send command index with given argument to SD card and wait for the
+ * response a response with only the idle bit set.
+ */
+static int command_call(struct sd_driver_t *self_p,
+                        uint8_t index,
+                        uint32_t arg,
+                        uint8_t *response_p)
+{
+    if (command_write(self_p, index, arg) != 0) {
+        return (-1);
+    }
+
+    return (wait_for_response(self_p, response_p));
+}
+
 static int command_check_call(struct sd_driver_t *self_p,
                               uint8_t index,
                               uint32_t arg,
@@ -279,30 +299,18 @@ static uint8_t application_command_call(struct sd_driver_t *self_p,
 }
 
 /**
- * Read from the SD card.
+ * Read a data block, that is, the data start token, the data and its
+ * checksum.
  */
-static ssize_t read(struct sd_driver_t *self_p,
-                    uint8_t index,
-                    uint32_t arg,
-                    void *dst_p,
-                    size_t size)
+static ssize_t read_data_block(struct sd_driver_t *self_p,
+                               void *dst_p,
+                               size_t size)
 {
     uint16_t real_crc, expected_crc;
-    ssize_t res;
-
-    spi_take_bus(self_p->spi_p);
-    spi_select(self_p->spi_p);
-
-    /* Issue read command. */
-    if (command_check_call(self_p, index, arg, 0) != 0) {
-        res = -SD_ERR_READ_COMMAND;
-        goto out;
-    }
 
     /* Receive the data block start token. */
     if (wait_for_data_start_block(self_p) != 0) {
-        res = -SD_ERR_READ_DATA_START_BLOCK;
-        goto out;
+        return (-SD_ERR_READ_DATA_START_BLOCK);
     }
 
     /* Receive the data and it's checksum. */
@@ -314,11 +322,33 @@ static ssize_t read(struct sd_driver_t *self_p,
     expected_crc = ntohs(expected_crc);
 
     if (real_crc != expected_crc) {
-        res = -SD_ERR_READ_WRONG_DATA_CRC;
+        return (-SD_ERR_READ_WRONG_DATA_CRC);
+    }
+
+    return (size);
+}
+
+/**
+ * Read from the SD card.
+ */
+static ssize_t read(struct sd_driver_t *self_p,
+                    uint8_t index,
+                    uint32_t arg,
+                    void *dst_p,
+                    size_t size)
+{
+    ssize_t res;
+
+    spi_take_bus(self_p->spi_p);
+    spi_select(self_p->spi_p);
+
+    /* Issue read command. */
+    if (command_check_call(self_p, index, arg, 0) != 0) {
+        res = -SD_ERR_READ_COMMAND;
         goto out;
     }
 
-    res = size;
+    res = read_data_block(self_p, dst_p, size);
 
  out:
     spi_deselect(self_p->spi_p);
@@ -327,6 +357,33 @@ static ssize_t read(struct sd_driver_t *self_p,
     return (res);
 }
 
+/**
+ * Stop an ongoing multiple block read.
+ */
+static int stop_transmission(struct sd_driver_t *self_p)
+{
+    uint8_t response;
+
+    /* The card is sending data, so the command is sent without
+       waiting for it to become idle. */
+    if (command_send(self_p, CMD_STOP_TRANSMISSION, 0) != 0) {
+        return (-1);
+    }
+
+    /* Discard the stuff byte following the command. */
+    spi_get(self_p->spi_p, &response);
+
+    if (wait_for_response(self_p, &response) != 0) {
+        return (-1);
+    }
+
+    if (response != 0) {
+        return (-1);
+    }
+
+    return (wait_not_busy(self_p, WRITE_TIMEOUT));
+}
+
 int sd_init(struct sd_driver_t *self_p,
             struct spi_driver_t *spi_p)
 {
@@ -596,4 +653,175 @@ ssize_t sd_write_block(struct sd_driver_t *self_p,
     return (res);
 }
 
+ssize_t sd_read_blocks(struct sd_driver_t *self_p,
+                       void *dst_p,
+                       uint32_t src_block,
+                       size_t count)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(dst_p != NULL, EINVAL);
+    ASSERTN(count > 0, EINVAL);
+
+    ssize_t res;
+    uint8_t *u8dst_p;
+    size_t i;
+
+    /* A single block read does not need the stop command. */
+    if (count == 1) {
+        return (sd_read_block(self_p, dst_p, src_block));
+    }
+
+    if (self_p->type != TYPE_SDHC) {
+        src_block <<= 9;
+    }
+
+    res = -1;
+    u8dst_p = dst_p;
+
+    spi_take_bus(self_p->spi_p);
+    spi_select(self_p->spi_p);
+
+    /* The card sends blocks until the read is stopped. */
+    if (command_check_call(self_p,
+                           CMD_READ_MULTIPLE_BLOCK,
+                           src_block,
+                           0) != 0) {
+        res = -SD_ERR_READ_COMMAND;
+        goto out;
+    }
+
+    for (i = 0; i < count; i++) {
+        res = read_data_block(self_p, u8dst_p, SD_BLOCK_SIZE);
+
+        if (res < 0) {
+            break;
+        }
+
+        u8dst_p += SD_BLOCK_SIZE;
+    }
+
+    if (stop_transmission(self_p) != 0) {
+        if (res >= 0) {
+            res = -SD_ERR_STOP_TRANSMISSION;
+        }
+    } else if (res >= 0) {
+        res = (count * SD_BLOCK_SIZE);
+    }
+
+ out:
+    spi_deselect(self_p->spi_p);
+    spi_give_bus(self_p->spi_p);
+
+    return (res);
+}
+
+ssize_t sd_write_blocks(struct sd_driver_t *self_p,
+                        uint32_t dst_block,
+                        const void *src_p,
+                        size_t count)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(src_p != NULL, EINVAL);
+    ASSERTN(count > 0, EINVAL);
+
+    ssize_t res;
+    uint16_t crc;
+    uint8_t response;
+    const uint8_t *u8src_p;
+    size_t i;
+
+    if (count == 1) {
+        return (sd_write_block(self_p, dst_block, src_p));
+    }
+
+    if (self_p->type != TYPE_SDHC) {
+        dst_block <<= 9;
+    }
+
+    u8src_p = src_p;
+    crc = htons(crc_xmodem(0, u8src_p, SD_BLOCK_SIZE));
+
+    spi_take_bus(self_p->spi_p);
+    spi_select(self_p->spi_p);
+
+    /* Tell the card how many blocks will be written so it can erase
+       them in advance. It is only a hint, so errors are ignored. */
+    if (command_check_call(self_p, CMD_APP_CMD, 0, 0) == 0) {
+        (void)command_check_call(self_p,
+                                 ACMD_SET_WR_BLK_ERASE_COUNT,
+                                 count,
+                                 0);
+    }
+
+    if (command_check_call(self_p,
+                           CMD_WRITE_MULTIPLE_BLOCK,
+                           dst_block,
+                           0) != 0) {
+        res = -SD_ERR_WRITE_BLOCK;
+        goto out;
+    }
+
+    res = (count * SD_BLOCK_SIZE);
+
+    for (i = 0; i < count; i++) {
+        spi_put(self_p->spi_p, TOKEN_WRITE_MULTIPLE_TOKEN);
+        spi_write(self_p->spi_p, u8src_p, SD_BLOCK_SIZE);
+        spi_write(self_p->spi_p, &crc, sizeof(crc));
+
+        spi_get(self_p->spi_p, &response);
+
+        if ((response & TOKEN_DATA_RES_MASK) != TOKEN_DATA_RES_ACCEPTED) {
+            res = -SD_ERR_WRITE_BLOCK_TOKEN_DATA_RES_ACCEPTED;
+            break;
+        }
+
+        u8src_p += SD_BLOCK_SIZE;
+
+        /* Calculate the checksum of the next block while the card
+           is programming the previous one. */
+        if (i < count - 1) {
+            crc = htons(crc_xmodem(0, u8src_p, SD_BLOCK_SIZE));
+        }
+
+        if (wait_not_busy(self_p, WRITE_TIMEOUT) != 0) {
+            res = -SD_ERR_WRITE_BLOCK_WAIT_NOT_BUSY;
+            break;
+        }
+    }
+
+    /* Stop the transmission and discard the byte preceding the busy
+       signal. */
+    spi_put(self_p->spi_p, TOKEN_STOP_TRAN_TOKEN);
+    spi_get(self_p->spi_p, &response);
+
+    if (wait_not_busy(self_p, WRITE_TIMEOUT) != 0) {
+        if (res >= 0) {
+            res = -SD_ERR_WRITE_BLOCK_WAIT_NOT_BUSY;
+        }
+
+        goto out;
+    }
+
+    if (res < 0) {
+        goto out;
+    }
+
+    if (command_check_call(self_p, CMD_SEND_STATUS, 0, 0) != 0) {
+        res = -SD_ERR_WRITE_BLOCK_SEND_STATUS;
+        goto out;
+    }
+
+    spi_get(self_p->spi_p, &response);
+
+    if (response != 0) {
+        res = -SD_ERR_WRITE_BLOCK_SEND_STATUS;
+    }
+
+ out:
+    spi_deselect(self_p->spi_p);
+    spi_give_bus(self_p->spi_p);
+
+    return (res);
+}
+
 #endif
@@ -58,6 +58,24 @@
 
 #include "simba.h"
 
+/* Streaming parser states. */
+#define STREAM_STATE_ROOT                                   0
+#define STREAM_STATE_VALUE                                  1
+#define STREAM_STATE_VALUE_OR_END                           2
+#define STREAM_STATE_KEY                                    3
+#define STREAM_STATE_KEY_OR_END                             4
+#define STREAM_STATE_COLON                                  5
+#define STREAM_STATE_NEXT                                   6
+#define STREAM_STATE_STRING                                 7
+#define STREAM_STATE_KEY_STRING                             8
+#define STREAM_STATE_PRIMITIVE                              9
+#define STREAM_STATE_KEY_PRIMITIVE                         10
+
+/* Streaming parser character results. */
+#define STREAM_CONSUMED                                     0
+#define STREAM_NOT_CONSUMED                                 1
+#define STREAM_COMPLETE                                     2
+
 struct dump_t {
     struct json_t *self_p;
     struct json_tok_t *tokens_p;
@@ -102,6 +120,7 @@ static struct json_tok_t *alloc_token(struct json_t *self_p)
     tok_p->buf_p = NULL;
     tok_p->size = -1;
     tok_p->num_tokens = 0;
+    tok_p->span = 0;
 #ifdef JSON_PARENT_LINKS
     tok_p->parent = -1;
 #endif
@@ -489,17 +508,47 @@ static int get_number_of_children(struct json_tok_t *token_p)
     return (number_of_children);
 }
 
+/**
+ * Set the subtree span of all parsed tokens. Children are stored
+ * after their parent, so the spans are calculated backwards in one
+ * pass.
+ */
+static void set_spans(struct json_t *self_p)
+{
+    int i;
+    int j;
+    struct json_tok_t *token_p;
+
+    for (i = self_p->toknext - 1; i >= 0; i--) {
+        token_p = &self_p->tokens_p[i];
+        token_p->span = 1;
+
+        for (j = 0; j < token_p->num_tokens; j++) {
+            token_p->span += token_p[token_p->span].span;
+        }
+    }
+}
+
+/**
+ * Get the token after given token and its children.
+ */
+static struct json_tok_t *next_sibling(struct json_tok_t *token_p)
+{
+    /* Tokens not created by the parser have no span. */
+    if (token_p->span == 0) {
+        return (token_p + get_number_of_children(token_p) + 1);
+    }
+
+    return (token_p + token_p->span);
+}
+
 static struct json_tok_t *object_get(struct json_t *self_p,
                                      const char *key_p,
+                                     size_t key_length,
                                      struct json_tok_t *object_p,
                                      int type)
 {
-    ASSERTNRN(self_p != NULL, EINVAL);
-    ASSERTNRN(key_p != NULL, EINVAL);
-
     int i;
-    int key_length;
-    int number_of_children;
     struct json_tok_t *token_p;
 
     /* Return immediatly if no object is found. */
@@ -512,22 +561,18 @@ static struct json_tok_t *object_get(struct json_t *self_p,
         return (NULL);
     }
 
-    key_length = strlen(key_p);
-
     /* The first child token. */
     token_p = (object_p + 1);
 
     /* Find given key in the object. */
     for (i = 0; i < object_p->num_tokens; i++) {
-        if (token_p->type == type) {
-            if (strncmp(key_p, token_p->buf_p, key_length) == 0) {
+        if ((token_p->type == type) && (token_p->size == key_length)) {
+            if (memcmp(key_p, token_p->buf_p, key_length) == 0) {
                 return (token_p + 1);
             }
         }
 
-        /* Get the next child token. */
-        number_of_children = get_number_of_children(token_p);
-        token_p += (number_of_children + 1);
+        token_p = next_sibling(token_p);
     }
 
     return (NULL);
@@ -772,6 +817,8 @@ int json_parse(struct json_t *self_p,
                 return (JSON_ERROR_PART);
             }
         }
+
+        set_spans(self_p);
     }
 
     return (count);
@@ -835,14 +882,24 @@ struct json_tok_t *json_object_get(struct json_t *self_p,
                                    const char *key_p,
                                    struct json_tok_t *object_p)
 {
-    return (object_get(self_p, key_p, object_p, JSON_STRING));
+    ASSERTNRN(self_p != NULL, EINVAL);
+    ASSERTNRN(key_p != NULL, EINVAL);
+
+    return (object_get(self_p, key_p, strlen(key_p), object_p, JSON_STRING));
 }
 
 struct json_tok_t *json_object_get_primitive(struct json_t *self_p,
                                              const char *key_p,
                                              struct json_tok_t *object_p)
 {
-    return (object_get(self_p, key_p, object_p, JSON_PRIMITIVE));
+    ASSERTNRN(self_p != NULL, EINVAL);
+    ASSERTNRN(key_p != NULL, EINVAL);
+
+    return (object_get(self_p,
+                       key_p,
+                       strlen(key_p),
+                       object_p,
+                       JSON_PRIMITIVE));
 }
 
 struct json_tok_t *json_array_get(struct json_t *self_p,
@@ -853,7 +910,6 @@ struct json_tok_t *json_array_get(struct json_t *self_p,
     ASSERTNRN(index >= 0, EINVAL);
 
     int i;
-    int number_of_children;
     struct json_tok_t *token_p;
 
     /* Return immediatly if no array is found. */
@@ -875,14 +931,67 @@ struct json_tok_t *json_array_get(struct json_t *self_p,
             return (token_p);
         }
 
-        /* Get the next child token. */
-        number_of_children = get_number_of_children(token_p);
-        token_p += (number_of_children + 1);
+        token_p = next_sibling(token_p);
     }
 
     return (NULL);
 }
 
+struct json_tok_t *json_get_path(struct json_t *self_p,
+                                 const char *path_p)
+{
+    ASSERTNRN(self_p != NULL, EINVAL);
+    ASSERTNRN(path_p != NULL, EINVAL);
+
+    struct json_tok_t *token_p;
+    const char *key_p;
+    long index;
+
+    token_p = json_root(self_p);
+
+    while ((*path_p != '\0') && (token_p != NULL)) {
+        if (*path_p == '[') {
+            /* Array index. */
+            path_p = std_strtolb(path_p + 1, &index, 10);
+
+            if ((path_p == NULL) || (*path_p != ']') || (index < 0)) {
+                return (NULL);
+            }
+
+            path_p++;
+            token_p = json_array_get(self_p, index, token_p);
+        } else {
+            /* Object key, separated by a dot from the previous
+               key or index. */
+            if (*path_p == '.') {
+                path_p++;
+            } else if (token_p != json_root(self_p)) {
+                return (NULL);
+            }
+
+            key_p = path_p;
+
+            while ((*path_p != '\0')
+                   && (*path_p != '.')
+                   && (*path_p != '[')) {
+                path_p++;
+            }
+
+            if (path_p == key_p) {
+                return (NULL);
+            }
+
+            token_p = object_get(self_p,
+                                 key_p,
+                                 path_p - key_p,
+                                 token_p,
+                                 JSON_STRING);
+        }
+    }
+
+    return (token_p);
+}
+
 void json_token_object(struct json_tok_t *token_p,
                        int num_keys)
 {
@@ -890,6 +999,7 @@ void json_token_object(struct json_tok_t *token_p,
     token_p->buf_p = NULL;
     token_p->size = -1;
     token_p->num_tokens = num_keys;
+    token_p->span = 0;
 }
 
 void json_token_array(struct json_tok_t *token_p,
@@ -899,6 +1009,7 @@ void json_token_array(struct json_tok_t *token_p,
     token_p->buf_p = NULL;
     token_p->size = -1;
     token_p->num_tokens = num_elements;
+    token_p->span = 0;
 }
 
 void json_token_true(struct json_tok_t *token_p)
@@ -907,6 +1018,7 @@ void json_token_true(struct json_tok_t *token_p)
     token_p->buf_p = "true";
     token_p->size = 4;
     token_p->num_tokens = -1;
+    token_p->span = 1;
 }
 
 void json_token_false(struct json_tok_t *token_p)
@@ -915,6 +1027,7 @@ void json_token_false(struct json_tok_t *token_p)
     token_p->buf_p = "false";
     token_p->size = 5;
     token_p->num_tokens = -1;
+    token_p->span = 1;
 }
 
 void json_token_null(struct json_tok_t *token_p)
@@ -923,6 +1036,7 @@ void json_token_null(struct json_tok_t *token_p)
     token_p->buf_p = "null";
     token_p->size = 4;
     token_p->num_tokens = -1;
+    token_p->span = 1;
 }
 
 void json_token_number(struct json_tok_t *token_p,
@@ -933,6 +1047,7 @@ void json_token_number(struct json_tok_t *token_p,
     token_p->buf_p = buf_p;
     token_p->size = size;
     token_p->num_tokens = -1;
+    token_p->span = 1;
 }
 
 void json_token_string(struct json_tok_t *token_p,
@@ -943,4 +1058,658 @@ void json_token_string(struct json_tok_t *token_p,
     token_p->buf_p = buf_p;
     token_p->size = size;
     token_p->num_tokens = -1;
+    token_p->span = 1;
+}
+
+/**
+ * Returns true(1) if given character is JSON whitespace.
+ */
+static int stream_is_space(char c)
+{
+    return ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'));
+}
+
+/**
+ * Returns true(1) if the innermost object or array is an object.
+ */
+static int stream_in_object(struct json_stream_t *self_p)
+{
+    return ((self_p->objects >> (self_p->depth - 1)) & 1);
+}
+
+static int stream_begin(struct json_stream_t *self_p,
+                        int object)
+{
+    if (self_p->depth == JSON_STREAM_DEPTH_MAX) {
+        return (JSON_ERROR_NOMEM);
+    }
+
+    if (object == 1) {
+        self_p->objects |= (1ul << self_p->depth);
+        self_p->state = STREAM_STATE_KEY_OR_END;
+    } else {
+        self_p->objects &= ~(1ul << self_p->depth);
+        self_p->state = STREAM_STATE_VALUE_OR_END;
+    }
+
+    self_p->depth++;
+
+    return (self_p->callback(self_p->arg_p,
+                             (object == 1
+                              ? JSON_EVENT_OBJECT_BEGIN
+                              : JSON_EVENT_ARRAY_BEGIN),
+                             NULL,
+                             0));
+}
+
+static int stream_end(struct json_stream_t *self_p,
+                      int object)
+{
+    int res;
+
+    if (stream_in_object(self_p) != object) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    self_p->depth--;
+    self_p->state = STREAM_STATE_NEXT;
+
+    res = self_p->callback(self_p->arg_p,
+                           (object == 1
+                            ? JSON_EVENT_OBJECT_END
+                            : JSON_EVENT_ARRAY_END),
+                           NULL,
+                           0);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    if (self_p->depth == 0) {
+        self_p->state = STREAM_STATE_ROOT;
+
+        return (STREAM_COMPLETE);
+    }
+
+    return (STREAM_CONSUMED);
+}
+
+static int stream_append(struct json_stream_t *self_p, char c)
+{
+    if (self_p->size == self_p->buf_size) {
+        return (JSON_ERROR_NOMEM);
+    }
+
+    self_p->buf_p[self_p->size++] = c;
+
+    return (STREAM_CONSUMED);
+}
+
+/**
+ * Start a string or primitive, key or value.
+ */
+static int stream_value_begin(struct json_stream_t *self_p,
+                              char c,
+                              int key)
+{
+    self_p->size = 0;
+
+    if (c == '"') {
+        self_p->escape = 0;
+        self_p->state = (key == 1
+                         ? STREAM_STATE_KEY_STRING
+                         : STREAM_STATE_STRING);
+
+        return (STREAM_CONSUMED);
+    }
+
+    if ((c < 32) || (c >= 127) || (c == ',') || (c == ':')
+        || (c == ']') || (c == '}')) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    self_p->state = (key == 1
+                     ? STREAM_STATE_KEY_PRIMITIVE
+                     : STREAM_STATE_PRIMITIVE);
+
+    return (stream_append(self_p, c));
+}
+
+static int stream_value_end(struct json_stream_t *self_p,
+                            enum json_event_t event)
+{
+    self_p->state = (event == JSON_EVENT_KEY
+                     ? STREAM_STATE_COLON
+                     : STREAM_STATE_NEXT);
+
+    return (self_p->callback(self_p->arg_p,
+                             event,
+                             self_p->buf_p,
+                             self_p->size));
+}
+
+static int stream_string(struct json_stream_t *self_p,
+                         char c,
+                         enum json_event_t event)
+{
+    if (self_p->escape == -1) {
+        /* The character after a backslash. */
+        switch (c) {
+
+        case '"':
+        case '/':
+        case '\\':
+        case 'b':
+        case 'f':
+        case 'r':
+        case 'n':
+        case 't':
+            self_p->escape = 0;
+            break;
+
+        case 'u':
+            self_p->escape = 4;
+            break;
+
+        default:
+            return (JSON_ERROR_INVAL);
+        }
+    } else if (self_p->escape > 0) {
+        /* Four hexadecimal digits of an \uXXXX escape. */
+        if (!isxdigit((int)c)) {
+            return (JSON_ERROR_INVAL);
+        }
+
+        self_p->escape--;
+    } else if (c == '"') {
+        return (stream_value_end(self_p, event));
+    } else if (c == '\\') {
+        self_p->escape = -1;
+    } else if ((unsigned char)c < 32) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    return (stream_append(self_p, c));
+}
+
+static int stream_primitive(struct json_stream_t *self_p,
+                            char c,
+                            enum json_event_t event)
+{
+    int res;
+
+    /* The primitive ends at the first character after it, which is
+       parsed in the next state. */
+    if (stream_is_space(c)
+        || (c == ',')
+        || (c == ']')
+        || (c == '}')
+        || ((c == ':') && (event == JSON_EVENT_KEY))) {
+        res = stream_value_end(self_p, event);
+
+        return (res == 0 ? STREAM_NOT_CONSUMED : res);
+    }
+
+    if ((c < 32) || (c >= 127)) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    return (stream_append(self_p, c));
+}
+
+/**
+ * Parse one character.
+ */
+static int stream_parse_char(struct json_stream_t *self_p, char c)
+{
+    switch (self_p->state) {
+
+    case STREAM_STATE_STRING:
+        return (stream_string(self_p, c, JSON_EVENT_STRING));
+
+    case STREAM_STATE_KEY_STRING:
+        return (stream_string(self_p, c, JSON_EVENT_KEY));
+
+    case STREAM_STATE_PRIMITIVE:
+        return (stream_primitive(self_p, c, JSON_EVENT_PRIMITIVE));
+
+    case STREAM_STATE_KEY_PRIMITIVE:
+        return (stream_primitive(self_p, c, JSON_EVENT_KEY));
+
+    default:
+        break;
+    }
+
+    if (stream_is_space(c)) {
+        return (STREAM_CONSUMED);
+    }
+
+    switch (self_p->state) {
+
+    case STREAM_STATE_ROOT:
+        if ((c == '{') || (c == '[')) {
+            return (stream_begin(self_p, c == '{'));
+        }
+
+        return (JSON_ERROR_INVAL);
+
+    case STREAM_STATE_VALUE_OR_END:
+        if (c == ']') {
+            return (stream_end(self_p, 0));
+        }
+
+        /* Fall through. */
+
+    case STREAM_STATE_VALUE:
+        if ((c == '{') || (c == '[')) {
+            return (stream_begin(self_p, c == '{'));
+        }
+
+        return (stream_value_begin(self_p, c, 0));
+
+    case STREAM_STATE_KEY_OR_END:
+        if (c == '}') {
+            return (stream_end(self_p, 1));
+        }
+
+        /* Fall through. */
+
+    case STREAM_STATE_KEY:
+        if ((c == '{') || (c == '[')) {
+            return (JSON_ERROR_INVAL);
+        }
+
+        return (stream_value_begin(self_p, c, 1));
+
+    case STREAM_STATE_COLON:
+        if (c == ':') {
+            self_p->state = STREAM_STATE_VALUE;
+
+            return (STREAM_CONSUMED);
+        }
+
+        return (JSON_ERROR_INVAL);
+
+    case STREAM_STATE_NEXT:
+        if (c == ',') {
+            self_p->state = (stream_in_object(self_p)
+                             ? STREAM_STATE_KEY
+                             : STREAM_STATE_VALUE);
+
+            return (STREAM_CONSUMED);
+        } else if ((c == '}') || (c == ']')) {
+            return (stream_end(self_p, c == '}'));
+        }
+
+        return (JSON_ERROR_INVAL);
+
+    default:
+        return (JSON_ERROR_INVAL);
+    }
+}
+
+/**
+ * Write given buffer to the writer channel.
+ */
+static int writer_write(struct json_writer_t *self_p,
+                        const char *buf_p,
+                        size_t size)
+{
+    if (chan_write(self_p->chout_p, buf_p, size) != size) {
+        return (-EIO);
+    }
+
+    self_p->size += size;
+
+    return (0);
+}
+
+/**
+ * Prepare for a new element in the current object or array by
+ * writing a comma if needed.
+ */
+static int writer_element(struct json_writer_t *self_p, int key)
+{
+    uint32_t mask;
+
+    if (self_p->depth == 0) {
+        return (key == 1 ? JSON_ERROR_INVAL : 0);
+    }
+
+    mask = (1ul << (self_p->depth - 1));
+
+    if (self_p->objects & mask) {
+        /* Values in objects must follow a key, and keys must
+           not. */
+        if (self_p->key != !key) {
+            return (JSON_ERROR_INVAL);
+        }
+
+        if (self_p->key == 1) {
+            self_p->key = 0;
+
+            return (0);
+        }
+    } else if (key == 1) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    if (self_p->elements & mask) {
+        return (writer_write(self_p, ",", 1));
+    }
+
+    self_p->elements |= mask;
+
+    return (0);
+}
+
+static int writer_begin(struct json_writer_t *self_p,
+                        int object)
+{
+    int res;
+    uint32_t mask;
+
+    if (self_p->depth == JSON_STREAM_DEPTH_MAX) {
+        return (JSON_ERROR_NOMEM);
+    }
+
+    res = writer_element(self_p, 0);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    mask = (1ul << self_p->depth);
+
+    if (object == 1) {
+        self_p->objects |= mask;
+    } else {
+        self_p->objects &= ~mask;
+    }
+
+    self_p->elements &= ~mask;
+    self_p->depth++;
+
+    return (writer_write(self_p, (object == 1 ? "{" : "["), 1));
+}
+
+static int writer_end(struct json_writer_t *self_p,
+                      int object)
+{
+    if ((self_p->depth == 0) || (self_p->key == 1)) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    if (((self_p->objects >> (self_p->depth - 1)) & 1) != object) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    self_p->depth--;
+
+    return (writer_write(self_p, (object == 1 ? "}" : "]"), 1));
+}
+
+int json_stream_init(struct json_stream_t *self_p,
+                     char *buf_p,
+                     size_t size,
+                     json_stream_callback_t callback,
+                     void *arg_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+    ASSERTN(callback != NULL, EINVAL);
+
+    self_p->callback = callback;
+    self_p->arg_p = arg_p;
+    self_p->state = STREAM_STATE_ROOT;
+    self_p->escape = 0;
+    self_p->depth = 0;
+    self_p->objects = 0;
+    self_p->buf_p = buf_p;
+    self_p->buf_size = size;
+    self_p->size = 0;
+    self_p->input.offset = 0;
+    self_p->input.size = 0;
+
+    return (0);
+}
+
+ssize_t json_stream_parse(struct json_stream_t *self_p,
+                          const char *buf_p,
+                          size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN((buf_p != NULL) || (size == 0), EINVAL);
+
+    size_t i;
+    int res;
+
+    i = 0;
+
+    while (i < size) {
+        res = stream_parse_char(self_p, buf_p[i]);
+
+        if (res < 0) {
+            return (res);
+        }
+
+        switch (res) {
+
+        case STREAM_CONSUMED:
+            i++;
+            break;
+
+        case STREAM_COMPLETE:
+            return (i + 1);
+
+        default:
+            break;
+        }
+    }
+
+    return (JSON_ERROR_PART);
+}
+
+int json_stream_read(struct json_stream_t *self_p, void *chan_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(chan_p != NULL, EINVAL);
+
+    ssize_t size;
+    ssize_t res;
+
+    do {
+        if (self_p->input.offset == self_p->input.size) {
+            size = chan_size(chan_p);
+
+            if (size <= 0) {
+                size = 1;
+            } else if (size > sizeof(self_p->input.buf)) {
+                size = sizeof(self_p->input.buf);
+            }
+
+            self_p->input.offset = 0;
+            self_p->input.size = 0;
+
+            if (chan_read(chan_p, &self_p->input.buf[0], size) != size) {
+                return (-EIO);
+            }
+
+            self_p->input.size = size;
+        }
+
+        res = json_stream_parse(self_p,
+                                &self_p->input.buf[self_p->input.offset],
+                                self_p->input.size - self_p->input.offset);
+
+        /* Keep bytes after the end of the document for the next
+           call. */
+        if (res >= 0) {
+            self_p->input.offset += res;
+        } else {
+            self_p->input.offset = self_p->input.size;
+        }
+    } while (res == JSON_ERROR_PART);
+
+    return (res < 0 ? res : 0);
+}
+
+int json_writer_init(struct json_writer_t *self_p, void *chout_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(chout_p != NULL, EINVAL);
+
+    self_p->chout_p = chout_p;
+    self_p->depth = 0;
+    self_p->key = 0;
+    self_p->objects = 0;
+    self_p->elements = 0;
+    self_p->size = 0;
+
+    return (0);
+}
+
+int json_writer_object_begin(struct json_writer_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (writer_begin(self_p, 1));
+}
+
+int json_writer_object_end(struct json_writer_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (writer_end(self_p, 1));
+}
+
+int json_writer_array_begin(struct json_writer_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (writer_begin(self_p, 0));
+}
+
+int json_writer_array_end(struct json_writer_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (writer_end(self_p, 0));
+}
+
+int json_writer_key(struct json_writer_t *self_p, const char *key_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(key_p != NULL, EINVAL);
+
+    int res;
+
+    res = writer_element(self_p, 1);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    self_p->key = 1;
+    res = writer_write(self_p, "\"", 1);
+
+    if (res == 0) {
+        res = writer_write(self_p, key_p, strlen(key_p));
+    }
+
+    if (res == 0) {
+        res = writer_write(self_p, "\":", 2);
+    }
+
+    return (res);
+}
+
+int json_writer_string(struct json_writer_t *self_p,
+                       const char *buf_p,
+                       size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN((buf_p != NULL) || (size == 0), EINVAL);
+
+    int res;
+
+    if (self_p->depth == 0) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    res = writer_element(self_p, 0);
+
+    if (res == 0) {
+        res = writer_write(self_p, "\"", 1);
+    }
+
+    if (res == 0) {
+        res = writer_write(self_p, buf_p, size);
+    }
+
+    if (res == 0) {
+        res = writer_write(self_p, "\"", 1);
+    }
+
+    return (res);
+}
+
+int json_writer_integer(struct json_writer_t *self_p, long value)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    char buf[24];
+    ssize_t size;
+
+    size = std_snprintf(&buf[0], sizeof(buf), FSTR("%ld"), value);
+
+    return (json_writer_primitive(self_p, &buf[0], size));
+}
+
+int json_writer_boolean(struct json_writer_t *self_p, int value)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    if (value) {
+        return (json_writer_primitive(self_p, "true", 4));
+    } else {
+        return (json_writer_primitive(self_p, "false", 5));
+    }
+}
+
+int json_writer_null(struct json_writer_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (json_writer_primitive(self_p, "null", 4));
+}
+
+int json_writer_primitive(struct json_writer_t *self_p,
+                          const char *buf_p,
+                          size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    int res;
+
+    /* The document must be an object or an array. */
+    if (self_p->depth == 0) {
+        return (JSON_ERROR_INVAL);
+    }
+
+    res = writer_element(self_p, 0);
+
+    if (res == 0) {
+        res = writer_write(self_p, buf_p, size);
+    }
+
+    return (res);
+}
+
+ssize_t json_writer_size(struct json_writer_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (self_p->size);
 }
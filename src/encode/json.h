@@ -92,6 +92,49 @@ enum json_err_t {
     JSON_ERROR_PART = -3
 };
 
+/**
+ * Streaming parser event.
+ */
+enum json_event_t {
+    /** Beginning of an object, ``{``. */
+    JSON_EVENT_OBJECT_BEGIN = 0,
+
+    /** End of an object, ``}``. */
+    JSON_EVENT_OBJECT_END,
+
+    /** Beginning of an array, ``[``. */
+    JSON_EVENT_ARRAY_BEGIN,
+
+    /** End of an array, ``]``. */
+    JSON_EVENT_ARRAY_END,
+
+    /** Object key, string or primitive. */
+    JSON_EVENT_KEY,
+
+    /** String value, without quotes. */
+    JSON_EVENT_STRING,
+
+    /** Other primitive value: number, boolean (true/false) or null. */
+    JSON_EVENT_PRIMITIVE
+};
+
+/** Maximum nesting depth of objects and arrays in the streaming
+    parser and writer. */
+#define JSON_STREAM_DEPTH_MAX                               32
+
+/**
+ * Streaming parser event callback. ``buf_p`` and ``size`` is the key
+ * or value for key, string and primitive events. Strings are not
+ * unescaped. The buffer is only valid during the call.
+ *
+ * @return zero(0) to continue parsing, or negative error code to
+ *         abort.
+ */
+typedef int (*json_stream_callback_t)(void *arg_p,
+                                      enum json_event_t event,
+                                      const char *buf_p,
+                                      size_t size);
+
 /*
  * JSON token description.
  */
@@ -104,6 +147,10 @@ struct json_tok_t {
     size_t size;
     /* Number of children of this token. Not recursive. */
     int num_tokens;
+    /* Number of tokens in the subtree of this token, including the
+       token itself. Set by the parser to skip subtrees in constant
+       time. Zero(0) if unknown. */
+    int span;
 #ifdef JSON_PARENT_LINKS
     int parent;
 #endif
@@ -127,6 +174,48 @@ struct json_t {
     int num_tokens;
 };
 
+/**
+ * Streaming JSON parser. Parses a document in chunks of any size and
+ * calls a callback for each event, without building a token tree.
+ */
+struct json_stream_t {
+    json_stream_callback_t callback;
+    void *arg_p;
+    int8_t state;
+    int8_t escape;
+    int8_t depth;
+    /* One bit per nesting level, set for objects and cleared for
+       arrays. */
+    uint32_t objects;
+    /* Key and value buffer. */
+    char *buf_p;
+    size_t buf_size;
+    size_t size;
+    /* Bytes read by json_stream_read() that are not yet parsed. */
+    struct {
+        char buf[32];
+        uint8_t offset;
+        uint8_t size;
+    } input;
+};
+
+/**
+ * Streaming JSON writer. Writes a document to a channel element by
+ * element, without building a token tree.
+ */
+struct json_writer_t {
+    void *chout_p;
+    int8_t depth;
+    int8_t key;
+    /* One bit per nesting level, set for objects and cleared for
+       arrays. */
+    uint32_t objects;
+    /* One bit per nesting level, set if the level has at least one
+       element. */
+    uint32_t elements;
+    ssize_t size;
+};
+
  /**
   * Initialize given JSON object. The JSON object must be initialized
   * before it can be used to parse and dump JSON data.
@@ -238,6 +327,20 @@ struct json_tok_t *json_array_get(struct json_t *self_p,
                                   int index,
                                   struct json_tok_t *array_p);
 
+/**
+ * Get the token at given path, starting at the root token. The path
+ * is a sequence of object keys separated by dots, and array indexes
+ * in brackets. For example, ``a.b[3].c`` is key ``c`` in the fourth
+ * element of the array ``b`` in the object ``a``.
+ *
+ * @param[in] self_p JSON object.
+ * @param[in] path_p Path of the token to get.
+ *
+ * @return Token or NULL if not found.
+ */
+struct json_tok_t *json_get_path(struct json_t *self_p,
+                                 const char *path_p);
+
 /**
  * Initialize a JSON object token.
  *
@@ -299,4 +402,173 @@ void json_token_string(struct json_tok_t *token_p,
                        const char *buf_p,
                        size_t size);
 
+/**
+ * Initialize given streaming JSON parser.
+ *
+ * @param[out] self_p Streaming parser to initialize.
+ * @param[in] buf_p Buffer for keys and values. Longer keys and
+ *                  values cannot be parsed.
+ * @param[in] size Buffer size.
+ * @param[in] callback Called for each parsed event.
+ * @param[in] arg_p Callback argument.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_stream_init(struct json_stream_t *self_p,
+                     char *buf_p,
+                     size_t size,
+                     json_stream_callback_t callback,
+                     void *arg_p);
+
+/**
+ * Parse given chunk of a JSON document. The document must be an
+ * object or an array. Call this function again with the next chunk
+ * as long as it returns ``JSON_ERROR_PART``. Once a document is
+ * complete, the parser is ready for the next one.
+ *
+ * @param[in] self_p Streaming parser.
+ * @param[in] buf_p Chunk to parse.
+ * @param[in] size Chunk size in bytes.
+ *
+ * @return Number of bytes parsed up to and including the end of the
+ *         document, ``JSON_ERROR_PART`` if more input is needed, or
+ *         negative error code.
+ */
+ssize_t json_stream_parse(struct json_stream_t *self_p,
+                          const char *buf_p,
+                          size_t size);
+
+/**
+ * Read and parse a JSON document from given channel. Bytes after the
+ * document that are available in the channel may also be read. They
+ * are kept in the parser and parsed first by the next call.
+ *
+ * @param[in] self_p Streaming parser.
+ * @param[in] chan_p Channel to read from.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_stream_read(struct json_stream_t *self_p, void *chan_p);
+
+/**
+ * Initialize given streaming JSON writer.
+ *
+ * @param[out] self_p Writer to initialize.
+ * @param[in] chout_p Channel to write the document to.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_init(struct json_writer_t *self_p, void *chout_p);
+
+/**
+ * Write the beginning of an object.
+ *
+ * @param[in] self_p Writer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_object_begin(struct json_writer_t *self_p);
+
+/**
+ * Write the end of an object.
+ *
+ * @param[in] self_p Writer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_object_end(struct json_writer_t *self_p);
+
+/**
+ * Write the beginning of an array.
+ *
+ * @param[in] self_p Writer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_array_begin(struct json_writer_t *self_p);
+
+/**
+ * Write the end of an array.
+ *
+ * @param[in] self_p Writer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_array_end(struct json_writer_t *self_p);
+
+/**
+ * Write an object key. Must be followed by a value.
+ *
+ * @param[in] self_p Writer.
+ * @param[in] key_p Null terminated key, escaped as needed.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_key(struct json_writer_t *self_p, const char *key_p);
+
+/**
+ * Write a string value.
+ *
+ * @param[in] self_p Writer.
+ * @param[in] buf_p String, escaped as needed.
+ * @param[in] size String length.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_string(struct json_writer_t *self_p,
+                       const char *buf_p,
+                       size_t size);
+
+/**
+ * Write an integer value.
+ *
+ * @param[in] self_p Writer.
+ * @param[in] value Integer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_integer(struct json_writer_t *self_p, long value);
+
+/**
+ * Write a boolean value.
+ *
+ * @param[in] self_p Writer.
+ * @param[in] value Boolean.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_boolean(struct json_writer_t *self_p, int value);
+
+/**
+ * Write a null value.
+ *
+ * @param[in] self_p Writer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_null(struct json_writer_t *self_p);
+
+/**
+ * Write given primitive value as is, for example a number formatted
+ * by the caller.
+ *
+ * @param[in] self_p Writer.
+ * @param[in] buf_p Primitive.
+ * @param[in] size Primitive length.
+ *
+ * @return zero(0) or negative error code.
+ */
+int json_writer_primitive(struct json_writer_t *self_p,
+                          const char *buf_p,
+                          size_t size);
+
+/**
+ * Get the number of bytes written so far.
+ *
+ * @param[in] self_p Writer.
+ *
+ * @return Number of written bytes, or negative error code.
+ */
+ssize_t json_writer_size(struct json_writer_t *self_p);
+
 #endif
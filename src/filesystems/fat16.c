@@ -80,6 +80,17 @@
 /** Default time for file timestamp is 1 am. */
 #define DEFAULT_TIME (1 << 11)
 
+/** Block number of an unused cache entry. */
+#define CACHE_BLOCK_NONE 0xffffffff
+
+struct module_t {
+    int8_t initialized;
+    struct fs_counter_t cache_hits;
+    struct fs_counter_t cache_misses;
+};
+
+static struct module_t module;
+
 static int is_end_of_cluster(fat_t cluster)
 {
     return (cluster >= 0xfff8);
@@ -201,33 +212,206 @@ static int make_name_from_83(char *dst_p, const char *dname_p)
     return (0);
 }
 
-static int cache_flush(struct fat16_t *self_p)
+/**
+ * Write given cache entry to the device if modified. A modified FAT
+ * block is written to the mirror FAT as well, once, no matter how
+ * many times it was modified.
+ */
+static int cache_entry_write_back(struct fat16_t *self_p,
+                                  struct fat16_cache_entry_t *entry_p)
 {
-    struct fat16_cache_t *cache_p = &self_p->cache;
-
-    if (cache_p->dirty) {
+    if (entry_p->dirty) {
         if (self_p->write(self_p->arg_p,
-                          cache_p->block_number,
-                          cache_p->buffer.data) != BLOCK_SIZE) {
+                          entry_p->block_number,
+                          entry_p->buffer.data) != BLOCK_SIZE) {
             return (-1);
         }
 
-        if (cache_p->mirror_block) {
+        if (entry_p->mirror_block) {
             if (self_p->write(self_p->arg_p,
-                              cache_p->mirror_block,
-                              cache_p->buffer.data) != BLOCK_SIZE) {
+                              entry_p->mirror_block,
+                              entry_p->buffer.data) != BLOCK_SIZE) {
                 return (-1);
             }
 
-            cache_p->mirror_block = 0;
+            entry_p->mirror_block = 0;
+        }
+
+        entry_p->dirty = 0;
+    }
+
+    return (0);
+}
+
+/**
+ * Write all modified blocks in the cache to the device.
+ */
+static int cache_flush(struct fat16_t *self_p)
+{
+    int i;
+
+    for (i = 0; i < membersof(self_p->cache.entries); i++) {
+        if (cache_entry_write_back(self_p, &self_p->cache.entries[i]) != 0) {
+            return (-1);
         }
+    }
+
+    return (0);
+}
 
-        cache_p->dirty = 0;
+/**
+ * Write modified cached blocks in given range to the device.
+ */
+static int cache_flush_range(struct fat16_t *self_p,
+                             uint32_t block_number,
+                             size_t count)
+{
+    int i;
+    struct fat16_cache_entry_t *entry_p;
+
+    for (i = 0; i < membersof(self_p->cache.entries); i++) {
+        entry_p = &self_p->cache.entries[i];
+
+        if ((entry_p->block_number >= block_number)
+            && (entry_p->block_number < block_number + count)) {
+            if (cache_entry_write_back(self_p, entry_p) != 0) {
+                return (-1);
+            }
+        }
     }
 
     return (0);
 }
 
+/**
+ * Drop cached blocks in given range without writing them to the
+ * device.
+ */
+static void cache_invalidate_range(struct fat16_t *self_p,
+                                   uint32_t block_number,
+                                   size_t count)
+{
+    int i;
+    struct fat16_cache_entry_t *entry_p;
+
+    for (i = 0; i < membersof(self_p->cache.entries); i++) {
+        entry_p = &self_p->cache.entries[i];
+
+        if ((entry_p->block_number >= block_number)
+            && (entry_p->block_number < block_number + count)) {
+            entry_p->block_number = CACHE_BLOCK_NONE;
+            entry_p->dirty = 0;
+            entry_p->mirror_block = 0;
+        }
+    }
+}
+
+static void cache_init(struct fat16_t *self_p)
+{
+    int i;
+
+    self_p->cache.tick = 0;
+
+    for (i = 0; i < membersof(self_p->cache.entries); i++) {
+        self_p->cache.entries[i].block_number = CACHE_BLOCK_NONE;
+        self_p->cache.entries[i].dirty = 0;
+        self_p->cache.entries[i].mirror_block = 0;
+        self_p->cache.entries[i].tick = 0;
+    }
+}
+
+/**
+ * Find the entry to replace when caching a new block; an unused entry
+ * or the least recently used one. FAT blocks and other blocks are
+ * replaced within their own set of entries.
+ */
+static struct fat16_cache_entry_t *cache_find_victim(struct fat16_t *self_p,
+                                                     int is_fat)
+{
+    struct fat16_cache_entry_t *entry_p;
+    struct fat16_cache_entry_t *victim_p;
+    int begin;
+    int end;
+    int i;
+
+#if CONFIG_FAT16_CACHE_FAT_BLOCKS > 0
+    if (is_fat == 1) {
+        begin = 0;
+        end = CONFIG_FAT16_CACHE_FAT_BLOCKS;
+    } else {
+        begin = CONFIG_FAT16_CACHE_FAT_BLOCKS;
+        end = CONFIG_FAT16_CACHE_BLOCKS;
+    }
+#else
+    begin = 0;
+    end = CONFIG_FAT16_CACHE_BLOCKS;
+#endif
+
+    victim_p = &self_p->cache.entries[begin];
+
+    for (i = begin; i < end; i++) {
+        entry_p = &self_p->cache.entries[i];
+
+        if (entry_p->block_number == CACHE_BLOCK_NONE) {
+            return (entry_p);
+        }
+
+        if ((int32_t)(entry_p->tick - victim_p->tick) < 0) {
+            victim_p = entry_p;
+        }
+    }
+
+    return (victim_p);
+}
+
+/**
+ * Get the cache entry of given block. The block is read from the
+ * device on a cache miss, unless read is zero(0).
+ */
+static struct fat16_cache_entry_t *cache_get(struct fat16_t *self_p,
+                                             uint32_t block_number,
+                                             int is_fat,
+                                             int read)
+{
+    struct fat16_cache_entry_t *entry_p;
+    int i;
+
+    self_p->cache.tick++;
+
+    for (i = 0; i < membersof(self_p->cache.entries); i++) {
+        entry_p = &self_p->cache.entries[i];
+
+        if (entry_p->block_number == block_number) {
+            fs_counter_increment(&module.cache_hits, 1);
+            entry_p->tick = self_p->cache.tick;
+
+            return (entry_p);
+        }
+    }
+
+    fs_counter_increment(&module.cache_misses, 1);
+    entry_p = cache_find_victim(self_p, is_fat);
+
+    if (cache_entry_write_back(self_p, entry_p) != 0) {
+        return (NULL);
+    }
+
+    entry_p->block_number = CACHE_BLOCK_NONE;
+
+    if (read == 1) {
+        if (self_p->read(self_p->arg_p,
+                         entry_p->buffer.data,
+                         block_number) != BLOCK_SIZE) {
+            return (NULL);
+        }
+    }
+
+    entry_p->block_number = block_number;
+    entry_p->tick = self_p->cache.tick;
+
+    return (entry_p);
+}
+
 static inline uint8_t block_of_cluster(uint8_t blocks_per_cluster,
                                        uint32_t position)
 {
@@ -239,11 +423,6 @@ static inline uint16_t cache_data_offset(uint32_t position)
     return (position & 0x1ff);
 }
 
-static inline void cache_set_dirty(struct fat16_cache_t *cache_p)
-{
-    cache_p->dirty |= CACHE_FOR_WRITE;
-}
-
 static inline uint32_t data_block_lba(struct fat16_file_t *file_p,
                                       uint8_t block_of_cluster)
 {
@@ -253,29 +432,45 @@ static inline uint32_t data_block_lba(struct fat16_file_t *file_p,
             block_of_cluster);
 }
 
-static int cache_raw_block(struct fat16_t *self_p,
-                           uint32_t block_number,
-                           uint8_t action)
+/**
+ * Cache given block and return its buffer, or NULL on failure.
+ */
+static union fat16_cache16_t *cache_raw_block(struct fat16_t *self_p,
+                                              uint32_t block_number,
+                                              uint8_t action)
 {
-    struct fat16_cache_t *cache_p = &self_p->cache;
+    struct fat16_cache_entry_t *entry_p;
 
-    if (cache_p->block_number != block_number) {
-        if (cache_flush(self_p) != 0) {
-            return (-1);
-        }
+    entry_p = cache_get(self_p, block_number, 0, 1);
 
-        if (self_p->read(self_p->arg_p,
-                         cache_p->buffer.data,
-                         block_number) != BLOCK_SIZE) {
-            return (-1);
-        }
+    if (entry_p == NULL) {
+        return (NULL);
+    }
+
+    entry_p->dirty |= action;
+
+    return (&entry_p->buffer);
+}
 
-        cache_p->block_number = block_number;
+/**
+ * Cache given block without reading it from the device. The buffer is
+ * zeroed and marked as modified.
+ */
+static union fat16_cache16_t *cache_zeroed_block(struct fat16_t *self_p,
+                                                 uint32_t block_number)
+{
+    struct fat16_cache_entry_t *entry_p;
+
+    entry_p = cache_get(self_p, block_number, 0, 0);
+
+    if (entry_p == NULL) {
+        return (NULL);
     }
 
-    cache_p->dirty |= action;
+    memset(&entry_p->buffer, 0, sizeof(entry_p->buffer));
+    entry_p->dirty = CACHE_FOR_WRITE;
 
-    return (0);
+    return (&entry_p->buffer);
 }
 
 static int fat_get(struct fat16_t *self_p,
@@ -283,20 +478,20 @@ static int fat_get(struct fat16_t *self_p,
                    fat_t* value)
 {
     uint32_t lba;
+    struct fat16_cache_entry_t *entry_p;
 
     if (cluster > (self_p->cluster_count + 1)) {
         return (-1);
     }
 
     lba = self_p->fat_start_block + (cluster >> 8);
+    entry_p = cache_get(self_p, lba, 1, 1);
 
-    if (lba != self_p->cache.block_number) {
-        if (cache_raw_block(self_p, lba, CACHE_FOR_READ)) {
-            return (-1);
-        }
+    if (entry_p == NULL) {
+        return (-1);
     }
 
-    *value = self_p->cache.buffer.fat[cluster & 0xff];
+    *value = entry_p->buffer.fat[cluster & 0xff];
 
     return (0);
 }
@@ -304,6 +499,7 @@ static int fat_get(struct fat16_t *self_p,
 static int fat_put(struct fat16_t *self_p, fat_t cluster, fat_t value)
 {
     uint32_t lba;
+    struct fat16_cache_entry_t *entry_p;
 
     if (cluster < 2) {
         return (-1);
@@ -314,18 +510,18 @@ static int fat_put(struct fat16_t *self_p, fat_t cluster, fat_t value)
     }
 
     lba = self_p->fat_start_block + (cluster >> 8);
+    entry_p = cache_get(self_p, lba, 1, 1);
 
-    if (lba != self_p->cache.block_number) {
-        if (cache_raw_block(self_p, lba, CACHE_FOR_READ) != 0) {
-            return (-1);
-        }
+    if (entry_p == NULL) {
+        return (-1);
     }
 
-    self_p->cache.buffer.fat[cluster & 0xff] = value;
-    cache_set_dirty(&self_p->cache);
+    entry_p->buffer.fat[cluster & 0xff] = value;
+    entry_p->dirty = CACHE_FOR_WRITE;
 
+    /* The mirror is written when the block is written back. */
     if (self_p->fat_count > 1) {
-        self_p->cache.mirror_block = (lba + self_p->blocks_per_fat);
+        entry_p->mirror_block = (lba + self_p->blocks_per_fat);
     }
 
     return (0);
@@ -336,11 +532,15 @@ static struct dir_t* cache_dir_entry(struct fat16_t *self_p,
                                      uint16_t index,
                                      uint8_t action)
 {
-    if (cache_raw_block(self_p, block + (index >> 4), action) != 0) {
+    union fat16_cache16_t *buffer_p;
+
+    buffer_p = cache_raw_block(self_p, block + (index >> 4), action);
+
+    if (buffer_p == NULL) {
         return (NULL);
     }
 
-    return (&self_p->cache.buffer.dir[index & 0xf]);
+    return (&buffer_p->dir[index & 0xf]);
 }
 
 static int free_chain(struct fat16_t *self_p, fat_t cluster)
@@ -371,13 +571,17 @@ static int write_volume_block(struct fat16_t *self_p,
                               uint32_t volume_start_block,
                               struct fbs_t *fbs_p)
 {
+    union fat16_cache16_t *buffer_p;
+
     /* Cache volume start block. */
-    if (cache_raw_block(self_p, volume_start_block, CACHE_FOR_WRITE) != 0) {
+    buffer_p = cache_zeroed_block(self_p, volume_start_block);
+
+    if (buffer_p == NULL) {
         return (-1);
     }
 
     /* Write the boot sector to the start block. */
-    self_p->cache.buffer.fbs = *fbs_p;
+    buffer_p->fbs = *fbs_p;
 
     return (cache_flush(self_p));
 }
@@ -387,19 +591,19 @@ static int format_fat_blocks(struct fat16_t *self_p,
                              uint32_t fat_end_block)
 {
     uint32_t block;
+    union fat16_cache16_t *buffer_p;
 
     for (block = fat_start_block; block < fat_end_block; block++) {
         /* Cache the next block within the fat. */
-        if (cache_raw_block(self_p, block, CACHE_FOR_WRITE) != 0) {
-            return (-1);
+        buffer_p = cache_zeroed_block(self_p, block);
 
+        if (buffer_p == NULL) {
+            return (-1);
         }
-        /* Format the block. */
-        memset(&self_p->cache.buffer, 0, sizeof(self_p->cache.buffer));
 
         if (block == fat_start_block) {
-            self_p->cache.buffer.fat[0] = 0xfff8;
-            self_p->cache.buffer.fat[1] = 0xffff;
+            buffer_p->fat[0] = 0xfff8;
+            buffer_p->fat[1] = 0xffff;
         }
 
         if (cache_flush(self_p) != 0) {
@@ -418,14 +622,10 @@ static int format_root_dir_blocks(struct fat16_t *self_p,
 
     for (block = root_dir_start_block; block < root_dir_end_block; block++) {
         /* Cache the next block within the root directory. */
-        if (cache_raw_block(self_p, block, CACHE_FOR_WRITE) != 0) {
+        if (cache_zeroed_block(self_p, block) == NULL) {
             return (-1);
         }
 
-        /* Clear the block. */
-        memset(&self_p->cache.buffer, 0, sizeof(self_p->cache.buffer));
-
-        /* The flush function writes to the mirrored fat block as well. */
         if (cache_flush(self_p) != 0) {
             return (-1);
         }
@@ -434,6 +634,28 @@ static int format_root_dir_blocks(struct fat16_t *self_p,
     return (0);
 }
 
+int fat16_module_init(void)
+{
+    /* Return immediately if the module is already initialized. */
+    if (module.initialized == 1) {
+        return (0);
+    }
+
+    module.initialized = 1;
+
+    fs_counter_init(&module.cache_hits,
+                    FSTR("/filesystems/fat16/cache/hits"),
+                    0);
+    fs_counter_register(&module.cache_hits);
+
+    fs_counter_init(&module.cache_misses,
+                    FSTR("/filesystems/fat16/cache/misses"),
+                    0);
+    fs_counter_register(&module.cache_misses);
+
+    return (0);
+}
+
 int fat16_init(struct fat16_t *self_p,
                fat16_read_t read,
                fat16_write_t write,
@@ -452,49 +674,68 @@ int fat16_init(struct fat16_t *self_p,
     /* Initialize datastructure.*/
     self_p->read = read;
     self_p->write = write;
+    self_p->read_blocks = NULL;
+    self_p->write_blocks = NULL;
     self_p->arg_p = arg_p;
     self_p->partition = partition;
 
     return (0);
 }
 
+int fat16_set_multiple_blocks_callbacks(struct fat16_t *self_p,
+                                        fat16_read_blocks_t read_blocks,
+                                        fat16_write_blocks_t write_blocks)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    self_p->read_blocks = read_blocks;
+    self_p->write_blocks = write_blocks;
+
+    return (0);
+}
+
 int fat16_mount(struct fat16_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
     uint32_t total_blocks;
     struct bpb_t* bpb_p;
+    union fat16_cache16_t *buffer_p;
 
     /* Initialize the cache. */
-    self_p->cache.block_number = 0xffffffff;
-    self_p->cache.dirty = 0;
-    self_p->cache.mirror_block = 0;
+    cache_init(self_p);
     self_p->volume_start_block = 0;
 
     /* If part == 0 assume super floppy with FAT16 boot sector in
        block zero. */
     /* If part > 0 assume mbr volume with partition table. */
     if (self_p->partition > 0) {
-        if (cache_raw_block(self_p,
-                            self_p->volume_start_block,
-                            CACHE_FOR_READ) != 0) {
+        buffer_p = cache_raw_block(self_p,
+                                   self_p->volume_start_block,
+                                   CACHE_FOR_READ);
+
+        if (buffer_p == NULL) {
             return (-1);
         }
 
         self_p->volume_start_block =
-            self_p->cache.buffer.mbr.part[self_p->partition - 1].first_sector;
+            buffer_p->mbr.part[self_p->partition - 1].first_sector;
     }
 
-    if (cache_raw_block(self_p, self_p->volume_start_block, CACHE_FOR_READ) != 0) {
+    buffer_p = cache_raw_block(self_p,
+                               self_p->volume_start_block,
+                               CACHE_FOR_READ);
+
+    if (buffer_p == NULL) {
         return (-1);
     }
 
     /* Check boot block signature. */
-    if (self_p->cache.buffer.fbs.boot_sector_sig != BOOTSIG) {
+    if (buffer_p->fbs.boot_sector_sig != BOOTSIG) {
         return (-1);
     }
 
-    bpb_p = &self_p->cache.buffer.fbs.bpb;
+    bpb_p = &buffer_p->fbs.bpb;
     self_p->fat_count = bpb_p->fat_count;
     self_p->blocks_per_cluster = bpb_p->sectors_per_cluster;
     self_p->blocks_per_fat = bpb_p->sectors_per_fat;
@@ -552,9 +793,7 @@ int fat16_format(struct fat16_t *self_p)
     uint32_t root_dir_block_count;
 
     /* Initialize the cache. */
-    self_p->cache.block_number = 0xffffffff;
-    self_p->cache.dirty = 0;
-    self_p->cache.mirror_block = 0;
+    cache_init(self_p);
 
     volume_start_block = 0;
 
@@ -1033,7 +1272,8 @@ static int dir_open(struct fat16_t *self_p,
 }
 
 static int get_block(struct fat16_file_t *file_p,
-                     uint16_t *block_offset_p)
+                     uint16_t *block_offset_p,
+                     union fat16_cache16_t **buffer_pp)
 {
     uint8_t blk_of_cluster;
     fat_t next;
@@ -1075,25 +1315,179 @@ static int get_block(struct fat16_file_t *file_p,
 
     if ((*block_offset_p == 0) && (file_p->cur_position >= file_p->file_size)) {
         /* Start of new block don't need to read into cache. */
-        if (cache_flush(file_p->fat16_p) != 0) {
-            return (FAT16_EOF);
-        }
-
-        file_p->fat16_p->cache.block_number = lba;
-        memset(&file_p->fat16_p->cache.buffer,
-               0,
-               sizeof(file_p->fat16_p->cache.buffer));
-        cache_set_dirty(&file_p->fat16_p->cache);
+        *buffer_pp = cache_zeroed_block(file_p->fat16_p, lba);
     } else {
         /* Rewrite part of block. */
-        if (cache_raw_block(file_p->fat16_p, lba, CACHE_FOR_WRITE) != 0) {
-            return (FAT16_EOF);
+        *buffer_pp = cache_raw_block(file_p->fat16_p, lba, CACHE_FOR_WRITE);
+    }
+
+    if (*buffer_pp == NULL) {
+        return (FAT16_EOF);
+    }
+
+    return (0);
+}
+
+/**
+ * Move given file to the cluster following its current cluster, or
+ * to its first cluster if at the start of the file. A cluster is
+ * added to the file at the end of the chain if allocate is set.
+ */
+static int next_cluster(struct fat16_file_t *file_p, int allocate)
+{
+    fat_t next;
+
+    if (file_p->cur_cluster == 0) {
+        if (file_p->first_cluster != 0) {
+            file_p->cur_cluster = file_p->first_cluster;
+
+            return (0);
+        }
+    } else {
+        if (fat_get(file_p->fat16_p, file_p->cur_cluster, &next) != 0) {
+            return (-1);
+        }
+
+        if (!is_end_of_cluster(next)) {
+            if (next < 2) {
+                return (-1);
+            }
+
+            file_p->cur_cluster = next;
+
+            return (0);
+        }
+    }
+
+    if (!allocate) {
+        return (-1);
+    }
+
+    return (add_cluster(file_p));
+}
+
+/**
+ * Find the run of consecutive data blocks on the device starting at
+ * the current, block aligned, position of given file. The run is at
+ * most given number of blocks long. When this function returns the
+ * current cluster of the file is the cluster of the last block in the
+ * run.
+ */
+static int get_block_run(struct fat16_file_t *file_p,
+                         size_t count_max,
+                         int allocate,
+                         uint32_t *lba_p,
+                         size_t *count_p)
+{
+    uint8_t blocks_per_cluster;
+    uint8_t blk_of_cluster;
+    fat_t cluster;
+    size_t count;
+
+    blocks_per_cluster = file_p->fat16_p->blocks_per_cluster;
+    blk_of_cluster = block_of_cluster(blocks_per_cluster,
+                                      file_p->cur_position);
+
+    if (blk_of_cluster == 0) {
+        if (next_cluster(file_p, allocate) != 0) {
+            return (-1);
+        }
+    }
+
+    *lba_p = data_block_lba(file_p, blk_of_cluster);
+    count = MIN((size_t)(blocks_per_cluster - blk_of_cluster), count_max);
+
+    /* Extend the run as long as the next cluster in the chain is
+       also the next cluster on the device. */
+    while (count < count_max) {
+        cluster = file_p->cur_cluster;
+
+        if (next_cluster(file_p, allocate) != 0) {
+            file_p->cur_cluster = cluster;
+            break;
+        }
+
+        if (file_p->cur_cluster != cluster + 1) {
+            file_p->cur_cluster = cluster;
+            break;
         }
+
+        count += MIN((size_t)blocks_per_cluster, count_max - count);
     }
 
+    *count_p = count;
+
     return (0);
 }
 
+/**
+ * Read up to given number of whole blocks from the current position
+ * of given file directly into given buffer.
+ */
+static ssize_t file_read_blocks(struct fat16_file_t *file_p,
+                                void *dst_p,
+                                size_t count_max)
+{
+    struct fat16_t *self_p;
+    uint32_t lba;
+    size_t count;
+    ssize_t size;
+
+    self_p = file_p->fat16_p;
+
+    if (get_block_run(file_p, count_max, 0, &lba, &count) != 0) {
+        return (-1);
+    }
+
+    /* Modified cached blocks may be part of the run. */
+    if (cache_flush_range(self_p, lba, count) != 0) {
+        return (-1);
+    }
+
+    size = (count * BLOCK_SIZE);
+
+    if (self_p->read_blocks(self_p->arg_p, dst_p, lba, count) != size) {
+        return (-1);
+    }
+
+    file_p->cur_position += size;
+
+    return (size);
+}
+
+/**
+ * Write up to given number of whole blocks from given buffer directly
+ * to the current position of given file.
+ */
+static ssize_t file_write_blocks(struct fat16_file_t *file_p,
+                                 const void *src_p,
+                                 size_t count_max)
+{
+    struct fat16_t *self_p;
+    uint32_t lba;
+    size_t count;
+    ssize_t size;
+
+    self_p = file_p->fat16_p;
+
+    if (get_block_run(file_p, count_max, 1, &lba, &count) != 0) {
+        return (-1);
+    }
+
+    size = (count * BLOCK_SIZE);
+
+    if (self_p->write_blocks(self_p->arg_p, lba, src_p, count) != size) {
+        return (-1);
+    }
+
+    /* Drop cached copies of overwritten blocks. */
+    cache_invalidate_range(self_p, lba, count);
+
+    file_p->cur_position += size;
+
+    return (size);
+}
+
 static int file_open(struct fat16_t *self_p,
                      struct fat16_file_t *file_p,
                      const char* path_p,
@@ -1184,6 +1578,8 @@ ssize_t fat16_file_read(struct fat16_file_t *file_p,
     uint16_t block_offset;
     uint8_t *src_p, *dst_p;
     size_t n;
+    ssize_t res;
+    union fat16_cache16_t *buffer_p;
 
     /* Error if not open for read. */
     if (!(file_p->flags & O_READ)) {
@@ -1204,6 +1600,21 @@ ssize_t fat16_file_read(struct fat16_file_t *file_p,
                                           file_p->cur_position);
         block_offset = cache_data_offset(file_p->cur_position);
 
+        /* Read whole blocks directly into the caller's buffer. */
+        if ((block_offset == 0)
+            && (left >= BLOCK_SIZE)
+            && (file_p->fat16_p->read_blocks != NULL)) {
+            res = file_read_blocks(file_p, dst_p, left / BLOCK_SIZE);
+
+            if (res < 0) {
+                return (FAT16_EOF);
+            }
+
+            dst_p += res;
+            left -= res;
+            continue;
+        }
+
         if (blk_of_cluster == 0 && block_offset == 0) {
             /* Start next cluster. */
             if (file_p->cur_cluster == 0) {
@@ -1221,14 +1632,16 @@ ssize_t fat16_file_read(struct fat16_file_t *file_p,
         }
 
         /* Cache data block. */
-        if (cache_raw_block(file_p->fat16_p,
-                            data_block_lba(file_p, blk_of_cluster),
-                            CACHE_FOR_READ) != 0) {
+        buffer_p = cache_raw_block(file_p->fat16_p,
+                                   data_block_lba(file_p, blk_of_cluster),
+                                   CACHE_FOR_READ);
+
+        if (buffer_p == NULL) {
             return (FAT16_EOF);
         }
 
         /* Location of data in cache. */
-        src_p = file_p->fat16_p->cache.buffer.data + block_offset;
+        src_p = buffer_p->data + block_offset;
 
         /* Max number of byte available in block. */
         n = 512 - block_offset;
@@ -1260,7 +1673,9 @@ ssize_t fat16_file_write(struct fat16_file_t *file_p,
     uint16_t block_offset;
     uint8_t* dst_p;
     size_t n;
+    ssize_t res;
     const char *csrc_p;
+    union fat16_cache16_t *buffer_p;
 
     csrc_p = src_p;
 
@@ -1278,11 +1693,26 @@ ssize_t fat16_file_write(struct fat16_file_t *file_p,
     }
 
     while (left > 0) {
-        if (get_block(file_p, &block_offset) != 0) {
+        /* Write whole blocks directly from the caller's buffer. */
+        if ((cache_data_offset(file_p->cur_position) == 0)
+            && (left >= BLOCK_SIZE)
+            && (file_p->fat16_p->write_blocks != NULL)) {
+            res = file_write_blocks(file_p, csrc_p, left / BLOCK_SIZE);
+
+            if (res < 0) {
+                return (FAT16_EOF);
+            }
+
+            csrc_p += res;
+            left -= res;
+            continue;
+        }
+
+        if (get_block(file_p, &block_offset, &buffer_p) != 0) {
             return (FAT16_EOF);
         }
 
-        dst_p = file_p->fat16_p->cache.buffer.data + block_offset;
+        dst_p = buffer_p->data + block_offset;
 
         /* Max space in block. */
         n = 512 - block_offset;
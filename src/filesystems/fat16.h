@@ -154,6 +154,16 @@ typedef ssize_t (*fat16_write_t)(void *arg_p,
 /**
  * A FAT entry.
  */
+typedef ssize_t (*fat16_read_blocks_t)(void *arg_p,
+                                       void *dst_p,
+                                       uint32_t src_block,
+                                       size_t count);
+
+typedef ssize_t (*fat16_write_blocks_t)(void *arg_p,
+                                        uint32_t dst_block,
+                                        const void *src_p,
+                                        size_t count);
+
 typedef uint16_t fat_t;
 
 /**
@@ -502,17 +512,26 @@ union fat16_cache16_t {
     struct fbs_t fbs;
 };
 
-struct fat16_cache_t {
+struct fat16_cache_entry_t {
     uint32_t block_number;         /* Logical number of block in the cache */
     uint8_t dirty;                 /* cacheFlush() will write block if true */
     uint32_t mirror_block;         /* mirror block for second FAT */
+    uint32_t tick;                 /* Time of last use, for LRU replacement */
     union fat16_cache16_t buffer;  /* 512 byte cache for raw blocks */
 };
 
+struct fat16_cache_t {
+    uint32_t tick;
+    struct fat16_cache_entry_t entries[CONFIG_FAT16_CACHE_BLOCKS];
+};
+
 struct fat16_t {
     /* Data block read and wrte functions. */
     fat16_read_t read;
     fat16_write_t write;
+    /* Optional multiple data blocks read and write functions. */
+    fat16_read_blocks_t read_blocks;
+    fat16_write_blocks_t write_blocks;
     void *arg_p;
     unsigned int partition;
 
@@ -560,6 +579,17 @@ struct fat16_stat_t {
     int is_dir;
 };
 
+/**
+ * Initialize the fat16 module. This function must be called before
+ * calling any other function in this module.
+ *
+ * The module will only be initialized once even if this function is
+ * called multiple times.
+ *
+ * @return zero(0) or negative error code.
+ */
+int fat16_module_init(void);
+
 /**
  * Initialize a FAT16 volume.
  *
@@ -583,6 +613,26 @@ int fat16_init(struct fat16_t *self_p,
                void *arg_p,
                unsigned int partition);
 
+/**
+ * Set callback functions used to read and write multiple consecutive
+ * blocks in one transfer, for example sd_read_blocks() and
+ * sd_write_blocks(). When set, file reads and writes of whole blocks
+ * are transferred directly between the caller's buffer and the
+ * device, one run of consecutive clusters at a time, instead of one
+ * block at a time through the block cache.
+ *
+ * @param[in] self_p Initialized FAT16 object.
+ * @param[in] read_blocks Callback function used to read multiple
+ *                        blocks of data, or NULL.
+ * @param[in] write_blocks Callback function used to write multiple
+ *                         blocks of data, or NULL.
+ *
+ * @return zero(0) or negative error code.
+ */
+int fat16_set_multiple_blocks_callbacks(struct fat16_t *self_p,
+                                        fat16_read_blocks_t read_blocks,
+                                        fat16_write_blocks_t write_blocks);
+
 /**
  * Mount given FAT16 volume.
  *
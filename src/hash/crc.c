@@ -113,6 +113,212 @@ static FAR const uint16_t ccitt_tab[256] = {
     0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
 };
 
+#if CONFIG_CRC_SLICE_BY_8 == 1
+
+/* Table k - 1 has the CRC of each byte followed by k zero bytes. */
+#include "crc_tables.i"
+
+static uint32_t read_le32(const uint8_t *b_p)
+{
+    return (((uint32_t)b_p[0] << 0)
+            | ((uint32_t)b_p[1] << 8)
+            | ((uint32_t)b_p[2] << 16)
+            | ((uint32_t)b_p[3] << 24));
+}
+
+/**
+ * The CRC of eight bytes is the xor of the CRC of each byte followed
+ * by the remaining bytes as zeros, after the current CRC has been
+ * xored into the first bytes.
+ */
+static uint32_t crc32_slice_by_8(uint32_t crc,
+                                 const uint8_t *b_p,
+                                 size_t size)
+{
+    uint32_t high;
+
+    while (size >= 8) {
+        crc ^= read_le32(&b_p[0]);
+        high = read_le32(&b_p[4]);
+        crc = (crc32_slice_tab[6][crc & 0xff]
+               ^ crc32_slice_tab[5][(crc >> 8) & 0xff]
+               ^ crc32_slice_tab[4][(crc >> 16) & 0xff]
+               ^ crc32_slice_tab[3][crc >> 24]
+               ^ crc32_slice_tab[2][high & 0xff]
+               ^ crc32_slice_tab[1][(high >> 8) & 0xff]
+               ^ crc32_slice_tab[0][(high >> 16) & 0xff]
+               ^ crc32_tab[high >> 24]);
+        b_p += 8;
+        size -= 8;
+    }
+
+    while (size--) {
+        crc = crc32_tab[(crc ^ *b_p++) & 0xff] ^ (crc >> 8);
+    }
+
+    return (crc);
+}
+
+static uint16_t ccitt_slice_by_8(uint16_t crc,
+                                 const uint8_t *b_p,
+                                 size_t size)
+{
+    while (size >= 8) {
+        crc = (ccitt_slice_tab[6][b_p[0] ^ (crc >> 8)]
+               ^ ccitt_slice_tab[5][b_p[1] ^ (crc & 0xff)]
+               ^ ccitt_slice_tab[4][b_p[2]]
+               ^ ccitt_slice_tab[3][b_p[3]]
+               ^ ccitt_slice_tab[2][b_p[4]]
+               ^ ccitt_slice_tab[1][b_p[5]]
+               ^ ccitt_slice_tab[0][b_p[6]]
+               ^ ccitt_tab[b_p[7]]);
+        b_p += 8;
+        size -= 8;
+    }
+
+    while (size--) {
+        crc = (crc << 8) ^ ccitt_tab[(crc >> 8) ^ *b_p++];
+    }
+
+    return (crc);
+}
+
+#    if defined(ARCH_LINUX) && defined(__x86_64__)
+
+#include <immintrin.h>
+
+#define CRC32_CLMUL_SIZE_MIN                               64
+
+/**
+ * Fold 64 bytes at a time using carry-less multiplication, as
+ * described in Intel's "Fast CRC Computation for Generic Polynomials
+ * Using PCLMULQDQ Instruction". Given size must be at least 64 and a
+ * multiple of 16.
+ */
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_clmul(uint32_t crc,
+                            const uint8_t *b_p,
+                            size_t size)
+{
+    __m128i k1k2;
+    __m128i k3k4;
+    __m128i k5k0;
+    __m128i poly;
+    __m128i mask;
+    __m128i x1, x2, x3, x4, x5, x6, x7, x8;
+
+    k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+    poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    x1 = _mm_loadu_si128((const __m128i *)&b_p[0]);
+    x2 = _mm_loadu_si128((const __m128i *)&b_p[16]);
+    x3 = _mm_loadu_si128((const __m128i *)&b_p[32]);
+    x4 = _mm_loadu_si128((const __m128i *)&b_p[48]);
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+    b_p += 64;
+    size -= 64;
+
+    /* Fold four blocks of 16 bytes in parallel. */
+    while (size >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128((const __m128i *)&b_p[0]));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                           _mm_loadu_si128((const __m128i *)&b_p[16]));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                           _mm_loadu_si128((const __m128i *)&b_p[32]));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                           _mm_loadu_si128((const __m128i *)&b_p[48]));
+        b_p += 64;
+        size -= 64;
+    }
+
+    /* Fold the four blocks into one. */
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    /* Fold remaining blocks of 16 bytes. */
+    while (size >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128((const __m128i *)b_p));
+        b_p += 16;
+        size -= 16;
+    }
+
+    /* Fold 128 bits to 64 bits. */
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction to 32 bits. */
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), poly, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (_mm_extract_epi32(x1, 1));
+}
+
+static int crc32_clmul_supported(void)
+{
+    return (__builtin_cpu_supports("pclmul")
+            && __builtin_cpu_supports("sse4.1"));
+}
+
+#    endif
+
+uint32_t crc_32(uint32_t crc, const void *buf_p, size_t size)
+{
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    const uint8_t *b_p;
+
+    b_p = buf_p;
+    crc ^= 0xfffffffful;
+
+#    if defined(ARCH_LINUX) && defined(__x86_64__)
+    size_t clmul_size;
+
+    if ((size >= CRC32_CLMUL_SIZE_MIN) && crc32_clmul_supported()) {
+        clmul_size = (size & ~(size_t)15);
+        crc = crc32_clmul(crc, b_p, clmul_size);
+        b_p += clmul_size;
+        size -= clmul_size;
+    }
+#    endif
+
+    return (~crc32_slice_by_8(crc, b_p, size));
+}
+
+uint16_t crc_ccitt(uint16_t crc, const void *buf_p, size_t size)
+{
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    return (ccitt_slice_by_8(crc, buf_p, size));
+}
+
+#else
+
 uint32_t crc_32(uint32_t crc, const void *buf_p, size_t size)
 {
     ASSERTN(buf_p != NULL, EINVAL);
@@ -145,6 +351,8 @@ uint16_t crc_ccitt(uint16_t crc, const void *buf_p, size_t size)
     return (crc);
 }
 
+#endif
+
 #else
 
 uint32_t crc_32(uint32_t crc, const void *buf_p, size_t size)
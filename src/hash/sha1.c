@@ -30,76 +30,483 @@
 
 #include "simba.h"
 
-static inline uint32_t rotateleft(uint32_t value, int positions)
+#if (CONFIG_SHA1_SIMD == 1) && defined(ARCH_LINUX) && defined(__x86_64__)
+#    define SIMD_X86_64                                            1
+#else
+#    define SIMD_X86_64                                            0
+#endif
+
+#define ROL(value, positions)                                   \
+    (((value) << (positions)) | ((value) >> (32 - (positions))))
+
+#define K0                                                0x5a827999
+#define K1                                                0x6ed9eba1
+#define K2                                                0x8f1bbcdc
+#define K3                                                0xca62c1d6
+
+#define F0(b, c, d) ((d) ^ ((b) & ((c) ^ (d))))
+#define F1(b, c, d) ((b) ^ (c) ^ (d))
+#define F2(b, c, d) (((b) & (c)) | ((d) & ((b) | (c))))
+#define F3(b, c, d) F1(b, c, d)
+
+/* Only the last 16 words of the message schedule are needed to
+   calculate the next one, so they are kept in a ring. */
+#define W(i) w[(i) & 15]
+#define SCHEDULE(i)                                                     \
+    (((i) < 16)                                                         \
+     ? W(i)                                                             \
+     : (W(i) = ROL(W((i) + 13) ^ W((i) + 8) ^ W((i) + 2) ^ W(i), 1)))
+
+#define ROUND(a, b, c, d, e, f, k, i)                   \
+    e += (ROL(a, 5) + f(b, c, d) + k + SCHEDULE(i));    \
+    b = ROL(b, 30)
+
+/* Five rounds, after which the variables are back in place. */
+#define ROUNDS_5(f, k, i)                       \
+    ROUND(a, b, c, d, e, f, k, (i) + 0);        \
+    ROUND(e, a, b, c, d, f, k, (i) + 1);        \
+    ROUND(d, e, a, b, c, f, k, (i) + 2);        \
+    ROUND(c, d, e, a, b, f, k, (i) + 3);        \
+    ROUND(b, c, d, e, a, f, k, (i) + 4)
+
+typedef void (*blocks_update_t)(uint32_t *h_p,
+                                const uint8_t *buf_p,
+                                size_t count);
+
+/**
+ * A lane in a multi buffer update.
+ */
+struct lane_t {
+    uint32_t *h_p;
+    const uint8_t *buf_p;
+    size_t count;
+};
+
+static uint32_t read_be32(const uint8_t *buf_p)
+{
+    return (((uint32_t)buf_p[0] << 24)
+            | ((uint32_t)buf_p[1] << 16)
+            | ((uint32_t)buf_p[2] << 8)
+            | ((uint32_t)buf_p[3] << 0));
+}
+
+static void blocks_update_generic(uint32_t *h_p,
+                                  const uint8_t *buf_p,
+                                  size_t count)
+{
+    uint32_t a, b, c, d, e;
+    uint32_t w[16];
+    int i;
+
+    while (count > 0) {
+        for (i = 0; i < 16; i++) {
+            w[i] = read_be32(&buf_p[4 * i]);
+        }
+
+        a = h_p[0];
+        b = h_p[1];
+        c = h_p[2];
+        d = h_p[3];
+        e = h_p[4];
+
+        ROUNDS_5(F0, K0, 0);
+        ROUNDS_5(F0, K0, 5);
+        ROUNDS_5(F0, K0, 10);
+        ROUNDS_5(F0, K0, 15);
+        ROUNDS_5(F1, K1, 20);
+        ROUNDS_5(F1, K1, 25);
+        ROUNDS_5(F1, K1, 30);
+        ROUNDS_5(F1, K1, 35);
+        ROUNDS_5(F2, K2, 40);
+        ROUNDS_5(F2, K2, 45);
+        ROUNDS_5(F2, K2, 50);
+        ROUNDS_5(F2, K2, 55);
+        ROUNDS_5(F3, K3, 60);
+        ROUNDS_5(F3, K3, 65);
+        ROUNDS_5(F3, K3, 70);
+        ROUNDS_5(F3, K3, 75);
+
+        h_p[0] += a;
+        h_p[1] += b;
+        h_p[2] += c;
+        h_p[3] += d;
+        h_p[4] += e;
+
+        buf_p += 64;
+        count--;
+    }
+}
+
+#if SIMD_X86_64 == 1
+
+#include <immintrin.h>
+
+#define LANES_MAX                                                  8
+
+/* Four rounds using the SHA extensions. The message words needed
+   four rounds later are prepared in parallel. */
+#define SHA_NI_ROUNDS_4(e_next, e_prev, m0, m1, m2, m3, func)   \
+    e_next = _mm_sha1nexte_epu32(e_next, m0);                   \
+    e_prev = abcd;                                              \
+    m1 = _mm_sha1msg2_epu32(m1, m0);                            \
+    abcd = _mm_sha1rnds4_epu32(abcd, e_next, func);             \
+    m3 = _mm_sha1msg1_epu32(m3, m0);                            \
+    m2 = _mm_xor_si128(m2, m0)
+
+__attribute__((target("sha,sse4.1")))
+static void blocks_update_sha_ni(uint32_t *h_p,
+                                 const uint8_t *buf_p,
+                                 size_t count)
+{
+    __m128i abcd;
+    __m128i abcd_saved;
+    __m128i e0;
+    __m128i e0_saved;
+    __m128i e1;
+    __m128i msg0, msg1, msg2, msg3;
+    __m128i mask;
+
+    mask = _mm_set_epi64x(0x0001020304050607ull, 0x08090a0b0c0d0e0full);
+    abcd = _mm_loadu_si128((const __m128i *)h_p);
+    abcd = _mm_shuffle_epi32(abcd, 0x1b);
+    e0 = _mm_set_epi32(h_p[4], 0, 0, 0);
+
+    while (count > 0) {
+        abcd_saved = abcd;
+        e0_saved = e0;
+
+        /* Rounds 0-3. */
+        msg0 = _mm_loadu_si128((const __m128i *)&buf_p[0]);
+        msg0 = _mm_shuffle_epi8(msg0, mask);
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        /* Rounds 4-7. */
+        msg1 = _mm_loadu_si128((const __m128i *)&buf_p[16]);
+        msg1 = _mm_shuffle_epi8(msg1, mask);
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        /* Rounds 8-11. */
+        msg2 = _mm_loadu_si128((const __m128i *)&buf_p[32]);
+        msg2 = _mm_shuffle_epi8(msg2, mask);
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        /* Rounds 12-79. */
+        msg3 = _mm_loadu_si128((const __m128i *)&buf_p[48]);
+        msg3 = _mm_shuffle_epi8(msg3, mask);
+        SHA_NI_ROUNDS_4(e1, e0, msg3, msg0, msg1, msg2, 0);
+        SHA_NI_ROUNDS_4(e0, e1, msg0, msg1, msg2, msg3, 0);
+        SHA_NI_ROUNDS_4(e1, e0, msg1, msg2, msg3, msg0, 1);
+        SHA_NI_ROUNDS_4(e0, e1, msg2, msg3, msg0, msg1, 1);
+        SHA_NI_ROUNDS_4(e1, e0, msg3, msg0, msg1, msg2, 1);
+        SHA_NI_ROUNDS_4(e0, e1, msg0, msg1, msg2, msg3, 1);
+        SHA_NI_ROUNDS_4(e1, e0, msg1, msg2, msg3, msg0, 1);
+        SHA_NI_ROUNDS_4(e0, e1, msg2, msg3, msg0, msg1, 2);
+        SHA_NI_ROUNDS_4(e1, e0, msg3, msg0, msg1, msg2, 2);
+        SHA_NI_ROUNDS_4(e0, e1, msg0, msg1, msg2, msg3, 2);
+        SHA_NI_ROUNDS_4(e1, e0, msg1, msg2, msg3, msg0, 2);
+        SHA_NI_ROUNDS_4(e0, e1, msg2, msg3, msg0, msg1, 2);
+        SHA_NI_ROUNDS_4(e1, e0, msg3, msg0, msg1, msg2, 3);
+        SHA_NI_ROUNDS_4(e0, e1, msg0, msg1, msg2, msg3, 3);
+        SHA_NI_ROUNDS_4(e1, e0, msg1, msg2, msg3, msg0, 3);
+        SHA_NI_ROUNDS_4(e0, e1, msg2, msg3, msg0, msg1, 3);
+        SHA_NI_ROUNDS_4(e1, e0, msg3, msg0, msg1, msg2, 3);
+
+        e0 = _mm_sha1nexte_epu32(e0, e0_saved);
+        abcd = _mm_add_epi32(abcd, abcd_saved);
+
+        buf_p += 64;
+        count--;
+    }
+
+    abcd = _mm_shuffle_epi32(abcd, 0x1b);
+    _mm_storeu_si128((__m128i *)h_p, abcd);
+    h_p[4] = _mm_extract_epi32(e0, 3);
+}
+
+static uint32_t load32(const uint8_t *buf_p)
+{
+    uint32_t value;
+
+    memcpy(&value, buf_p, sizeof(value));
+
+    return (value);
+}
+
+#define AVX2_ROL(value, positions)                              \
+    _mm256_or_si256(_mm256_slli_epi32(value, positions),        \
+                    _mm256_srli_epi32(value, 32 - (positions)))
+
+#define AVX2_F0(b, c, d)                                                \
+    _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)))
+#define AVX2_F1(b, c, d)                                \
+    _mm256_xor_si256(_mm256_xor_si256(b, c), d)
+#define AVX2_F2(b, c, d)                                                \
+    _mm256_or_si256(_mm256_and_si256(b, c),                             \
+                    _mm256_and_si256(d, _mm256_or_si256(b, c)))
+#define AVX2_F3(b, c, d) AVX2_F1(b, c, d)
+
+#define AVX2_SCHEDULE(i)                                                \
+    (((i) < 16)                                                         \
+     ? W(i)                                                             \
+     : (W(i) = AVX2_ROL(_mm256_xor_si256(                               \
+                            _mm256_xor_si256(W((i) + 13), W((i) + 8)),  \
+                            _mm256_xor_si256(W((i) + 2), W(i))),        \
+                        1)))
+
+#define AVX2_ROUND(a, b, c, d, e, f, k, i)                              \
+    e = _mm256_add_epi32(                                               \
+        _mm256_add_epi32(e, AVX2_ROL(a, 5)),                            \
+        _mm256_add_epi32(f(b, c, d),                                    \
+                         _mm256_add_epi32(_mm256_set1_epi32(k),         \
+                                          AVX2_SCHEDULE(i))));          \
+    b = AVX2_ROL(b, 30)
+
+#define AVX2_ROUNDS_5(f, k, i)                          \
+    AVX2_ROUND(a, b, c, d, e, f, k, (i) + 0);           \
+    AVX2_ROUND(e, a, b, c, d, f, k, (i) + 1);           \
+    AVX2_ROUND(d, e, a, b, c, f, k, (i) + 2);           \
+    AVX2_ROUND(c, d, e, a, b, f, k, (i) + 3);           \
+    AVX2_ROUND(b, c, d, e, a, f, k, (i) + 4)
+
+/**
+ * Hash given number of blocks in eight lanes at the same time, one
+ * lane per 32 bits word in the AVX2 registers.
+ */
+__attribute__((target("avx2")))
+static void blocks_update_avx2_x8(struct lane_t **lanes_pp,
+                                  size_t count)
+{
+    __m256i a, b, c, d, e;
+    __m256i h[5];
+    __m256i w[16];
+    __m256i swap;
+    const uint8_t *bufs[LANES_MAX];
+    int i;
+    int j;
+
+    /* Byte swap each 32 bits word. */
+    swap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+                           4, 5, 6, 7, 0, 1, 2, 3,
+                           12, 13, 14, 15, 8, 9, 10, 11,
+                           4, 5, 6, 7, 0, 1, 2, 3);
+
+    for (i = 0; i < 5; i++) {
+        h[i] = _mm256_set_epi32(lanes_pp[7]->h_p[i],
+                                lanes_pp[6]->h_p[i],
+                                lanes_pp[5]->h_p[i],
+                                lanes_pp[4]->h_p[i],
+                                lanes_pp[3]->h_p[i],
+                                lanes_pp[2]->h_p[i],
+                                lanes_pp[1]->h_p[i],
+                                lanes_pp[0]->h_p[i]);
+    }
+
+    for (j = 0; j < LANES_MAX; j++) {
+        bufs[j] = lanes_pp[j]->buf_p;
+    }
+
+    while (count > 0) {
+        for (i = 0; i < 16; i++) {
+            w[i] = _mm256_shuffle_epi8(
+                _mm256_set_epi32(load32(&bufs[7][4 * i]),
+                                 load32(&bufs[6][4 * i]),
+                                 load32(&bufs[5][4 * i]),
+                                 load32(&bufs[4][4 * i]),
+                                 load32(&bufs[3][4 * i]),
+                                 load32(&bufs[2][4 * i]),
+                                 load32(&bufs[1][4 * i]),
+                                 load32(&bufs[0][4 * i])),
+                swap);
+        }
+
+        a = h[0];
+        b = h[1];
+        c = h[2];
+        d = h[3];
+        e = h[4];
+
+        AVX2_ROUNDS_5(AVX2_F0, K0, 0);
+        AVX2_ROUNDS_5(AVX2_F0, K0, 5);
+        AVX2_ROUNDS_5(AVX2_F0, K0, 10);
+        AVX2_ROUNDS_5(AVX2_F0, K0, 15);
+        AVX2_ROUNDS_5(AVX2_F1, K1, 20);
+        AVX2_ROUNDS_5(AVX2_F1, K1, 25);
+        AVX2_ROUNDS_5(AVX2_F1, K1, 30);
+        AVX2_ROUNDS_5(AVX2_F1, K1, 35);
+        AVX2_ROUNDS_5(AVX2_F2, K2, 40);
+        AVX2_ROUNDS_5(AVX2_F2, K2, 45);
+        AVX2_ROUNDS_5(AVX2_F2, K2, 50);
+        AVX2_ROUNDS_5(AVX2_F2, K2, 55);
+        AVX2_ROUNDS_5(AVX2_F3, K3, 60);
+        AVX2_ROUNDS_5(AVX2_F3, K3, 65);
+        AVX2_ROUNDS_5(AVX2_F3, K3, 70);
+        AVX2_ROUNDS_5(AVX2_F3, K3, 75);
+
+        h[0] = _mm256_add_epi32(h[0], a);
+        h[1] = _mm256_add_epi32(h[1], b);
+        h[2] = _mm256_add_epi32(h[2], c);
+        h[3] = _mm256_add_epi32(h[3], d);
+        h[4] = _mm256_add_epi32(h[4], e);
+
+        for (j = 0; j < LANES_MAX; j++) {
+            bufs[j] += 64;
+        }
+
+        count--;
+    }
+
+    for (i = 0; i < 5; i++) {
+        uint32_t values[LANES_MAX];
+
+        _mm256_storeu_si256((__m256i *)&values[0], h[i]);
+
+        for (j = 0; j < LANES_MAX; j++) {
+            lanes_pp[j]->h_p[i] = values[j];
+        }
+    }
+}
+
+/**
+ * Hash lanes with blocks left eight at a time, for as many blocks as
+ * the shortest of them has.
+ */
+static void lanes_update_avx2(struct lane_t *lanes_p,
+                              int length,
+                              blocks_update_t blocks_update)
 {
-    return ((value << positions) | (value >> (32 - positions)));
+    struct lane_t *active[LANES_MAX];
+    struct lane_t padding;
+    uint32_t padding_h[5];
+    size_t count;
+    int number_of_active;
+    int i;
+
+    while (1) {
+        number_of_active = 0;
+        count = SIZE_MAX;
+
+        for (i = 0; i < length; i++) {
+            if (lanes_p[i].count > 0) {
+                active[number_of_active++] = &lanes_p[i];
+                count = MIN(count, lanes_p[i].count);
+
+                if (number_of_active == LANES_MAX) {
+                    break;
+                }
+            }
+        }
+
+        if (number_of_active < 2) {
+            break;
+        }
+
+        /* Unused lanes hash the first lane's data into a scratch
+           state. */
+        memset(&padding_h[0], 0, sizeof(padding_h));
+        padding.h_p = &padding_h[0];
+        padding.buf_p = active[0]->buf_p;
+
+        for (i = number_of_active; i < LANES_MAX; i++) {
+            active[i] = &padding;
+        }
+
+        blocks_update_avx2_x8(&active[0], count);
+
+        for (i = 0; i < number_of_active; i++) {
+            active[i]->buf_p += (64 * count);
+            active[i]->count -= count;
+        }
+    }
+
+    for (i = 0; i < length; i++) {
+        blocks_update(lanes_p[i].h_p, lanes_p[i].buf_p, lanes_p[i].count);
+    }
+}
+
+#endif
+
+static blocks_update_t get_blocks_update(void)
+{
+#if SIMD_X86_64 == 1
+    if (__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1")) {
+        return (blocks_update_sha_ni);
+    }
+#endif
+
+    return (blocks_update_generic);
+}
+
+static void lanes_update(struct lane_t *lanes_p, int length)
+{
+    blocks_update_t blocks_update;
+    int i;
+
+    blocks_update = get_blocks_update();
+
+#if SIMD_X86_64 == 1
+    if (__builtin_cpu_supports("avx2")) {
+        lanes_update_avx2(lanes_p, length, blocks_update);
+
+        return;
+    }
+#endif
+
+    for (i = 0; i < length; i++) {
+        blocks_update(lanes_p[i].h_p, lanes_p[i].buf_p, lanes_p[i].count);
+    }
 }
 
 static void block_update(struct sha1_t *self_p,
                          uint8_t *block_p)
 {
-    uint32_t a ,b ,c ,d ,e, f, i ,t ,w[80];
-    uint32_t *b_p = (uint32_t *)block_p;
-
-    for (i = 0; i < 16; i++) {
-        w[i] = ntohl(b_p[i]);
-    }
-
-    for (i = 16; i < 80; i++) {
-        w[i] = rotateleft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
-    }
-
-    a = self_p->h[0];
-    b = self_p->h[1];
-    c = self_p->h[2];
-    d = self_p->h[3];
-    e = self_p->h[4];
-
-    for (i = 0; i < 20; i++) {
-        f = ((b & c) ^ (~b & d));
-        t = rotateleft(a, 5) + f + e + 0x5a827999 + w[i];
-        e = d;
-        d = c;
-        c = rotateleft(b, 30);
-        b = a;
-        a = t;
-    }
-
-    for (; i < 40; i++) {
-        f = (b ^ c ^ d);
-        t = rotateleft(a, 5) + f + e + 0x6ed9eba1 + w[i];
-        e = d;
-        d = c;
-        c = rotateleft(b, 30);
-        b = a;
-        a = t;
-    }
-
-    for (; i < 60; i++) {
-        f = ((b & c) ^ (b & d) ^ (c & d));
-        t = rotateleft(a, 5) + f + e + 0x8f1bbcdc + w[i];
-        e = d;
-        d = c;
-        c = rotateleft(b, 30);
-        b = a;
-        a = t;
-    }
-
-    for (; i < 80; i++) {
-        f = (b ^ c ^ d);
-        t = rotateleft(a,5) + f + e + 0xca62c1d6 + w[i];
-        e = d;
-        d = c;
-        c = rotateleft(b, 30);
-        b = a;
-        a = t;
-    }
-
-    self_p->h[0] += a;
-    self_p->h[1] += b;
-    self_p->h[2] += c;
-    self_p->h[3] += d;
-    self_p->h[4] += e;
+    get_blocks_update()(&self_p->h[0], block_p, 1);
+}
+
+/**
+ * Add given data to the partial block, returning the data that
+ * follows it.
+ */
+static uint8_t *update_begin(struct sha1_t *self_p,
+                             uint8_t *b_p,
+                             size_t *size_p)
+{
+    uint32_t temp;
+
+    self_p->size += *size_p;
+
+    /* Prologue: Fill the buffer. */
+    if (self_p->block.size > 0) {
+        if ((self_p->block.size + *size_p) >= 64) {
+            temp = (64 - self_p->block.size);
+            memcpy(&self_p->block.buf[self_p->block.size], b_p, temp);
+            *size_p -= temp;
+            b_p += temp;
+            block_update(self_p, self_p->block.buf);
+            self_p->block.size = 0;
+        }
+    }
+
+    return (b_p);
+}
+
+static void update_end(struct sha1_t *self_p,
+                       uint8_t *b_p,
+                       size_t size)
+{
+    /* Epilogue: Save left over block in buffer. */
+    if (size > 0) {
+        memcpy(&self_p->block.buf[self_p->block.size], b_p, size);
+        self_p->block.size += size;
+    }
 }
 
 int sha1_init(struct sha1_t *self_p)
@@ -124,35 +531,61 @@ int sha1_update(struct sha1_t *self_p,
     ASSERTN(self_p != NULL, EINVAL);
     ASSERTN(buf_p != NULL, EINVAL);
 
-    uint32_t temp;
-    uint8_t *b_p = buf_p;
+    uint8_t *b_p;
 
-    self_p->size += size;
+    b_p = update_begin(self_p, buf_p, &size);
 
-    /* Prologue: Fill the buffer. */
-    if (self_p->block.size > 0) {
-        if ((self_p->block.size + size) >= 64) {
-            temp = (64 - self_p->block.size);
-            memcpy(&self_p->block.buf[self_p->block.size], b_p, temp);
-            size -= temp;
-            b_p += temp;
-            block_update(self_p, self_p->block.buf);
-            self_p->block.size = 0;
+    /* Main loop. */
+    get_blocks_update()(&self_p->h[0], b_p, size / 64);
+    b_p += (size & ~(size_t)63);
+    update_end(self_p, b_p, size & 63);
+
+    return (0);
+}
+
+int sha1_update_multi(struct sha1_t **selfs_pp,
+                      void **bufs_pp,
+                      size_t *sizes_p,
+                      int length)
+{
+    ASSERTN(selfs_pp != NULL, EINVAL);
+    ASSERTN(bufs_pp != NULL, EINVAL);
+    ASSERTN(sizes_p != NULL, EINVAL);
+    ASSERTN(length >= 0, EINVAL);
+
+    struct lane_t lanes[CONFIG_SHA1_MULTI_LANES_MAX];
+    struct {
+        uint8_t *buf_p;
+        size_t size;
+    } tails[CONFIG_SHA1_MULTI_LANES_MAX];
+    size_t size;
+    int offset;
+    int number_of_lanes;
+    int i;
+
+    for (offset = 0; offset < length; offset += number_of_lanes) {
+        number_of_lanes = MIN(length - offset, CONFIG_SHA1_MULTI_LANES_MAX);
+
+        for (i = 0; i < number_of_lanes; i++) {
+            ASSERTN(selfs_pp[offset + i] != NULL, EINVAL);
+            ASSERTN(bufs_pp[offset + i] != NULL, EINVAL);
+
+            size = sizes_p[offset + i];
+            lanes[i].h_p = &selfs_pp[offset + i]->h[0];
+            lanes[i].buf_p = update_begin(selfs_pp[offset + i],
+                                          bufs_pp[offset + i],
+                                          &size);
+            lanes[i].count = (size / 64);
+            tails[i].buf_p = ((uint8_t *)lanes[i].buf_p
+                              + (size & ~(size_t)63));
+            tails[i].size = (size & 63);
         }
-    }
 
-    /* Main loop. */
-    while (size >= 64) {
-        memcpy(&self_p->block.buf[0], b_p, 64);
-        block_update(self_p, self_p->block.buf);
-        size -= 64;
-        b_p += 64;
-    }
+        lanes_update(&lanes[0], number_of_lanes);
 
-    /* Epilogue: Save left over block in buffer. */
-    if (size > 0) {
-        memcpy(&self_p->block.buf[self_p->block.size], b_p, size);
-        self_p->block.size += size;
+        for (i = 0; i < number_of_lanes; i++) {
+            update_end(selfs_pp[offset + i], tails[i].buf_p, tails[i].size);
+        }
     }
 
     return (0);
@@ -79,4 +79,21 @@ int sha1_update(struct sha1_t *self_p,
 int sha1_digest(struct sha1_t *self_p,
                 uint8_t *hash_p);
 
+/**
+ * Update each of given SHA1 objects with its own buffer. Equivalent
+ * to calling `sha1_update()` once per object, but the buffers are
+ * hashed in parallel on CPUs with AVX2.
+ *
+ * @param[in] selfs_pp SHA1 objects.
+ * @param[in] bufs_pp Buffer to update each sha object with.
+ * @param[in] sizes_p Size of each buffer.
+ * @param[in] length Number of SHA1 objects, buffers and sizes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int sha1_update_multi(struct sha1_t **selfs_pp,
+                      void **bufs_pp,
+                      size_t *sizes_p,
+                      int length);
+
 #endif
@@ -30,81 +30,243 @@
 
 #include "simba.h"
 
-static const FAR char ok_fmt[] =
-    "HTTP/1.1 200 OK\r\n"
-    "Content-Type: %s\r\n"
-    "Content-Length: %d\r\n"
-    "\r\n";
+/* Response header templates. A response header is a status line
+   template, a content type template, the content length and an empty
+   line. */
+static const FAR char ok_header[] =
+    "HTTP/1.1 200 OK\r\n";
 
-static const FAR char unauthorized_fmt[] =
+static const FAR char bad_request_header[] =
+    "HTTP/1.1 400 Bad Request\r\n";
+
+static const FAR char unauthorized_header[] =
     "HTTP/1.1 401 Unauthorized\r\n"
-    "WWW-Authenticate: Basic realm=\"\"\r\n"
-    "Content-Type: %s\r\n"
-    "Content-Length: %d\r\n"
-    "\r\n";
+    "WWW-Authenticate: Basic realm=\"\"\r\n";
 
-static const FAR char not_found_fmt[] =
-    "HTTP/1.1 404 Not Found\r\n"
-    "Content-Type: %s\r\n"
-    "Content-Length: %d\r\n"
-    "\r\n";
+static const FAR char not_found_header[] =
+    "HTTP/1.1 404 Not Found\r\n";
 
-static const FAR char bad_request_header[] =
+static const FAR char text_plain_header[] =
+    "Content-Type: text/plain\r\n"
+    "Content-Length: ";
+
+static const FAR char text_html_header[] =
+    "Content-Type: text/html\r\n"
+    "Content-Length: ";
+
+static const FAR char bad_request[] =
     "HTTP/1.1 400 Bad Request\r\n"
     "Content-Type: text/plain\r\n"
     "Content-Length: 32\r\n"
     "\r\n"
     "Failed to parse the HTTP header.";
 
-static int read_initial_request_line(void *chan_p,
-                                     char *buf_p,
-                                     struct http_server_request_t *request_p)
+static ssize_t input_read(struct http_server_connection_input_t *self_p,
+                          void *buf_p,
+                          size_t size)
 {
-    char *action_p = NULL;
-    char *path_p = NULL;
-    char *proto_p = NULL;
-    size_t size;
+    size_t left;
+    ssize_t res;
 
-    *buf_p++ = '\0';
-    action_p = buf_p;
-    size = 0;
+    /* Buffered data first. */
+    left = MIN(size, self_p->end - self_p->begin);
+    memcpy(buf_p, &self_p->buf[self_p->begin], left);
+    self_p->begin += left;
 
-    while (1) {
-        if (size == CONFIG_HTTP_SERVER_REQUEST_BUFFER_SIZE) {
-            return (-ENOMEM);
-        }
+    if (left < size) {
+        /* Then read directly from the underlying channel. */
+        res = chan_read(self_p->chan_p, (char *)buf_p + left, size - left);
 
-        if (chan_read(chan_p, buf_p, sizeof(*buf_p)) != sizeof(*buf_p)) {
-            return (-EIO);
+        if (res < 0) {
+            return (res);
         }
 
-        buf_p++;
+        left += res;
+    }
+
+    self_p->body_left -= MIN(left, self_p->body_left);
+
+    return (left);
+}
+
+static ssize_t input_write(struct http_server_connection_input_t *self_p,
+                           const void *buf_p,
+                           size_t size)
+{
+    return (chan_write(self_p->chan_p, buf_p, size));
+}
+
+static size_t input_size(struct http_server_connection_input_t *self_p)
+{
+    return ((self_p->end - self_p->begin) + chan_size(self_p->chan_p));
+}
+
+static void input_init(struct http_server_connection_input_t *self_p,
+                       void *chan_p)
+{
+    chan_init(&self_p->base,
+              (chan_read_fn_t)input_read,
+              (chan_write_fn_t)input_write,
+              (chan_size_fn_t)input_size);
+    self_p->chan_p = chan_p;
+    self_p->begin = 0;
+    self_p->end = 0;
+    self_p->body_left = 0;
+}
+
+/**
+ * Read more data from the underlying channel into the input
+ * buffer. Reads all available data that fits in the buffer, but at
+ * least one byte.
+ */
+static ssize_t input_fill(struct http_server_connection_input_t *self_p)
+{
+    ssize_t size;
+    ssize_t left;
+
+    /* Move the unparsed data to the beginning of the buffer. */
+    if (self_p->begin > 0) {
+        memmove(&self_p->buf[0],
+                &self_p->buf[self_p->begin],
+                self_p->end - self_p->begin);
+        self_p->end -= self_p->begin;
+        self_p->begin = 0;
+    }
+
+    left = (sizeof(self_p->buf) - self_p->end);
+
+    if (left == 0) {
+        return (-ENOMEM);
+    }
+
+    size = (ssize_t)chan_size(self_p->chan_p);
+
+    if (size <= 0) {
+        size = 1;
+    } else if (size > left) {
+        size = left;
+    }
+
+    size = chan_read(self_p->chan_p, &self_p->buf[self_p->end], size);
 
-        /* The line ending is "\r\n". */
-        if ((buf_p[-2] == '\r') && (buf_p[-1] == '\n')) {
-            buf_p[-2] = '\0';
+    if (size <= 0) {
+        return (-EIO);
+    }
+
+    self_p->end += size;
+
+    return (size);
+}
+
+/**
+ * Read a line ending with "\r\n" from the input buffer. The line is
+ * null terminated in place and is valid until the next line is read.
+ */
+static ssize_t input_read_line(struct http_server_connection_input_t *self_p,
+                               char **line_pp)
+{
+    char *line_p;
+    char *end_p;
+    ssize_t res;
+    size_t size;
+
+    while (1) {
+        line_p = &self_p->buf[self_p->begin];
+        end_p = memchr(line_p, '\n', self_p->end - self_p->begin);
+
+        if (end_p != NULL) {
             break;
         }
 
-        /* Action and path has ' ' as terminator. */
-        if (buf_p[-1] == ' ') {
-            buf_p[-1] = '\0';
+        res = input_fill(self_p);
 
-            if (path_p == NULL) {
-                path_p = buf_p;
-            } else if (proto_p == NULL) {
-                proto_p = buf_p;
-            }
+        if (res < 0) {
+            return (res);
+        }
+    }
+
+    size = (end_p - line_p);
+
+    if ((size == 0) || (end_p[-1] != '\r')) {
+        return (-EPROTO);
+    }
+
+    size--;
+    line_p[size] = '\0';
+    self_p->begin += (size + 2);
+    *line_pp = line_p;
+
+    return (size);
+}
+
+/**
+ * Discard the request body bytes not read by the route callback, so
+ * the next request can be parsed.
+ *
+ * @return zero(0) or negative error code.
+ */
+static int input_discard_body(struct http_server_connection_input_t *self_p)
+{
+    size_t size;
+
+    if (self_p->body_left > CONFIG_HTTP_SERVER_BODY_DISCARD_SIZE_MAX) {
+        return (-EMSGSIZE);
+    }
+
+    /* Buffered data first. */
+    size = MIN(self_p->body_left, self_p->end - self_p->begin);
+    self_p->begin += size;
+    self_p->body_left -= size;
+
+    /* Then from the underlying channel, using the empty input buffer
+       as scratch. */
+    while (self_p->body_left > 0) {
+        self_p->begin = 0;
+        self_p->end = 0;
+        size = MIN(self_p->body_left, sizeof(self_p->buf));
+
+        if (chan_read(self_p->chan_p, &self_p->buf[0], size) != size) {
+            return (-EIO);
         }
 
-        size++;
+        self_p->body_left -= size;
+    }
+
+    return (0);
+}
+
+static int read_initial_request_line(struct http_server_connection_input_t *input_p,
+                                     struct http_server_request_t *request_p)
+{
+    char *action_p;
+    char *path_p;
+    char *proto_p;
+    ssize_t res;
+    size_t size;
+
+    res = input_read_line(input_p, &action_p);
+
+    if (res < 0) {
+        return (res);
     }
 
+    /* Action and path has ' ' as terminator. */
+    path_p = strchr(action_p, ' ');
+
+    if (path_p == NULL) {
+        return (-1);
+    }
+
+    *path_p++ = '\0';
+    proto_p = strchr(path_p, ' ');
+
     /* Path and protocol are mandatory. */
-    if ((path_p == NULL) || (proto_p == NULL)) {
+    if (proto_p == NULL) {
         return (-1);
     }
 
+    *proto_p++ = '\0';
+
     log_object_print(NULL,
                      LOG_DEBUG,
                      OSTR("%s %s %s\r\n"), action_p, path_p, proto_p);
@@ -122,54 +284,42 @@ static int read_initial_request_line(void *chan_p,
         return (-1);
     }
 
+    /* Persistent connections are default in HTTP/1.1. */
+    request_p->keep_alive = (strcmp(proto_p, "HTTP/1.1") == 0);
+
     return (0);
 }
 
-static int read_header_line(void *chan_p,
-                            char *buf_p,
+static int read_header_line(struct http_server_connection_input_t *input_p,
                             char **header_pp,
                             char **value_pp)
 {
-    size_t size;
-    *buf_p++ = '\0';
-    *header_pp = buf_p;
-    *value_pp = NULL;
-    size = 0;
-
-    while (1) {
-        if (size == CONFIG_HTTP_SERVER_REQUEST_BUFFER_SIZE) {
-            return (-ENOMEM);
-        }
+    ssize_t res;
+    char *value_p;
 
-        if (chan_read(chan_p, buf_p, sizeof(*buf_p)) != sizeof(*buf_p)) {
-            return (-EIO);
-        }
+    *value_pp = NULL;
+    res = input_read_line(input_p, header_pp);
 
-        buf_p++;
+    if (res < 0) {
+        return (res);
+    }
 
-        /* The line ending is "\r\n". */
-        if ((buf_p[-2] == '\r') && (buf_p[-1] == '\n')) {
-            buf_p[-2] = '\0';
-            break;
-        }
+    /* Empty line. */
+    if (res == 0) {
+        return (1);
+    }
 
-        /* Value starts after ': '. */
-        if ((buf_p[-2] == ':') && (buf_p[-1] == ' ')) {
-            if (*value_pp == NULL) {
-                buf_p[-2] = '\0';
-                *value_pp = buf_p;
-            }
-        }
+    /* Value starts after ': '. */
+    value_p = strstr(*header_pp, ": ");
 
-        size++;
+    if (value_p == NULL) {
+        return (-1);
     }
 
-    if (*value_pp != NULL) {
-        return (0);
-    } else {
-        /* Empty line. */
-        return (1);
-    }
+    *value_p = '\0';
+    *value_pp = (value_p + 2);
+
+    return (0);
 }
 
 static int read_request(struct http_server_t *self_p,
@@ -177,28 +327,23 @@ static int read_request(struct http_server_t *self_p,
                         struct http_server_request_t *request_p)
 {
     int res;
-    char buf[CONFIG_HTTP_SERVER_REQUEST_BUFFER_SIZE];
     char *header_p;
     char *value_p;
     size_t size;
 
     /* Read the intial line in the request. */
-    res = read_initial_request_line(connection_p->chan_p,
-                                    buf,
-                                    request_p);
+    res = read_initial_request_line(&connection_p->input, request_p);
 
     if (res != 0) {
         return (res);
     }
 
     memset(&request_p->headers, 0, sizeof(request_p->headers));
+    connection_p->input.body_left = 0;
 
     /* Read the header lines. */
     while (1) {
-        res = read_header_line(connection_p->chan_p,
-                               buf,
-                               &header_p,
-                               &value_p);
+        res = read_header_line(&connection_p->input, &header_p, &value_p);
 
         if (res == 1) {
             break;
@@ -222,6 +367,11 @@ static int read_request(struct http_server_t *self_p,
         } else if (strcmp(header_p, "Content-Length") == 0) {
             if (std_strtol(value_p, &request_p->headers.content_length.value) != NULL) {
                 request_p->headers.content_length.present = 1;
+
+                if (request_p->headers.content_length.value > 0) {
+                    connection_p->input.body_left =
+                        request_p->headers.content_length.value;
+                }
             }
         } else if (strcmp(header_p, "Authorization") == 0) {
             request_p->headers.authorization.present = 1;
@@ -233,6 +383,20 @@ static int read_request(struct http_server_t *self_p,
             size = sizeof(request_p->headers.expect.value);
             strncpy(request_p->headers.expect.value, value_p, size - 1);
             request_p->headers.expect.value[size - 1] = '\0';
+        } else if (strcmp(header_p, "Connection") == 0) {
+            request_p->headers.connection.present = 1;
+            size = sizeof(request_p->headers.connection.value);
+            strncpy(request_p->headers.connection.value, value_p, size - 1);
+            request_p->headers.connection.value[size - 1] = '\0';
+
+            /* An upgraded connection is never used for HTTP again. */
+            if ((strstr(value_p, "close") != NULL)
+                || (strstr(value_p, "Upgrade") != NULL)
+                || (strstr(value_p, "upgrade") != NULL)) {
+                request_p->keep_alive = 0;
+            } else if (strstr(value_p, "keep-alive") != NULL) {
+                request_p->keep_alive = 1;
+            }
         }
     }
 
@@ -240,27 +404,287 @@ static int read_request(struct http_server_t *self_p,
 }
 
 /**
- * Search for given path in the routes array and return its callback.
+ * Get the next segment in given path. Segments are separated by '/'
+ * and the path ends at the query string, if any.
+ *
+ * @return true(1) if a segment was found, otherwise false(0).
  */
-static http_server_route_callback_t
-find_route_callback(struct http_server_t *self_p,
-                    const char *path_p)
+static int next_segment(const char **path_pp,
+                        const char **segment_pp,
+                        size_t *size_p)
+{
+    const char *path_p;
+
+    path_p = *path_pp;
+
+    while (*path_p == '/') {
+        path_p++;
+    }
+
+    *segment_pp = path_p;
+
+    while ((*path_p != '\0') && (*path_p != '/') && (*path_p != '?')) {
+        path_p++;
+    }
+
+    *size_p = (path_p - *segment_pp);
+
+    if (*path_p == '?') {
+        *path_pp = "";
+    } else {
+        *path_pp = path_p;
+    }
+
+    return (*size_p > 0);
+}
+
+static int route_trie_add(struct http_server_t *self_p,
+                          const struct http_server_route_t *route_p)
+{
+    struct http_server_route_node_t *nodes_p;
+    const char *path_p;
+    const char *segment_p;
+    size_t size;
+    int parent;
+    int child;
+
+    nodes_p = &self_p->trie.nodes[0];
+    path_p = route_p->path_p;
+    parent = 0;
+
+    while (next_segment(&path_p, &segment_p, &size)) {
+        if (size > 255) {
+            return (-ENAMETOOLONG);
+        }
+
+        child = nodes_p[parent].child;
+
+        while (child != -1) {
+            if ((nodes_p[child].segment_size == size)
+                && (memcmp(nodes_p[child].segment_p, segment_p, size) == 0)) {
+                break;
+            }
+
+            child = nodes_p[child].sibling;
+        }
+
+        /* Add a node for a new segment. */
+        if (child == -1) {
+            if (self_p->trie.length == membersof(self_p->trie.nodes)) {
+                return (-ENOMEM);
+            }
+
+            child = self_p->trie.length++;
+            nodes_p[child].segment_p = segment_p;
+            nodes_p[child].segment_size = size;
+            nodes_p[child].route_p = NULL;
+            nodes_p[child].child = -1;
+            nodes_p[child].sibling = nodes_p[parent].child;
+            nodes_p[parent].child = child;
+        }
+
+        parent = child;
+    }
+
+    /* The first route wins if there are duplicates. */
+    if (nodes_p[parent].route_p == NULL) {
+        nodes_p[parent].route_p = route_p;
+    }
+
+    return (0);
+}
+
+static int route_trie_init(struct http_server_t *self_p)
 {
     const struct http_server_route_t *route_p;
+    int res;
+
+    self_p->trie.nodes[0].segment_p = "";
+    self_p->trie.nodes[0].segment_size = 0;
+    self_p->trie.nodes[0].route_p = NULL;
+    self_p->trie.nodes[0].child = -1;
+    self_p->trie.nodes[0].sibling = -1;
+    self_p->trie.length = 1;
 
     route_p = self_p->routes_p;
 
     while (route_p->path_p != NULL) {
-        if (strncmp(route_p->path_p, path_p, strlen(route_p->path_p)) == 0) {
-            return (route_p->callback);
+        res = route_trie_add(self_p, route_p);
+
+        if (res != 0) {
+            return (res);
         }
 
         route_p++;
     }
 
-    return (NULL);
+    return (0);
+}
+
+/**
+ * A parameter node to retry if the literal segment next to it does
+ * not lead to a deeper route.
+ */
+struct route_trie_branch_t {
+    const char *path_p;
+    int16_t node;
+    uint8_t depth;
+    uint8_t params_length;
+};
+
+static void request_add_param(struct http_server_request_t *request_p,
+                              const struct http_server_route_node_t *node_p,
+                              const char *segment_p,
+                              size_t size)
+{
+    struct http_server_request_param_t *param_p;
+
+    param_p = &request_p->params.items[request_p->params.length++];
+    param_p->name_p = (node_p->segment_p + 1);
+    param_p->name_size = (node_p->segment_size - 2);
+    param_p->value_p = segment_p;
+    param_p->value_size = size;
+}
+
+/**
+ * Walk the route trie one request path segment at a time and return
+ * the deepest route found. Literal segments are tried before
+ * parameters. A parameter next to a literal segment is retried if
+ * the literal segment does not lead to a deeper route.
+ */
+static const struct http_server_route_t *
+route_trie_find(struct http_server_t *self_p,
+                struct http_server_request_t *request_p)
+{
+    const struct http_server_route_node_t *nodes_p;
+    const struct http_server_route_node_t *node_p;
+    const struct http_server_route_t *route_p;
+    struct http_server_request_param_t params[CONFIG_HTTP_SERVER_ROUTE_PARAMS_MAX];
+    struct route_trie_branch_t branches[CONFIG_HTTP_SERVER_ROUTE_PARAMS_MAX];
+    struct route_trie_branch_t *branch_p;
+    const char *path_p;
+    const char *segment_path_p;
+    const char *segment_p;
+    size_t size;
+    int node;
+    int child;
+    int sibling;
+    int param;
+    int depth;
+    int route_depth;
+    int params_length;
+    int params_saved;
+    int branches_length;
+
+    nodes_p = &self_p->trie.nodes[0];
+    path_p = &request_p->path[0];
+    node = 0;
+    depth = 0;
+    route_p = nodes_p[0].route_p;
+    route_depth = 0;
+    request_p->params.length = 0;
+    params_length = 0;
+    params_saved = 0;
+    branches_length = 0;
+
+    while (1) {
+        segment_path_p = path_p;
+        child = -1;
+
+        if (next_segment(&path_p, &segment_p, &size)) {
+            param = -1;
+            sibling = nodes_p[node].child;
+
+            while (sibling != -1) {
+                node_p = &nodes_p[sibling];
+
+                if (node_p->segment_p[0] == '{') {
+                    param = sibling;
+                } else if ((node_p->segment_size == size)
+                           && (memcmp(node_p->segment_p, segment_p, size) == 0)) {
+                    child = sibling;
+                }
+
+                sibling = node_p->sibling;
+            }
+
+            if (request_p->params.length == membersof(request_p->params.items)) {
+                param = -1;
+            }
+
+            if (child == -1) {
+                if (param != -1) {
+                    child = param;
+                    request_add_param(request_p,
+                                      &nodes_p[child],
+                                      segment_p,
+                                      size);
+                }
+            } else if ((param != -1)
+                       && (branches_length < membersof(branches))) {
+                branch_p = &branches[branches_length++];
+                branch_p->path_p = segment_path_p;
+                branch_p->node = param;
+                branch_p->depth = depth;
+                branch_p->params_length = request_p->params.length;
+            }
+        }
+
+        /* Dead end. Retry the last remembered parameter. */
+        if (child == -1) {
+            if (branches_length == 0) {
+                break;
+            }
+
+            /* The parameters of the matched route are overwritten
+               when walking the parameter branch. */
+            if (params_saved == 0) {
+                memcpy(&params[0],
+                       &request_p->params.items[0],
+                       params_length * sizeof(params[0]));
+                params_saved = 1;
+            }
+
+            branch_p = &branches[--branches_length];
+            path_p = branch_p->path_p;
+            (void)next_segment(&path_p, &segment_p, &size);
+            child = branch_p->node;
+            depth = branch_p->depth;
+            request_p->params.length = branch_p->params_length;
+            request_add_param(request_p, &nodes_p[child], segment_p, size);
+        }
+
+        node = child;
+        depth++;
+
+        /* Only deeper routes, so literal segments win ties. */
+        if ((nodes_p[node].route_p != NULL) && (depth > route_depth)) {
+            route_p = nodes_p[node].route_p;
+            route_depth = depth;
+            params_length = request_p->params.length;
+            params_saved = 0;
+        }
+    }
+
+    /* Only keep the parameters of the matched route. */
+    if (params_saved == 1) {
+        memcpy(&request_p->params.items[0],
+               &params[0],
+               params_length * sizeof(params[0]));
+    }
+
+    request_p->params.length = params_length;
+
+    return (route_p);
 }
 
+/**
+ * Read and handle one request.
+ *
+ * @return zero(0) if the connection should be kept open for more
+ *         requests, one(1) if it should be closed, or negative error
+ *         code.
+ */
 static int handle_request(struct http_server_t *self_p,
                           struct http_server_connection_t *connection_p)
 {
@@ -272,21 +696,89 @@ static int handle_request(struct http_server_t *self_p,
     res = read_request(self_p, connection_p, &request);
 
     if (res != 0) {
-        /* Reply with a Bad Request if the header could not be read.*/
-        std_fprintf(connection_p->chan_p, bad_request_header);
+        /* Reply with a Bad Request if the header could not be
+           read. Nothing to reply if the client closed the
+           connection. */
+        if (res != -EIO) {
+            std_fprintf(connection_p->chan_p, bad_request);
+        }
 
         return (res);
     }
 
     /* Find the callback for given path. */
-    callback = find_route_callback(self_p, request.path);
+    callback = http_server_find_route(self_p, &request);
 
     if (callback == NULL) {
         callback = self_p->on_no_route;
     }
 
     /* Call the callback and write the response if requested. */
-    return (callback(connection_p, &request));
+    res = callback(connection_p, &request);
+
+    if (res < 0) {
+        return (res);
+    }
+
+    if (request.keep_alive == 0) {
+        return (1);
+    }
+
+    /* Close the connection if the rest of the body cannot be
+       skipped. */
+    if (input_discard_body(&connection_p->input) != 0) {
+        return (1);
+    }
+
+    return (0);
+}
+
+/**
+ * Wait for the next request on given connection.
+ *
+ * @return zero(0) if data is available, or -ETIMEDOUT if the
+ *         connection has been idle for too long.
+ */
+static int wait_for_request(struct http_server_connection_t *connection_p)
+{
+    struct time_t timeout;
+
+    if (chan_size(&connection_p->input) > 0) {
+        return (0);
+    }
+
+    timeout.seconds = (CONFIG_HTTP_SERVER_IDLE_TIMEOUT_MS / 1000);
+    timeout.nanoseconds = (CONFIG_HTTP_SERVER_IDLE_TIMEOUT_MS % 1000) * 1000000;
+
+    if (chan_poll(&connection_p->socket, &timeout) == NULL) {
+        log_object_print(NULL,
+                         LOG_DEBUG,
+                         OSTR("Closing idle connection.\r\n"));
+
+        return (-ETIMEDOUT);
+    }
+
+    return (0);
+}
+
+/**
+ * Handle requests until the connection should be closed. Pipelined
+ * requests are parsed from the input buffer.
+ */
+static void handle_requests(struct http_server_t *self_p,
+                            struct http_server_connection_t *connection_p)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_HTTP_SERVER_KEEP_ALIVE_REQUESTS_MAX; i++) {
+        if (wait_for_request(connection_p) != 0) {
+            break;
+        }
+
+        if (handle_request(self_p, connection_p) != 0) {
+            break;
+        }
+    }
 }
 
 /**
@@ -321,10 +813,15 @@ static void *connection_main(void *arg_p)
                                 &connection_p->socket,
                                 SSL_SOCKET_SERVER_SIDE,
                                 NULL);
+                input_init(&connection_p->input, &connection_p->ssl_socket);
+            } else {
+                input_init(&connection_p->input, &connection_p->socket);
             }
+#else
+            input_init(&connection_p->input, &connection_p->socket);
 #endif
 
-            handle_request(self_p, connection_p);
+            handle_requests(self_p, connection_p);
 
 #if CONFIG_HTTP_SERVER_SSL == 1
             if (self_p->ssl_context_p != NULL) {
@@ -469,6 +966,7 @@ int http_server_init(struct http_server_t *self_p,
     ASSERTN(on_no_route != NULL, EINVAL);
 
     struct http_server_connection_t *connection_p;
+    int res;
 
     self_p->listener_p = listener_p;
     self_p->connections_p = connections_p;
@@ -477,6 +975,12 @@ int http_server_init(struct http_server_t *self_p,
     self_p->on_no_route = on_no_route;
     self_p->ssl_context_p = NULL;
 
+    res = route_trie_init(self_p);
+
+    if (res != 0) {
+        return (res);
+    }
+
     connection_p = self_p->connections_p;
 
     while (connection_p->thrd.name_p != NULL) {
@@ -525,15 +1029,7 @@ int http_server_start(struct http_server_t *self_p)
 
     /* Spawn the connection threads. */
     while (connection_p->thrd.stack.buf_p != NULL) {
-#if CONFIG_HTTP_SERVER_SSL == 1
-        if (self_p->ssl_context_p == NULL) {
-            connection_p->chan_p = &connection_p->socket;
-        } else {
-            connection_p->chan_p = &connection_p->ssl_socket;
-        }
-#else
-        connection_p->chan_p = &connection_p->socket;
-#endif
+        connection_p->chan_p = &connection_p->input;
 
         connection_p->thrd.id_p =
             thrd_spawn(connection_main,
@@ -555,6 +1051,71 @@ int http_server_stop(struct http_server_t *self_p)
     return (0);
 }
 
+http_server_route_callback_t
+http_server_find_route(struct http_server_t *self_p,
+                       struct http_server_request_t *request_p)
+{
+    ASSERTNRN(self_p != NULL, EINVAL);
+    ASSERTNRN(request_p != NULL, EINVAL);
+
+    const struct http_server_route_t *route_p;
+    http_server_route_callback_t callback;
+
+    route_p = route_trie_find(self_p, request_p);
+
+    if (route_p == NULL) {
+        return (NULL);
+    }
+
+    callback = NULL;
+
+    if (request_p->action == http_server_request_action_get_t) {
+        callback = route_p->methods.get;
+    } else if (request_p->action == http_server_request_action_post_t) {
+        callback = route_p->methods.post;
+    }
+
+    if (callback == NULL) {
+        callback = route_p->callback;
+    }
+
+    return (callback);
+}
+
+ssize_t http_server_request_get_param(struct http_server_request_t *request_p,
+                                      const char *name_p,
+                                      char *buf_p,
+                                      size_t size)
+{
+    ASSERTN(request_p != NULL, EINVAL);
+    ASSERTN(name_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    struct http_server_request_param_t *param_p;
+    size_t name_size;
+    int i;
+
+    name_size = strlen(name_p);
+
+    for (i = 0; i < request_p->params.length; i++) {
+        param_p = &request_p->params.items[i];
+
+        if ((param_p->name_size == name_size)
+            && (memcmp(param_p->name_p, name_p, name_size) == 0)) {
+            if (param_p->value_size >= size) {
+                return (-ENOMEM);
+            }
+
+            memcpy(buf_p, param_p->value_p, param_p->value_size);
+            buf_p[param_p->value_size] = '\0';
+
+            return (param_p->value_size);
+        }
+    }
+
+    return (-ENOENT);
+}
+
 int http_server_response_write(struct http_server_connection_t *connection_p,
                                struct http_server_request_t *request_p,
                                struct http_server_response_t *response_p)
@@ -563,42 +1124,62 @@ int http_server_response_write(struct http_server_connection_t *connection_p,
     ASSERTN(request_p != NULL, EINVAL);
     ASSERTN(response_p != NULL, EINVAL);
 
-    int res = 0;
-    ssize_t size;
-    char buf[128];
-    char *content_type_p;
+    ssize_t res;
+    size_t size;
+    size_t content_size;
+    char buf[160];
+    char digits[20];
+    int i;
+
+    /* Status line. The templates may be in far memory. */
+    if (response_p->code == http_server_response_code_200_ok_t) {
+        size = std_strcpy(&buf[0], ok_header);
+    } else if (response_p->code == http_server_response_code_400_bad_request_t) {
+        size = std_strcpy(&buf[0], bad_request_header);
+    } else if (response_p->code == http_server_response_code_401_unauthorized_t) {
+        size = std_strcpy(&buf[0], unauthorized_header);
+    } else {
+        size = std_strcpy(&buf[0], not_found_header);
+    }
 
-    /* Set content type. */
+    /* Content type. */
     if (response_p->content.type == http_server_content_type_text_plain_t) {
-        content_type_p = "text/plain";
+        size += std_strcpy(&buf[size], text_plain_header);
     } else if (response_p->content.type
                == http_server_content_type_text_html_t) {
-        content_type_p = "text/html";
+        size += std_strcpy(&buf[size], text_html_header);
     } else {
         return (-1);
     }
 
-    /* Write the header. */
-    if (response_p->code == http_server_response_code_200_ok_t) {
-        size = std_sprintf(buf,
-                           ok_fmt,
-                           content_type_p,
-                           response_p->content.size);
-    } else if (response_p->code == http_server_response_code_401_unauthorized_t) {
-        size = std_sprintf(buf,
-                           unauthorized_fmt,
-                           content_type_p,
-                           response_p->content.size);
-    } else {
-        size = std_sprintf(buf,
-                           not_found_fmt,
-                           content_type_p,
-                           response_p->content.size);
-    }
+    /* Content length, formatted backwards. */
+    content_size = response_p->content.size;
+    i = sizeof(digits);
+
+    do {
+        digits[--i] = ('0' + (content_size % 10));
+        content_size /= 10;
+    } while (content_size > 0);
+
+    memcpy(&buf[size], &digits[i], sizeof(digits) - i);
+    size += (sizeof(digits) - i);
+    memcpy(&buf[size], "\r\n\r\n", 4);
+    size += 4;
+
+    /* Write small content in the same write as the header. */
+    if ((response_p->content.buf_p != NULL)
+        && (response_p->content.size <= sizeof(buf) - size)) {
+        memcpy(&buf[size], response_p->content.buf_p, response_p->content.size);
+        size += response_p->content.size;
 
-    res = chan_write(connection_p->chan_p, buf, size);
+        if (chan_write(connection_p->chan_p, buf, size) != size) {
+            return (-1);
+        }
+
+        return (response_p->content.size);
+    }
 
-    if (res != size) {
+    if (chan_write(connection_p->chan_p, buf, size) != size) {
         return (-1);
     }
 
@@ -67,6 +67,18 @@ enum http_server_connection_state_t {
     http_server_connection_state_allocated_t
 };
 
+/**
+ * A path parameter, for example ``id`` in the route path
+ * ``/sensors/{id}``. The name points into the route path and the
+ * value into the request path. Neither is null terminated.
+ */
+struct http_server_request_param_t {
+    const char *name_p;
+    size_t name_size;
+    const char *value_p;
+    size_t value_size;
+};
+
 /**
  * HTTP request.
  */
@@ -94,7 +106,21 @@ struct http_server_request_t {
             int present;
             char value[20];
         } expect;
+        struct {
+            int present;
+            char value[32];
+        } connection;
     } headers;
+    /* One(1) if the connection should be kept open after the
+       response has been written. Initialized from the protocol
+       version and the Connection header. A route callback may set
+       it to zero(0) to close the connection. */
+    int keep_alive;
+    /* Path parameters of the matched route. */
+    struct {
+        int length;
+        struct http_server_request_param_t items[CONFIG_HTTP_SERVER_ROUTE_PARAMS_MAX];
+    } params;
 };
 
 /**
@@ -129,6 +155,22 @@ struct http_server_listener_t {
     struct socket_t socket;
 };
 
+/**
+ * Buffered input channel of a connection. Request lines are parsed
+ * in place in the buffer. The request body and pipelined requests
+ * are read from the buffer before the underlying channel. Request
+ * body bytes not read by the route callback are discarded before
+ * the next request is parsed.
+ */
+struct http_server_connection_input_t {
+    struct chan_t base;
+    void *chan_p;
+    size_t begin;
+    size_t end;
+    size_t body_left;
+    char buf[CONFIG_HTTP_SERVER_REQUEST_BUFFER_SIZE];
+};
+
 struct http_server_connection_t {
     enum http_server_connection_state_t state;
     struct {
@@ -144,21 +186,56 @@ struct http_server_connection_t {
 #if CONFIG_HTTP_SERVER_SSL == 1
     struct ssl_socket_t ssl_socket;
 #endif
+    struct http_server_connection_input_t input;
     void *chan_p;
     struct event_t events;
 };
 
 /**
  * Call given callback for given path.
+ *
+ * The path is split into segments separated by ``/``. A segment on
+ * the form ``{name}`` is a path parameter that matches any segment
+ * in the request path. A request is dispatched to the route with the
+ * most segments matching the beginning of the request path. Literal
+ * segments take precedence over parameters when both match equally
+ * many segments.
+ *
+ * The method specific callbacks take precedence over ``callback``,
+ * which is called for all methods without a method specific
+ * callback, and may be NULL.
+ *
+ * Request body bytes not read by the callback are discarded after
+ * it returns. The connection is closed instead if more than
+ * ``CONFIG_HTTP_SERVER_BODY_DISCARD_SIZE_MAX`` bytes are unread.
  */
 struct http_server_route_t {
     const char *path_p;
     http_server_route_callback_t callback;
+    struct {
+        http_server_route_callback_t get;
+        http_server_route_callback_t post;
+    } methods;
+};
+
+/**
+ * A node in the route trie. Each node is a path segment.
+ */
+struct http_server_route_node_t {
+    const char *segment_p;
+    const struct http_server_route_t *route_p;
+    int16_t child;
+    int16_t sibling;
+    uint8_t segment_size;
 };
 
 struct http_server_t {
     const char *root_path_p;
     const struct http_server_route_t *routes_p;
+    struct {
+        struct http_server_route_node_t nodes[CONFIG_HTTP_SERVER_ROUTE_NODES_MAX];
+        int length;
+    } trie;
     http_server_route_callback_t on_no_route;
     struct http_server_listener_t *listener_p;
     struct http_server_connection_t *connections_p;
@@ -178,7 +255,9 @@ struct http_server_t {
  * @param[in] on_no_route Callback called for all requests without a
  *                        matching route in route_p.
  *
- * @return zero(0) or negative error code.
+ * @return zero(0) or negative error code. -ENOMEM if the routes
+ *         needs more than ``CONFIG_HTTP_SERVER_ROUTE_NODES_MAX`` trie
+ *         nodes.
  */
 int http_server_init(struct http_server_t *self_p,
                      struct http_server_listener_t *listener_p,
@@ -224,6 +303,35 @@ int http_server_start(struct http_server_t *self_p);
  */
 int http_server_stop(struct http_server_t *self_p);
 
+/**
+ * Find the callback of the route matching the path and action of
+ * given request, and save the path parameters in the request. This
+ * function is called by the server for each received request.
+ *
+ * @param[in] self_p Http server.
+ * @param[in,out] request_p Request to find the route for.
+ *
+ * @return Route callback, or NULL if no route matches.
+ */
+http_server_route_callback_t http_server_find_route(struct http_server_t *self_p,
+                                                    struct http_server_request_t *request_p);
+
+/**
+ * Copy the value of given path parameter to given buffer as a null
+ * terminated string.
+ *
+ * @param[in] request_p Request.
+ * @param[in] name_p Parameter name.
+ * @param[out] buf_p Value buffer.
+ * @param[in] size Value buffer size.
+ *
+ * @return Value length, or negative error code.
+ */
+ssize_t http_server_request_get_param(struct http_server_request_t *request_p,
+                                      const char *name_p,
+                                      char *buf_p,
+                                      size_t size);
+
 /**
  * Write given HTTP response to given connected client. This function
  * should only be called from the route callbacks to respond to given
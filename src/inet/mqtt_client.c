@@ -68,10 +68,21 @@
 #define CONTROL_SUBSCRIBE      4
 #define CONTROL_UNSUBSCRIBE    5
 #define CONTROL_NONE           6
+#define CONTROL_ADD_SUBSCRIPTION       7
+#define CONTROL_REMOVE_SUBSCRIPTION    8
 
 //! Length of a MQTT CONNECT variable header.
 #define CONNECT_VAR_HDR_LEN   10
 
+/** Publish fixed header flags. */
+#define PUBLISH_DUP         0x8
+
+/** States of an outgoing in-flight packet. */
+#define INFLIGHT_FREE          0
+#define INFLIGHT_PUBACK        1
+#define INFLIGHT_PUBREC        2
+#define INFLIGHT_PUBCOMP       3
+
 static const char *message_fmt[] = {
     "forbidden",
     "connect",
@@ -98,14 +109,99 @@ static const char *message_fmt[] = {
 #define LSB(b) (b & 0xff)
 
 /**
- * Write a single variable length string with header to the server.
+ * Write given control response to the caller of the client API.
  */
-static int write_mqtt_string(struct mqtt_client_t *self_p,
-                             struct mqtt_string_t *mqtt_string)
+static void write_control_response(struct mqtt_client_t *self_p,
+                                   int res)
+{
+    chan_write(&self_p->control.out, &res, sizeof(res));
+}
+
+/**
+ * Start assembling a packet in given buffer.
+ */
+static void packet_begin(struct mqtt_client_t *self_p,
+                         uint8_t *buf_p,
+                         size_t size)
+{
+    self_p->transmit.buf_p = buf_p;
+    self_p->transmit.size = size;
+    self_p->transmit.pos = 0;
+}
+
+/**
+ * Write the assembled part of the packet to the server.
+ */
+static int packet_flush(struct mqtt_client_t *self_p)
+{
+    size_t pos;
+
+    pos = self_p->transmit.pos;
+
+    if (pos == 0) {
+        return (0);
+    }
+
+    self_p->transmit.pos = 0;
+
+    if (chan_write(self_p->transport.out_p,
+                   self_p->transmit.buf_p,
+                   pos) != pos) {
+        return (-EIO);
+    }
+
+    return (0);
+}
+
+/**
+ * Append given data to the packet. The packet buffer is written to
+ * the server when full, which only happens for packets bigger than
+ * the buffer.
+ */
+static int packet_append(struct mqtt_client_t *self_p,
+                         const void *buf_p,
+                         size_t size)
+{
+    if (self_p->transmit.pos + size > self_p->transmit.size) {
+        if (packet_flush(self_p) != 0) {
+            return (-EIO);
+        }
+
+        if (size > self_p->transmit.size) {
+            if (chan_write(self_p->transport.out_p, buf_p, size) != size) {
+                return (-EIO);
+            }
+
+            return (0);
+        }
+    }
+
+    memcpy(&self_p->transmit.buf_p[self_p->transmit.pos], buf_p, size);
+    self_p->transmit.pos += size;
+
+    return (0);
+}
+
+/**
+ * Append a 16 bit big endian value to the packet.
+ */
+static int packet_append_u16(struct mqtt_client_t *self_p,
+                             size_t value)
 {
-    int res;
     uint8_t buf[2];
 
+    buf[0] = MSB(value);
+    buf[1] = LSB(value);
+
+    return (packet_append(self_p, &buf[0], sizeof(buf)));
+}
+
+/**
+ * Append a single variable length string with header to the packet.
+ */
+static int packet_append_string(struct mqtt_client_t *self_p,
+                                struct mqtt_string_t *mqtt_string)
+{
     if (mqtt_string->size == 0 || mqtt_string->buf_p == NULL) {
         return (-EINVAL);
     }
@@ -114,32 +210,37 @@ static int write_mqtt_string(struct mqtt_client_t *self_p,
         return (-EINVAL);
     }
 
-    /* Write length header */
-    buf[0] = MSB(mqtt_string->size);
-    buf[1] = LSB(mqtt_string->size);
-
-    if (chan_write(self_p->transport.out_p, &buf[0], 2) != 2) {
+    if (packet_append_u16(self_p, mqtt_string->size) != 0) {
         return (-EIO);
     }
 
-    res = chan_write(self_p->transport.out_p,
-                     mqtt_string->buf_p,
-                     mqtt_string->size);
+    return (packet_append(self_p, mqtt_string->buf_p, mqtt_string->size));
+}
 
-    if (res != mqtt_string->size) {
-        return (-EIO);
+/**
+ * Returns the size of a fixed header with given remaining length.
+ */
+static size_t fixed_header_size(size_t size)
+{
+    size_t header_size;
+
+    header_size = 2;
+
+    while (size >= 128) {
+        size /= 128;
+        header_size++;
     }
 
-    return (0);
+    return (header_size);
 }
 
 /**
- * Write the fixed header of the MQTT message to the server.
+ * Append the fixed header of the MQTT message to the packet.
  */
-static int write_fixed_header(struct mqtt_client_t *self_p,
-                              int type,
-                              int flags,
-                              size_t size)
+static int packet_append_fixed_header(struct mqtt_client_t *self_p,
+                                      int type,
+                                      int flags,
+                                      size_t size)
 {
     uint8_t buf[5];
     int pos;
@@ -168,13 +269,727 @@ static int write_fixed_header(struct mqtt_client_t *self_p,
         pos++;
     } while (size > 0);
 
-    if (chan_write(self_p->transport.out_p, &buf[0], pos) != pos) {
+    return (packet_append(self_p, &buf[0], pos));
+}
+
+/**
+ * Write a packet with only a fixed header to the server.
+ */
+static int write_fixed_header(struct mqtt_client_t *self_p,
+                              int type,
+                              int flags,
+                              size_t size)
+{
+    packet_begin(self_p,
+                 &self_p->transmit.buf[0],
+                 sizeof(self_p->transmit.buf));
+
+    if (packet_append_fixed_header(self_p, type, flags, size) != 0) {
         return (-EIO);
     }
 
+    return (packet_flush(self_p));
+}
+
+/**
+ * Write an acknowledgement packet with given packet identifier to the
+ * server.
+ */
+static int write_ack(struct mqtt_client_t *self_p,
+                     int type,
+                     int flags,
+                     uint16_t packet_id)
+{
+    packet_begin(self_p,
+                 &self_p->transmit.buf[0],
+                 sizeof(self_p->transmit.buf));
+
+    if (packet_append_fixed_header(self_p, type, flags, 2) != 0) {
+        return (-EIO);
+    }
+
+    if (packet_append_u16(self_p, packet_id) != 0) {
+        return (-EIO);
+    }
+
+    return (packet_flush(self_p));
+}
+
+/**
+ * Returns the remaining length of a publish packet of given message.
+ */
+static size_t publish_remaining_size(struct mqtt_application_message_t *message_p)
+{
+    size_t size;
+
+    size = (message_p->topic.size + message_p->payload.size + 2);
+
+    if (message_p->qos > 0) {
+        size += 2;
+    }
+
+    return (size);
+}
+
+/**
+ * Assemble a publish packet in given buffer and write it to the
+ * server.
+ */
+static int write_publish(struct mqtt_client_t *self_p,
+                         struct mqtt_application_message_t *message_p,
+                         uint16_t packet_id,
+                         int flags,
+                         uint8_t *buf_p,
+                         size_t size)
+{
+    int res;
+
+    packet_begin(self_p, buf_p, size);
+
+    res = packet_append_fixed_header(self_p,
+                                     MQTT_PUBLISH,
+                                     (message_p->qos << 1) | flags,
+                                     publish_remaining_size(message_p));
+
+    if (res != 0) {
+        return (res);
+    }
+
+    res = packet_append_string(self_p, &message_p->topic);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    if (message_p->qos > 0) {
+        if (packet_append_u16(self_p, packet_id) != 0) {
+            return (-EIO);
+        }
+    }
+
+    if (message_p->payload.size > 0) {
+        res = packet_append(self_p,
+                            message_p->payload.buf_p,
+                            message_p->payload.size);
+
+        if (res != 0) {
+            return (res);
+        }
+    }
+
+    return (packet_flush(self_p));
+}
+
+/**
+ * Read a two bytes packet identifier from the server.
+ */
+static int read_packet_id(struct mqtt_client_t *self_p,
+                          size_t size,
+                          uint16_t *packet_id_p)
+{
+    uint8_t buf[2];
+
+    if (size != 2) {
+        return (-EMSGSIZE);
+    }
+
+    if (chan_read(self_p->transport.in_p, &buf[0], size) != size) {
+        return (-EIO);
+    }
+
+    *packet_id_p = (((uint16_t)buf[0] << 8) | buf[1]);
+
+    return (0);
+}
+
+/**
+ * Read and discard given number of bytes from the server.
+ */
+static int discard(struct mqtt_client_t *self_p,
+                   size_t size)
+{
+    uint8_t buf[16];
+    size_t n;
+
+    while (size > 0) {
+        n = MIN(size, sizeof(buf));
+
+        if (chan_read(self_p->transport.in_p, &buf[0], n) != n) {
+            return (-EIO);
+        }
+
+        size -= n;
+    }
+
+    return (0);
+}
+
+/**
+ * Find the outgoing in-flight packet with given identifier and state.
+ */
+static struct mqtt_client_inflight_t *inflight_find(struct mqtt_client_t *self_p,
+                                                    uint16_t packet_id,
+                                                    int state)
+{
+    int i;
+    struct mqtt_client_inflight_t *entry_p;
+
+    for (i = 0; i < membersof(self_p->inflight.outgoing); i++) {
+        entry_p = &self_p->inflight.outgoing[i];
+
+        if (entry_p->state == state) {
+            if ((state == INFLIGHT_FREE) || (entry_p->packet_id == packet_id)) {
+                return (entry_p);
+            }
+        }
+    }
+
+    return (NULL);
+}
+
+/**
+ * Returns true(1) if given packet identifier is in use, otherwise
+ * false(0).
+ */
+static int is_packet_id_in_use(struct mqtt_client_t *self_p,
+                               uint16_t packet_id)
+{
+    int i;
+
+    if (packet_id == self_p->message.packet_id) {
+        return (1);
+    }
+
+    for (i = 0; i < membersof(self_p->inflight.outgoing); i++) {
+        if ((self_p->inflight.outgoing[i].state != INFLIGHT_FREE)
+            && (self_p->inflight.outgoing[i].packet_id == packet_id)) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+/**
+ * Allocate an unused non-zero packet identifier.
+ */
+static uint16_t packet_id_alloc(struct mqtt_client_t *self_p)
+{
+    uint16_t packet_id;
+
+    do {
+        packet_id = self_p->inflight.next_packet_id++;
+    } while ((packet_id == 0) || is_packet_id_in_use(self_p, packet_id));
+
+    return (packet_id);
+}
+
+/**
+ * The flow of given outgoing packet is complete. Wake the caller if
+ * it is waiting for the acknowledgement.
+ */
+static void inflight_complete(struct mqtt_client_t *self_p,
+                              struct mqtt_client_inflight_t *entry_p,
+                              int res)
+{
+    entry_p->state = INFLIGHT_FREE;
+
+    if (entry_p->message_p != NULL) {
+        entry_p->message_p = NULL;
+        write_control_response(self_p, res);
+    }
+}
+
+/**
+ * Drop all in-flight packets in both directions.
+ */
+static void inflight_reset(struct mqtt_client_t *self_p)
+{
+    int i;
+
+    for (i = 0; i < membersof(self_p->inflight.outgoing); i++) {
+        if (self_p->inflight.outgoing[i].state != INFLIGHT_FREE) {
+            inflight_complete(self_p,
+                              &self_p->inflight.outgoing[i],
+                              -ENOTCONN);
+        }
+
+        self_p->inflight.incoming[i] = 0;
+    }
+}
+
+/**
+ * Returns the number of milliseconds since given in-flight packet
+ * was last written to the server.
+ */
+static long inflight_elapsed_ms(struct mqtt_client_inflight_t *entry_p,
+                                struct time_t *now_p)
+{
+    struct time_t elapsed;
+
+    time_subtract(&elapsed, now_p, &entry_p->timestamp);
+
+    return (1000L * elapsed.seconds + elapsed.nanoseconds / 1000000L);
+}
+
+/**
+ * Retransmit all in-flight packets that have not been acknowledged
+ * within the retransmit timeout.
+ */
+static int inflight_retransmit(struct mqtt_client_t *self_p)
+{
+    int i;
+    int res;
+    struct mqtt_client_inflight_t *entry_p;
+    struct time_t now;
+
+    sys_uptime(&now);
+
+    for (i = 0; i < membersof(self_p->inflight.outgoing); i++) {
+        entry_p = &self_p->inflight.outgoing[i];
+
+        if (entry_p->state == INFLIGHT_FREE) {
+            continue;
+        }
+
+        if (inflight_elapsed_ms(entry_p, &now)
+            < CONFIG_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS) {
+            continue;
+        }
+
+        log_object_print(self_p->log_object_p,
+                         LOG_DEBUG,
+                         OSTR("Retransmitting packet %u.\r\n"),
+                         (unsigned int)entry_p->packet_id);
+
+        if (entry_p->state == INFLIGHT_PUBCOMP) {
+            res = write_ack(self_p, MQTT_PUBREL, 2, entry_p->packet_id);
+        } else if (entry_p->message_p == NULL) {
+            entry_p->buf[0] |= PUBLISH_DUP;
+
+            if (chan_write(self_p->transport.out_p,
+                           &entry_p->buf[0],
+                           entry_p->size) != entry_p->size) {
+                res = -EIO;
+            } else {
+                res = 0;
+            }
+        } else {
+            res = write_publish(self_p,
+                                entry_p->message_p,
+                                entry_p->packet_id,
+                                PUBLISH_DUP,
+                                &self_p->transmit.buf[0],
+                                sizeof(self_p->transmit.buf));
+        }
+
+        if (res != 0) {
+            return (res);
+        }
+
+        entry_p->timestamp = now;
+    }
+
+    return (0);
+}
+
+/**
+ * Get the time until the next retransmission. Returns NULL if no
+ * packet is in flight.
+ */
+static struct time_t *inflight_get_timeout(struct mqtt_client_t *self_p,
+                                           struct time_t *timeout_p)
+{
+    int i;
+    long timeout_ms;
+    long elapsed_ms;
+    struct mqtt_client_inflight_t *entry_p;
+    struct time_t now;
+
+    timeout_ms = -1;
+    sys_uptime(&now);
+
+    for (i = 0; i < membersof(self_p->inflight.outgoing); i++) {
+        entry_p = &self_p->inflight.outgoing[i];
+
+        if (entry_p->state == INFLIGHT_FREE) {
+            continue;
+        }
+
+        elapsed_ms = inflight_elapsed_ms(entry_p, &now);
+
+        if (elapsed_ms >= CONFIG_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS) {
+            timeout_ms = 0;
+        } else if ((timeout_ms == -1)
+                   || (CONFIG_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS - elapsed_ms
+                       < timeout_ms)) {
+            timeout_ms = (CONFIG_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS - elapsed_ms);
+        }
+    }
+
+    if (timeout_ms == -1) {
+        return (NULL);
+    }
+
+    timeout_p->seconds = (timeout_ms / 1000);
+    timeout_p->nanoseconds = (1000000L * (timeout_ms % 1000));
+
+    return (timeout_p);
+}
+
+/**
+ * Returns true(1) if given incoming QoS 2 packet identifier has been
+ * received but not yet released, otherwise false(0).
+ */
+static int incoming_contains(struct mqtt_client_t *self_p,
+                             uint16_t packet_id)
+{
+    int i;
+
+    for (i = 0; i < membersof(self_p->inflight.incoming); i++) {
+        if (self_p->inflight.incoming[i] == packet_id) {
+            return (1);
+        }
+    }
+
     return (0);
 }
 
+/**
+ * Replace given incoming packet identifier with another one. Zero(0)
+ * is a free slot.
+ */
+static void incoming_replace(struct mqtt_client_t *self_p,
+                             uint16_t old_packet_id,
+                             uint16_t new_packet_id)
+{
+    int i;
+
+    for (i = 0; i < membersof(self_p->inflight.incoming); i++) {
+        if (self_p->inflight.incoming[i] == old_packet_id) {
+            self_p->inflight.incoming[i] = new_packet_id;
+            break;
+        }
+    }
+}
+
+/**
+ * Returns the size of the topic level at the beginning of given
+ * topic or topic filter.
+ */
+static size_t get_level_size(const char *topic_p, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        if (topic_p[i] == '/') {
+            break;
+        }
+    }
+
+    return (i);
+}
+
+/**
+ * Returns true(1) if given topic level node is given wildcard,
+ * otherwise false(0).
+ */
+static int is_wildcard(struct mqtt_client_topic_node_t *node_p,
+                       char wildcard)
+{
+    return ((node_p->size == 1) && (node_p->level_p[0] == wildcard));
+}
+
+/**
+ * Wildcards must occupy a whole topic level, and the multi-level
+ * wildcard must be the last level of the filter.
+ */
+static int validate_filter(struct mqtt_string_t *filter_p)
+{
+    const char *filter_buf_p;
+    size_t pos;
+    size_t level_size;
+    size_t i;
+
+    if ((filter_p->buf_p == NULL) || (filter_p->size == 0)) {
+        return (-EINVAL);
+    }
+
+    filter_buf_p = filter_p->buf_p;
+    pos = 0;
+
+    while (1) {
+        level_size = get_level_size(&filter_buf_p[pos], filter_p->size - pos);
+
+        for (i = pos; i < pos + level_size; i++) {
+            if ((filter_buf_p[i] == '+') || (filter_buf_p[i] == '#')) {
+                if (level_size != 1) {
+                    return (-EINVAL);
+                }
+
+                if ((filter_buf_p[i] == '#') && (i != filter_p->size - 1)) {
+                    return (-EINVAL);
+                }
+            }
+        }
+
+        pos += level_size;
+
+        if (pos == filter_p->size) {
+            break;
+        }
+
+        /* Skip the level separator. */
+        pos++;
+    }
+
+    return (0);
+}
+
+/**
+ * Insert given subscription into the trie, one node per topic level.
+ */
+static int subscriptions_insert(struct mqtt_client_t *self_p,
+                                struct mqtt_client_subscription_t *subscription_p)
+{
+    struct mqtt_client_topic_node_t **children_pp;
+    struct mqtt_client_topic_node_t *node_p;
+    const char *filter_buf_p;
+    size_t pos;
+    size_t level_size;
+
+    filter_buf_p = subscription_p->filter.buf_p;
+    children_pp = &self_p->subscriptions.root_p;
+    pos = 0;
+
+    while (1) {
+        level_size = get_level_size(&filter_buf_p[pos],
+                                    subscription_p->filter.size - pos);
+
+        for (node_p = *children_pp; node_p != NULL; node_p = node_p->next_p) {
+            if ((node_p->size == level_size)
+                && (memcmp(node_p->level_p,
+                           &filter_buf_p[pos],
+                           level_size) == 0)) {
+                break;
+            }
+        }
+
+        if (node_p == NULL) {
+            if (self_p->subscriptions.used == self_p->subscriptions.length) {
+                return (-ENOMEM);
+            }
+
+            node_p = &self_p->subscriptions.nodes_p[self_p->subscriptions.used];
+            self_p->subscriptions.used++;
+            node_p->level_p = &filter_buf_p[pos];
+            node_p->size = level_size;
+            node_p->subscription_p = NULL;
+            node_p->children_p = NULL;
+            node_p->next_p = *children_pp;
+            *children_pp = node_p;
+        }
+
+        children_pp = &node_p->children_p;
+        pos += level_size;
+
+        if (pos == subscription_p->filter.size) {
+            break;
+        }
+
+        /* Skip the level separator. */
+        pos++;
+    }
+
+    if (node_p->subscription_p != NULL) {
+        return (-EEXIST);
+    }
+
+    node_p->subscription_p = subscription_p;
+
+    return (0);
+}
+
+/**
+ * Rebuild the trie from the list of subscriptions. The nodes point
+ * into the filters of the subscriptions, so they are rebuilt instead
+ * of being removed one by one.
+ */
+static void subscriptions_rebuild(struct mqtt_client_t *self_p)
+{
+    struct mqtt_client_subscription_t *subscription_p;
+
+    self_p->subscriptions.root_p = NULL;
+    self_p->subscriptions.used = 0;
+    subscription_p = self_p->subscriptions.list_p;
+
+    while (subscription_p != NULL) {
+        subscriptions_insert(self_p, subscription_p);
+        subscription_p = subscription_p->next_p;
+    }
+}
+
+/**
+ * Add given subscription to the list of subscriptions and the trie.
+ */
+static int subscriptions_add(struct mqtt_client_t *self_p,
+                             struct mqtt_client_subscription_t *subscription_p)
+{
+    int res;
+
+    res = validate_filter(&subscription_p->filter);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    res = subscriptions_insert(self_p, subscription_p);
+
+    if (res != 0) {
+        /* Free any nodes allocated before the failure. */
+        subscriptions_rebuild(self_p);
+
+        return (res);
+    }
+
+    subscription_p->next_p = self_p->subscriptions.list_p;
+    self_p->subscriptions.list_p = subscription_p;
+
+    return (0);
+}
+
+/**
+ * Remove given subscription from the list of subscriptions and the
+ * trie.
+ */
+static int subscriptions_remove(struct mqtt_client_t *self_p,
+                                struct mqtt_client_subscription_t *subscription_p)
+{
+    struct mqtt_client_subscription_t **subscription_pp;
+
+    subscription_pp = &self_p->subscriptions.list_p;
+
+    while (*subscription_pp != subscription_p) {
+        if (*subscription_pp == NULL) {
+            return (-ENOENT);
+        }
+
+        subscription_pp = &(*subscription_pp)->next_p;
+    }
+
+    *subscription_pp = subscription_p->next_p;
+    subscriptions_rebuild(self_p);
+
+    return (0);
+}
+
+static struct mqtt_client_subscription_t *subscriptions_match(
+    struct mqtt_client_topic_node_t *nodes_p,
+    const char *topic_p,
+    size_t size,
+    int is_first_level);
+
+/**
+ * Match the rest of the topic, starting with a level separator,
+ * below given node.
+ */
+static struct mqtt_client_subscription_t *subscriptions_match_node(
+    struct mqtt_client_topic_node_t *node_p,
+    const char *topic_p,
+    size_t size)
+{
+    struct mqtt_client_topic_node_t *child_p;
+
+    if (node_p == NULL) {
+        return (NULL);
+    }
+
+    if (size == 0) {
+        if (node_p->subscription_p != NULL) {
+            return (node_p->subscription_p);
+        }
+
+        /* The multi-level wildcard also matches the parent level. */
+        for (child_p = node_p->children_p;
+             child_p != NULL;
+             child_p = child_p->next_p) {
+            if (is_wildcard(child_p, '#')) {
+                return (child_p->subscription_p);
+            }
+        }
+
+        return (NULL);
+    }
+
+    return (subscriptions_match(node_p->children_p,
+                                &topic_p[1],
+                                size - 1,
+                                0));
+}
+
+/**
+ * Find the most specific subscription matching given topic among
+ * given sibling nodes and their children.
+ */
+static struct mqtt_client_subscription_t *subscriptions_match(
+    struct mqtt_client_topic_node_t *nodes_p,
+    const char *topic_p,
+    size_t size,
+    int is_first_level)
+{
+    struct mqtt_client_topic_node_t *node_p;
+    struct mqtt_client_topic_node_t *exact_p;
+    struct mqtt_client_topic_node_t *single_p;
+    struct mqtt_client_topic_node_t *multi_p;
+    struct mqtt_client_subscription_t *subscription_p;
+    size_t level_size;
+
+    level_size = get_level_size(topic_p, size);
+    exact_p = NULL;
+    single_p = NULL;
+    multi_p = NULL;
+
+    for (node_p = nodes_p; node_p != NULL; node_p = node_p->next_p) {
+        if (is_wildcard(node_p, '+')) {
+            single_p = node_p;
+        } else if (is_wildcard(node_p, '#')) {
+            multi_p = node_p;
+        } else if ((node_p->size == level_size)
+                   && (memcmp(node_p->level_p, topic_p, level_size) == 0)) {
+            exact_p = node_p;
+        }
+    }
+
+    /* Wildcards do not match topics starting with '$'
+       [MQTT-4.7.2-1]. */
+    if (is_first_level && (level_size > 0) && (topic_p[0] == '$')) {
+        single_p = NULL;
+        multi_p = NULL;
+    }
+
+    subscription_p = subscriptions_match_node(exact_p,
+                                              &topic_p[level_size],
+                                              size - level_size);
+
+    if (subscription_p != NULL) {
+        return (subscription_p);
+    }
+
+    subscription_p = subscriptions_match_node(single_p,
+                                              &topic_p[level_size],
+                                              size - level_size);
+
+    if (subscription_p != NULL) {
+        return (subscription_p);
+    }
+
+    if (multi_p != NULL) {
+        return (multi_p->subscription_p);
+    }
+
+    return (NULL);
+}
+
 /**
  * Read the fixed header of a MQTT message from the server.
  */
@@ -301,17 +1116,24 @@ static int handle_control_connect(struct mqtt_client_t *self_p)
         options_p->keep_alive_s = DEFAULT_KEEP_ALIVE_S;
     }
 
-    /* Write the fixed header. */
-    res = write_fixed_header(self_p,
-                             MQTT_CONNECT,
-                             0,
-                             CONNECT_VAR_HDR_LEN + payload_length);
+    /* A new clean session. */
+    inflight_reset(self_p);
+
+    packet_begin(self_p,
+                 &self_p->transmit.buf[0],
+                 sizeof(self_p->transmit.buf));
+
+    /* Append the fixed header. */
+    res = packet_append_fixed_header(self_p,
+                                     MQTT_CONNECT,
+                                     0,
+                                     CONNECT_VAR_HDR_LEN + payload_length);
 
     if (res != 0) {
         return (res);
     }
 
-    /* Write the variable header. */
+    /* Append the variable header. */
     buf[0] = 0;                            /* Protocol Name - Length MSB */
     buf[1] = 4;                            /* Protocol Name - Length LSB */
     buf[2] = 'M';                          /* Protocol Name */
@@ -323,26 +1145,27 @@ static int handle_control_connect(struct mqtt_client_t *self_p)
     buf[8] = MSB(options_p->keep_alive_s); /* Keep Alive MSB */
     buf[9] = LSB(options_p->keep_alive_s); /* Keep Alive LSB */
 
-    if (chan_write(self_p->transport.out_p, &buf[0], CONNECT_VAR_HDR_LEN)
-        != CONNECT_VAR_HDR_LEN) {
-        return (-EIO);
+    res = packet_append(self_p, &buf[0], CONNECT_VAR_HDR_LEN);
+
+    if (res != 0) {
+        return (res);
     }
 
-    /* Write paylaod string by string. */
-    res = write_mqtt_string(self_p, &options_p->client_id);
+    /* Append paylaod string by string. */
+    res = packet_append_string(self_p, &options_p->client_id);
 
     if (res != 0) {
         return (res);
     }
 
     if (options_p->will.topic.size > 0) {
-        res = write_mqtt_string(self_p, &options_p->will.topic);
+        res = packet_append_string(self_p, &options_p->will.topic);
 
         if (res != 0) {
             return (res);
         }
 
-        res = write_mqtt_string(self_p, &options_p->will.payload);
+        res = packet_append_string(self_p, &options_p->will.payload);
 
         if (res != 0) {
             return (res);
@@ -350,7 +1173,7 @@ static int handle_control_connect(struct mqtt_client_t *self_p)
     }
 
     if (options_p->user_name.size > 0) {
-        res = write_mqtt_string(self_p, &options_p->user_name);
+        res = packet_append_string(self_p, &options_p->user_name);
 
         if (res != 0) {
             return (res);
@@ -358,13 +1181,19 @@ static int handle_control_connect(struct mqtt_client_t *self_p)
     }
 
     if (options_p->password.size > 0) {
-        res = write_mqtt_string(self_p, &options_p->password);
+        res = packet_append_string(self_p, &options_p->password);
 
         if (res != 0) {
             return (res);
         }
     }
 
+    res = packet_flush(self_p);
+
+    if (res != 0) {
+        return (res);
+    }
+
     self_p->message.type = CONTROL_CONNECT;
 
     return (0);
@@ -410,6 +1239,7 @@ static int handle_response_connack(struct mqtt_client_t *self_p,
  */
 static int handle_control_disconnect(struct mqtt_client_t *self_p)
 {
+    inflight_reset(self_p);
 
     if (write_fixed_header(self_p, MQTT_DISCONNECT, 0, 0) != 0) {
         return (-1);
@@ -459,72 +1289,105 @@ static int handle_response_ping(struct mqtt_client_t *self_p,
 }
 
 /**
- * Send the publish message to the server.
+ * Publish the message waiting for a free slot in the in-flight
+ * window, if any.
  */
-static int handle_control_publish(struct mqtt_client_t *self_p)
+static int publish_pending(struct mqtt_client_t *self_p)
 {
-    int res = 0;
-    uint8_t buf[2];
+    int res;
     struct mqtt_application_message_t *message_p;
-    size_t size;
+    struct mqtt_client_inflight_t *entry_p;
+    uint16_t packet_id;
 
-    if (queue_read(&self_p->control.in,
-                   &message_p,
-                   sizeof(message_p)) != sizeof(message_p)) {
-        return (-1);
+    if (self_p->message.type != CONTROL_PUBLISH) {
+        return (0);
     }
 
-    /* Write the fixed header. */
-    size = (message_p->topic.size + message_p->payload.size + 2);
+    entry_p = inflight_find(self_p, 0, INFLIGHT_FREE);
 
-    if (message_p->qos > 0) {
-        size += 2;
+    if (entry_p == NULL) {
+        return (0);
     }
 
-    res = write_fixed_header(self_p,
-                             MQTT_PUBLISH,
-                             (message_p->qos << 1),
-                             size);
-
-    if (res != 0) {
-        return (res);
+    self_p->message.type = CONTROL_NONE;
+    message_p = self_p->message.data_p;
+    packet_id = packet_id_alloc(self_p);
+
+    /* Keep a copy of the packet for retransmission if it fits in the
+       in-flight buffer, otherwise the caller waits for the
+       acknowledgement. */
+    entry_p->size = (fixed_header_size(publish_remaining_size(message_p))
+                     + publish_remaining_size(message_p));
+
+    if (entry_p->size <= sizeof(entry_p->buf)) {
+        entry_p->message_p = NULL;
+        res = write_publish(self_p,
+                            message_p,
+                            packet_id,
+                            0,
+                            &entry_p->buf[0],
+                            sizeof(entry_p->buf));
+    } else {
+        entry_p->message_p = message_p;
+        res = write_publish(self_p,
+                            message_p,
+                            packet_id,
+                            0,
+                            &self_p->transmit.buf[0],
+                            sizeof(self_p->transmit.buf));
     }
 
-    /* Write the variable header. */
-    buf[0] = 0;
-    buf[1] = message_p->topic.size;
+    if (res == 0) {
+        entry_p->packet_id = packet_id;
 
-    if (chan_write(self_p->transport.out_p, &buf[0], 2) != 2) {
-        return (-EIO);
+        if (message_p->qos == mqtt_qos_1_t) {
+            entry_p->state = INFLIGHT_PUBACK;
+        } else {
+            entry_p->state = INFLIGHT_PUBREC;
+        }
+
+        sys_uptime(&entry_p->timestamp);
     }
 
-    if (chan_write(self_p->transport.out_p,
-                   message_p->topic.buf_p,
-                   message_p->topic.size) != message_p->topic.size) {
-        return (-EIO);
+    if ((res != 0) || (entry_p->message_p == NULL)) {
+        entry_p->message_p = NULL;
+        write_control_response(self_p, res);
     }
 
-    if (message_p->qos > 0) {
-        buf[0] = 0;
-        buf[1] = 1;
+    return (res);
+}
 
-        if (chan_write(self_p->transport.out_p, &buf[0], 2) != 2) {
-            return (-EIO);
-        }
+/**
+ * Send the publish message to the server. A QoS 1 or QoS 2 message
+ * is sent once there is a free slot in the in-flight window.
+ */
+static int handle_control_publish(struct mqtt_client_t *self_p)
+{
+    int res;
+    struct mqtt_application_message_t *message_p;
+
+    if (queue_read(&self_p->control.in,
+                   &message_p,
+                   sizeof(message_p)) != sizeof(message_p)) {
+        return (-1);
     }
 
-    /* Write the payload. */
-    if (message_p->payload.size > 0) {
-        if (chan_write(self_p->transport.out_p,
-                       message_p->payload.buf_p,
-                       message_p->payload.size) != message_p->payload.size) {
-            return (-EIO);
-        }
+    if (message_p->qos == mqtt_qos_0_t) {
+        res = write_publish(self_p,
+                            message_p,
+                            0,
+                            0,
+                            &self_p->transmit.buf[0],
+                            sizeof(self_p->transmit.buf));
+        write_control_response(self_p, res);
+
+        return (res);
     }
 
     self_p->message.type = CONTROL_PUBLISH;
+    self_p->message.data_p = message_p;
 
-    return (0);
+    return (publish_pending(self_p));
 }
 
 /**
@@ -533,86 +1396,134 @@ static int handle_control_publish(struct mqtt_client_t *self_p)
 static int handle_response_puback(struct mqtt_client_t *self_p,
                                   size_t size)
 {
-    uint8_t buf[2];
+    int res;
+    uint16_t packet_id;
+    struct mqtt_client_inflight_t *entry_p;
 
-    if (self_p->message.type != CONTROL_PUBLISH) {
+    res = read_packet_id(self_p, size, &packet_id);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    entry_p = inflight_find(self_p, packet_id, INFLIGHT_PUBACK);
+
+    if (entry_p == NULL) {
         return (-1);
     }
 
-    self_p->message.type = CONTROL_NONE;
+    inflight_complete(self_p, entry_p, 0);
+
+    return (0);
+}
+
+/**
+ * Handle the pubrec message from the server by releasing the packet.
+ */
+static int handle_response_pubrec(struct mqtt_client_t *self_p,
+                                  size_t size)
+{
+    int res;
+    uint16_t packet_id;
+    struct mqtt_client_inflight_t *entry_p;
+
+    res = read_packet_id(self_p, size, &packet_id);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    entry_p = inflight_find(self_p, packet_id, INFLIGHT_PUBREC);
+
+    if (entry_p == NULL) {
+        return (-1);
+    }
+
+    entry_p->state = INFLIGHT_PUBCOMP;
+    sys_uptime(&entry_p->timestamp);
+
+    return (write_ack(self_p, MQTT_PUBREL, 2, packet_id));
+}
+
+/**
+ * Handle the pubcomp message from the server.
+ */
+static int handle_response_pubcomp(struct mqtt_client_t *self_p,
+                                   size_t size)
+{
+    int res;
+    uint16_t packet_id;
+    struct mqtt_client_inflight_t *entry_p;
+
+    res = read_packet_id(self_p, size, &packet_id);
 
-    if (size != 2) {
-        return (-EMSGSIZE);
+    if (res != 0) {
+        return (res);
     }
 
-    if (chan_read(self_p->transport.in_p, &buf[0], size) != size) {
-        return (-EIO);
-    }
+    entry_p = inflight_find(self_p, packet_id, INFLIGHT_PUBCOMP);
 
-    if (buf[0] != 0) {
+    if (entry_p == NULL) {
         return (-1);
     }
 
-    if (buf[1] != 1) {
-        return (-1);
-    }
+    inflight_complete(self_p, entry_p, 0);
 
     return (0);
 }
 
 /**
- * Send the subscribe message to the server.
+ * Write a subscribe message with given topic filter to the server.
  */
-static int handle_control_subscribe(struct mqtt_client_t *self_p)
+static int write_subscribe(struct mqtt_client_t *self_p,
+                           struct mqtt_string_t *filter_p,
+                           enum mqtt_qos_t qos)
 {
-    int res = 0;
-    uint8_t buf[2];
-    struct mqtt_application_message_t *message_p;
+    int res;
+    uint8_t requested_qos;
 
-    if (queue_read(&self_p->control.in,
-                   &message_p,
-                   sizeof(message_p)) != sizeof(message_p)) {
-        return (-1);
-    }
+    self_p->message.packet_id = packet_id_alloc(self_p);
+
+    packet_begin(self_p,
+                 &self_p->transmit.buf[0],
+                 sizeof(self_p->transmit.buf));
 
-    /* Write the fixed header to the server. */
-    res = write_fixed_header(self_p,
-                             MQTT_SUBSCRIBE,
-                             2,
-                             message_p->topic.size + 5);
+    /* Append the fixed header. */
+    res = packet_append_fixed_header(self_p,
+                                     MQTT_SUBSCRIBE,
+                                     2,
+                                     filter_p->size + 5);
 
     if (res != 0) {
         return (res);
     }
 
-    /* Write the packet identifier. */
-    buf[0] = 0;
-    buf[1] = 1;
+    /* Append the packet identifier. */
+    res = packet_append_u16(self_p, self_p->message.packet_id);
 
-    if (chan_write(self_p->transport.out_p, &buf[0], 2) != 2) {
-        return (-EIO);
+    if (res != 0) {
+        return (res);
     }
 
-    /* Write the topic filter length. */
-    buf[0] = ((message_p->topic.size >> 8) & 0xff);
-    buf[1] = (message_p->topic.size & 0xff);
+    /* Append the topic filter. */
+    res = packet_append_string(self_p, filter_p);
 
-    if (chan_write(self_p->transport.out_p, &buf[0], 2) != 2) {
-        return (-EIO);
+    if (res != 0) {
+        return (res);
     }
 
-    /* Write the topic filter. */
-    if (chan_write(self_p->transport.out_p,
-                   message_p->topic.buf_p,
-                   message_p->topic.size) != message_p->topic.size) {
-        return (-EIO);
+    /* Append the topic filter QoS. */
+    requested_qos = qos;
+    res = packet_append(self_p, &requested_qos, 1);
+
+    if (res != 0) {
+        return (res);
     }
 
-    /* Write the topic filter QoS. */
-    buf[0] = message_p->qos;
+    res = packet_flush(self_p);
 
-    if (chan_write(self_p->transport.out_p, &buf[0], 1) != 1) {
-        return (-EIO);
+    if (res != 0) {
+        return (res);
     }
 
     self_p->message.type = CONTROL_SUBSCRIBE;
@@ -620,40 +1531,109 @@ static int handle_control_subscribe(struct mqtt_client_t *self_p)
     return (0);
 }
 
+/**
+ * Send the subscribe message to the server.
+ */
+static int handle_control_subscribe(struct mqtt_client_t *self_p)
+{
+    struct mqtt_application_message_t *message_p;
+
+    if (queue_read(&self_p->control.in,
+                   &message_p,
+                   sizeof(message_p)) != sizeof(message_p)) {
+        return (-1);
+    }
+
+    self_p->message.data_p = NULL;
+
+    return (write_subscribe(self_p, &message_p->topic, message_p->qos));
+}
+
 /**
  * Handle the suback message from the server.
  */
 static int handle_response_suback(struct mqtt_client_t *self_p,
                                   size_t size)
 {
+    int res;
     uint8_t buf[3];
+    uint16_t packet_id;
+    struct mqtt_client_subscription_t *subscription_p;
 
     if (self_p->message.type != CONTROL_SUBSCRIBE) {
         return (-1);
     }
 
     self_p->message.type = CONTROL_NONE;
+    packet_id = self_p->message.packet_id;
+    self_p->message.packet_id = 0;
+    subscription_p = self_p->message.data_p;
+    res = 0;
 
     if (size != 3) {
-        return (-EMSGSIZE);
+        res = -EMSGSIZE;
+    } else if (chan_read(self_p->transport.in_p, &buf[0], size) != size) {
+        res = -EIO;
+    } else if ((buf[0] != MSB(packet_id)) || (buf[1] != LSB(packet_id))) {
+        res = -1;
+    } else if (buf[2] > 2) {
+        res = -1;
     }
 
-    if (chan_read(self_p->transport.in_p, &buf[0], size) != size) {
-        return (-EIO);
+    /* The server refused an added subscription. */
+    if ((res != 0) && (subscription_p != NULL)) {
+        subscriptions_remove(self_p, subscription_p);
     }
 
-    if (buf[0] != 0) {
-        return (-1);
+    return (res);
+}
+
+/**
+ * Write an unsubscribe message with given topic filter to the server.
+ */
+static int write_unsubscribe(struct mqtt_client_t *self_p,
+                             struct mqtt_string_t *filter_p)
+{
+    int res;
+
+    self_p->message.packet_id = packet_id_alloc(self_p);
+
+    packet_begin(self_p,
+                 &self_p->transmit.buf[0],
+                 sizeof(self_p->transmit.buf));
+
+    /* Append the fixed header. */
+    res = packet_append_fixed_header(self_p,
+                                     MQTT_UNSUBSCRIBE,
+                                     2,
+                                     filter_p->size + 4);
+
+    if (res != 0) {
+        return (res);
     }
 
-    if (buf[1] != 1) {
-        return (-1);
+    /* Append the packet identifier. */
+    res = packet_append_u16(self_p, self_p->message.packet_id);
+
+    if (res != 0) {
+        return (res);
     }
 
-    if (buf[2] > 2) {
-        return (-1);
+    /* Append the topic filter. */
+    res = packet_append_string(self_p, filter_p);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    res = packet_flush(self_p);
+
+    if (res != 0) {
+        return (res);
     }
 
+    self_p->message.type = CONTROL_UNSUBSCRIBE;
+
     return (0);
 }
 
@@ -662,8 +1642,6 @@ static int handle_response_suback(struct mqtt_client_t *self_p,
  */
 static int handle_control_unsubscribe(struct mqtt_client_t *self_p)
 {
-    int res = 0;
-    uint8_t buf[2];
     struct mqtt_application_message_t *message_p;
 
     if (queue_read(&self_p->control.in,
@@ -672,42 +1650,70 @@ static int handle_control_unsubscribe(struct mqtt_client_t *self_p)
         return (-1);
     }
 
-    /* Write the fixed header to the server. */
-    res = write_fixed_header(self_p,
-                             MQTT_UNSUBSCRIBE,
-                             2,
-                             message_p->topic.size + 4);
+    return (write_unsubscribe(self_p, &message_p->topic));
+}
 
-    if (res != 0) {
-        return (res);
+/**
+ * Add a subscription to the trie and send the subscribe message to
+ * the server.
+ */
+static int handle_control_add_subscription(struct mqtt_client_t *self_p)
+{
+    int res;
+    struct mqtt_client_subscription_t *subscription_p;
+
+    if (queue_read(&self_p->control.in,
+                   &subscription_p,
+                   sizeof(subscription_p)) != sizeof(subscription_p)) {
+        return (-1);
     }
 
-    /* Write the packet identifier. */
-    buf[0] = 0;
-    buf[1] = 2;
+    res = subscriptions_add(self_p, subscription_p);
 
-    if (chan_write(self_p->transport.out_p, &buf[0], 2) != 2) {
-        return (-EIO);
+    if (res == 0) {
+        self_p->message.data_p = subscription_p;
+        res = write_subscribe(self_p,
+                              &subscription_p->filter,
+                              subscription_p->qos);
+
+        if (res != 0) {
+            subscriptions_remove(self_p, subscription_p);
+        }
+    }
+
+    if (res != 0) {
+        write_control_response(self_p, res);
     }
 
-    /* Write the topic filter length. */
-    buf[0] = ((message_p->topic.size >> 8) & 0xff);
-    buf[1] = (message_p->topic.size & 0xff);
+    return (res);
+}
 
-    if (chan_write(self_p->transport.out_p, &buf[0], 2) != 2) {
-        return (-EIO);
+/**
+ * Remove a subscription from the trie and send the unsubscribe
+ * message to the server.
+ */
+static int handle_control_remove_subscription(struct mqtt_client_t *self_p)
+{
+    int res;
+    struct mqtt_client_subscription_t *subscription_p;
+
+    if (queue_read(&self_p->control.in,
+                   &subscription_p,
+                   sizeof(subscription_p)) != sizeof(subscription_p)) {
+        return (-1);
     }
 
-    /* Write the topic filter. */
-    if (chan_write(self_p->transport.out_p,
-                   message_p->topic.buf_p,
-                   message_p->topic.size) != message_p->topic.size) {
-        return (-EIO);
+    res = subscriptions_remove(self_p, subscription_p);
+
+    if (res == 0) {
+        res = write_unsubscribe(self_p, &subscription_p->filter);
     }
 
-    self_p->message.type = CONTROL_UNSUBSCRIBE;
+    if (res != 0) {
+        write_control_response(self_p, res);
+    }
 
-    return (0);
+    return (res);
 }
 
 /**
@@ -716,7 +1722,8 @@ static int handle_control_unsubscribe(struct mqtt_client_t *self_p)
 static int handle_response_unsuback(struct mqtt_client_t *self_p,
                                     size_t size)
 {
-    uint8_t buf[3];
+    int res;
+    uint16_t packet_id;
 
     if (self_p->message.type != CONTROL_UNSUBSCRIBE) {
         return (-1);
@@ -724,23 +1731,19 @@ static int handle_response_unsuback(struct mqtt_client_t *self_p,
 
     self_p->message.type = CONTROL_NONE;
 
-    if (size != 2) {
-        return (-EMSGSIZE);
-    }
+    res = read_packet_id(self_p, size, &packet_id);
 
-    if (chan_read(self_p->transport.in_p, &buf[0], size) != size) {
-        return (-EIO);
+    if (res != 0) {
+        return (res);
     }
 
-    if (buf[0] != 0) {
-        return (-1);
+    if (packet_id != self_p->message.packet_id) {
+        res = -1;
     }
 
-    if (buf[1] != 2) {
-        return (-1);
-    }
+    self_p->message.packet_id = 0;
 
-    return (0);
+    return (res);
 }
 
 /**
@@ -752,10 +1755,27 @@ static int handle_publish(struct mqtt_client_t *self_p,
 {
     int res;
     size_t topic_size;
+    size_t header_size;
     size_t payload_size;
+    size_t read_size;
     uint8_t buf[2];
     uint8_t qos;
-    char topic[128];
+    uint16_t packet_id;
+    int is_duplicate;
+    int is_topic_too_long;
+    struct mqtt_client_subscription_t *subscription_p;
+    char buf_topic[CONFIG_MQTT_CLIENT_TOPIC_SIZE_MAX];
+    char *topic_p;
+    size_t topic_buf_size;
+
+    /* Use the application's topic buffer if given. */
+    if (self_p->topic.buf_p != NULL) {
+        topic_p = self_p->topic.buf_p;
+        topic_buf_size = self_p->topic.size;
+    } else {
+        topic_p = &buf_topic[0];
+        topic_buf_size = sizeof(buf_topic);
+    }
 
     /* Read the variable header. */
     if (chan_read(self_p->transport.in_p, buf, 2) != 2) {
@@ -763,20 +1783,39 @@ static int handle_publish(struct mqtt_client_t *self_p,
     }
 
     topic_size = (((size_t)buf[0] << 8) | buf[1]);
+    qos = ((flags >> 1) & 0x3);
+    header_size = (topic_size + 2);
+
+    if (qos > 0) {
+        header_size += 2;
+    }
 
-    if (topic_size > sizeof(topic) - 1) {
+    if (header_size > size) {
         return (-EMSGSIZE);
     }
 
-    /* Read the topic. */
-    if (chan_read(self_p->transport.in_p,
-                  topic,
-                  topic_size) != topic_size) {
-        return (-EIO);
+    payload_size = (size - header_size);
+    is_topic_too_long = (topic_size > topic_buf_size - 1);
+
+    /* Read the topic, or discard it if it does not fit in the
+       buffer. The message is still acknowledged. */
+    if (is_topic_too_long) {
+        res = discard(self_p, topic_size);
+
+        if (res != 0) {
+            return (res);
+        }
+    } else {
+        if (chan_read(self_p->transport.in_p,
+                      topic_p,
+                      topic_size) != topic_size) {
+            return (-EIO);
+        }
+
+        topic_p[topic_size] = '\0';
     }
 
-    topic[topic_size] = '\0';
-    qos = ((flags >> 1) & 0x3);
+    is_duplicate = 0;
 
     log_object_print(self_p->log_object_p,
                      LOG_DEBUG,
@@ -784,18 +1823,26 @@ static int handle_publish(struct mqtt_client_t *self_p,
                      qos,
                      flags);
 
-    if (qos == 0) {
-        payload_size = (size - topic_size - 2);
-    } else {
+    if (qos > 0) {
         /* Read the packet identifier. */
-        if (chan_read(self_p->transport.in_p, buf, 2) != 2) {
-            return (-EIO);
+        res = read_packet_id(self_p, 2, &packet_id);
+
+        if (res != 0) {
+            return (res);
         }
 
         if (qos == 1) {
-            res = write_fixed_header(self_p, MQTT_PUBACK, 0, 2);
+            res = write_ack(self_p, MQTT_PUBACK, 0, packet_id);
         } else if (qos == 2) {
-            res = write_fixed_header(self_p, MQTT_PUBREC, 0, 2);
+            /* A retransmitted packet that has not yet been released
+               was already given to the application. */
+            is_duplicate = incoming_contains(self_p, packet_id);
+
+            if (!is_duplicate) {
+                incoming_replace(self_p, 0, packet_id);
+            }
+
+            res = write_ack(self_p, MQTT_PUBREC, 0, packet_id);
         } else {
             res = (-EPROTO);
         }
@@ -803,17 +1850,49 @@ static int handle_publish(struct mqtt_client_t *self_p,
         if (res != 0) {
             return (res);
         }
+    }
 
-        /* Write the variable header. */
-        if (chan_write(self_p->transport.out_p, &buf[0], 2) != 2) {
-            return (-EIO);
+    if (is_topic_too_long) {
+        res = discard(self_p, payload_size);
+
+        if (res != 0) {
+            return (res);
+        }
+
+        return (-EMSGSIZE);
+    }
+
+    if (is_duplicate) {
+        return (discard(self_p, payload_size));
+    }
+
+    /* The payload is read from the transport channel by the
+       callback. */
+    subscription_p = subscriptions_match(self_p->subscriptions.root_p,
+                                         topic_p,
+                                         topic_size,
+                                         1);
+
+    if (subscription_p != NULL) {
+        read_size = subscription_p->on_publish(self_p,
+                                               subscription_p,
+                                               topic_p,
+                                               self_p->transport.in_p,
+                                               payload_size);
+
+        if (read_size > payload_size) {
+            return (-1);
         }
 
-        payload_size = (size - topic_size - 4);
+        return (discard(self_p, payload_size - read_size));
+    }
+
+    if (self_p->on_publish == NULL) {
+        return (discard(self_p, payload_size));
     }
 
     if (self_p->on_publish(self_p,
-                           topic,
+                           topic_p,
                            self_p->transport.in_p,
                            payload_size) != 0) {
         return (-1);
@@ -822,6 +1901,27 @@ static int handle_publish(struct mqtt_client_t *self_p,
     return (0);
 }
 
+/**
+ * Handle the pubrel message from the server by completing the QoS 2
+ * flow.
+ */
+static int handle_pubrel(struct mqtt_client_t *self_p,
+                         size_t size)
+{
+    int res;
+    uint16_t packet_id;
+
+    res = read_packet_id(self_p, size, &packet_id);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    incoming_replace(self_p, packet_id, 0);
+
+    return (write_ack(self_p, MQTT_PUBCOMP, 0, packet_id));
+}
+
 /**
  * Read a control message.
  */
@@ -858,7 +1958,7 @@ static int read_control_message(struct mqtt_client_t *self_p)
 
             case CONTROL_DISCONNECT:
                 res = handle_control_disconnect(self_p);
-                chan_write(&self_p->control.out, &res, sizeof(res));
+                write_control_response(self_p, res);
                 break;
 
             case CONTROL_PING:
@@ -877,6 +1977,14 @@ static int read_control_message(struct mqtt_client_t *self_p)
                 res = handle_control_unsubscribe(self_p);
                 break;
 
+            case CONTROL_ADD_SUBSCRIPTION:
+                res = handle_control_add_subscription(self_p);
+                break;
+
+            case CONTROL_REMOVE_SUBSCRIPTION:
+                res = handle_control_remove_subscription(self_p);
+                break;
+
             default:
                 break;
             }
@@ -917,32 +2025,38 @@ static int read_server_message(struct mqtt_client_t *self_p)
 
     case MQTT_CONNACK:
         res = handle_response_connack(self_p,  size);
-        chan_write(&self_p->control.out, &res, sizeof(res));
+        write_control_response(self_p, res);
         break;
 
     case MQTT_PUBACK:
         res = handle_response_puback(self_p, size);
-        chan_write(&self_p->control.out, &res, sizeof(res));
         break;
 
     case MQTT_PUBREC:
+        res = handle_response_pubrec(self_p, size);
+        break;
+
     case MQTT_PUBREL:
+        res = handle_pubrel(self_p, size);
+        break;
+
     case MQTT_PUBCOMP:
+        res = handle_response_pubcomp(self_p, size);
         break;
 
     case MQTT_SUBACK:
         res = handle_response_suback(self_p,  size);
-        chan_write(&self_p->control.out, &res, sizeof(res));
+        write_control_response(self_p, res);
         break;
 
     case MQTT_UNSUBACK:
         res = handle_response_unsuback(self_p,  size);
-        chan_write(&self_p->control.out, &res, sizeof(res));
+        write_control_response(self_p, res);
         break;
 
     case MQTT_PINGRESP:
         res = handle_response_ping(self_p, size);
-        chan_write(&self_p->control.out, &res, sizeof(res));
+        write_control_response(self_p, res);
         break;
 
     case MQTT_PUBLISH:
@@ -978,6 +2092,8 @@ int mqtt_client_init(struct mqtt_client_t *self_p,
                      mqtt_on_publish_t on_publish,
                      mqtt_on_error_t on_error)
 {
+    int i;
+
     if (on_error == NULL) {
         on_error = default_on_error;
     }
@@ -986,8 +2102,24 @@ int mqtt_client_init(struct mqtt_client_t *self_p,
     self_p->log_object_p = log_object_p;
     self_p->state = mqtt_client_state_disconnected_t;
     self_p->message.type = CONTROL_NONE;
+    self_p->message.packet_id = 0;
     self_p->transport.out_p = transport_out_p;
     self_p->transport.in_p = transport_in_p;
+    self_p->inflight.next_packet_id = 1;
+    self_p->subscriptions.list_p = NULL;
+    self_p->subscriptions.root_p = NULL;
+    self_p->subscriptions.nodes_p = NULL;
+    self_p->subscriptions.length = 0;
+    self_p->subscriptions.used = 0;
+    self_p->topic.buf_p = NULL;
+    self_p->topic.size = 0;
+
+    for (i = 0; i < membersof(self_p->inflight.outgoing); i++) {
+        self_p->inflight.outgoing[i].state = INFLIGHT_FREE;
+        self_p->inflight.outgoing[i].message_p = NULL;
+        self_p->inflight.incoming[i] = 0;
+    }
+
     queue_init(&self_p->control.out, NULL, 0);
     queue_init(&self_p->control.in, NULL, 0);
     self_p->on_publish = on_publish;
@@ -1044,6 +2176,7 @@ int mqtt_client_publish(struct mqtt_client_t *self_p,
 {
     ASSERTN(self_p != NULL, EINVAL)
     ASSERTN(message_p != NULL, EINVAL)
+    ASSERTN(message_p->qos <= mqtt_qos_2_t, EINVAL)
 
     return (control_routine(self_p,
                             CONTROL_PUBLISH,
@@ -1075,27 +2208,109 @@ int mqtt_client_unsubscribe(struct mqtt_client_t *self_p,
                             sizeof(message_p)));
 }
 
+int mqtt_client_subscription_init(struct mqtt_client_subscription_t *self_p,
+                                  const char *filter_p,
+                                  enum mqtt_qos_t qos,
+                                  mqtt_on_subscription_publish_t on_publish,
+                                  void *arg_p)
+{
+    ASSERTN(self_p != NULL, EINVAL)
+    ASSERTN(filter_p != NULL, EINVAL)
+    ASSERTN(on_publish != NULL, EINVAL)
+
+    self_p->filter.buf_p = filter_p;
+    self_p->filter.size = strlen(filter_p);
+    self_p->qos = qos;
+    self_p->on_publish = on_publish;
+    self_p->arg_p = arg_p;
+    self_p->next_p = NULL;
+
+    return (0);
+}
+
+int mqtt_client_init_subscriptions(struct mqtt_client_t *self_p,
+                                   struct mqtt_client_topic_node_t *nodes_p,
+                                   int length)
+{
+    ASSERTN(self_p != NULL, EINVAL)
+    ASSERTN(nodes_p != NULL, EINVAL)
+    ASSERTN(length > 0, EINVAL)
+
+    self_p->subscriptions.list_p = NULL;
+    self_p->subscriptions.root_p = NULL;
+    self_p->subscriptions.nodes_p = nodes_p;
+    self_p->subscriptions.length = length;
+    self_p->subscriptions.used = 0;
+
+    return (0);
+}
+
+int mqtt_client_set_topic_buffer(struct mqtt_client_t *self_p,
+                                 char *buf_p,
+                                 size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL)
+    ASSERTN(buf_p != NULL, EINVAL)
+    ASSERTN(size > 0, EINVAL)
+
+    self_p->topic.buf_p = buf_p;
+    self_p->topic.size = size;
+
+    return (0);
+}
+
+int mqtt_client_add_subscription(struct mqtt_client_t *self_p,
+                                 struct mqtt_client_subscription_t *subscription_p)
+{
+    ASSERTN(self_p != NULL, EINVAL)
+    ASSERTN(subscription_p != NULL, EINVAL)
+
+    return (control_routine(self_p,
+                            CONTROL_ADD_SUBSCRIPTION,
+                            &subscription_p,
+                            sizeof(subscription_p)));
+}
+
+int mqtt_client_remove_subscription(struct mqtt_client_t *self_p,
+                                    struct mqtt_client_subscription_t *subscription_p)
+{
+    ASSERTN(self_p != NULL, EINVAL)
+    ASSERTN(subscription_p != NULL, EINVAL)
+
+    return (control_routine(self_p,
+                            CONTROL_REMOVE_SUBSCRIPTION,
+                            &subscription_p,
+                            sizeof(subscription_p)));
+}
+
 void *mqtt_client_main(void *arg_p)
 {
     struct mqtt_client_t *self_p = arg_p;
     struct chan_list_t list;
     struct chan_list_elem_t elements[2];
+    struct time_t timeout;
+    struct time_t *timeout_p;
     void *chan_p;
     int res;
+    int control_polled;
 
     thrd_set_name(self_p->name_p);
 
     chan_list_init(&list, &elements[0], membersof(elements));
     chan_list_add(&list, &self_p->control.in);
     chan_list_add(&list, self_p->transport.in_p);
+    control_polled = 1;
+    timeout_p = NULL;
 
     while (1) {
-        chan_p = chan_list_poll(&list, NULL);
+        chan_p = chan_list_poll(&list, timeout_p);
 
         if (chan_p == &self_p->control.in) {
             res = read_control_message(self_p);
         } else if (chan_p == self_p->transport.in_p) {
             res = read_server_message(self_p);
+        } else if (chan_p == NULL) {
+            res = 0;
         } else {
             res = -1;
         }
@@ -1103,5 +2318,31 @@ void *mqtt_client_main(void *arg_p)
         if (res != 0) {
             self_p->on_error(self_p, res);
         }
+
+        res = inflight_retransmit(self_p);
+
+        if (res != 0) {
+            self_p->on_error(self_p, res);
+        }
+
+        res = publish_pending(self_p);
+
+        if (res != 0) {
+            self_p->on_error(self_p, res);
+        }
+
+        /* Do not accept more control messages while a publish is
+           waiting for a free slot in the in-flight window. */
+        if (self_p->message.type == CONTROL_PUBLISH) {
+            if (control_polled) {
+                chan_list_remove(&list, &self_p->control.in);
+                control_polled = 0;
+            }
+        } else if (!control_polled) {
+            chan_list_add(&list, &self_p->control.in);
+            control_polled = 1;
+        }
+
+        timeout_p = inflight_get_timeout(self_p, &timeout);
     }
 }
@@ -86,6 +86,73 @@ struct mqtt_string_t {
     size_t size;
 };
 
+/**
+ * MQTT application message.
+ */
+struct mqtt_application_message_t {
+    struct mqtt_string_t topic;
+    struct mqtt_string_t payload;
+    enum mqtt_qos_t qos;
+};
+
+struct mqtt_client_subscription_t;
+
+/**
+ * Prototype of the subscription on-publish callback function.
+ *
+ * @param[in] client_p The client.
+ * @param[in] subscription_p The subscription the topic matched.
+ * @param[in] topic_p The received topic.
+ * @param[in] chin_p The channel to read the value from.
+ * @param[in] size Number of bytes of the value in chin_p.
+ *
+ * @return Number of bytes read from the input channel. Unread bytes
+ *         are discarded by the client.
+ */
+typedef size_t (*mqtt_on_subscription_publish_t)(
+    struct mqtt_client_t *client_p,
+    struct mqtt_client_subscription_t *subscription_p,
+    const char *topic_p,
+    void *chin_p,
+    size_t size);
+
+/**
+ * A topic filter subscription with its own on-publish callback.
+ */
+struct mqtt_client_subscription_t {
+    struct mqtt_string_t filter;
+    enum mqtt_qos_t qos;
+    mqtt_on_subscription_publish_t on_publish;
+    void *arg_p;
+    struct mqtt_client_subscription_t *next_p;
+};
+
+/**
+ * A topic level node in the subscription trie.
+ */
+struct mqtt_client_topic_node_t {
+    const char *level_p;
+    size_t size;
+    struct mqtt_client_subscription_t *subscription_p;
+    struct mqtt_client_topic_node_t *children_p;
+    struct mqtt_client_topic_node_t *next_p;
+};
+
+/**
+ * An outgoing QoS 1 or QoS 2 publish packet waiting for an
+ * acknowledgement from the server.
+ */
+struct mqtt_client_inflight_t {
+    uint16_t packet_id;
+    uint8_t state;
+    /* Set if the packet did not fit in the buffer below. The caller
+       is blocked until the packet is acknowledged. */
+    struct mqtt_application_message_t *message_p;
+    struct time_t timestamp;
+    size_t size;
+    uint8_t buf[CONFIG_MQTT_CLIENT_PACKET_SIZE_MAX];
+};
+
 /**
  * MQTT client.
  */
@@ -96,11 +163,35 @@ struct mqtt_client_t {
     struct {
         int type;
         void *data_p;
+        uint16_t packet_id;
     } message;
     struct {
         void *out_p;
         void *in_p;
     } transport;
+    struct {
+        uint8_t *buf_p;
+        size_t size;
+        size_t pos;
+        uint8_t buf[CONFIG_MQTT_CLIENT_PACKET_SIZE_MAX];
+    } transmit;
+    struct {
+        uint16_t next_packet_id;
+        struct mqtt_client_inflight_t outgoing[CONFIG_MQTT_CLIENT_INFLIGHT_MAX];
+        /* Identifiers of received QoS 2 packets waiting for PUBREL. */
+        uint16_t incoming[CONFIG_MQTT_CLIENT_INFLIGHT_MAX];
+    } inflight;
+    struct {
+        struct mqtt_client_subscription_t *list_p;
+        struct mqtt_client_topic_node_t *root_p;
+        struct mqtt_client_topic_node_t *nodes_p;
+        int length;
+        int used;
+    } subscriptions;
+    struct {
+        char *buf_p;
+        size_t size;
+    } topic;
     struct {
         struct queue_t out;
         struct queue_t in;
@@ -109,15 +200,6 @@ struct mqtt_client_t {
     mqtt_on_error_t on_error;
 };
 
-/**
- * MQTT application message.
- */
-struct mqtt_application_message_t {
-    struct mqtt_string_t topic;
-    struct mqtt_string_t payload;
-    enum mqtt_qos_t qos;
-};
-
 /**
  * MQTT Connection options.
  */
@@ -205,12 +287,19 @@ int mqtt_client_disconnect(struct mqtt_client_t *self_p);
 int mqtt_client_ping(struct mqtt_client_t *self_p);
 
 /**
- * Publish given topic.
+ * Publish given message.
+ *
+ * A QoS 1 or QoS 2 message is copied to the in-flight window and
+ * this function returns as soon as the packet has been written to
+ * the server. The acknowledgement is handled by the client thread,
+ * which retransmits the packet if it is not acknowledged in time,
+ * and acknowledgement errors are reported to the on-error
+ * callback. This function blocks if the in-flight window is full,
+ * and until the packet is acknowledged if it is bigger than
+ * ``CONFIG_MQTT_CLIENT_PACKET_SIZE_MAX``.
  *
  * @param[in] self_p MQTT client.
- * @param[in] topic_p Topic.
- * @param[in] payload_p Payload to publish. May be NULL.
- * @param[in] payload_size Number of bytes in the payload.
+ * @param[in] message_p Message to publish.
  *
  * @return zero(0) or negative error code.
  */
@@ -242,4 +331,89 @@ int mqtt_client_subscribe(struct mqtt_client_t *self_p,
 int mqtt_client_unsubscribe(struct mqtt_client_t *self_p,
                             struct mqtt_application_message_t *message_p);
 
+/**
+ * Initialize given subscription.
+ *
+ * @param[in] self_p Subscription to initialize.
+ * @param[in] filter_p Topic filter, that may contain the ``+`` and
+ *                     ``#`` wildcards. The string must be valid as
+ *                     long as the subscription is added to a client.
+ * @param[in] qos Maximum QoS of messages sent by the server.
+ * @param[in] on_publish Called when a message matching the filter is
+ *                       received.
+ * @param[in] arg_p Argument available in the callback as
+ *                  ``subscription_p->arg_p``.
+ *
+ * @return zero(0) or negative error code.
+ */
+int mqtt_client_subscription_init(struct mqtt_client_subscription_t *self_p,
+                                  const char *filter_p,
+                                  enum mqtt_qos_t qos,
+                                  mqtt_on_subscription_publish_t on_publish,
+                                  void *arg_p);
+
+/**
+ * Initialize the subscription trie of given client with given topic
+ * level nodes. Each topic level of each added filter uses one node,
+ * but nodes are shared between filters with common leading levels.
+ *
+ * @param[in] self_p MQTT client.
+ * @param[in] nodes_p Topic level nodes.
+ * @param[in] length Number of nodes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int mqtt_client_init_subscriptions(struct mqtt_client_t *self_p,
+                                   struct mqtt_client_topic_node_t *nodes_p,
+                                   int length);
+
+/**
+ * Receive topics into given buffer instead of the
+ * ``CONFIG_MQTT_CLIENT_TOPIC_SIZE_MAX`` bytes buffer on the client
+ * thread stack. MQTT topics may be up to 65535 bytes long. Received
+ * messages with topics that do not fit in the buffer, including the
+ * null termination, are acknowledged and discarded. Must not be
+ * called while the client is receiving a message.
+ *
+ * @param[in] self_p MQTT client.
+ * @param[in] buf_p Topic buffer.
+ * @param[in] size Topic buffer size.
+ *
+ * @return zero(0) or negative error code.
+ */
+int mqtt_client_set_topic_buffer(struct mqtt_client_t *self_p,
+                                 char *buf_p,
+                                 size_t size);
+
+/**
+ * Add given subscription to the subscription trie and subscribe to
+ * its topic filter on the server.
+ *
+ * A received message is given to the subscription with the most
+ * specific matching filter, where a topic level matches before the
+ * ``+`` wildcard, which matches before the ``#`` wildcard. The
+ * payload is read directly from the transport channel by the
+ * callback. Messages that do not match any subscription are given
+ * to the on-publish callback of the client.
+ *
+ * @param[in] self_p MQTT client.
+ * @param[in] subscription_p Subscription to add.
+ *
+ * @return zero(0) or negative error code.
+ */
+int mqtt_client_add_subscription(struct mqtt_client_t *self_p,
+                                 struct mqtt_client_subscription_t *subscription_p);
+
+/**
+ * Remove given subscription from the subscription trie and
+ * unsubscribe from its topic filter on the server.
+ *
+ * @param[in] self_p MQTT client.
+ * @param[in] subscription_p Subscription to remove.
+ *
+ * @return zero(0) or negative error code.
+ */
+int mqtt_client_remove_subscription(struct mqtt_client_t *self_p,
+                                    struct mqtt_client_subscription_t *subscription_p);
+
 #endif
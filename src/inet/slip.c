@@ -36,44 +36,153 @@
 #define SLIP_ESC_END      0xdc
 #define SLIP_ESC_ESC      0xdd
 
+struct output_t {
+    void *chout_p;
+    size_t size;
+    uint8_t buf[CONFIG_SLIP_OUTPUT_BUFFER_SIZE];
+};
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#else
+
+#define ONES ((size_t)-1 / 0xff)
+#define HIGHS (ONES * 0x80)
+
+/**
+ * Returns non-zero if any byte in given word is zero.
+ */
+static size_t has_zero_byte(size_t word)
+{
+    return ((word - ONES) & ~word & HIGHS);
+}
+
+#endif
+
+/**
+ * Returns the offset of the first END or ESC byte in given buffer,
+ * or given size if there is none.
+ */
+static size_t find_special(const uint8_t *buf_p, size_t size)
+{
+    size_t offset;
+
+    offset = 0;
+
+#if defined(__SSE2__)
+    __m128i block;
+    int mask;
+
+    while (offset + 16 <= size) {
+        block = _mm_loadu_si128((const __m128i *)&buf_p[offset]);
+        mask = _mm_movemask_epi8(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(block, _mm_set1_epi8((char)SLIP_END)),
+                _mm_cmpeq_epi8(block, _mm_set1_epi8((char)SLIP_ESC))));
+
+        if (mask != 0) {
+            return (offset + __builtin_ctz(mask));
+        }
+
+        offset += 16;
+    }
+#else
+    size_t word;
+
+    while (offset + sizeof(word) <= size) {
+        memcpy(&word, &buf_p[offset], sizeof(word));
+
+        if (has_zero_byte(word ^ (ONES * SLIP_END))
+            || has_zero_byte(word ^ (ONES * SLIP_ESC))) {
+            break;
+        }
+
+        offset += sizeof(word);
+    }
+#endif
+
+    while ((offset < size)
+           && (buf_p[offset] != SLIP_END)
+           && (buf_p[offset] != SLIP_ESC)) {
+        offset++;
+    }
+
+    return (offset);
+}
+
+static void output_flush(struct output_t *output_p)
+{
+    if (output_p->size > 0) {
+        chan_write(output_p->chout_p, &output_p->buf[0], output_p->size);
+        output_p->size = 0;
+    }
+}
+
+/**
+ * Runs longer than the buffer are written directly from the packet,
+ * after the buffered data.
+ */
+static void output_write(struct output_t *output_p,
+                         const uint8_t *buf_p,
+                         size_t size)
+{
+    if (output_p->size + size > sizeof(output_p->buf)) {
+        output_flush(output_p);
+
+        if (size >= sizeof(output_p->buf)) {
+            chan_write(output_p->chout_p, buf_p, size);
+
+            return;
+        }
+    }
+
+    memcpy(&output_p->buf[output_p->size], buf_p, size);
+    output_p->size += size;
+}
+
 static ssize_t packet_write(void *chan_p,
                             const void *buf_p,
                             size_t size)
 {
     struct slip_t *self_p;
-    int i;
-    uint8_t data;
+    struct output_t output;
     const uint8_t *b_p;
+    size_t left;
+    size_t run;
+    uint8_t escaped[2];
 
     self_p = container_of(chan_p, struct slip_t, chout);
     b_p = buf_p;
+    left = size;
+    output.chout_p = self_p->chout_p;
+    output.buf[0] = SLIP_END;
+    output.size = 1;
+    escaped[0] = SLIP_ESC;
 
-    data = SLIP_END;
-    chan_write(self_p->chout_p, &data, 1);
-
-    for (i = 0; i < size; i++) {
-        data = b_p[i];
+    while (left > 0) {
+        run = find_special(b_p, left);
+        output_write(&output, b_p, run);
+        b_p += run;
+        left -= run;
 
-        switch (data) {
-
-        case SLIP_END:
-            data = SLIP_ESC;
-            chan_write(self_p->chout_p, &data, 1);
-            data = SLIP_ESC_END;
-            break;
+        if (left > 0) {
+            if (*b_p == SLIP_END) {
+                escaped[1] = SLIP_ESC_END;
+            } else {
+                escaped[1] = SLIP_ESC_ESC;
+            }
 
-        case SLIP_ESC:
-            data = SLIP_ESC;
-            chan_write(self_p->chout_p, &data, 1);
-            data = SLIP_ESC_ESC;
-            break;
+            output_write(&output, &escaped[0], sizeof(escaped));
+            b_p++;
+            left--;
         }
-
-        chan_write(self_p->chout_p, &data, 1);
     }
 
-    data = SLIP_END;
-    chan_write(self_p->chout_p, &data, 1);
+    escaped[0] = SLIP_END;
+    output_write(&output, &escaped[0], 1);
+    output_flush(&output);
 
     return (size);
 }
@@ -154,6 +263,57 @@ ssize_t slip_input(struct slip_t *self_p,
     return (res);
 }
 
+ssize_t slip_input_buffer(struct slip_t *self_p,
+                          const void *buf_p,
+                          size_t size,
+                          size_t *consumed_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+    ASSERTN(consumed_p != NULL, EINVAL);
+
+    const uint8_t *b_p;
+    size_t pos;
+    size_t run;
+    size_t space;
+    ssize_t res;
+
+    b_p = buf_p;
+    pos = 0;
+    res = 0;
+
+    while ((pos < size) && (res == 0)) {
+        if (self_p->rx.is_escaped == 0) {
+            run = find_special(&b_p[pos], size - pos);
+            space = (self_p->rx.size - self_p->rx.pos);
+
+            if (run > space) {
+                /* Truncate long packets. */
+                memcpy(&self_p->rx.buf_p[self_p->rx.pos], &b_p[pos], space);
+                self_p->rx.pos += space;
+                pos += (space + 1);
+                res = -1;
+                break;
+            }
+
+            memcpy(&self_p->rx.buf_p[self_p->rx.pos], &b_p[pos], run);
+            self_p->rx.pos += run;
+            pos += run;
+
+            if (pos == size) {
+                break;
+            }
+        }
+
+        res = slip_input(self_p, b_p[pos]);
+        pos++;
+    }
+
+    *consumed_p = pos;
+
+    return (res);
+}
+
 void *slip_get_output_channel(struct slip_t *self_p)
 {
     ASSERTNRN(self_p != NULL, EINVAL);
@@ -66,6 +66,25 @@ int slip_init(struct slip_t *self_p,
 ssize_t slip_input(struct slip_t *self_p,
                    uint8_t data);
 
+/**
+ * Input data bytes into the slip parser. Equivalent to calling
+ * `slip_input()` for one byte at a time, until it returns non-zero
+ * or all bytes have been input, but bytes between special characters
+ * are copied to the frame buffer in bulk.
+ *
+ * @param[in] self_p Slip object.
+ * @param[in] buf_p Data bytes to input.
+ * @param[in] size Number of data bytes.
+ * @param[out] consumed_p Number of input data bytes. Input the rest
+ *                        in another call.
+ *
+ * @return Same as `slip_input()` for the last input data byte.
+ */
+ssize_t slip_input_buffer(struct slip_t *self_p,
+                          const void *buf_p,
+                          size_t size,
+                          size_t *consumed_p);
+
 /**
  * Get the output channel for given slip object.
  *
@@ -1400,7 +1400,12 @@ ssize_t socket_size(struct socket_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
-    return (self_p->input.u.common.left != 0);
+    /* A closed connection is readable. */
+    if (self_p->input.u.common.left < 0) {
+        return (1);
+    }
+
+    return (self_p->input.u.common.left);
 }
 
 #else
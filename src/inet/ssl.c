@@ -378,8 +378,17 @@ ssize_t ssl_socket_size(struct ssl_socket_t *self_p)
     ASSERTN(self_p != NULL, EINVAL);
     ASSERTN(self_p->ssl_p != NULL, EINVAL);
 
-    return (mbedtls_ssl_get_bytes_avail(self_p->ssl_p)
-            + chan_size(self_p->socket_p));
+    ssize_t size;
+
+    size = mbedtls_ssl_get_bytes_avail(self_p->ssl_p);
+
+    /* Encrypted input is not decrypted until read, so only report
+       that there is at least one byte available. */
+    if ((size == 0) && (chan_size(self_p->socket_p) > 0)) {
+        size = 1;
+    }
+
+    return (size);
 }
 
 const char *ssl_socket_get_server_hostname(struct ssl_socket_t *self_p)
@@ -34,14 +34,126 @@
 
 static pthread_mutex_t mutex;
 
+#define TICK_PERIOD_NS (1000000000LL / CONFIG_SYSTEM_TICK_FREQUENCY)
+
 struct sys_port_t {
     pthread_t thrd;
     pthread_mutex_t mutex;
     pthread_cond_t cond;
+#if CONFIG_SYSTEM_TICKLESS == 1
+    struct {
+        long long next_ns;       /* Time of next tick. */
+        uint32_t ticks;          /* Ticks to sleep, one when not idle. */
+        uint32_t requested;      /* Catch up request counter. */
+        uint32_t completed;      /* Completed catch up requests. */
+        pthread_cond_t completed_cond;
+    } tickless;
+#endif
 };
 
 static struct sys_port_t sys_port;
 
+#if CONFIG_SYSTEM_TICKLESS == 1
+
+static long long now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return (now.tv_sec * 1000000000LL + now.tv_nsec);
+}
+
+/**
+ * Sleep until the next programmed tick, or until woken up early to
+ * reprogram it. All ticks that elapsed while sleeping are processed
+ * at once.
+ */
+static void *sys_port_ticker(void *arg)
+{
+    struct timespec abstimeout;
+    long long timeout_ns;
+    long long elapsed_ns;
+    uint32_t ticks;
+    uint32_t requested;
+
+    pthread_mutex_lock(&sys_port.mutex);
+    sys_port.tickless.next_ns = (now_ns() + TICK_PERIOD_NS);
+
+    while (1) {
+        if (sys_port.tickless.completed == sys_port.tickless.requested) {
+            timeout_ns = (sys_port.tickless.next_ns
+                          + (sys_port.tickless.ticks - 1) * TICK_PERIOD_NS);
+            abstimeout.tv_sec = (timeout_ns / 1000000000LL);
+            abstimeout.tv_nsec = (timeout_ns % 1000000000LL);
+            pthread_cond_timedwait(&sys_port.cond,
+                                   &sys_port.mutex,
+                                   &abstimeout);
+        }
+
+        requested = sys_port.tickless.requested;
+        elapsed_ns = (now_ns() - sys_port.tickless.next_ns);
+        ticks = 0;
+
+        if (elapsed_ns >= 0) {
+            ticks = (elapsed_ns / TICK_PERIOD_NS + 1);
+            sys_port.tickless.next_ns += (ticks * TICK_PERIOD_NS);
+        }
+
+        /* Timer callbacks may take the system lock, which must never
+           be taken with the ticker mutex locked. */
+        pthread_mutex_unlock(&sys_port.mutex);
+
+        if (ticks == 1) {
+            sys_tick_isr();
+        } else if (ticks > 1) {
+            sys_tick_catch_up_isr(ticks);
+        }
+
+        pthread_mutex_lock(&sys_port.mutex);
+        sys_port.tickless.completed = requested;
+        pthread_cond_broadcast(&sys_port.tickless.completed_cond);
+    }
+
+    return (NULL);
+}
+
+static void sys_port_tick_idle_enter(uint32_t ticks)
+{
+    pthread_mutex_lock(&sys_port.mutex);
+
+    if (ticks > 1) {
+        sys_port.tickless.ticks = ticks;
+        pthread_cond_signal(&sys_port.cond);
+    }
+
+    pthread_mutex_unlock(&sys_port.mutex);
+}
+
+static void sys_port_tick_idle_exit(void)
+{
+    uint32_t requested;
+
+    pthread_mutex_lock(&sys_port.mutex);
+
+    if (sys_port.tickless.ticks > 1) {
+        /* Wait for the ticker to catch up with elapsed ticks before
+           any thread reads the uptime. */
+        sys_port.tickless.ticks = 1;
+        requested = ++sys_port.tickless.requested;
+        pthread_cond_signal(&sys_port.cond);
+
+        while ((int32_t)(sys_port.tickless.completed - requested) < 0) {
+            pthread_cond_wait(&sys_port.tickless.completed_cond,
+                              &sys_port.mutex);
+        }
+    }
+
+    pthread_mutex_unlock(&sys_port.mutex);
+}
+
+#else
+
 static void *sys_port_ticker(void *arg)
 {
     struct timespec abstimeout;
@@ -67,6 +179,8 @@ static void *sys_port_ticker(void *arg)
     return (NULL);
 }
 
+#endif
+
 static void sys_port_stop(int error)
 {
     exit(error);
@@ -149,6 +263,15 @@ int sys_port_module_init(void)
 {
     pthread_mutex_init(&mutex, NULL);
 
+#if CONFIG_SYSTEM_TICKLESS == 1
+    pthread_mutex_init(&sys_port.mutex, NULL);
+    pthread_cond_init(&sys_port.cond, NULL);
+    pthread_cond_init(&sys_port.tickless.completed_cond, NULL);
+    sys_port.tickless.ticks = 1;
+    sys_port.tickless.requested = 0;
+    sys_port.tickless.completed = 0;
+#endif
+
     signal(SIGSEGV, signal_handler);
 
     /* Start sys tick thrd.*/
@@ -31,6 +31,7 @@
 struct thrd_port_idle_t {
     pthread_mutex_t mutex;
     pthread_cond_t cond;
+    int pending;
 };
 
 static struct thrd_t main_thrd;
@@ -48,9 +49,22 @@ static char *thrd_port_get_main_thrd_stack_top(void)
 
 static struct thrd_port_idle_t idle = {
     .mutex = PTHREAD_MUTEX_INITIALIZER,
-    .cond = PTHREAD_COND_INITIALIZER
+    .cond = PTHREAD_COND_INITIALIZER,
+    .pending = 0
 };
 
+/**
+ * Wake up the idle thread. The wakeup is remembered if the idle
+ * thread is not waiting.
+ */
+static void thrd_port_idle_signal(void)
+{
+    pthread_mutex_lock(&idle.mutex);
+    idle.pending = 1;
+    pthread_cond_signal(&idle.cond);
+    pthread_mutex_unlock(&idle.mutex);
+}
+
 static void *thrd_port_main(void *arg_p)
 {
     struct thrd_port_t *port_p;
@@ -114,9 +128,20 @@ static int thrd_port_spawn(struct thrd_t *thrd_p,
 static void thrd_port_idle_wait(struct thrd_t *thrd_p)
 {
     pthread_mutex_lock(&idle.mutex);
-    pthread_cond_wait(&idle.cond, &idle.mutex);
+
+    while (idle.pending == 0) {
+        pthread_cond_wait(&idle.cond, &idle.mutex);
+    }
+
+    idle.pending = 0;
     pthread_mutex_unlock(&idle.mutex);
 
+#if CONFIG_SYSTEM_TICKLESS == 1
+    /* Restart the periodic system tick before any other thread
+       runs. */
+    sys_tick_idle_exit();
+#endif
+
     /* Add this thread to the ready list and reschedule. */
     sys_lock();
     thrd_p->state = THRD_STATE_READY;
@@ -127,18 +152,21 @@ static void thrd_port_idle_wait(struct thrd_t *thrd_p)
 
 static void thrd_port_on_suspend_timer_expired(struct thrd_t *thrd_p)
 {
-    /* Signal idle thrd.*/
-    pthread_mutex_lock(&idle.mutex);
-    pthread_cond_signal(&idle.cond);
-    pthread_mutex_unlock(&idle.mutex);
+    thrd_port_idle_signal();
+}
+
+#if CONFIG_SYSTEM_TICKLESS == 1
+
+static void thrd_port_on_resume_idle_isr(void)
+{
+    thrd_port_idle_signal();
 }
 
+#endif
+
 static void thrd_port_tick(void)
 {
-    /* Signal idle thrd.*/
-    pthread_mutex_lock(&idle.mutex);
-    pthread_cond_signal(&idle.cond);
-    pthread_mutex_unlock(&idle.mutex);
+    thrd_port_idle_signal();
 }
 
 static void thrd_port_cpu_usage_start(struct thrd_t *thrd_p)
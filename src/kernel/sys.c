@@ -114,6 +114,10 @@ static const FAR char * const FAR reset_cause_string_map[sys_reset_cause_max_t]
 
 extern const FAR char sysinfo[];
 
+#if CONFIG_SYSTEM_TICKLESS == 1 && !defined(ARCH_LINUX)
+#    error "The tickless system tick is only supported on Linux."
+#endif
+
 extern void time_tick_isr(void);
 extern void timer_tick_isr(void);
 extern void thrd_tick_isr(void);
@@ -131,6 +135,32 @@ static void RAM_CODE sys_tick_isr(void)
     thrd_tick_isr();
 }
 
+#if CONFIG_SYSTEM_TICKLESS == 1
+
+/**
+ * Catch up given number of ticks that elapsed while the system tick
+ * was stopped. All timers are processed tick by tick to fire them in
+ * order, but the scheduler is only ticked once.
+ */
+static void RAM_CODE sys_tick_catch_up_isr(uint32_t ticks)
+{
+    while (ticks > 0) {
+        module.tick.lsb++;
+
+        if (module.tick.lsb == TICKS_PER_MSB) {
+            module.tick.msb++;
+            module.tick.lsb = 0;
+        }
+
+        timer_tick_isr();
+        ticks--;
+    }
+
+    thrd_tick_isr();
+}
+
+#endif
+
 #include "sys_port.i"
 
 static void tick_to_time(struct time_t *time_p,
@@ -519,6 +549,9 @@ int sys_start(void)
 #if CONFIG_MODULE_INIT_BUS == 1
     bus_module_init();
 #endif
+#if CONFIG_MODULE_INIT_FAT16 == 1
+    fat16_module_init();
+#endif
 
     init_drivers();
     init_inet();
@@ -666,6 +699,20 @@ int sys_uptime_isr(struct time_t *uptime_p)
     return (time_add(uptime_p, uptime_p, &offset));
 }
 
+#if CONFIG_SYSTEM_TICKLESS == 1
+
+void sys_tick_idle_enter(uint32_t ticks)
+{
+    sys_port_tick_idle_enter(ticks);
+}
+
+void sys_tick_idle_exit(void)
+{
+    sys_port_tick_idle_exit();
+}
+
+#endif
+
 void sys_set_on_fatal_callback(sys_on_fatal_fn_t callback)
 {
     sys.on_fatal_callback = callback;
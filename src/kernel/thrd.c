@@ -43,11 +43,39 @@ enum thrd_state_t {
 #define THRD_STACK_LOW_MAGIC      0x1337
 #define THRD_FILL_PATTERN           0x19
 
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+
+/* One bucket per thread priority, -128..127. */
+#define READY_QUEUE_BUCKETS_MAX                          256
+#define READY_QUEUE_GROUP_BITS                            32
+#define READY_QUEUE_GROUPS_MAX                                  \
+    (READY_QUEUE_BUCKETS_MAX / READY_QUEUE_GROUP_BITS)
+
+/**
+ * The ready queue is one circular FIFO of threads per priority. A
+ * two level bitmap of non-empty buckets is used to find the highest
+ * priority ready thread with two find-first-set operations.
+ */
+struct ready_queue_t {
+    uint8_t summary;
+    uint32_t groups[READY_QUEUE_GROUPS_MAX];
+    struct thrd_t *buckets[READY_QUEUE_BUCKETS_MAX];
+};
+
+#endif
+
 struct module_t {
     int8_t initialized;
     struct {
         struct thrd_t *current_p;
+#if CONFIG_SYSTEM_TICKLESS == 1
+        struct thrd_t *idle_p;
+#endif
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+        struct ready_queue_t ready;
+#else
         struct thrd_prio_list_t ready;
+#endif
     } scheduler;
     struct thrd_t *threads_p;
 #if CONFIG_THRD_ENV == 1
@@ -141,6 +169,12 @@ static const char *get_env(struct thrd_environment_t *env_p,
 /* Forward declarations for thrd_port. */
 static void scheduler_ready_push(struct thrd_t *thrd_p);
 
+#if CONFIG_SYSTEM_TICKLESS == 1
+extern uint32_t timer_next_expiry_isr(void);
+extern void sys_tick_idle_enter(uint32_t ticks);
+extern void sys_tick_idle_exit(void);
+#endif
+
 static void thrd_reschedule(void);
 
 void terminate(void);
@@ -151,6 +185,10 @@ void terminate(void);
 #    include "thrd/thrd_monitor.i"
 #endif
 
+#if CONFIG_THRD_TRACE == 1
+#    include "thrd/thrd_trace.i"
+#endif
+
 /* Stacks. */
 static THRD_STACK(idle_thrd_stack, CONFIG_THRD_IDLE_STACK_SIZE);
 
@@ -160,10 +198,15 @@ static THRD_STACK(idle_thrd_stack, CONFIG_THRD_IDLE_STACK_SIZE);
 void terminate(void)
 {
 #if CONFIG_THRD_TERMINATE == 1
+#if CONFIG_HEAP_MAGAZINES > 0
+    heap_release_magazines(thrd_self());
+#endif
+
     /* Remove the thread from the global list of threads. */
     sys_lock();
     sem_give_isr(&thrd_self()->join_sem, 1);
     thrd_self()->state = THRD_STATE_TERMINATED;
+    THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_TERMINATE);
     thrd_reschedule();
 
     /* Should never come here. */
@@ -189,9 +232,111 @@ static void on_suspend_timer_expired(void *arg_p)
     thrd_p->state = THRD_STATE_READY;
     scheduler_ready_push(thrd_p);
 
+#if CONFIG_THRD_TRACE == 1
+    trace_on_wake(thrd_p, NULL);
+#endif
+
     thrd_port_on_suspend_timer_expired(thrd_p);
 }
 
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+
+static void ready_queue_init(struct ready_queue_t *self_p)
+{
+    memset(self_p, 0, sizeof(*self_p));
+}
+
+static RAM_CODE void ready_queue_push(struct ready_queue_t *self_p,
+                                      struct thrd_t *thrd_p)
+{
+    struct thrd_t *head_p;
+    int bucket;
+
+    bucket = (thrd_p->prio + 128);
+    head_p = self_p->buckets[bucket];
+    thrd_p->scheduler.bucket = bucket;
+
+    if (head_p == NULL) {
+        /* Empty bucket. */
+        thrd_p->scheduler.next_p = thrd_p;
+        thrd_p->scheduler.prev_p = thrd_p;
+        self_p->buckets[bucket] = thrd_p;
+        self_p->groups[bucket / READY_QUEUE_GROUP_BITS] |=
+            (1UL << (bucket % READY_QUEUE_GROUP_BITS));
+        self_p->summary |= (1 << (bucket / READY_QUEUE_GROUP_BITS));
+    } else {
+        /* Add last in the bucket, after any already pushed threads
+           with the same priority. */
+        thrd_p->scheduler.next_p = head_p;
+        thrd_p->scheduler.prev_p = head_p->scheduler.prev_p;
+        head_p->scheduler.prev_p->scheduler.next_p = thrd_p;
+        head_p->scheduler.prev_p = thrd_p;
+    }
+}
+
+static RAM_CODE void ready_queue_unlink(struct ready_queue_t *self_p,
+                                        struct thrd_t *thrd_p)
+{
+    int bucket;
+    int group;
+
+    bucket = thrd_p->scheduler.bucket;
+
+    if (thrd_p->scheduler.next_p == thrd_p) {
+        /* Last thread in the bucket. */
+        group = (bucket / READY_QUEUE_GROUP_BITS);
+        self_p->buckets[bucket] = NULL;
+        self_p->groups[group] &= ~(1UL << (bucket % READY_QUEUE_GROUP_BITS));
+
+        if (self_p->groups[group] == 0) {
+            self_p->summary &= ~(1 << group);
+        }
+    } else {
+        thrd_p->scheduler.next_p->scheduler.prev_p = thrd_p->scheduler.prev_p;
+        thrd_p->scheduler.prev_p->scheduler.next_p = thrd_p->scheduler.next_p;
+
+        if (self_p->buckets[bucket] == thrd_p) {
+            self_p->buckets[bucket] = thrd_p->scheduler.next_p;
+        }
+    }
+
+    thrd_p->scheduler.next_p = NULL;
+}
+
+static RAM_CODE struct thrd_t *ready_queue_pop(struct ready_queue_t *self_p)
+{
+    struct thrd_t *thrd_p;
+    int group;
+    int bucket;
+
+    if (self_p->summary == 0) {
+        return (NULL);
+    }
+
+    group = __builtin_ctz(self_p->summary);
+    bucket = (group * READY_QUEUE_GROUP_BITS
+              + __builtin_ctzl(self_p->groups[group]));
+    thrd_p = self_p->buckets[bucket];
+    ready_queue_unlink(self_p, thrd_p);
+
+    return (thrd_p);
+}
+
+static RAM_CODE int ready_queue_remove(struct ready_queue_t *self_p,
+                                       struct thrd_t *thrd_p)
+{
+    /* Not in the ready queue. */
+    if (thrd_p->scheduler.next_p == NULL) {
+        return (-1);
+    }
+
+    ready_queue_unlink(self_p, thrd_p);
+
+    return (0);
+}
+
+#endif
+
 /**
  * Push a thread on the list of threads that are ready to be
  * scheduled.
@@ -202,7 +347,11 @@ static void on_suspend_timer_expired(void *arg_p)
  */
 static void scheduler_ready_push(struct thrd_t *thrd_p)
 {
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+    ready_queue_push(&module.scheduler.ready, thrd_p);
+#else
     thrd_prio_list_push_isr(&module.scheduler.ready, &thrd_p->scheduler.elem);
+#endif
 }
 
 /**
@@ -212,7 +361,29 @@ static void scheduler_ready_push(struct thrd_t *thrd_p)
  */
 static struct thrd_t *scheduler_ready_pop(void)
 {
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+    return (ready_queue_pop(&module.scheduler.ready));
+#else
     return (thrd_prio_list_pop_isr(&module.scheduler.ready)->thrd_p);
+#endif
+}
+
+/**
+ * Remove given thread from the ready list, if present.
+ *
+ * @param[in] thrd_p Thread to remove.
+ *
+ * @return zero(0) if the thread was removed, otherwise negative
+ *         error code.
+ */
+static int scheduler_ready_remove(struct thrd_t *thrd_p)
+{
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+    return (ready_queue_remove(&module.scheduler.ready, thrd_p));
+#else
+    return (thrd_prio_list_remove_isr(&module.scheduler.ready,
+                                      &thrd_p->scheduler.elem));
+#endif
 }
 
 /**
@@ -239,11 +410,18 @@ static void thrd_reschedule(void)
         module.scheduler.current_p = in_p;
         thrd_port_cpu_usage_stop(out_p);
         thrd_port_cpu_usage_start(in_p);
+#if CONFIG_THRD_TRACE == 1
+        trace_on_switch(out_p, in_p);
+#endif
         thrd_port_swap(in_p, out_p);
 #if CONFIG_THRD_SCHEDULED == 1
         out_p->statistics.scheduled++;
 #endif
     }
+
+    /* The thread is running again, so the reason it stopped running
+       is no longer valid. */
+    THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_NONE);
 }
 
 #if CONFIG_PROFILE_STACK == 1
@@ -388,12 +566,27 @@ static int cmd_set_log_mask_cb(int argc,
 static void *idle_thrd(void *arg_p)
 {
     struct thrd_t *thrd_p;
+#if CONFIG_SYSTEM_TICKLESS == 1
+    uint32_t ticks;
+#endif
 
     thrd_set_name("idle");
 
     thrd_p = thrd_self();
 
+#if CONFIG_SYSTEM_TICKLESS == 1
+    module.scheduler.idle_p = thrd_p;
+#endif
+
     while (1) {
+#if CONFIG_SYSTEM_TICKLESS == 1
+        /* Let the system tick sleep until the first timer
+           expires. */
+        sys_lock();
+        ticks = timer_next_expiry_isr();
+        sys_unlock();
+        sys_tick_idle_enter(ticks);
+#endif
         thrd_port_idle_wait(thrd_p);
     }
 
@@ -411,7 +604,11 @@ int thrd_module_init(void)
 
     module.initialized = 1;
 
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+    ready_queue_init(&module.scheduler.ready);
+#else
     thrd_prio_list_init(&module.scheduler.ready);
+#endif
 
 #if CONFIG_THRD_STACK_HEAP == 1
     heap_init(&stack_heap,
@@ -435,15 +632,31 @@ int thrd_module_init(void)
     /* Main function becomes a thrd. */
     thrd_p = thrd_port_get_main_thrd();
     thrd_p->scheduler.elem.thrd_p = thrd_p;
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+    thrd_p->scheduler.next_p = NULL;
+#endif
     thrd_p->prio = 0;
     thrd_p->state = THRD_STATE_CURRENT;
     thrd_p->err = 0;
     thrd_p->log_mask = CONFIG_THRD_DEFAULT_LOG_MASK;
     thrd_p->timer_p = NULL;
     thrd_p->name_p = "main";
+#if CONFIG_HEAP_MAGAZINES > 0
+    thrd_p->heap_magazines_p = NULL;
+#endif
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    thrd_p->inheritance.prio = 0;
+    thrd_p->inheritance.inherited_prio = 127;
+    thrd_p->inheritance.owned_p = NULL;
+    thrd_p->inheritance.waiting_for_p = NULL;
+#endif
     thrd_p->next_p = NULL;
     thrd_p->stack_size = (thrd_port_get_main_thrd_stack_top() - (char *)(thrd_p + 1));
 
+#if CONFIG_THRD_TRACE == 1
+    trace_on_spawn(thrd_p);
+#endif
+
 #if CONFIG_THRD_TERMINATE == 1
     sem_init(&thrd_p->join_sem, 1, 1);
 #endif
@@ -512,6 +725,10 @@ int thrd_module_init(void)
 #    endif
 #endif
 
+#if CONFIG_THRD_TRACE == 1
+    trace_module_init();
+#endif
+
     return (0);
 }
 
@@ -531,14 +748,32 @@ struct thrd_t *thrd_spawn(void *(*main)(void *),
     /* Initialize thrd structure in the beginning of the stack. */
     thrd_p = stack_p;
     thrd_p->scheduler.elem.thrd_p = thrd_p;
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+    thrd_p->scheduler.next_p = NULL;
+#endif
     thrd_p->prio = prio;
     thrd_p->state = THRD_STATE_READY;
     thrd_p->err = 0;
     thrd_p->log_mask = CONFIG_THRD_DEFAULT_LOG_MASK;
     thrd_p->timer_p = NULL;
     thrd_p->name_p = "";
+#if CONFIG_HEAP_MAGAZINES > 0
+    thrd_p->heap_magazines_p = NULL;
+#endif
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    thrd_p->inheritance.prio = prio;
+    thrd_p->inheritance.inherited_prio = 127;
+    thrd_p->inheritance.owned_p = NULL;
+    thrd_p->inheritance.waiting_for_p = NULL;
+#endif
     thrd_p->stack_size = (stack_size - sizeof(*thrd_p));
 
+#if CONFIG_THRD_TRACE == 1
+    sys_lock();
+    trace_on_spawn(thrd_p);
+    sys_unlock();
+#endif
+
 #if CONFIG_THRD_TERMINATE == 1
     sem_init(&thrd_p->join_sem, 1, 1);
 #endif
@@ -606,6 +841,7 @@ int thrd_yield(void)
     int res;
 
     sys_lock();
+    THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_YIELD);
     res = thrd_yield_isr();
     sys_unlock();
 
@@ -628,9 +864,12 @@ int thrd_join(struct thrd_t *thrd_p)
 
 int thrd_terminate(struct thrd_t *thrd_p)
 {
+#if CONFIG_HEAP_MAGAZINES > 0
+    heap_release_magazines(thrd_p);
+#endif
+
     sys_lock();
-    thrd_prio_list_remove_isr(&module.scheduler.ready,
-                              &thrd_p->scheduler.elem);
+    scheduler_ready_remove(thrd_p);
 #if CONFIG_THRD_TERMINATE == 1
     sem_give_isr(&thrd_self()->join_sem, 1);
 #endif
@@ -657,16 +896,20 @@ int thrd_sleep_ms(int milliseconds)
 int thrd_sleep_us(long microseconds)
 {
     struct time_t timeout;
+    int res;
 
     timeout.seconds = (microseconds / 1000000);
     timeout.nanoseconds = 1000 * (microseconds % 1000000);
 
-#if CONFIG_PANIC_ASSERT == 0
-    thrd_suspend(&timeout);
-#else
-    int res;
-    res = thrd_suspend(&timeout);
+    sys_lock();
+    THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_SLEEP);
+    res = thrd_suspend_isr(&timeout);
+    sys_unlock();
+
+#if CONFIG_PANIC_ASSERT == 1
     PANIC_ASSERT(res == -ETIMEDOUT);
+#else
+    (void)res;
 #endif
 
     return (0);
@@ -723,11 +966,37 @@ int thrd_get_log_mask(void)
     return (module.scheduler.current_p->log_mask);
 }
 
+/**
+ * Change the scheduling priority of given thread. A ready thread is
+ * moved to its new position in the ready list.
+ */
+static void thrd_update_prio_isr(struct thrd_t *thrd_p, int prio)
+{
+    if (prio == thrd_p->prio) {
+        return;
+    }
+
+    if (scheduler_ready_remove(thrd_p) == 0) {
+        thrd_p->prio = prio;
+        scheduler_ready_push(thrd_p);
+    } else {
+        thrd_p->prio = prio;
+    }
+}
+
 int thrd_set_prio(struct thrd_t *thrd_p, int prio)
 {
     ASSERTN(thrd_p != NULL, EINVAL);
 
-    thrd_p->prio = prio;
+    sys_lock();
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    thrd_p->inheritance.prio = prio;
+    thrd_update_prio_isr(thrd_p,
+                         MIN(prio, thrd_p->inheritance.inherited_prio));
+#else
+    thrd_update_prio_isr(thrd_p, prio);
+#endif
+    sys_unlock();
 
     return (0);
 }
@@ -737,6 +1006,18 @@ int thrd_get_prio(void)
     return (module.scheduler.current_p->prio);
 }
 
+int thrd_set_inherited_prio_isr(struct thrd_t *thrd_p, int prio)
+{
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    thrd_p->inheritance.inherited_prio = prio;
+    thrd_update_prio_isr(thrd_p, MIN(thrd_p->inheritance.prio, prio));
+
+    return (0);
+#else
+    return (-ENOSYS);
+#endif
+}
+
 int thrd_init_global_env(struct thrd_environment_variable_t *variables_p,
                          int length)
 {
@@ -851,22 +1132,32 @@ int thrd_suspend_isr(const struct time_t *timeout_p)
     if (thrd_p->state == THRD_STATE_RESUMED) {
         thrd_p->state = THRD_STATE_READY;
         scheduler_ready_push(thrd_p);
+    } else if ((timeout_p != NULL)
+               && (timeout_p->seconds <= 0)
+               && (timeout_p->nanoseconds <= 0)) {
+        /* Do not suspend at all on zero timeout. The thread is still
+           the current thread. */
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_NONE);
+
+        return (-ETIMEDOUT);
     } else {
         thrd_p->state = THRD_STATE_SUSPENDED;
 
+#if CONFIG_THRD_TRACE == 1
+        if (thrd_p->trace.reason == THRD_TRACE_REASON_NONE) {
+            thrd_p->trace.reason = THRD_TRACE_REASON_SUSPEND;
+        }
+#endif
+
         if (timeout_p != NULL) {
-            if ((timeout_p->seconds <= 0) && (timeout_p->nanoseconds <= 0)) {
-                return (-ETIMEDOUT);
-            } else {
-                PANIC_ASSERT(thrd_p->timer_p == NULL);
-                thrd_p->timer_p = &timer;
-                timer_init(&timer,
-                           timeout_p,
-                           on_suspend_timer_expired,
-                           thrd_p,
-                           0);
-                timer_start_isr(&timer);
-            }
+            PANIC_ASSERT(thrd_p->timer_p == NULL);
+            thrd_p->timer_p = &timer;
+            timer_init(&timer,
+                       timeout_p,
+                       on_suspend_timer_expired,
+                       thrd_p,
+                       0);
+            timer_start_isr(&timer);
         }
     }
 
@@ -892,6 +1183,18 @@ int thrd_resume_isr(struct thrd_t *thrd_p, int err)
         }
 
         scheduler_ready_push(thrd_p);
+
+#if CONFIG_THRD_TRACE == 1
+        trace_on_wake(thrd_p, module.scheduler.current_p);
+#endif
+
+#if CONFIG_SYSTEM_TICKLESS == 1
+        /* The system tick may be stopped, so wake up the idle thread
+           to let the resumed thread run. */
+        if (module.scheduler.current_p == module.scheduler.idle_p) {
+            thrd_port_on_resume_idle_isr();
+        }
+#endif
     } else if (thrd_p->state != THRD_STATE_TERMINATED) {
         thrd_p->state = THRD_STATE_RESUMED;
     } else {
@@ -1028,3 +1331,44 @@ RAM_CODE int thrd_prio_list_remove_isr(struct thrd_prio_list_t *self_p,
 
     return (-1);
 }
+
+#if CONFIG_THRD_TRACE == 0
+
+int thrd_trace_start(void)
+{
+    return (-ENOSYS);
+}
+
+int thrd_trace_stop(void)
+{
+    return (-ENOSYS);
+}
+
+int thrd_trace_reset(void)
+{
+    return (-ENOSYS);
+}
+
+ssize_t thrd_trace_get_events(struct thrd_trace_event_t *events_p,
+                              size_t length)
+{
+    return (-ENOSYS);
+}
+
+int thrd_trace_get_statistics(struct thrd_t *thrd_p,
+                              struct thrd_trace_statistics_t *statistics_p)
+{
+    return (-ENOSYS);
+}
+
+int thrd_trace_export_chrome(void *chan_p)
+{
+    return (-ENOSYS);
+}
+
+int thrd_trace_set_reason_isr(int reason)
+{
+    return (-ENOSYS);
+}
+
+#endif
@@ -69,6 +69,80 @@
         THRD_CONTEXT_LOAD_ISR;                  \
     } while (0)
 
+/**
+ * Set the reason the current thread is about to be suspended for, as
+ * recorded by the scheduler trace. Must be called with the system
+ * lock taken, just before calling `thrd_suspend_isr()`.
+ */
+#if CONFIG_THRD_TRACE == 1
+#    define THRD_TRACE_SET_REASON_ISR(reason)   \
+    thrd_trace_set_reason_isr(reason)
+#else
+#    define THRD_TRACE_SET_REASON_ISR(reason)
+#endif
+
+/**
+ * Scheduler trace event types.
+ */
+enum thrd_trace_event_type_t {
+    /** The thread started running. */
+    THRD_TRACE_EVENT_SWITCH_IN = 0,
+    /** The thread stopped running. The reason is why. */
+    THRD_TRACE_EVENT_SWITCH_OUT,
+    /** The suspended thread was resumed by the other thread, or by a
+        timeout if the other thread is NULL. The reason is what it
+        was suspended for. */
+    THRD_TRACE_EVENT_WAKE
+};
+
+/**
+ * Why a thread stopped running.
+ */
+enum thrd_trace_reason_t {
+    /** Preempted by another thread. */
+    THRD_TRACE_REASON_NONE = 0,
+    THRD_TRACE_REASON_YIELD,
+    /** Suspended by a call to `thrd_suspend()` or
+        `thrd_suspend_isr()` without a more specific reason. */
+    THRD_TRACE_REASON_SUSPEND,
+    THRD_TRACE_REASON_SLEEP,
+    THRD_TRACE_REASON_MUTEX,
+    THRD_TRACE_REASON_RWLOCK,
+    THRD_TRACE_REASON_SEM,
+    THRD_TRACE_REASON_COND,
+    THRD_TRACE_REASON_EVENT,
+    THRD_TRACE_REASON_QUEUE,
+    THRD_TRACE_REASON_POLL,
+    THRD_TRACE_REASON_TERMINATE,
+    THRD_TRACE_REASON_MAX
+};
+
+/**
+ * A scheduler trace event. Times are in microseconds.
+ */
+struct thrd_trace_event_t {
+    uint32_t time;
+    struct thrd_t *thrd_p;
+    struct thrd_t *other_p;
+    uint8_t type;
+    uint8_t reason;
+};
+
+/**
+ * Scheduler trace statistics of a thread. Times are in microseconds.
+ */
+struct thrd_trace_statistics_t {
+    /** Time spent running. */
+    uint32_t run_time;
+    /** Time spent ready to run, waiting for other threads. */
+    uint32_t ready_time;
+    /** Time spent suspended, per reason. */
+    uint32_t suspended_time[THRD_TRACE_REASON_MAX];
+    /** Number of times the thread stopped running by itself. */
+    uint32_t voluntary_switches;
+    /** Number of times the thread was preempted. */
+    uint32_t involuntary_switches;
+};
 
 /**
  * A thread environment variable.
@@ -87,6 +161,11 @@ struct thrd_environment_t {
 struct thrd_t {
     struct {
         struct thrd_prio_list_elem_t elem;
+#if CONFIG_THRD_READY_QUEUE_BITMAP == 1
+        struct thrd_t *next_p;
+        struct thrd_t *prev_p;
+        uint8_t bucket;
+#endif
     } scheduler;
     struct thrd_port_t port;
     int8_t prio;
@@ -96,6 +175,10 @@ struct thrd_t {
     struct timer_t *timer_p;
     const char *name_p;
     struct thrd_t *next_p;
+#if CONFIG_HEAP_MAGAZINES > 0
+    /** Heap caches of this thread, released when it terminates. */
+    struct heap_magazine_t *heap_magazines_p;
+#endif
 # if CONFIG_THRD_TERMINATE == 1
     struct sem_t join_sem;
 #endif
@@ -113,8 +196,29 @@ struct thrd_t {
         uint32_t scheduled;
 #endif
     } statistics;
+#if CONFIG_THRD_TRACE == 1
+    struct {
+        /** Trace time of the last state change. */
+        uint32_t time;
+        uint8_t reason;
+        struct thrd_trace_statistics_t statistics;
+    } trace;
+#endif
 #if CONFIG_THRD_ENV == 1
     struct thrd_environment_t env;
+#endif
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    struct {
+        /** Priority of the thread itself. */
+        int8_t prio;
+        /** Priority inherited from threads waiting for mutexes owned
+            by this thread. */
+        int8_t inherited_prio;
+        /** Owned priority inheritance mutexes. */
+        struct mutex_t *owned_p;
+        /** Priority inheritance mutex this thread is waiting for. */
+        struct mutex_t *waiting_for_p;
+    } inheritance;
 #endif
     size_t stack_size;
 #if CONFIG_PANIC_ASSERT == 1
@@ -303,6 +407,21 @@ int thrd_set_prio(struct thrd_t *thrd_p, int prio);
  */
 int thrd_get_prio(void);
 
+/**
+ * Set the priority given thread inherits from threads waiting for
+ * mutexes it owns. The thread is scheduled with the highest of its
+ * own and the inherited priority.
+ *
+ * This function may only be called from an isr or with the system
+ * lock taken (see `sys_lock()`).
+ *
+ * @param[in] thrd_p Thread to set the inherited priority for.
+ * @param[in] prio Inherited priority, or 127 for none.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_set_inherited_prio_isr(struct thrd_t *thrd_p, int prio);
+
 /**
  * Initialize the global environment variables storage. These
  * variables are shared among all threads.
@@ -478,4 +597,76 @@ struct thrd_prio_list_elem_t *thrd_prio_list_pop_isr(
 int thrd_prio_list_remove_isr(struct thrd_prio_list_t *self_p,
                               struct thrd_prio_list_elem_t *elem_p);
 
+/**
+ * Start recording scheduler events and thread statistics. Requires
+ * `CONFIG_THRD_TRACE`.
+ *
+ * The event timestamps are accumulated from `time_micros()` deltas,
+ * so periods longer than `time_micros_maximum()` without scheduler
+ * events, for example in tickless idle, are shortened.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_start(void);
+
+/**
+ * Stop recording scheduler events and thread statistics.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_stop(void);
+
+/**
+ * Discard all recorded events and clear the statistics of all
+ * threads.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_reset(void);
+
+/**
+ * Copy the recorded events, oldest first, to given buffer. The event
+ * ring overwrites the oldest events when full.
+ *
+ * @param[out] events_p Buffer to copy events to.
+ * @param[in] length Number of events that fit in given buffer.
+ *
+ * @return Number of copied events or negative error code.
+ */
+ssize_t thrd_trace_get_events(struct thrd_trace_event_t *events_p,
+                              size_t length);
+
+/**
+ * Get the trace statistics of given thread, including the time spent
+ * in its current state.
+ *
+ * @param[in] thrd_p Thread.
+ * @param[out] statistics_p Statistics of given thread.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_get_statistics(struct thrd_t *thrd_p,
+                              struct thrd_trace_statistics_t *statistics_p);
+
+/**
+ * Write the recorded events in the Chrome trace event JSON format to
+ * given channel. Open the output in chrome://tracing or Perfetto.
+ *
+ * @param[in] chan_p Output channel.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_export_chrome(void *chan_p);
+
+/**
+ * Set the reason the current thread is about to be suspended
+ * for. Use `THRD_TRACE_SET_REASON_ISR()` instead of calling this
+ * function directly.
+ *
+ * @param[in] reason Suspend reason.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_set_reason_isr(int reason);
+
 #endif
@@ -0,0 +1,668 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+struct trace_t {
+    int started;
+    /* Trace clock in microseconds since startup. */
+    uint32_t time;
+    int micros;
+    /* Total number of recorded events. The ring holds the last
+       CONFIG_THRD_TRACE_EVENTS_MAX of them. */
+    uint32_t count;
+    struct thrd_trace_event_t events[CONFIG_THRD_TRACE_EVENTS_MAX];
+#if CONFIG_THRD_FS_COMMANDS == 1
+    struct fs_command_t cmd_start;
+    struct fs_command_t cmd_stop;
+    struct fs_command_t cmd_reset;
+    struct fs_command_t cmd_list;
+    struct fs_command_t cmd_print;
+    struct fs_command_t cmd_export;
+#endif
+};
+
+static struct trace_t trace;
+
+static const char FAR *const FAR reason_names[] = {
+    "preempted",
+    "yield",
+    "suspend",
+    "sleep",
+    "mutex",
+    "rwlock",
+    "sem",
+    "cond",
+    "event",
+    "queue",
+    "poll",
+    "terminate"
+};
+
+static const char FAR *const FAR event_type_names[] = {
+    "in",
+    "out",
+    "wake"
+};
+
+#define TRACE_TICK_MICROS (1000000L / CONFIG_SYSTEM_TICK_FREQUENCY)
+
+/**
+ * Advance the trace clock to now. Must be called with the system lock
+ * taken.
+ *
+ * The clock is advanced by time_micros() deltas for sub-tick
+ * resolution, and kept within one tick from the system uptime, as
+ * time_micros() wraps within a tick on some ports and every second on
+ * Linux.
+ */
+static uint32_t trace_now(void)
+{
+    struct time_t uptime;
+    uint32_t uptime_time;
+    uint32_t time;
+    int32_t ahead;
+    int micros;
+
+    sys_uptime_isr(&uptime);
+    uptime_time = (1000000UL * uptime.seconds + uptime.nanoseconds / 1000);
+    micros = time_micros();
+    time = (trace.time + time_micros_elapsed(trace.micros, micros));
+    trace.micros = micros;
+    ahead = (int32_t)(time - uptime_time);
+
+    if (ahead < 0) {
+        /* time_micros() wrapped more than once since last call. */
+        time = uptime_time;
+    } else if (ahead > TRACE_TICK_MICROS) {
+        time = (uptime_time + TRACE_TICK_MICROS);
+    }
+
+    trace.time = time;
+
+    return (time);
+}
+
+static void trace_record(uint32_t time,
+                         int type,
+                         struct thrd_t *thrd_p,
+                         struct thrd_t *other_p,
+                         int reason)
+{
+    struct thrd_trace_event_t *event_p;
+
+    event_p = &trace.events[trace.count % CONFIG_THRD_TRACE_EVENTS_MAX];
+    event_p->time = time;
+    event_p->thrd_p = thrd_p;
+    event_p->other_p = other_p;
+    event_p->type = type;
+    event_p->reason = reason;
+    trace.count++;
+}
+
+/**
+ * Returns the time since the last state change of given thread, and
+ * makes now the time of its last state change.
+ */
+static uint32_t trace_state_time(struct thrd_t *thrd_p, uint32_t now)
+{
+    uint32_t time;
+
+    time = (now - thrd_p->trace.time);
+    thrd_p->trace.time = now;
+
+    return (time);
+}
+
+static void trace_on_spawn(struct thrd_t *thrd_p)
+{
+    memset(&thrd_p->trace, 0, sizeof(thrd_p->trace));
+
+    if (trace.started == 1) {
+        thrd_p->trace.time = trace_now();
+    }
+}
+
+static void trace_on_switch(struct thrd_t *out_p, struct thrd_t *in_p)
+{
+    uint32_t now;
+    int reason;
+
+    if (trace.started == 0) {
+        return;
+    }
+
+    now = trace_now();
+    reason = out_p->trace.reason;
+
+    if (out_p->state == THRD_STATE_TERMINATED) {
+        reason = THRD_TRACE_REASON_TERMINATE;
+    }
+
+    out_p->trace.statistics.run_time += trace_state_time(out_p, now);
+
+    if (reason == THRD_TRACE_REASON_NONE) {
+        out_p->trace.statistics.involuntary_switches++;
+    } else {
+        out_p->trace.statistics.voluntary_switches++;
+    }
+
+    trace_record(now, THRD_TRACE_EVENT_SWITCH_OUT, out_p, in_p, reason);
+
+    in_p->trace.statistics.ready_time += trace_state_time(in_p, now);
+    trace_record(now,
+                 THRD_TRACE_EVENT_SWITCH_IN,
+                 in_p,
+                 out_p,
+                 THRD_TRACE_REASON_NONE);
+}
+
+/**
+ * Given suspended thread is ready to run again. The other thread is
+ * NULL on timeout.
+ */
+static void trace_on_wake(struct thrd_t *thrd_p, struct thrd_t *other_p)
+{
+    uint32_t now;
+    int reason;
+
+    if (trace.started == 0) {
+        return;
+    }
+
+    now = trace_now();
+    reason = thrd_p->trace.reason;
+    thrd_p->trace.statistics.suspended_time[reason] +=
+        trace_state_time(thrd_p, now);
+    trace_record(now, THRD_TRACE_EVENT_WAKE, thrd_p, other_p, reason);
+}
+
+/**
+ * Get the name of given thread, or NULL if it no longer exists.
+ */
+static const char *trace_get_name(struct thrd_t *thrd_p)
+{
+    struct thrd_t *curr_p;
+
+    curr_p = module.threads_p;
+
+    while (curr_p != NULL) {
+        if (curr_p == thrd_p) {
+            return (thrd_p->name_p);
+        }
+
+        curr_p = curr_p->next_p;
+    }
+
+    return (NULL);
+}
+
+/**
+ * Get a copy of the recorded event with given sequence number, which
+ * may have been overwritten since it was recorded.
+ */
+static int trace_get_event(uint32_t sequence,
+                           struct thrd_trace_event_t *event_p)
+{
+    int res;
+
+    res = -1;
+
+    sys_lock();
+
+    if ((trace.count - sequence - 1) < CONFIG_THRD_TRACE_EVENTS_MAX) {
+        *event_p = trace.events[sequence % CONFIG_THRD_TRACE_EVENTS_MAX];
+        res = 0;
+    }
+
+    sys_unlock();
+
+    return (res);
+}
+
+static uint32_t trace_get_oldest_sequence(uint32_t count)
+{
+    if (count > CONFIG_THRD_TRACE_EVENTS_MAX) {
+        return (count - CONFIG_THRD_TRACE_EVENTS_MAX);
+    } else {
+        return (0);
+    }
+}
+
+#if CONFIG_THRD_FS_COMMANDS == 1
+
+static int cmd_trace_start_cb(int argc,
+                              const char *argv[],
+                              void *chout_p,
+                              void *chin_p,
+                              void *arg_p,
+                              void *call_arg_p)
+{
+    return (thrd_trace_start());
+}
+
+static int cmd_trace_stop_cb(int argc,
+                             const char *argv[],
+                             void *chout_p,
+                             void *chin_p,
+                             void *arg_p,
+                             void *call_arg_p)
+{
+    return (thrd_trace_stop());
+}
+
+static int cmd_trace_reset_cb(int argc,
+                              const char *argv[],
+                              void *chout_p,
+                              void *chin_p,
+                              void *arg_p,
+                              void *call_arg_p)
+{
+    return (thrd_trace_reset());
+}
+
+static int cmd_trace_list_cb(int argc,
+                             const char *argv[],
+                             void *chout_p,
+                             void *chin_p,
+                             void *arg_p,
+                             void *call_arg_p)
+{
+    struct thrd_t *thrd_p;
+    struct thrd_trace_statistics_t statistics;
+    int i;
+
+    std_fprintf(chout_p,
+                OSTR("                NAME     RUN-US   READY-US"
+                     "  VOLUNTARY  INVOLUNTARY  SUSPENDED-US\r\n"));
+
+    thrd_p = module.threads_p;
+
+    while (thrd_p != NULL) {
+        thrd_trace_get_statistics(thrd_p, &statistics);
+        std_fprintf(chout_p,
+                    OSTR("%20s %10lu %10lu %10lu   %10lu "),
+                    thrd_p->name_p,
+                    (unsigned long)statistics.run_time,
+                    (unsigned long)statistics.ready_time,
+                    (unsigned long)statistics.voluntary_switches,
+                    (unsigned long)statistics.involuntary_switches);
+
+        for (i = 0; i < THRD_TRACE_REASON_MAX; i++) {
+            if (statistics.suspended_time[i] > 0) {
+                std_fprintf(chout_p,
+                            OSTR(" %s=%lu"),
+                            reason_names[i],
+                            (unsigned long)statistics.suspended_time[i]);
+            }
+        }
+
+        std_fprintf(chout_p, OSTR("\r\n"));
+        thrd_p = thrd_p->next_p;
+    }
+
+    return (0);
+}
+
+static void print_thrd(void *chout_p, struct thrd_t *thrd_p)
+{
+    const char *name_p;
+
+    name_p = trace_get_name(thrd_p);
+
+    if (name_p != NULL) {
+        std_fprintf(chout_p, OSTR(" %20s"), name_p);
+    } else {
+        std_fprintf(chout_p, OSTR(" %20lx"), (unsigned long)thrd_p);
+    }
+}
+
+static int cmd_trace_print_cb(int argc,
+                              const char *argv[],
+                              void *chout_p,
+                              void *chin_p,
+                              void *arg_p,
+                              void *call_arg_p)
+{
+    struct thrd_trace_event_t event;
+    uint32_t sequence;
+    uint32_t count;
+
+    std_fprintf(chout_p,
+                OSTR("   TIME-US  TYPE               THREAD"
+                     "                OTHER  REASON\r\n"));
+
+    count = trace.count;
+
+    for (sequence = trace_get_oldest_sequence(count);
+         sequence != count;
+         sequence++) {
+        if (trace_get_event(sequence, &event) != 0) {
+            continue;
+        }
+
+        std_fprintf(chout_p,
+                    OSTR("%10lu  %4s"),
+                    (unsigned long)event.time,
+                    event_type_names[event.type]);
+        print_thrd(chout_p, event.thrd_p);
+
+        if (event.other_p != NULL) {
+            print_thrd(chout_p, event.other_p);
+        } else {
+            std_fprintf(chout_p, OSTR(" %20s"), "-");
+        }
+
+        if (event.type == THRD_TRACE_EVENT_SWITCH_IN) {
+            std_fprintf(chout_p, OSTR("\r\n"));
+        } else {
+            std_fprintf(chout_p,
+                        OSTR("  %s\r\n"),
+                        reason_names[event.reason]);
+        }
+    }
+
+    return (0);
+}
+
+static int cmd_trace_export_cb(int argc,
+                               const char *argv[],
+                               void *chout_p,
+                               void *chin_p,
+                               void *arg_p,
+                               void *call_arg_p)
+{
+    return (thrd_trace_export_chrome(chout_p));
+}
+
+#endif
+
+static void trace_module_init(void)
+{
+#if CONFIG_THRD_FS_COMMANDS == 1
+    fs_command_init(&trace.cmd_start,
+                    CSTR("/kernel/thrd/trace/start"),
+                    cmd_trace_start_cb,
+                    NULL);
+    fs_command_register(&trace.cmd_start);
+
+    fs_command_init(&trace.cmd_stop,
+                    CSTR("/kernel/thrd/trace/stop"),
+                    cmd_trace_stop_cb,
+                    NULL);
+    fs_command_register(&trace.cmd_stop);
+
+    fs_command_init(&trace.cmd_reset,
+                    CSTR("/kernel/thrd/trace/reset"),
+                    cmd_trace_reset_cb,
+                    NULL);
+    fs_command_register(&trace.cmd_reset);
+
+    fs_command_init(&trace.cmd_list,
+                    CSTR("/kernel/thrd/trace/list"),
+                    cmd_trace_list_cb,
+                    NULL);
+    fs_command_register(&trace.cmd_list);
+
+    fs_command_init(&trace.cmd_print,
+                    CSTR("/kernel/thrd/trace/print"),
+                    cmd_trace_print_cb,
+                    NULL);
+    fs_command_register(&trace.cmd_print);
+
+    fs_command_init(&trace.cmd_export,
+                    CSTR("/kernel/thrd/trace/export"),
+                    cmd_trace_export_cb,
+                    NULL);
+    fs_command_register(&trace.cmd_export);
+#endif
+}
+
+int thrd_trace_start(void)
+{
+    struct thrd_t *thrd_p;
+    uint32_t now;
+
+    sys_lock();
+
+    if (trace.started == 0) {
+        trace.micros = time_micros();
+        now = trace_now();
+        thrd_p = module.threads_p;
+
+        while (thrd_p != NULL) {
+            thrd_p->trace.time = now;
+            thrd_p = thrd_p->next_p;
+        }
+
+        trace.started = 1;
+    }
+
+    sys_unlock();
+
+    return (0);
+}
+
+int thrd_trace_stop(void)
+{
+    sys_lock();
+    trace.started = 0;
+    sys_unlock();
+
+    return (0);
+}
+
+int thrd_trace_reset(void)
+{
+    struct thrd_t *thrd_p;
+    uint32_t now;
+
+    sys_lock();
+
+    trace.count = 0;
+    now = trace_now();
+    thrd_p = module.threads_p;
+
+    while (thrd_p != NULL) {
+        memset(&thrd_p->trace.statistics,
+               0,
+               sizeof(thrd_p->trace.statistics));
+        thrd_p->trace.time = now;
+        thrd_p = thrd_p->next_p;
+    }
+
+    sys_unlock();
+
+    return (0);
+}
+
+ssize_t thrd_trace_get_events(struct thrd_trace_event_t *events_p,
+                              size_t length)
+{
+    ASSERTN(events_p != NULL, EINVAL);
+
+    uint32_t sequence;
+    size_t i;
+
+    sys_lock();
+
+    sequence = trace_get_oldest_sequence(trace.count);
+
+    for (i = 0; (i < length) && (sequence != trace.count); i++) {
+        events_p[i] = trace.events[sequence % CONFIG_THRD_TRACE_EVENTS_MAX];
+        sequence++;
+    }
+
+    sys_unlock();
+
+    return (i);
+}
+
+int thrd_trace_get_statistics(struct thrd_t *thrd_p,
+                              struct thrd_trace_statistics_t *statistics_p)
+{
+    ASSERTN(thrd_p != NULL, EINVAL);
+    ASSERTN(statistics_p != NULL, EINVAL);
+
+    uint32_t time;
+
+    sys_lock();
+
+    *statistics_p = thrd_p->trace.statistics;
+
+    /* Add the time spent in the current state. */
+    if (trace.started == 1) {
+        time = (trace_now() - thrd_p->trace.time);
+
+        switch (thrd_p->state) {
+
+        case THRD_STATE_CURRENT:
+            statistics_p->run_time += time;
+            break;
+
+        case THRD_STATE_READY:
+            statistics_p->ready_time += time;
+            break;
+
+        case THRD_STATE_SUSPENDED:
+            statistics_p->suspended_time[thrd_p->trace.reason] += time;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    sys_unlock();
+
+    return (0);
+}
+
+/**
+ * Write given event in the Chrome trace event format. Thread ids are
+ * the thread pointers.
+ */
+static void export_chrome_event(void *chan_p,
+                                struct thrd_trace_event_t *event_p)
+{
+    const char *name_p;
+
+    switch (event_p->type) {
+
+    case THRD_TRACE_EVENT_SWITCH_IN:
+        std_fprintf(chan_p,
+                    OSTR(",\n{\"name\":\"running\",\"ph\":\"B\","
+                         "\"pid\":1,\"tid\":%lu,\"ts\":%lu}"),
+                    (unsigned long)event_p->thrd_p,
+                    (unsigned long)event_p->time);
+        break;
+
+    case THRD_TRACE_EVENT_SWITCH_OUT:
+        std_fprintf(chan_p,
+                    OSTR(",\n{\"name\":\"running\",\"ph\":\"E\","
+                         "\"pid\":1,\"tid\":%lu,\"ts\":%lu,"
+                         "\"args\":{\"reason\":\"%s\"}}"),
+                    (unsigned long)event_p->thrd_p,
+                    (unsigned long)event_p->time,
+                    reason_names[event_p->reason]);
+        break;
+
+    case THRD_TRACE_EVENT_WAKE:
+        if (event_p->other_p == NULL) {
+            name_p = "timeout";
+        } else {
+            name_p = trace_get_name(event_p->other_p);
+
+            if (name_p == NULL) {
+                name_p = "terminated";
+            }
+        }
+
+        std_fprintf(chan_p,
+                    OSTR(",\n{\"name\":\"wake\",\"ph\":\"i\",\"s\":\"t\","
+                         "\"pid\":1,\"tid\":%lu,\"ts\":%lu,"
+                         "\"args\":{\"reason\":\"%s\",\"by\":\"%s\"}}"),
+                    (unsigned long)event_p->thrd_p,
+                    (unsigned long)event_p->time,
+                    reason_names[event_p->reason],
+                    name_p);
+        break;
+
+    default:
+        break;
+    }
+}
+
+int thrd_trace_export_chrome(void *chan_p)
+{
+    ASSERTN(chan_p != NULL, EINVAL);
+
+    struct thrd_trace_event_t event;
+    struct thrd_t *thrd_p;
+    uint32_t sequence;
+    uint32_t count;
+
+    /* Thread names as metadata events. */
+    std_fprintf(chan_p,
+                OSTR("{\"traceEvents\":[\n"
+                     "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                     "\"args\":{\"name\":\"simba\"}}"));
+
+    thrd_p = module.threads_p;
+
+    while (thrd_p != NULL) {
+        std_fprintf(chan_p,
+                    OSTR(",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+                         "\"pid\":1,\"tid\":%lu,"
+                         "\"args\":{\"name\":\"%s\"}}"),
+                    (unsigned long)thrd_p,
+                    thrd_p->name_p);
+        thrd_p = thrd_p->next_p;
+    }
+
+    count = trace.count;
+
+    for (sequence = trace_get_oldest_sequence(count);
+         sequence != count;
+         sequence++) {
+        if (trace_get_event(sequence, &event) == 0) {
+            export_chrome_event(chan_p, &event);
+        }
+    }
+
+    std_fprintf(chan_p, OSTR("\n]}\n"));
+
+    return (0);
+}
+
+int thrd_trace_set_reason_isr(int reason)
+{
+    thrd_self()->trace.reason = reason;
+
+    return (0);
+}
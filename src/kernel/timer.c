@@ -43,15 +43,45 @@ struct timer_list_t {
     struct timer_t tail;     /* Tail element of list. */
 };
 
+#if CONFIG_TIMER_WHEEL == 1
+
+#define TIMER_WHEEL_LEVELS                                     4
+#define TIMER_WHEEL_SLOT_BITS                                  6
+#define TIMER_WHEEL_SLOTS              (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK                (TIMER_WHEEL_SLOTS - 1)
+
+/* Timeouts longer than this are parked in the last level and
+   re-inserted when cascaded. */
+#define TIMER_WHEEL_TICKS_MAX                                           \
+    ((1UL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1)
+
+/**
+ * A hierarchical timing wheel. Level zero has one slot per tick, and
+ * each following level has one slot per revolution of the previous
+ * level. Timers are cascaded to a lower level when the previous level
+ * wraps.
+ */
+struct timer_wheel_t {
+    uint32_t tick;           /* Next tick to process. */
+    struct timer_t *slots_p[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+};
+
+#endif
+
 struct module_t {
     struct {
+#if CONFIG_TIMER_WHEEL == 1
+        struct timer_wheel_t tick;
+#else
         struct timer_list_t tick;
+#endif
         struct timer_list_t high_resolution;
     } timers;
 };
 
 static struct module_t module = {
     .timers = {
+#if CONFIG_TIMER_WHEEL == 0
         .tick = {
             .head_p = &module.timers.tick.tail,
             .tail = {
@@ -59,6 +89,7 @@ static struct module_t module = {
                 .delta = 0xffffffff
             }
         },
+#endif
         .high_resolution = {
             .head_p = &module.timers.high_resolution.tail,
             .tail = {
@@ -143,13 +174,254 @@ static int timer_list_remove_isr(struct timer_list_t *self_p,
     return (0);
 }
 
+#if CONFIG_TIMER_WHEEL == 1
+
+/**
+ * Add given timer first in given slot.
+ */
+static void RAM_CODE timer_wheel_link_isr(struct timer_t **slot_pp,
+                                          struct timer_t *timer_p)
+{
+    timer_p->next_p = *slot_pp;
+
+    if (timer_p->next_p != NULL) {
+        timer_p->next_p->pprev_p = &timer_p->next_p;
+    }
+
+    timer_p->pprev_p = slot_pp;
+    *slot_pp = timer_p;
+}
+
+/**
+ * Remove given timer from the slot it is in.
+ */
+static void RAM_CODE timer_wheel_unlink_isr(struct timer_t *timer_p)
+{
+    *timer_p->pprev_p = timer_p->next_p;
+
+    if (timer_p->next_p != NULL) {
+        timer_p->next_p->pprev_p = timer_p->pprev_p;
+    }
+
+    timer_p->pprev_p = NULL;
+}
+
+/**
+ * Add given timer to the slot matching its expiry tick, which is
+ * stored in its delta member.
+ */
+static void RAM_CODE timer_wheel_add_isr(struct timer_wheel_t *self_p,
+                                         struct timer_t *timer_p)
+{
+    uint32_t expires;
+    uint32_t ticks;
+    int level;
+
+    expires = timer_p->delta;
+    ticks = (expires - self_p->tick);
+
+    if ((int32_t)ticks < 0) {
+        /* Already expired. Fire on next tick. */
+        expires = self_p->tick;
+        ticks = 0;
+    } else if (ticks > TIMER_WHEEL_TICKS_MAX) {
+        expires = (self_p->tick + TIMER_WHEEL_TICKS_MAX);
+        ticks = TIMER_WHEEL_TICKS_MAX;
+    }
+
+    level = 0;
+
+    while (ticks >= TIMER_WHEEL_SLOTS) {
+        ticks >>= TIMER_WHEEL_SLOT_BITS;
+        level++;
+    }
+
+    timer_wheel_link_isr(
+        &self_p->slots_p[level][(expires >> (level * TIMER_WHEEL_SLOT_BITS))
+                                & TIMER_WHEEL_SLOT_MASK],
+        timer_p);
+}
+
+/**
+ * Insert given timer in given timing wheel. It expires after given
+ * number of ticks.
+ */
+static void RAM_CODE timer_wheel_insert_isr(struct timer_wheel_t *self_p,
+                                            struct timer_t *timer_p,
+                                            uint32_t ticks)
+{
+    timer_p->delta = (self_p->tick + ticks - 1);
+    timer_wheel_add_isr(self_p, timer_p);
+}
+
+/**
+ * Remove given timer from given timing wheel.
+ */
+static int RAM_CODE timer_wheel_remove_isr(struct timer_wheel_t *self_p,
+                                           struct timer_t *timer_p)
+{
+    if (timer_p->pprev_p == NULL) {
+        return (0);
+    }
+
+    timer_wheel_unlink_isr(timer_p);
+
+    return (1);
+}
+
+/**
+ * Move all timers in given slot to lower levels.
+ *
+ * @return Index of the cascaded slot.
+ */
+static int RAM_CODE timer_wheel_cascade_isr(struct timer_wheel_t *self_p,
+                                            int level)
+{
+    struct timer_t *timer_p;
+    struct timer_t *next_p;
+    int index;
+
+    index = ((self_p->tick >> (level * TIMER_WHEEL_SLOT_BITS))
+             & TIMER_WHEEL_SLOT_MASK);
+    timer_p = self_p->slots_p[level][index];
+    self_p->slots_p[level][index] = NULL;
+
+    while (timer_p != NULL) {
+        next_p = timer_p->next_p;
+        timer_wheel_add_isr(self_p, timer_p);
+        timer_p = next_p;
+    }
+
+    return (index);
+}
+
+/**
+ * Fire all timers expiring on the current tick.
+ */
+static void RAM_CODE timer_wheel_tick_isr(struct timer_wheel_t *self_p)
+{
+    struct timer_t *timer_p;
+    struct timer_t *expired_p;
+    int index;
+    int level;
+
+    index = (self_p->tick & TIMER_WHEEL_SLOT_MASK);
+
+    /* Cascade higher levels when the lower level wraps. */
+    if (index == 0) {
+        level = 1;
+
+        while ((level < TIMER_WHEEL_LEVELS)
+               && (timer_wheel_cascade_isr(self_p, level) == 0)) {
+            level++;
+        }
+    }
+
+    self_p->tick++;
+
+    /* Move expired timers to a local list, as callbacks may start
+       and stop timers. */
+    expired_p = NULL;
+    timer_p = self_p->slots_p[0][index];
+
+    if (timer_p != NULL) {
+        self_p->slots_p[0][index] = NULL;
+        expired_p = timer_p;
+        timer_p->pprev_p = &expired_p;
+    }
+
+    while (expired_p != NULL) {
+        timer_p = expired_p;
+        timer_wheel_unlink_isr(timer_p);
+        timer_p->callback(timer_p->arg_p);
+
+        /* Re-set periodic timers. */
+        if (timer_p->flags & TIMER_PERIODIC) {
+            timer_wheel_insert_isr(self_p, timer_p, timer_p->timeout);
+        }
+    }
+}
+
+#if CONFIG_SYSTEM_TICKLESS == 1
+
+/**
+ * Get the number of ticks until the first timer in given timing wheel
+ * expires.
+ */
+static uint32_t timer_wheel_next_expiry_isr(struct timer_wheel_t *self_p)
+{
+    struct timer_t *timer_p;
+    uint32_t ticks;
+    uint32_t min_ticks;
+    int level;
+    int index;
+    int i;
+
+    min_ticks = 0xffffffff;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        index = ((self_p->tick >> (level * TIMER_WHEEL_SLOT_BITS))
+                 & TIMER_WHEEL_SLOT_MASK);
+
+        /* The first non-empty slot on each level holds the timer that
+           expires first on that level. The current slot on level one
+           and up has already been cascaded, so start after it. */
+        for (i = (level == 0 ? 0 : 1); i <= TIMER_WHEEL_SLOTS; i++) {
+            timer_p = self_p->slots_p[level][(index + i)
+                                             & TIMER_WHEEL_SLOT_MASK];
+
+            if (timer_p != NULL) {
+                break;
+            }
+        }
+
+        while (timer_p != NULL) {
+            ticks = (timer_p->delta - self_p->tick + 1);
+
+            if (ticks < min_ticks) {
+                min_ticks = ticks;
+            }
+
+            timer_p = timer_p->next_p;
+        }
+    }
+
+    return (min_ticks);
+}
+
+#endif
+
+#endif
+
 static int is_high_resolution_timer(struct timer_t *self_p)
 {
     return (self_p->flags & TIMER_HIGH_RESOLUTION);
 }
 
+#if CONFIG_SYSTEM_TICKLESS == 1
+
+uint32_t timer_next_expiry_isr(void)
+{
+#if CONFIG_TIMER_WHEEL == 1
+    return (timer_wheel_next_expiry_isr(&module.timers.tick));
+#else
+    if (module.timers.tick.head_p == &module.timers.tick.tail) {
+        return (0xffffffff);
+    }
+
+    return (module.timers.tick.head_p->delta);
+#endif
+}
+
+#endif
+
 void RAM_CODE timer_tick_isr(void)
 {
+#if CONFIG_TIMER_WHEEL == 1
+    sys_lock_isr();
+    timer_wheel_tick_isr(&module.timers.tick);
+    sys_unlock_isr();
+#else
     struct timer_t *timer_p;
     struct timer_list_t *list_p;
 
@@ -176,6 +448,7 @@ void RAM_CODE timer_tick_isr(void)
     }
 
     sys_unlock_isr();
+#endif
 }
 
 void RAM_CODE timer_high_resolution_isr(void)
@@ -237,6 +510,9 @@ int timer_init(struct timer_t *self_p,
     self_p->flags = flags;
     self_p->callback = callback;
     self_p->arg_p = arg_p;
+#if CONFIG_TIMER_WHEEL == 1
+    self_p->pprev_p = NULL;
+#endif
 
     return (0);
 }
@@ -276,7 +552,11 @@ int RAM_CODE timer_start_isr(struct timer_t *self_p)
            occurs. */
         self_p->delta++;
 
+#if CONFIG_TIMER_WHEEL == 1
+        timer_wheel_insert_isr(&module.timers.tick, self_p, self_p->delta);
+#else
         timer_list_insert_isr(&module.timers.tick, self_p);
+#endif
     }
 
     return (0);
@@ -306,7 +586,11 @@ int timer_stop_isr(struct timer_t *self_p)
             timer_port_high_resolution_stop_isr(self_p);
         }
     } else {
+#if CONFIG_TIMER_WHEEL == 1
+        return (timer_wheel_remove_isr(&module.timers.tick, self_p));
+#else
         list_p = &module.timers.tick;
+#endif
     }
 
     return (timer_list_remove_isr(list_p, self_p));
@@ -48,6 +48,12 @@ typedef void (*timer_callback_t)(void *arg_p);
 /* Timer. */
 struct timer_t {
     struct timer_t *next_p;
+#if CONFIG_TIMER_WHEEL == 1
+    /* Previous timers' next pointer in the timing wheel slot, or NULL
+       if the timer is not active. The delta member is the absolute
+       expiry tick for system tick timers. */
+    struct timer_t **pprev_p;
+#endif
     uint32_t delta;
     uint32_t timeout;
     int flags;
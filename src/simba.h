@@ -91,7 +91,9 @@ typedef intptr_t longptr_t;
 #include "collections/fifo.h"
 #include "collections/list.h"
 #include "collections/hash_map.h"
+#include "collections/open_hash_map.h"
 #include "collections/circular_buffer.h"
+#include "collections/spsc_ring.h"
 
 #include "kernel/time.h"
 
@@ -105,13 +107,11 @@ typedef intptr_t longptr_t;
 #include "sync/mutex.h"
 #include "sync/cond.h"
 #include "sync/queue.h"
+#include "sync/record_queue.h"
 #include "sync/event.h"
 #include "sync/rwlock.h"
 #include "sync/bus.h"
 
-#include "alloc/heap.h"
-#include "alloc/circular_heap.h"
-
 #if CONFIG_FAT16 == 1
 #    include "filesystems/fat16.h"
 #endif
@@ -119,6 +119,10 @@ typedef intptr_t longptr_t;
 
 #include "oam/console.h"
 #include "filesystems/fs.h"
+
+#include "alloc/heap.h"
+#include "alloc/circular_heap.h"
+
 #include "oam/shell.h"
 #include "oam/service.h"
 #include "oam/nvm.h"
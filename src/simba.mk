@@ -33,7 +33,8 @@ ifeq ($(TYPE),suite)
   INC += $(SIMBA_ROOT)/tst/stubs
 
   ALLOC_SRC += heap.c
-  COLLECTIONS_SRC += circular_buffer.c binary_tree.c list.c
+  COLLECTIONS_SRC += circular_buffer.c binary_tree.c list.c \
+    spsc_ring.c
   DEBUG_SRC += log.c harness.c
   DRIVERS_SRC += storage/flash.c network/uart.c
   ENCODE_SRC +=
@@ -45,7 +46,7 @@ ifeq ($(TYPE),suite)
   OAM_SRC += console.c settings.c nvm.c
   FILESYSTEMS_SRC += fs.c
   SPIFFS_SRC +=
-  SYNC_SRC += chan.c queue.c rwlock.c sem.c mutex.c bus.c event.c
+  SYNC_SRC += chan.c queue.c record_queue.c rwlock.c sem.c mutex.c bus.c event.c
   TEXT_SRC += std.c
   SCIENCE_SRC +=
 
@@ -95,7 +96,9 @@ COLLECTIONS_SRC ?= \
 	binary_tree.c \
 	circular_buffer.c \
 	hash_map.c \
-	list.c
+	list.c \
+	open_hash_map.c \
+	spsc_ring.c
 
 SRC += $(COLLECTIONS_SRC:%=$(SIMBA_ROOT)/src/collections/%)
 
@@ -398,6 +401,7 @@ SYNC_SRC ?= bus.c \
 	    event.c \
 	    mutex.c \
 	    queue.c \
+	    record_queue.c \
 	    rwlock.c \
 	    sem.c
 
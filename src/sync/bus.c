@@ -30,6 +30,120 @@
 
 #include "simba.h"
 
+static int is_range_listener(struct bus_listener_t *listener_p)
+{
+    return (listener_p->id != listener_p->max_id);
+}
+
+static int detach_range_listener(struct bus_t *self_p,
+                                 struct bus_listener_t *listener_p)
+{
+    struct bus_listener_t *curr_p, *prev_p;
+
+    curr_p = self_p->ranges_p;
+    prev_p = NULL;
+
+    while (curr_p != NULL) {
+        if (curr_p == listener_p) {
+            if (prev_p == NULL) {
+                self_p->ranges_p = listener_p->next_p;
+            } else {
+                prev_p->next_p = listener_p->next_p;
+            }
+
+            return (0);
+        }
+
+        prev_p = curr_p;
+        curr_p = curr_p->next_p;
+    }
+
+    return (-1);
+}
+
+static int count_listeners(struct bus_t *self_p, int id)
+{
+    int count;
+    struct bus_listener_t *curr_p;
+
+    count = 0;
+    curr_p = (struct bus_listener_t *)binary_tree_search(
+        &self_p->listeners, id);
+
+    while (curr_p != NULL) {
+        count++;
+        curr_p = curr_p->next_p;
+    }
+
+    curr_p = self_p->ranges_p;
+
+    while (curr_p != NULL) {
+        if ((id >= curr_p->id) && (id <= curr_p->max_id)) {
+            count++;
+        }
+
+        curr_p = curr_p->next_p;
+    }
+
+    return (count);
+}
+
+static void write_to_listener(struct bus_t *self_p,
+                              struct bus_listener_t *listener_p,
+                              const void *buf_p,
+                              size_t size,
+                              struct bus_message_t *message_p)
+{
+    ssize_t res;
+
+    res = ((struct chan_t *)listener_p->chan_p)->write(listener_p->chan_p,
+                                                       buf_p,
+                                                       size);
+
+    /* Release the reference of a listener that did not receive the
+       message. */
+    if ((message_p != NULL) && (res != (ssize_t)size)) {
+        heap_free(self_p->heap_p, message_p);
+    }
+}
+
+/**
+ * Write given buffer to all listeners of given id. Each listener
+ * holds a reference to given message, if not NULL.
+ */
+static int write_to_listeners(struct bus_t *self_p,
+                              int id,
+                              const void *buf_p,
+                              size_t size,
+                              struct bus_message_t *message_p)
+{
+    int number_of_receivers;
+    struct bus_listener_t *curr_p;
+
+    curr_p = (struct bus_listener_t *)binary_tree_search(
+        &self_p->listeners, id);
+    number_of_receivers = 0;
+
+    while (curr_p != NULL) {
+        write_to_listener(self_p, curr_p, buf_p, size, message_p);
+        number_of_receivers++;
+        curr_p = curr_p->next_p;
+    }
+
+    curr_p = self_p->ranges_p;
+
+    while (curr_p != NULL) {
+        if ((id >= curr_p->id) && (id <= curr_p->max_id)) {
+            write_to_listener(self_p, curr_p, buf_p, size, message_p);
+            number_of_receivers++;
+        }
+
+        curr_p = curr_p->next_p;
+    }
+
+    return (number_of_receivers);
+}
+
 int bus_module_init()
 {
     return (0);
@@ -41,6 +155,8 @@ int bus_init(struct bus_t *self_p)
 
     binary_tree_init(&self_p->listeners);
     rwlock_init(&self_p->rwlock);
+    self_p->ranges_p = NULL;
+    self_p->heap_p = NULL;
 
     return (0);
 }
@@ -54,12 +170,28 @@ int bus_listener_init(struct bus_listener_t *self_p,
 
     self_p->base.key = id;
     self_p->id = id;
+    self_p->max_id = id;
     self_p->chan_p = chan_p;
     self_p->next_p = NULL;
 
     return (0);
 }
 
+int bus_listener_init_range(struct bus_listener_t *self_p,
+                            int min_id,
+                            int max_id,
+                            void *chan_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(min_id <= max_id, EINVAL);
+    ASSERTN(chan_p != NULL, EINVAL);
+
+    bus_listener_init(self_p, min_id, chan_p);
+    self_p->max_id = max_id;
+
+    return (0);
+}
+
 int bus_attach(struct bus_t *self_p,
                struct bus_listener_t *listener_p)
 {
@@ -70,9 +202,13 @@ int bus_attach(struct bus_t *self_p,
 
     rwlock_writer_take(&self_p->rwlock);
 
-    /* Try to insert the node into the tree. It fails if there already
-     * is a node with the same key (id).*/
-    if (binary_tree_insert(&self_p->listeners, &listener_p->base) != 0) {
+    if (is_range_listener(listener_p)) {
+        listener_p->next_p = self_p->ranges_p;
+        self_p->ranges_p = listener_p;
+    } else if (binary_tree_insert(&self_p->listeners,
+                                  &listener_p->base) != 0) {
+        /* Insertion into the tree fails if there already is a node
+           with the same key (id). */
         head_p = (struct bus_listener_t *)binary_tree_search(
             &self_p->listeners, listener_p->id);
 
@@ -99,7 +235,9 @@ int bus_detach(struct bus_t *self_p,
     head_p = (struct bus_listener_t *)binary_tree_search(
         &self_p->listeners, listener_p->id);
 
-    if (head_p == NULL) {
+    if (is_range_listener(listener_p)) {
+        res = detach_range_listener(self_p, listener_p);
+    } else if (head_p == NULL) {
         res = -1;
     } else if (head_p == listener_p) {
         res = binary_tree_delete(&self_p->listeners, listener_p->id);
@@ -140,23 +278,80 @@ int bus_write(struct bus_t *self_p,
     ASSERTN(size > 0, EINVAL);
 
     int number_of_receivers;
-    struct bus_listener_t *curr_p;
 
     rwlock_reader_take(&self_p->rwlock);
+    number_of_receivers = write_to_listeners(self_p, id, buf_p, size, NULL);
+    rwlock_reader_give(&self_p->rwlock);
 
-    curr_p = (struct bus_listener_t *)binary_tree_search(
-        &self_p->listeners, id);
-    number_of_receivers = 0;
+    return (number_of_receivers);
+}
 
-    while (curr_p != NULL) {
-        ((struct chan_t *)curr_p->chan_p)->write(curr_p->chan_p,
-                                                 buf_p,
-                                                 size);
-        number_of_receivers++;
-        curr_p = curr_p->next_p;
+int bus_set_heap(struct bus_t *self_p,
+                 struct heap_t *heap_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(heap_p != NULL, EINVAL);
+
+    self_p->heap_p = heap_p;
+
+    return (0);
+}
+
+struct bus_message_t *bus_message_alloc(struct bus_t *self_p,
+                                        int id,
+                                        size_t size)
+{
+    ASSERTNRN(self_p != NULL, EINVAL);
+    ASSERTNRN(self_p->heap_p != NULL, EINVAL);
+
+    struct bus_message_t *message_p;
+
+    message_p = heap_alloc(self_p->heap_p, sizeof(*message_p) + size);
+
+    if (message_p != NULL) {
+        message_p->id = id;
+        message_p->size = size;
+    }
+
+    return (message_p);
+}
+
+int bus_write_message(struct bus_t *self_p,
+                      struct bus_message_t *message_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(message_p != NULL, EINVAL);
+
+    int number_of_receivers;
+
+    rwlock_reader_take(&self_p->rwlock);
+
+    /* Take all listener references at once before any listener can
+       release its reference. */
+    number_of_receivers = count_listeners(self_p, message_p->id);
+
+    if (number_of_receivers > 0) {
+        heap_share(self_p->heap_p, message_p, number_of_receivers);
+        write_to_listeners(self_p,
+                           message_p->id,
+                           &message_p,
+                           sizeof(message_p),
+                           message_p);
     }
 
     rwlock_reader_give(&self_p->rwlock);
 
+    /* Release the reference of the caller. */
+    heap_free(self_p->heap_p, message_p);
+
     return (number_of_receivers);
 }
+
+int bus_message_release(struct bus_t *self_p,
+                        struct bus_message_t *message_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(message_p != NULL, EINVAL);
+
+    return (heap_free(self_p->heap_p, message_p));
+}
@@ -33,18 +33,35 @@
 
 #include "simba.h"
 
+/* Smallest and largest message ids, for wildcard listeners. */
+#define BUS_ID_MIN                               (-__INT_MAX__ - 1)
+#define BUS_ID_MAX                                     __INT_MAX__
+
 struct bus_t {
     struct rwlock_t rwlock;
     struct binary_tree_t listeners;
+    /* Listeners of id ranges. */
+    struct bus_listener_t *ranges_p;
+    struct heap_t *heap_p;
 };
 
 struct bus_listener_t {
     struct binary_tree_node_t base;
     int id;
+    int max_id;
     void *chan_p;
     struct bus_listener_t *next_p;
 };
 
+/**
+ * A reference counted message allocated by `bus_message_alloc()`.
+ */
+struct bus_message_t {
+    int id;
+    size_t size;
+    uint8_t buf[];
+};
+
 /**
  * Initialize the bus module. This function must be called before
  * calling any other function in this module.
@@ -81,10 +98,31 @@ int bus_listener_init(struct bus_listener_t *self_p,
                       int id,
                       void *chan_p);
 
+/**
+ * Initialize given listener to receive messages with an id in given
+ * inclusive range, after the listener is attached to the bus. Give
+ * `BUS_ID_MIN` and `BUS_ID_MAX` to receive all messages written to
+ * the bus.
+ *
+ * Range listeners are searched linearly on every write, so prefer
+ * `bus_listener_init()` for single ids.
+ *
+ * @param[in] self_p Listener to initialize.
+ * @param[in] min_id Smallest message id to receive.
+ * @param[in] max_id Largest message id to receive.
+ * @param[in] chan_p Channel to receive messages on.
+ *
+ * @return zero(0) or negative error code.
+ */
+int bus_listener_init_range(struct bus_listener_t *self_p,
+                            int min_id,
+                            int max_id,
+                            void *chan_p);
+
 /**
  * Attach given listener to given bus. Messages written to the bus
  * will be written to all listeners initialized with the written
- * message id.
+ * message id, or with a range of ids including it.
  *
  * @param[in] self_p Bus to attach the listener to.
  * @param[in] listener_p Listener to attach to the bus.
@@ -124,4 +162,62 @@ int bus_write(struct bus_t *self_p,
               const void *buf_p,
               size_t size);
 
+/**
+ * Set the heap reference counted messages are allocated from.
+ *
+ * @param[in] self_p Bus.
+ * @param[in] heap_p Heap to allocate messages from.
+ *
+ * @return zero(0) or negative error code.
+ */
+int bus_set_heap(struct bus_t *self_p,
+                 struct heap_t *heap_p);
+
+/**
+ * Allocate a reference counted message of given id and size from the
+ * heap of given bus. Write the payload to the buffer of the message
+ * and pass it to `bus_write_message()`.
+ *
+ * @param[in] self_p Bus.
+ * @param[in] id Message identity.
+ * @param[in] size Payload size in bytes.
+ *
+ * @return Allocated message or NULL on failure.
+ */
+struct bus_message_t *bus_message_alloc(struct bus_t *self_p,
+                                        int id,
+                                        size_t size);
+
+/**
+ * Write given reference counted message to given bus. Instead of
+ * copying the payload, a pointer to the message is written to the
+ * channel of each listener, which must release the message with
+ * `bus_message_release()` once done with it. A listener reads the
+ * message with `chan_read(chan_p, &message_p, sizeof(message_p))`.
+ *
+ * The reference of the caller is released by this function, so the
+ * message must not be accessed by the caller after this call.
+ *
+ * @param[in] self_p Bus to write the message to.
+ * @param[in] message_p Message allocated with `bus_message_alloc()`.
+ *
+ * @return Number of listeners that received the message, or negative
+ *         error code.
+ */
+int bus_write_message(struct bus_t *self_p,
+                      struct bus_message_t *message_p);
+
+/**
+ * Release given message. The message is freed when released by all
+ * listeners.
+ *
+ * @param[in] self_p Bus the message was written to.
+ * @param[in] message_p Message to release.
+ *
+ * @return Number of remaining references to the message, or negative
+ *         error code.
+ */
+int bus_message_release(struct bus_t *self_p,
+                        struct bus_message_t *message_p);
+
 #endif
@@ -38,6 +38,86 @@ static const struct chan_t null = {
     .control = chan_control_null
 };
 
+/**
+ * Put given poll set element last in the ready list of its poll set,
+ * unless already in it, and resume the waiting thread, if any.
+ */
+static RAM_CODE void poll_set_ready_isr(struct chan_poll_set_elem_t *elem_p)
+{
+    struct chan_poll_set_t *set_p;
+
+    if (elem_p->ready == 1) {
+        return;
+    }
+
+    set_p = elem_p->set_p;
+    elem_p->ready = 1;
+    elem_p->next_p = NULL;
+
+    if (set_p->ready.tail_p == NULL) {
+        set_p->ready.head_p = elem_p;
+    } else {
+        set_p->ready.tail_p->next_p = elem_p;
+    }
+
+    set_p->ready.tail_p = elem_p;
+
+    if (set_p->thrd_p != NULL) {
+        thrd_resume_isr(set_p->thrd_p, 0);
+        set_p->thrd_p = NULL;
+    }
+}
+
+/**
+ * Move at most given number of channels with data from the ready list
+ * of given poll set to given array. Level triggered channels are put
+ * last in the ready list again, and removed by a later call when they
+ * no longer have any data.
+ */
+static ssize_t poll_set_pop_ready_isr(struct chan_poll_set_t *self_p,
+                                      void **chans_pp,
+                                      size_t length)
+{
+    struct chan_poll_set_elem_t *elem_p;
+    struct chan_poll_set_elem_t *next_p;
+    struct chan_poll_set_elem_t *tail_p;
+    ssize_t number_of_chans;
+
+    number_of_chans = 0;
+    elem_p = self_p->ready.head_p;
+    tail_p = self_p->ready.tail_p;
+    self_p->ready.head_p = NULL;
+    self_p->ready.tail_p = NULL;
+
+    while ((elem_p != NULL) && (number_of_chans < length)) {
+        next_p = elem_p->next_p;
+        elem_p->ready = 0;
+
+        if (elem_p->chan_p->size(elem_p->chan_p) > 0) {
+            chans_pp[number_of_chans] = elem_p->chan_p;
+            number_of_chans++;
+
+            if (!(elem_p->flags & CHAN_POLL_SET_FLAGS_EDGE_TRIGGERED)) {
+                poll_set_ready_isr(elem_p);
+            }
+        }
+
+        elem_p = next_p;
+    }
+
+    /* Channels not visited are kept first in the ready list. */
+    if (elem_p != NULL) {
+        tail_p->next_p = self_p->ready.head_p;
+        self_p->ready.head_p = elem_p;
+
+        if (self_p->ready.tail_p == NULL) {
+            self_p->ready.tail_p = tail_p;
+        }
+    }
+
+    return (number_of_chans);
+}
+
 int chan_module_init(void)
 {
     return (0);
@@ -62,6 +142,7 @@ int chan_init(struct chan_t *self_p,
     self_p->write_filter_isr_cb = NULL;
     self_p->reader_p = NULL;
     self_p->list_p = NULL;
+    self_p->poll_set_elem_p = NULL;
 
     return (0);
 }
@@ -314,8 +395,33 @@ void *chan_list_poll(struct chan_list_t *self_p,
             chan_p->list_p = self_p;
         }
 
+        /* Check again as lock-free producers, for example single
+           producer, single consumer queues, may have written data
+           without the system lock before the marking above was
+           visible to them. */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        for (i = 0; i < self_p->len; i++) {
+            chan_p = self_p->elements_p[i].chan_p;
+
+            if (chan_p->size(chan_p) > 0) {
+                break;
+            }
+        }
+
+        if (i < self_p->len) {
+            for (i = 0; i < self_p->len; i++) {
+                self_p->elements_p[i].chan_p->reader_p = NULL;
+                self_p->elements_p[i].chan_p->list_p = NULL;
+            }
+
+            chan_p = NULL;
+            continue;
+        }
+
         /* No data was available, wait for data to be written to one
            of the channels. */
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_POLL);
         if (thrd_suspend_isr(timeout_p) == -ETIMEDOUT) {
             for (i = 0; i < self_p->len; i++) {
                 chan_p = self_p->elements_p[i].chan_p;
@@ -335,6 +441,155 @@ void *chan_list_poll(struct chan_list_t *self_p,
     return (chan_p);
 }
 
+int chan_poll_set_init(struct chan_poll_set_t *self_p,
+                       struct chan_poll_set_elem_t *elements_p,
+                       size_t number_of_elements)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(elements_p != NULL, EINVAL);
+    ASSERTN(number_of_elements > 0, EINVAL);
+
+    size_t i;
+
+    self_p->ready.head_p = NULL;
+    self_p->ready.tail_p = NULL;
+    self_p->thrd_p = NULL;
+    self_p->free_p = NULL;
+
+    for (i = 0; i < number_of_elements; i++) {
+        elements_p[i].next_p = self_p->free_p;
+        self_p->free_p = &elements_p[i];
+    }
+
+    return (0);
+}
+
+int chan_poll_set_add(struct chan_poll_set_t *self_p,
+                      void *chan_p,
+                      int flags)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(chan_p != NULL, EINVAL);
+
+    int res;
+    struct chan_poll_set_elem_t *elem_p;
+
+    res = 0;
+
+    sys_lock();
+
+    elem_p = self_p->free_p;
+
+    if (((struct chan_t *)chan_p)->poll_set_elem_p != NULL) {
+        res = -EEXIST;
+    } else if (elem_p == NULL) {
+        res = -ENOMEM;
+    } else {
+        self_p->free_p = elem_p->next_p;
+        elem_p->chan_p = chan_p;
+        elem_p->set_p = self_p;
+        elem_p->flags = flags;
+        elem_p->ready = 0;
+        elem_p->chan_p->poll_set_elem_p = elem_p;
+
+        /* Data may have been written before the channel was added. */
+        if (elem_p->chan_p->size(elem_p->chan_p) > 0) {
+            poll_set_ready_isr(elem_p);
+        }
+    }
+
+    sys_unlock();
+
+    return (res);
+}
+
+int chan_poll_set_remove(struct chan_poll_set_t *self_p,
+                         void *chan_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(chan_p != NULL, EINVAL);
+
+    int res;
+    struct chan_poll_set_elem_t *elem_p;
+    struct chan_poll_set_elem_t *curr_p;
+    struct chan_poll_set_elem_t *prev_p;
+
+    res = 0;
+
+    sys_lock();
+
+    elem_p = ((struct chan_t *)chan_p)->poll_set_elem_p;
+
+    if ((elem_p == NULL) || (elem_p->set_p != self_p)) {
+        res = -ENOENT;
+    } else {
+        /* Unlink from the ready list. */
+        if (elem_p->ready == 1) {
+            curr_p = self_p->ready.head_p;
+            prev_p = NULL;
+
+            while (curr_p != elem_p) {
+                prev_p = curr_p;
+                curr_p = curr_p->next_p;
+            }
+
+            if (prev_p == NULL) {
+                self_p->ready.head_p = elem_p->next_p;
+            } else {
+                prev_p->next_p = elem_p->next_p;
+            }
+
+            if (self_p->ready.tail_p == elem_p) {
+                self_p->ready.tail_p = prev_p;
+            }
+        }
+
+        elem_p->chan_p->poll_set_elem_p = NULL;
+        elem_p->next_p = self_p->free_p;
+        self_p->free_p = elem_p;
+    }
+
+    sys_unlock();
+
+    return (res);
+}
+
+ssize_t chan_poll_set_wait(struct chan_poll_set_t *self_p,
+                           void **chans_pp,
+                           size_t length,
+                           const struct time_t *timeout_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(chans_pp != NULL, EINVAL);
+    ASSERTN(length > 0, EINVAL);
+
+    ssize_t res;
+
+    sys_lock();
+
+    while (1) {
+        res = poll_set_pop_ready_isr(self_p, chans_pp, length);
+
+        if (res > 0) {
+            break;
+        }
+
+        /* No channel was ready, wait for a write to one of them. */
+        self_p->thrd_p = thrd_self();
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_POLL);
+
+        if (thrd_suspend_isr(timeout_p) == -ETIMEDOUT) {
+            self_p->thrd_p = NULL;
+            res = -ETIMEDOUT;
+            break;
+        }
+    }
+
+    sys_unlock();
+
+    return (res);
+}
+
 void *chan_poll(void *chan_p, const struct time_t *timeout_p)
 {
     struct chan_list_t list;
@@ -382,6 +637,10 @@ RAM_CODE int chan_is_polled_isr(struct chan_t *self_p)
     struct chan_t *chan_p;
     struct chan_list_t *list_p;
 
+    if (self_p->poll_set_elem_p != NULL) {
+        poll_set_ready_isr(self_p->poll_set_elem_p);
+    }
+
     list_p = self_p->list_p;
 
     /* Already resumed? */
@@ -64,6 +64,12 @@
  */
 #define CHAN_CONTROL_BLOCKING_READ                          6
 
+/**
+ * Report a channel in a poll set once per write, instead of as long
+ * as it has data to read.
+ */
+#define CHAN_POLL_SET_FLAGS_EDGE_TRIGGERED                0x1
+
 /**
  * Channel read function callback type.
  *
@@ -134,6 +140,30 @@ struct chan_list_t {
     size_t len;
 };
 
+struct chan_poll_set_elem_t {
+    struct chan_t *chan_p;
+    struct chan_poll_set_t *set_p;
+    /* Next element in the ready list or the free list. */
+    struct chan_poll_set_elem_t *next_p;
+    int flags;
+    int ready;
+};
+
+/**
+ * A set of channels that stay registered between polls. Writers put
+ * their channel on the ready list of the set, so a poll only visits
+ * channels with data, instead of all channels in the set.
+ */
+struct chan_poll_set_t {
+    struct {
+        struct chan_poll_set_elem_t *head_p;
+        struct chan_poll_set_elem_t *tail_p;
+    } ready;
+    struct chan_poll_set_elem_t *free_p;
+    /* Thread waiting for a channel to become ready. */
+    struct thrd_t *thrd_p;
+};
+
 /**
  * Channel datastructure.
  */
@@ -149,6 +179,8 @@ struct chan_t {
     struct thrd_t *reader_p;
     /* Used by the reader when polling channels. */
     struct chan_list_t *list_p;
+    /* Poll set element, if the channel is in a poll set. */
+    struct chan_poll_set_elem_t *poll_set_elem_p;
 };
 
 /**
@@ -408,6 +440,72 @@ int chan_list_remove(struct chan_list_t *self_p, void *chan_p);
 void *chan_list_poll(struct chan_list_t *self_p,
                      const struct time_t *timeout_p);
 
+/**
+ * Initialize an empty poll set. Channels in a poll set are registered
+ * once and then polled any number of times with
+ * `chan_poll_set_wait()`, at a cost proportional to the number of
+ * ready channels rather than to the number of channels in the set.
+ *
+ * @param[out] self_p Poll set to initialize.
+ * @param[in] elements_p Array of elements to store added channels in.
+ * @param[in] number_of_elements Number of elements in the element
+ *                               array.
+ *
+ * @return zero(0) or negative error code.
+ */
+int chan_poll_set_init(struct chan_poll_set_t *self_p,
+                       struct chan_poll_set_elem_t *elements_p,
+                       size_t number_of_elements);
+
+/**
+ * Add given channel to given poll set. A channel can only be in one
+ * poll set at a time.
+ *
+ * A level triggered channel, the default, is reported by every wait
+ * as long as it has data to read. An edge triggered channel is only
+ * reported once for each write to it, so all its data should be read
+ * when it is reported.
+ *
+ * @param[in] self_p Poll set.
+ * @param[in] chan_p Channel to add.
+ * @param[in] flags Zero(0) or `CHAN_POLL_SET_FLAGS_EDGE_TRIGGERED`.
+ *
+ * @return zero(0) or negative error code.
+ */
+int chan_poll_set_add(struct chan_poll_set_t *self_p,
+                      void *chan_p,
+                      int flags);
+
+/**
+ * Remove given channel from given poll set.
+ *
+ * @param[in] self_p Poll set.
+ * @param[in] chan_p Channel to remove.
+ *
+ * @return zero(0) or negative error code.
+ */
+int chan_poll_set_remove(struct chan_poll_set_t *self_p,
+                         void *chan_p);
+
+/**
+ * Wait for at least one channel in given poll set to have data ready
+ * to be read, or a timeout to occur. Only one thread may wait on a
+ * poll set at a time.
+ *
+ * @param[in] self_p Poll set.
+ * @param[out] chans_pp Array to store ready channels in.
+ * @param[in] length Number of channels that fit in given array.
+ * @param[in] timeout_p Time to wait for data on any channel before a
+ *                      timeout occurs. Set to NULL to wait forever.
+ *
+ * @return Number of ready channels or negative error code. -ETIMEDOUT
+ *         on timeout.
+ */
+ssize_t chan_poll_set_wait(struct chan_poll_set_t *self_p,
+                           void **chans_pp,
+                           size_t length,
+                           const struct time_t *timeout_p);
+
 /**
  * Poll given channel for events. Blocks until the channel has data
  * ready to be read or an timeout occurs.
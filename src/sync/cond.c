@@ -56,6 +56,7 @@ int cond_wait(struct cond_t *self_p,
     elem.thrd_p = thrd_self();
     thrd_prio_list_push_isr(&self_p->waiters, &elem);
 
+    THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_COND);
     res = thrd_suspend_isr(timeout_p);
 
     if (res == -ETIMEDOUT) {
@@ -67,6 +67,7 @@ ssize_t event_read(struct event_t *self_p,
     } else {
         self_p->reader_mask = *mask_p;
         self_p->base.reader_p = thrd_self();
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_EVENT);
         thrd_suspend_isr(NULL);
         *mask_p = (self_p->mask & *mask_p);
     }
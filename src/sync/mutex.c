@@ -35,9 +35,124 @@ int mutex_module_init(void)
     return (0);
 }
 
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+
+/**
+ * Get the priority of the highest priority thread waiting for any of
+ * the mutexes owned by given thread.
+ */
+static int owned_waiters_prio(struct thrd_t *thrd_p)
+{
+    struct mutex_t *mutex_p;
+    struct thrd_prio_list_elem_t *elem_p;
+    int prio;
+
+    prio = 127;
+    mutex_p = thrd_p->inheritance.owned_p;
+
+    while (mutex_p != NULL) {
+        elem_p = mutex_p->waiters.head_p;
+
+        if ((elem_p != NULL) && (elem_p->thrd_p->prio < prio)) {
+            prio = elem_p->thrd_p->prio;
+        }
+
+        mutex_p = mutex_p->next_p;
+    }
+
+    return (prio);
+}
+
+static void owned_add(struct thrd_t *thrd_p, struct mutex_t *mutex_p)
+{
+    mutex_p->next_p = thrd_p->inheritance.owned_p;
+    thrd_p->inheritance.owned_p = mutex_p;
+}
+
+static void owned_remove(struct thrd_t *thrd_p, struct mutex_t *mutex_p)
+{
+    struct mutex_t **mutex_pp;
+
+    mutex_pp = &thrd_p->inheritance.owned_p;
+
+    while (*mutex_pp != NULL) {
+        if (*mutex_pp == mutex_p) {
+            *mutex_pp = mutex_p->next_p;
+            break;
+        }
+
+        mutex_pp = &(*mutex_pp)->next_p;
+    }
+}
+
+/**
+ * Move given waiting thread to its new position in the wait list of
+ * given mutex after a priority change.
+ */
+static void waiters_reorder(struct mutex_t *self_p, struct thrd_t *thrd_p)
+{
+    struct thrd_prio_list_elem_t *elem_p;
+
+    elem_p = self_p->waiters.head_p;
+
+    while (elem_p != NULL) {
+        if (elem_p->thrd_p == thrd_p) {
+            thrd_prio_list_remove_isr(&self_p->waiters, elem_p);
+            thrd_prio_list_push_isr(&self_p->waiters, elem_p);
+            break;
+        }
+
+        elem_p = elem_p->next_p;
+    }
+}
+
+/**
+ * Let the owner of given mutex inherit given priority, and then the
+ * owner of the mutex it is waiting for, and so on.
+ */
+static void inherit(struct mutex_t *self_p, int prio)
+{
+    struct thrd_t *owner_p;
+
+    while ((self_p != NULL)
+           && (self_p->flags & MUTEX_PRIORITY_INHERITANCE)) {
+        owner_p = self_p->owner_p;
+
+        if (prio >= owner_p->inheritance.inherited_prio) {
+            break;
+        }
+
+        thrd_set_inherited_prio_isr(owner_p, prio);
+        self_p = owner_p->inheritance.waiting_for_p;
+
+        if (self_p != NULL) {
+            waiters_reorder(self_p, owner_p);
+        }
+
+        prio = owner_p->prio;
+    }
+}
+
+#endif
+
 int mutex_init(struct mutex_t *self_p)
 {
+    return (mutex_init_flags(self_p, 0));
+}
+
+int mutex_init_flags(struct mutex_t *self_p, int flags)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 0
+    if (flags & MUTEX_PRIORITY_INHERITANCE) {
+        return (-ENOSYS);
+    }
+#endif
+
     self_p->is_locked = 0;
+    self_p->flags = flags;
+    self_p->owner_p = NULL;
     thrd_prio_list_init(&self_p->waiters);
 
     return (0);
@@ -68,13 +183,33 @@ int mutex_unlock(struct mutex_t *self_p)
 int mutex_lock_isr(struct mutex_t *self_p)
 {
     struct thrd_prio_list_elem_t elem;
+    struct thrd_t *thrd_p;
+
+    thrd_p = thrd_self();
 
     if (self_p->is_locked == 1) {
-        elem.thrd_p = thrd_self();
+        elem.thrd_p = thrd_p;
         thrd_prio_list_push_isr(&self_p->waiters, &elem);
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+        if (self_p->flags & MUTEX_PRIORITY_INHERITANCE) {
+            thrd_p->inheritance.waiting_for_p = self_p;
+            inherit(self_p, thrd_p->prio);
+        }
+#endif
+
+        /* The mutex is handed over to this thread on unlock. */
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_MUTEX);
         thrd_suspend_isr(NULL);
     } else {
         self_p->is_locked = 1;
+        self_p->owner_p = thrd_p;
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+        if (self_p->flags & MUTEX_PRIORITY_INHERITANCE) {
+            owned_add(thrd_p, self_p);
+        }
+#endif
     }
 
     return (0);
@@ -83,13 +218,36 @@ int mutex_lock_isr(struct mutex_t *self_p)
 int mutex_unlock_isr(struct mutex_t *self_p)
 {
     struct thrd_prio_list_elem_t *elem_p;
+    struct thrd_t *thrd_p;
 
     elem_p = thrd_prio_list_pop_isr(&self_p->waiters);
 
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    if (self_p->flags & MUTEX_PRIORITY_INHERITANCE) {
+        /* Restore the priority of the previous owner. */
+        thrd_p = self_p->owner_p;
+        owned_remove(thrd_p, self_p);
+        thrd_set_inherited_prio_isr(thrd_p, owned_waiters_prio(thrd_p));
+    }
+#endif
+
     if (elem_p != NULL) {
-        thrd_resume_isr(elem_p->thrd_p, 0);
+        /* Hand over the mutex to the highest priority waiter. */
+        thrd_p = elem_p->thrd_p;
+        self_p->owner_p = thrd_p;
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+        if (self_p->flags & MUTEX_PRIORITY_INHERITANCE) {
+            thrd_p->inheritance.waiting_for_p = NULL;
+            owned_add(thrd_p, self_p);
+            thrd_set_inherited_prio_isr(thrd_p, owned_waiters_prio(thrd_p));
+        }
+#endif
+
+        thrd_resume_isr(thrd_p, 0);
     } else {
         self_p->is_locked = 0;
+        self_p->owner_p = NULL;
     }
 
     return (0);
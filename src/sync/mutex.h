@@ -33,9 +33,25 @@
 
 #include "simba.h"
 
+/**
+ * Boost the priority of the mutex owner to the highest priority of
+ * the threads waiting for the mutex, until the mutex is
+ * unlocked. Inheritance is transitive through chains of owners
+ * waiting for other priority inheritance mutexes.
+ */
+#define MUTEX_PRIORITY_INHERITANCE                          (1 << 0)
+
 struct mutex_t {
     /** Mutex lock state. */
     int8_t is_locked;
+    /** Mutex flags. */
+    int8_t flags;
+    /** Thread owning the mutex, or NULL if unlocked. */
+    struct thrd_t *owner_p;
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    /** Next mutex owned by the same thread. */
+    struct mutex_t *next_p;
+#endif
     /** Wait list. */
     struct thrd_prio_list_t waiters;
 };
@@ -60,6 +76,17 @@ int mutex_module_init(void);
  */
 int mutex_init(struct mutex_t *self_p);
 
+/**
+ * Initialize given mutex object with given flags.
+ *
+ * @param[in] self_p Mutex to initialize.
+ * @param[in] flags Set `MUTEX_PRIORITY_INHERITANCE` for priority
+ *                  inheritance.
+ *
+ * @return zero(0) or negative error code.
+ */
+int mutex_init_flags(struct mutex_t *self_p, int flags);
+
 /**
  * Lock given mutex.
  *
@@ -67,6 +67,102 @@ static int control(struct queue_t *self_p, int operation)
     return (res);
 }
 
+/**
+ * Resume the reader of given single producer, single consumer queue,
+ * if any. The system lock must be taken.
+ */
+static void spsc_resume_reader_isr(struct queue_t *self_p)
+{
+    /* The resume value is ignored by both the poller and the reader,
+       but polled channels must be unmarked. */
+    chan_is_polled_isr(&self_p->base);
+
+    if (self_p->base.reader_p != NULL) {
+        thrd_resume_isr(self_p->base.reader_p, 0);
+        self_p->base.reader_p = NULL;
+    }
+}
+
+static ssize_t spsc_write(struct queue_t *self_p,
+                          const void *buf_p,
+                          size_t size)
+{
+    ssize_t res;
+
+    /* Write is not possible to a stopped queue. */
+    if (self_p->state == QUEUE_STATE_STOPPED) {
+        return (-1);
+    }
+
+    res = spsc_ring_write(&self_p->ring, buf_p, size);
+
+    /* Publish the written data before checking for a reader. Pairs
+       with the fences in spsc_read() and chan_list_poll(), so either
+       the reader sees the data, or the producer sees the reader. */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return (res);
+}
+
+static ssize_t spsc_read(struct queue_t *self_p,
+                         void *buf_p,
+                         size_t size)
+{
+    size_t left;
+    char *c_buf_p;
+
+    left = size;
+    c_buf_p = buf_p;
+
+    while (1) {
+        /* Copy data from the ring without the system lock. */
+        left -= spsc_ring_read(&self_p->ring, c_buf_p, left);
+        c_buf_p = &((char *)buf_p)[size - left];
+
+        if (left == 0) {
+            break;
+        }
+
+        /* No more data will be written to a stopped queue. */
+        if (self_p->state == QUEUE_STATE_STOPPED) {
+            size = (size - left);
+            break;
+        }
+
+        if (self_p->flags & QUEUE_FLAGS_NON_BLOCKING_READ) {
+            size = (size - left);
+
+            if (size == 0) {
+                size = -EAGAIN;
+            }
+
+            break;
+        }
+
+        /* Wait for more data. The ring is checked again after
+           registering as reader as the producer does not take the
+           system lock when writing. */
+        sys_lock();
+
+        self_p->base.reader_p = thrd_self();
+        self_p->reader.size = size;
+        self_p->reader.left = left;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        if ((spsc_ring_used_size(&self_p->ring) == 0)
+            && (self_p->state != QUEUE_STATE_STOPPED)) {
+            THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_QUEUE);
+            thrd_suspend_isr(NULL);
+        }
+
+        self_p->base.reader_p = NULL;
+
+        sys_unlock();
+    }
+
+    return (size);
+}
+
 int queue_init(struct queue_t *self_p,
                void *buf_p,
                size_t size)
@@ -102,6 +198,27 @@ int queue_init(struct queue_t *self_p,
     return (0);
 }
 
+int queue_init_spsc(struct queue_t *self_p,
+                    void *buf_p,
+                    size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    int res;
+
+    res = spsc_ring_init(&self_p->ring, buf_p, size);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    queue_init(self_p, NULL, 0);
+    self_p->flags = QUEUE_FLAGS_SPSC;
+
+    return (0);
+}
+
 int queue_start(struct queue_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
@@ -159,6 +276,10 @@ ssize_t queue_read(struct queue_t *self_p, void *buf_p, size_t size)
     size_t left, n;
     char *c_buf_p;
 
+    if (self_p->flags & QUEUE_FLAGS_SPSC) {
+        return (spsc_read(self_p, buf_p, size));
+    }
+
     left = size;
     c_buf_p = buf_p;
 
@@ -211,6 +332,7 @@ ssize_t queue_read(struct queue_t *self_p, void *buf_p, size_t size)
             self_p->reader.size = size;
             self_p->reader.left = left;
 
+            THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_QUEUE);
             size = thrd_suspend_isr(NULL);
         }
     }
@@ -232,6 +354,10 @@ ssize_t queue_write(struct queue_t *self_p,
     const char *c_buf_p;
     struct queue_writer_elem_t elem;
 
+    if (self_p->flags & QUEUE_FLAGS_SPSC) {
+        return (queue_write_spsc_isr(self_p, buf_p, size));
+    }
+
     left = size;
     c_buf_p = buf_p;
     
@@ -257,6 +383,7 @@ ssize_t queue_write(struct queue_t *self_p,
                                         (struct thrd_prio_list_elem_t *)&elem);
             }
 
+            THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_QUEUE);
             res = thrd_suspend_isr(NULL);
         }
     }
@@ -272,6 +399,14 @@ RAM_CODE ssize_t queue_write_isr(struct queue_t *self_p,
 {
     size_t n, left;
     const char *c_buf_p;
+    ssize_t res;
+
+    if (self_p->flags & QUEUE_FLAGS_SPSC) {
+        res = spsc_write(self_p, buf_p, size);
+        spsc_resume_reader_isr(self_p);
+
+        return (res);
+    }
 
     left = size;
     c_buf_p = buf_p;
@@ -311,10 +446,37 @@ RAM_CODE ssize_t queue_write_isr(struct queue_t *self_p,
     return (size - left);
 }
 
+RAM_CODE ssize_t queue_write_spsc_isr(struct queue_t *self_p,
+                                      const void *buf_p,
+                                      size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    ssize_t res;
+
+    res = spsc_write(self_p, buf_p, size);
+
+    /* Only take the system lock if there is a reader to resume, or
+       the queue is in a poll set. */
+    if ((__atomic_load_n(&self_p->base.reader_p, __ATOMIC_RELAXED) != NULL)
+        || (self_p->base.poll_set_elem_p != NULL)) {
+        sys_lock_isr();
+        spsc_resume_reader_isr(self_p);
+        sys_unlock_isr();
+    }
+
+    return (res);
+}
+
 RAM_CODE ssize_t queue_size(struct queue_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
+    if (self_p->flags & QUEUE_FLAGS_SPSC) {
+        return (spsc_ring_used_size(&self_p->ring));
+    }
+
     return ((self_p->buf_p != NULL
              ? circular_buffer_used_size(&self_p->buffer)
              : 0) + WRITER_SIZE(self_p));
@@ -335,6 +497,10 @@ ssize_t queue_unused_size(struct queue_t *self_p)
 
 RAM_CODE ssize_t queue_unused_size_isr(struct queue_t *self_p)
 {
+    if (self_p->flags & QUEUE_FLAGS_SPSC) {
+        return (spsc_ring_unused_size(&self_p->ring));
+    }
+
     return ((self_p->buf_p != NULL
              ? circular_buffer_unused_size(&self_p->buffer)
              : 0) + READER_SIZE(self_p));
@@ -347,6 +513,17 @@ ssize_t queue_ignore(struct queue_t *self_p,
     ASSERTN(size >= 0, EINVAL);
 
     size_t left, n;
+    void *buf_p;
+
+    /* Only the reader may ignore data, which does not require the
+       system lock. */
+    if (self_p->flags & QUEUE_FLAGS_SPSC) {
+        n = spsc_ring_read_array_one(&self_p->ring, &buf_p, size);
+        n += spsc_ring_read_array_two(&self_p->ring, &buf_p, size - n);
+        spsc_ring_read_commit(&self_p->ring, n);
+
+        return (n);
+    }
 
     left = size;
 
@@ -34,6 +34,7 @@
 #include "simba.h"
 
 #define QUEUE_FLAGS_NON_BLOCKING_READ                     0x1
+#define QUEUE_FLAGS_SPSC                                  0x2
 
 /* Compile time declaration and initialization of a channel. */
 #define QUEUE_INIT_DECL(_name, _buf, _size)             \
@@ -44,7 +45,8 @@
             .size = (chan_size_fn_t)queue_size,         \
             .control = chan_control_null,               \
             .reader_p = NULL,                           \
-            .list_p = NULL                              \
+            .list_p = NULL,                             \
+            .poll_set_elem_p = NULL                     \
         },                                              \
         .writers = {                                    \
             .head_p = NULL,                             \
@@ -88,6 +90,7 @@ struct queue_t {
     } reader;
     void *buf_p;
     struct circular_buffer_t buffer;
+    struct spsc_ring_t ring;
     enum queue_state_t state;
     int flags;
 };
@@ -108,6 +111,27 @@ int queue_init(struct queue_t *self_p,
                void *buf_p,
                size_t size);
 
+/**
+ * Initialize given queue as a single producer, single consumer
+ * queue. The producer, often an interrupt service routine, writes
+ * data to a lock-free ring using `queue_write_spsc_isr()`, and only
+ * takes the system lock to resume a reader waiting for data. All
+ * reads must be made by a single thread.
+ *
+ * Writes from threads do not block, but may write less than given
+ * size if the buffer is full.
+ *
+ * @param[in] self_p Queue to initialize.
+ * @param[in] buf_p Buffer for data storage.
+ * @param[in] size Size of given buffer. Must be a power of two, and
+ *                 at most 128 bytes on AVR.
+ *
+ * @return zero(0) or negative error code
+ */
+int queue_init_spsc(struct queue_t *self_p,
+                    void *buf_p,
+                    size_t size);
+
 /**
  * Start given queue. It is not required to start a queue unless it
  * has been stopped.
@@ -178,6 +202,23 @@ ssize_t queue_write_isr(struct queue_t *self_p,
                         const void *buf_p,
                         size_t size);
 
+/**
+ * Write bytes to given single producer, single consumer queue from
+ * isr or a thread without the system lock taken. The system lock is
+ * only taken if a reader is waiting for data. May write less than
+ * size bytes.
+ *
+ * @param[in] self_p Queue initialized with `queue_init_spsc()` to
+ *                   write to.
+ * @param[in] buf_p Buffer to write from.
+ * @param[in] size Number of bytes to write.
+ *
+ * @return Number of bytes written or negative error code.
+ */
+ssize_t queue_write_spsc_isr(struct queue_t *self_p,
+                             const void *buf_p,
+                             size_t size);
+
 /**
  * Get the number of bytes currently stored in the queue. May return
  * less bytes than number of bytes stored in the channel.
@@ -0,0 +1,362 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+#define STATE_RESERVED                                      0
+#define STATE_COMMITTED                                     1
+#define STATE_PADDING                                       2
+
+/* Records are aligned for any payload type. */
+union align_t {
+    long long value;
+    void *ptr_p;
+};
+
+#define ALIGN(size) (((size) + sizeof(union align_t) - 1)       \
+                     & ~(sizeof(union align_t) - 1))
+
+/* Padding records only use the first two members, which always fit
+   at the end of the buffer as it is aligned. */
+struct header_t {
+    /* Size in the buffer, including the header and alignment. */
+    uint32_t size;
+    uint32_t state;
+    /* Record size given when reserved. */
+    size_t length;
+};
+
+#define HEADER_SIZE ALIGN(sizeof(struct header_t))
+
+static struct header_t *header_at(struct record_queue_t *self_p,
+                                  size_t offset)
+{
+    return ((struct header_t *)&self_p->buf_p[offset]);
+}
+
+static struct header_t *header_of(void *record_p)
+{
+    return ((struct header_t *)((char *)record_p - HEADER_SIZE));
+}
+
+/**
+ * Get the oldest committed record, skipping padding. Called with the
+ * system lock taken.
+ */
+static struct header_t *peek_isr(struct record_queue_t *self_p)
+{
+    struct header_t *header_p;
+
+    while (self_p->used > 0) {
+        header_p = header_at(self_p, self_p->tail);
+
+        if (header_p->state == STATE_COMMITTED) {
+            return (header_p);
+        } else if (header_p->state == STATE_RESERVED) {
+            break;
+        }
+
+        /* Padding at the end of the buffer. */
+        self_p->used -= header_p->size;
+        self_p->tail = 0;
+    }
+
+    return (NULL);
+}
+
+int record_queue_init(struct record_queue_t *self_p,
+                      void *buf_p,
+                      size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+    ASSERTN(((uintptr_t)buf_p % sizeof(union align_t)) == 0, EINVAL);
+    ASSERTN(size >= HEADER_SIZE, EINVAL);
+
+    chan_init(&self_p->base,
+              (chan_read_fn_t)record_queue_read,
+              (chan_write_fn_t)record_queue_write,
+              (chan_size_fn_t)record_queue_size);
+    chan_set_write_isr_cb(&self_p->base,
+                          (chan_write_fn_t)record_queue_write_isr);
+
+    self_p->buf_p = buf_p;
+    self_p->size = (size & ~(sizeof(union align_t) - 1));
+    self_p->head = 0;
+    self_p->tail = 0;
+    self_p->used = 0;
+
+    return (0);
+}
+
+void *record_queue_reserve(struct record_queue_t *self_p,
+                           size_t size)
+{
+    ASSERTNRN(self_p != NULL, EINVAL);
+
+    void *record_p;
+
+    sys_lock();
+    record_p = record_queue_reserve_isr(self_p, size);
+    sys_unlock();
+
+    return (record_p);
+}
+
+RAM_CODE void *record_queue_reserve_isr(struct record_queue_t *self_p,
+                                        size_t size)
+{
+    struct header_t *header_p;
+    size_t padding;
+    size_t length;
+
+    length = size;
+    size = (HEADER_SIZE + ALIGN(size));
+
+    /* Start over at the beginning of the buffer when empty to avoid
+       padding. */
+    if (self_p->used == 0) {
+        self_p->head = 0;
+        self_p->tail = 0;
+    }
+
+    /* A record does not wrap around the end of the buffer, so a
+       padding record is inserted if needed. */
+    if (self_p->head + size > self_p->size) {
+        padding = (self_p->size - self_p->head);
+    } else {
+        padding = 0;
+    }
+
+    if (self_p->used + padding + size > self_p->size) {
+        return (NULL);
+    }
+
+    if (padding > 0) {
+        header_p = header_at(self_p, self_p->head);
+        header_p->size = padding;
+        header_p->state = STATE_PADDING;
+        self_p->head = 0;
+        self_p->used += padding;
+    }
+
+    header_p = header_at(self_p, self_p->head);
+    header_p->size = size;
+    header_p->length = length;
+    header_p->state = STATE_RESERVED;
+    self_p->head += size;
+    self_p->used += size;
+
+    if (self_p->head == self_p->size) {
+        self_p->head = 0;
+    }
+
+    return ((char *)header_p + HEADER_SIZE);
+}
+
+int record_queue_commit(struct record_queue_t *self_p,
+                        void *record_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(record_p != NULL, EINVAL);
+
+    int res;
+
+    sys_lock();
+    res = record_queue_commit_isr(self_p, record_p);
+    sys_unlock();
+
+    return (res);
+}
+
+RAM_CODE int record_queue_commit_isr(struct record_queue_t *self_p,
+                                     void *record_p)
+{
+    header_of(record_p)->state = STATE_COMMITTED;
+
+    /* Resume the reader, either polling or peeking. */
+    chan_is_polled_isr(&self_p->base);
+
+    if (self_p->base.reader_p != NULL) {
+        thrd_resume_isr(self_p->base.reader_p, 0);
+        self_p->base.reader_p = NULL;
+    }
+
+    return (0);
+}
+
+void *record_queue_peek(struct record_queue_t *self_p,
+                        size_t *size_p,
+                        const struct time_t *timeout_p)
+{
+    ASSERTNRN(self_p != NULL, EINVAL);
+    ASSERTNRN(size_p != NULL, EINVAL);
+
+    struct header_t *header_p;
+
+    sys_lock();
+
+    while (1) {
+        header_p = peek_isr(self_p);
+
+        if (header_p != NULL) {
+            break;
+        }
+
+        self_p->base.reader_p = thrd_self();
+
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_QUEUE);
+        if (thrd_suspend_isr(timeout_p) == -ETIMEDOUT) {
+            self_p->base.reader_p = NULL;
+            break;
+        }
+    }
+
+    sys_unlock();
+
+    if (header_p == NULL) {
+        return (NULL);
+    }
+
+    *size_p = header_p->length;
+
+    return ((char *)header_p + HEADER_SIZE);
+}
+
+int record_queue_release(struct record_queue_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    struct header_t *header_p;
+    int res;
+
+    res = 0;
+
+    sys_lock();
+
+    header_p = peek_isr(self_p);
+
+    if (header_p != NULL) {
+        self_p->tail += header_p->size;
+        self_p->used -= header_p->size;
+
+        if (self_p->tail == self_p->size) {
+            self_p->tail = 0;
+        }
+    } else {
+        res = -ENOMSG;
+    }
+
+    sys_unlock();
+
+    return (res);
+}
+
+ssize_t record_queue_read(struct record_queue_t *self_p,
+                          void *buf_p,
+                          size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    void *record_p;
+    size_t record_size;
+
+    record_p = record_queue_peek(self_p, &record_size, NULL);
+    size = MIN(size, record_size);
+    memcpy(buf_p, record_p, size);
+    record_queue_release(self_p);
+
+    return (size);
+}
+
+ssize_t record_queue_write(struct record_queue_t *self_p,
+                           const void *buf_p,
+                           size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    void *record_p;
+
+    record_p = record_queue_reserve(self_p, size);
+
+    if (record_p == NULL) {
+        return (-ENOMEM);
+    }
+
+    memcpy(record_p, buf_p, size);
+    record_queue_commit(self_p, record_p);
+
+    return (size);
+}
+
+RAM_CODE ssize_t record_queue_write_isr(struct record_queue_t *self_p,
+                                        const void *buf_p,
+                                        size_t size)
+{
+    void *record_p;
+
+    record_p = record_queue_reserve_isr(self_p, size);
+
+    if (record_p == NULL) {
+        return (-ENOMEM);
+    }
+
+    memcpy(record_p, buf_p, size);
+    record_queue_commit_isr(self_p, record_p);
+
+    return (size);
+}
+
+RAM_CODE ssize_t record_queue_size(struct record_queue_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    struct header_t *header_p;
+
+    if (self_p->used == 0) {
+        return (0);
+    }
+
+    header_p = header_at(self_p, self_p->tail);
+
+    /* The record after padding is at the beginning of the buffer. */
+    if ((header_p->state == STATE_PADDING)
+        && (self_p->used > header_p->size)) {
+        header_p = header_at(self_p, 0);
+    }
+
+    if (header_p->state != STATE_COMMITTED) {
+        return (0);
+    }
+
+    return (header_p->length);
+}
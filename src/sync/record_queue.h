@@ -0,0 +1,184 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __SYNC_RECORD_QUEUE_H__
+#define __SYNC_RECORD_QUEUE_H__
+
+#include "simba.h"
+
+/**
+ * A queue of variable size records in a caller supplied buffer. A
+ * producer reserves space for a record, writes it in place and
+ * commits it. The consumer peeks at the oldest committed record,
+ * uses it in place and releases it. Records are never copied by the
+ * queue.
+ *
+ * Records are committed in the order they were reserved. A single
+ * consumer is supported.
+ */
+struct record_queue_t {
+    struct chan_t base;
+    char *buf_p;
+    size_t size;
+    /* Offsets in the buffer and number of used bytes, including
+       headers and padding. */
+    size_t head;
+    size_t tail;
+    size_t used;
+};
+
+/**
+ * Initialize given record queue.
+ *
+ * @param[out] self_p Record queue to initialize.
+ * @param[in] buf_p Buffer for records.
+ * @param[in] size Buffer size in bytes. Each record uses a small
+ *                 header and is aligned, so the buffer holds fewer
+ *                 payload bytes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int record_queue_init(struct record_queue_t *self_p,
+                      void *buf_p,
+                      size_t size);
+
+/**
+ * Reserve a record of given size at the end of the queue. Write the
+ * record in place, and then call `record_queue_commit()` to make it
+ * available to the consumer.
+ *
+ * @param[in] self_p Record queue.
+ * @param[in] size Record size in bytes, at least one.
+ *
+ * @return Pointer to the reserved record, or NULL if the queue is
+ *         full.
+ */
+void *record_queue_reserve(struct record_queue_t *self_p,
+                           size_t size);
+
+/**
+ * Same as `record_queue_reserve()`, but may only be called from
+ * isr or with the system lock taken (see `sys_lock()`).
+ */
+void *record_queue_reserve_isr(struct record_queue_t *self_p,
+                               size_t size);
+
+/**
+ * Commit given reserved record, waking the consumer if it is
+ * waiting.
+ *
+ * @param[in] self_p Record queue.
+ * @param[in] record_p Record returned by `record_queue_reserve()`.
+ *
+ * @return zero(0) or negative error code.
+ */
+int record_queue_commit(struct record_queue_t *self_p,
+                        void *record_p);
+
+/**
+ * Same as `record_queue_commit()`, but may only be called from isr
+ * or with the system lock taken (see `sys_lock()`).
+ */
+int record_queue_commit_isr(struct record_queue_t *self_p,
+                            void *record_p);
+
+/**
+ * Get the oldest committed record without removing it from the
+ * queue. Call `record_queue_release()` when done with it.
+ *
+ * @param[in] self_p Record queue.
+ * @param[out] size_p Record size in bytes.
+ * @param[in] timeout_p Read timeout, or NULL to wait forever.
+ *
+ * @return Pointer to the record, or NULL on timeout.
+ */
+void *record_queue_peek(struct record_queue_t *self_p,
+                        size_t *size_p,
+                        const struct time_t *timeout_p);
+
+/**
+ * Remove the record returned by `record_queue_peek()` from the
+ * queue.
+ *
+ * @param[in] self_p Record queue.
+ *
+ * @return zero(0) or negative error code.
+ */
+int record_queue_release(struct record_queue_t *self_p);
+
+/**
+ * Copy the oldest record to given buffer and remove it from the
+ * queue. Waits for a record if the queue is empty. This is the
+ * channel read function.
+ *
+ * @param[in] self_p Record queue.
+ * @param[out] buf_p Buffer to read into. Longer records are
+ *                   truncated.
+ * @param[in] size Buffer size.
+ *
+ * @return Number of read bytes or negative error code.
+ */
+ssize_t record_queue_read(struct record_queue_t *self_p,
+                          void *buf_p,
+                          size_t size);
+
+/**
+ * Write given buffer as one record. This is the channel write
+ * function.
+ *
+ * @param[in] self_p Record queue.
+ * @param[in] buf_p Record to write.
+ * @param[in] size Record size.
+ *
+ * @return Number of written bytes or negative error code.
+ */
+ssize_t record_queue_write(struct record_queue_t *self_p,
+                           const void *buf_p,
+                           size_t size);
+
+/**
+ * Same as `record_queue_write()`, but may only be called from isr or
+ * with the system lock taken (see `sys_lock()`).
+ */
+ssize_t record_queue_write_isr(struct record_queue_t *self_p,
+                               const void *buf_p,
+                               size_t size);
+
+/**
+ * Get the size of the oldest committed record.
+ *
+ * @param[in] self_p Record queue.
+ *
+ * @return Record size in bytes, or zero(0) if no record is
+ *         available.
+ */
+ssize_t record_queue_size(struct record_queue_t *self_p);
+
+#endif
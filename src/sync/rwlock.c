@@ -71,6 +71,7 @@ int rwlock_reader_take(struct rwlock_t *self_p)
         elem.prev_p = NULL;
         self_p->readers_p = &elem;
 
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_RWLOCK);
         thrd_suspend_isr(NULL);
     }
 
@@ -132,6 +133,7 @@ int rwlock_writer_take(struct rwlock_t *self_p)
         elem.prev_p = NULL;
         self_p->writers_p = &elem;
 
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_RWLOCK);
         thrd_suspend_isr(NULL);
     }
 
@@ -64,6 +64,7 @@ int sem_take(struct sem_t *self_p,
     if (self_p->count == self_p->count_max) {
         elem.thrd_p = thrd_self();
         thrd_prio_list_push_isr(&self_p->waiters, &elem);
+        THRD_TRACE_SET_REASON_ISR(THRD_TRACE_REASON_SEM);
         err = thrd_suspend_isr(timeout_p);
 
         if (err == -ETIMEDOUT) {
@@ -36,6 +36,16 @@
 /* +7 for floating point decimal point and fraction. */
 #define VALUE_BUF_MAX (3 * sizeof(long) + 7)
 
+/* Output function called with spans of formatted characters. */
+typedef void (*output_write_fn_t)(const char *buf_p,
+                                  size_t size,
+                                  void *arg_p);
+
+/* Channel write function. */
+typedef ssize_t (*output_chan_write_fn_t)(void *self_p,
+                                          const void *buf_p,
+                                          size_t size);
+
 struct buffered_output_t {
     void *chan_p;
     int pos;
@@ -49,6 +59,58 @@ struct snprintf_output_t {
     size_t size_max;
 };
 
+/**
+ * A parsed conversion specification, %[flags][width][length]specifier.
+ */
+struct directive_t {
+    char flags;
+    char length;
+    char specifier;
+    int width;
+};
+
+#if CONFIG_STD_FORMAT_CACHE == 1
+
+struct format_cache_directive_t {
+    /* Offset of the '%' in the format string. */
+    uint16_t offset;
+    uint8_t size;
+    struct directive_t directive;
+};
+
+/**
+ * A parsed format string. An entry is claimed once and never changed
+ * after its format string pointer is set, so it can be read without
+ * the system lock.
+ */
+struct format_cache_entry_t {
+    far_string_t fmt_p;
+    uint8_t claimed;
+    uint8_t number_of_directives;
+    uint16_t end;
+    struct format_cache_directive_t
+    directives[CONFIG_STD_FORMAT_CACHE_DIRECTIVES_MAX];
+};
+
+static struct format_cache_entry_t format_cache[
+    CONFIG_STD_FORMAT_CACHE_ENTRIES];
+
+#endif
+
+static const FAR char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const FAR char hex_digits[] = "0123456789abcdef";
+
 /**
  * @return true(1) if the character is part of the string, otherwise
  *         false(0).
@@ -67,47 +129,75 @@ static int char_in_string(char c, const char *str_p)
 }
 
 /**
- * Put characters to buffer.
+ * Write characters to buffer.
  */
-static void sprintf_putc(char c, void *arg_p)
+static void sprintf_write(const char *buf_p, size_t size, void *arg_p)
 {
     char **dst_pp = arg_p;
 
-    *(*dst_pp)++ = c;
+    memcpy(*dst_pp, buf_p, size);
+    *dst_pp += size;
 }
 
 /**
- * Put characters to buffer.
+ * Write characters to buffer.
  */
-static void snprintf_putc(char c, void *arg_p)
+static void snprintf_write(const char *buf_p, size_t size, void *arg_p)
 {
     struct snprintf_output_t *output_p;
 
     output_p = arg_p;
 
     if (output_p->size < output_p->size_max) {
-        output_p->dst_p[output_p->size] = c;
+        memcpy(&output_p->dst_p[output_p->size],
+               buf_p,
+               MIN(size, output_p->size_max - output_p->size));
     }
 
-    output_p->size++;
+    output_p->size += size;
 }
 
 /**
- * Put characters to standard output.
+ * Write characters to the output buffer, and write the buffer to the
+ * channel when full. Spans not fitting in the buffer are written
+ * directly to the channel.
  */
-static void fprintf_putc(char c, void *arg_p)
+static void buffered_output_write(struct buffered_output_t *output_p,
+                                  const char *buf_p,
+                                  size_t size,
+                                  output_chan_write_fn_t chan_write_fn)
 {
-    struct buffered_output_t *output_p = arg_p;
+    size_t n;
 
-    output_p->buffer[output_p->pos++] = c;
-    output_p->size++;
+    output_p->size += size;
 
-    if (output_p->pos == membersof(output_p->buffer)) {
-        chan_write(output_p->chan_p, output_p->buffer, output_p->pos);
-        output_p->pos = 0;
+    while (size > 0) {
+        if ((output_p->pos == 0) && (size >= sizeof(output_p->buffer))) {
+            chan_write_fn(output_p->chan_p, buf_p, size);
+            break;
+        }
+
+        n = MIN(size, sizeof(output_p->buffer) - output_p->pos);
+        memcpy(&output_p->buffer[output_p->pos], buf_p, n);
+        output_p->pos += n;
+        buf_p += n;
+        size -= n;
+
+        if (output_p->pos == sizeof(output_p->buffer)) {
+            chan_write_fn(output_p->chan_p, output_p->buffer, output_p->pos);
+            output_p->pos = 0;
+        }
     }
 }
 
+/**
+ * Write characters to standard output.
+ */
+static void fprintf_write(const char *buf_p, size_t size, void *arg_p)
+{
+    buffered_output_write(arg_p, buf_p, size, chan_write);
+}
+
 /**
  * Flush output buffer to channel.
  */
@@ -120,20 +210,12 @@ static void output_flush(struct buffered_output_t *output_p)
 }
 
 /**
- * Put characters to standard output from interrupt context or with
+ * Write characters to standard output from interrupt context or with
  * the system lock taken.
  */
-static void fprintf_putc_isr(char c, void *arg_p)
+static void fprintf_write_isr(const char *buf_p, size_t size, void *arg_p)
 {
-    struct buffered_output_t *output_p = arg_p;
-
-    output_p->buffer[output_p->pos++] = c;
-    output_p->size++;
-
-    if (output_p->pos == membersof(output_p->buffer)) {
-        chan_write_isr(output_p->chan_p, output_p->buffer, output_p->pos);
-        output_p->pos = 0;
-    }
+    buffered_output_write(arg_p, buf_p, size, chan_write_isr);
 }
 
 /**
@@ -147,52 +229,124 @@ static void output_flush_isr(struct buffered_output_t *output_p)
     }
 }
 
-static void formats(void (*std_putc)(char c, void *arg_p),
+/**
+ * Write given number of characters in far memory.
+ */
+static void output_far(output_write_fn_t output_write,
+                       void *arg_p,
+                       far_string_t str_p,
+                       size_t size)
+{
+#if defined(FAR_SPECIAL_ADDRESS)
+    char buf[16];
+    size_t i;
+    size_t n;
+
+    while (size > 0) {
+        n = MIN(size, sizeof(buf));
+
+        for (i = 0; i < n; i++) {
+            buf[i] = *str_p++;
+        }
+
+        output_write(&buf[0], n, arg_p);
+        size -= n;
+    }
+#else
+    if (size > 0) {
+        output_write(str_p, size, arg_p);
+    }
+#endif
+}
+
+/**
+ * Write given character given number of times.
+ */
+static void output_fill(output_write_fn_t output_write,
+                        void *arg_p,
+                        char c,
+                        int size)
+{
+    char buf[16];
+    int n;
+
+    if (size <= 0) {
+        return;
+    }
+
+    memset(&buf[0], c, MIN(size, (int)sizeof(buf)));
+
+    while (size > 0) {
+        n = MIN(size, (int)sizeof(buf));
+        output_write(&buf[0], n, arg_p);
+        size -= n;
+    }
+}
+
+static void formats(output_write_fn_t output_write,
                     void *arg_p,
-                    char *str_p,
+                    const char *str_p,
+                    size_t size,
                     char flags,
                     int width,
                     char negative_sign)
 {
-    char *s_p = str_p;
-
-    while (*s_p++ != '\0') {
-        width--;
-    }
+    width -= size;
 
     /* Right justification. */
     if (flags != '-') {
         if ((negative_sign == 1) && (flags == '0')) {
-            std_putc(*str_p++, arg_p);
+            output_write(str_p, 1, arg_p);
+            str_p++;
+            size--;
         }
 
-        while (width > 0) {
-            std_putc(flags, arg_p);
-            width--;
-        }
+        output_fill(output_write, arg_p, flags, width);
+        width = 0;
     }
 
     /* Number */
-    while (*str_p != '\0') {
-        std_putc(*str_p++, arg_p);
+    if (size > 0) {
+        output_write(str_p, size, arg_p);
     }
 
     /* Left justification. */
-    while (width > 0) {
-        std_putc(' ', arg_p);
-        width--;
+    output_fill(output_write, arg_p, ' ', width);
+}
+
+/**
+ * Format given value as a decimal number ending just before given
+ * buffer position, two digits at a time.
+ */
+static char *format_decimal(char *str_p, unsigned long value)
+{
+    unsigned int i;
+
+    while (value >= 100) {
+        i = (2 * (unsigned int)(value % 100));
+        value /= 100;
+        *--str_p = digit_pairs[i + 1];
+        *--str_p = digit_pairs[i];
     }
+
+    if (value >= 10) {
+        i = (2 * (unsigned int)value);
+        *--str_p = digit_pairs[i + 1];
+        *--str_p = digit_pairs[i];
+    } else {
+        *--str_p = ('0' + (char)value);
+    }
+
+    return (str_p);
 }
 
 static char *formati(char c,
                      char *str_p,
-                     char radix,
                      va_list *ap_p,
                      char length,
                      char *negative_sign_p)
 {
     unsigned long value;
-    char digit;
 
     /* Get argument. */
     if (length == 0) {
@@ -213,14 +367,14 @@ static char *formati(char c,
     }
 
     /* Format number into buffer. */
-    do {
-        digit = (char)(value % radix);
-        value /= radix;
-        if (digit > 9) {
-            digit += 39;
-        }
-        *--str_p = ('0' + digit);
-    } while (value > 0);
+    if (c == 'x') {
+        do {
+            *--str_p = hex_digits[value & 0xf];
+            value >>= 4;
+        } while (value > 0);
+    } else {
+        str_p = format_decimal(str_p, value);
+    }
 
     if (*negative_sign_p == 1) {
         *--str_p = '-';
@@ -240,7 +394,7 @@ static char *formatf(char c,
     double value;
     unsigned long whole_number;
     unsigned long fraction_number;
-    int i;
+    unsigned int i;
 
     /* Get argument. */
     value = va_arg(*ap_p, double);
@@ -266,18 +420,18 @@ static char *formatf(char c,
     fraction_number = (unsigned long)((value - whole_number) * 1000000.0);
 
     /* Write fraction number to output buffer. */
-    for (i = 0; i < 6; i++) {
-        *--str_p = '0' + (fraction_number % 10);
-        fraction_number /= 10;
+    for (i = 0; i < 3; i++) {
+        *--str_p = digit_pairs[2 * (fraction_number % 100) + 1];
+        *--str_p = digit_pairs[2 * (fraction_number % 100)];
+        fraction_number /= 100;
     }
 
     /* Write the decimal dot. */
     *--str_p = '.';
 
     /* Write whole number to output buffer. */
-    while (whole_number != 0) {
-        *--str_p = '0' + (whole_number % 10);
-        whole_number /= 10;
+    if (whole_number != 0) {
+        str_p = format_decimal(str_p, whole_number);
     }
 
     /* Add negative sign if the number is negative. */
@@ -290,127 +444,306 @@ static char *formatf(char c,
 
 #endif
 
-static void vcprintf(void (*std_putc)(char c, void *arg_p),
-                     void *arg_p,
-                     far_string_t fmt_p,
-                     va_list *ap_p)
+/**
+ * Parse the conversion specification following a '%' in a format
+ * string. The specifier is '\0' if the format string ended.
+ *
+ * @return Format string position after the conversion specification.
+ */
+static far_string_t parse_directive(far_string_t fmt_p,
+                                    struct directive_t *directive_p)
 {
-    char c, flags, length, negative_sign, buf[VALUE_BUF_MAX], *s_p;
-    int width;
+    char c;
 
-    buf[sizeof(buf) - 1] = '\0';
+    /* Prototype: %[flags][width][length]specifier  */
 
-    while ((c = *fmt_p++) != '\0') {
-        if (c != '%') {
-            std_putc(c, arg_p);
-            continue;
-        }
+    /* Parse the flags. */
+    directive_p->flags = ' ';
+    c = *fmt_p++;
+
+    if ((c == '0') || (c == '-')) {
+        directive_p->flags = c;
+        c = *fmt_p++;
+    }
+
+    /* Parse the width. */
+    directive_p->width = 0;
 
-        /* Prototype: %[flags][width][length]specifier  */
+    while ((c >= '0') && (c <= '9')) {
+        directive_p->width *= 10;
+        directive_p->width += (c - '0');
+        c = *fmt_p++;
+    }
+
+    /* Parse the length. */
+    directive_p->length = 0;
 
-        /* Parse the flags. */
-        flags = ' ';
+    if (c == 'l') {
+        directive_p->length = 1;
         c = *fmt_p++;
+    }
+
+    directive_p->specifier = c;
 
-        if ((c == '0') || (c == '-')) {
-            flags = c;
-            c = *fmt_p++;
+    return (fmt_p);
+}
+
+/**
+ * Format the argument of given conversion specification.
+ */
+static void output_directive(output_write_fn_t output_write,
+                             void *arg_p,
+                             struct directive_t *directive_p,
+                             va_list *ap_p)
+{
+    char c, negative_sign, buf[VALUE_BUF_MAX], *s_p, *end_p;
+
+    c = directive_p->specifier;
+    end_p = &buf[sizeof(buf)];
+    negative_sign = 0;
+
+    switch (c) {
+
+    case 'S':
+#if defined(FAR_SPECIAL_ADDRESS)
+        {
+            FAR const char *far_string_p;
+            size_t size;
+
+            far_string_p = va_arg(*ap_p, FAR const char*);
+
+            if (far_string_p == NULL) {
+                far_string_p = FSTR("(null)");
+            }
+
+            size = std_strlen(far_string_p);
+
+            /* Right justification. */
+            if (directive_p->flags != '-') {
+                output_fill(output_write,
+                            arg_p,
+                            directive_p->flags,
+                            directive_p->width - size);
+            }
+
+            output_far(output_write, arg_p, far_string_p, size);
+
+            /* Left justification. */
+            if (directive_p->flags == '-') {
+                output_fill(output_write,
+                            arg_p,
+                            ' ',
+                            directive_p->width - size);
+            }
         }
 
-        /* Parse the width. */
-        width = 0;
+        return;
+#endif
+
+    case 's':
+        s_p = va_arg(*ap_p, char*);
 
-        while ((c >= '0') && (c <= '9')) {
-            width *= 10;
-            width += (c - '0');
-            c = *fmt_p++;
+        if (s_p == NULL) {
+            s_p = "(null)";
         }
 
-        /* Parse the length. */
-        length = 0;
+        end_p = (s_p + strlen(s_p));
+        break;
+
+    case 'c':
+        buf[0] = (char)va_arg(*ap_p, int);
+        s_p = &buf[0];
+        end_p = &buf[buf[0] != '\0'];
+        break;
+
+    case 'i':
+    case 'd':
+    case 'u':
+    case 'x':
+        s_p = formati(c, end_p, ap_p, directive_p->length, &negative_sign);
+        break;
+
+#if CONFIG_FLOAT == 1
+    case 'f':
+        s_p = formatf(c, end_p, ap_p, directive_p->length, &negative_sign);
+        break;
+#endif
+
+    default:
+        output_write(&c, 1, arg_p);
+        return;
+    }
+
+    formats(output_write,
+            arg_p,
+            s_p,
+            end_p - s_p,
+            directive_p->flags,
+            directive_p->width,
+            negative_sign);
+}
+
+#if CONFIG_STD_FORMAT_CACHE == 1
+
+static struct format_cache_entry_t *format_cache_get(far_string_t fmt_p)
+{
+    struct format_cache_entry_t *entry_p;
+
+    entry_p = &format_cache[((uintptr_t)fmt_p / sizeof(int))
+                            % CONFIG_STD_FORMAT_CACHE_ENTRIES];
 
-        if (c == 'l') {
-            length = 1;
-            c = *fmt_p++;
+    if (__atomic_load_n(&entry_p->fmt_p, __ATOMIC_ACQUIRE) == fmt_p) {
+        return (entry_p);
+    }
+
+    return (NULL);
+}
+
+/**
+ * Parse given format string into a free cache entry, if any. Format
+ * strings that do not fit in an entry are not cached.
+ */
+static void format_cache_add(far_string_t fmt_p)
+{
+    struct format_cache_entry_t *entry_p;
+    struct format_cache_directive_t *cache_directive_p;
+    far_string_t begin_p;
+    far_string_t pos_p;
+    uint8_t claimed;
+
+    entry_p = &format_cache[((uintptr_t)fmt_p / sizeof(int))
+                            % CONFIG_STD_FORMAT_CACHE_ENTRIES];
+    claimed = 0;
+
+    if (!__atomic_compare_exchange_n(&entry_p->claimed,
+                                     &claimed,
+                                     1,
+                                     0,
+                                     __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    entry_p->number_of_directives = 0;
+    pos_p = fmt_p;
+
+    while (1) {
+        while ((*pos_p != '%') && (*pos_p != '\0')) {
+            pos_p++;
         }
 
-        if (c == '\0') {
+        if (*pos_p == '\0') {
             break;
         }
 
-        /* Parse the specifier. */
-        negative_sign = 0;
+        if (entry_p->number_of_directives == membersof(entry_p->directives)) {
+            goto out;
+        }
 
-        switch (c) {
+        cache_directive_p =
+            &entry_p->directives[entry_p->number_of_directives];
+        begin_p = pos_p;
+        pos_p = parse_directive(pos_p + 1, &cache_directive_p->directive);
 
-        case 'S':
-#if defined(FAR_SPECIAL_ADDRESS)
-            {
-                FAR const char *far_string_p;
+        if ((cache_directive_p->directive.specifier == '\0')
+            || (pos_p - begin_p > 0xff)
+            || (pos_p - fmt_p > 0xffff)) {
+            goto out;
+        }
 
-                far_string_p = va_arg(*ap_p, FAR const char*);
+        cache_directive_p->offset = (begin_p - fmt_p);
+        cache_directive_p->size = (pos_p - begin_p);
+        entry_p->number_of_directives++;
+    }
 
-                if (far_string_p == NULL) {
-                    far_string_p = FSTR("(null)");
-                }
+    if (pos_p - fmt_p > 0xffff) {
+        goto out;
+    }
 
-                s_p = &buf[sizeof(buf) - 1];
-                width -= std_strlen(far_string_p);
+    entry_p->end = (pos_p - fmt_p);
+    __atomic_store_n(&entry_p->fmt_p, fmt_p, __ATOMIC_RELEASE);
 
-                /* Right justification. */
-                if (flags != '-') {
-                    formats(std_putc, arg_p, s_p, flags, width, negative_sign);
-                }
+    return;
 
-                while (*far_string_p != '\0') {
-                    std_putc(*far_string_p++, arg_p);
-                }
+ out:
+    /* Let another format string use the entry. */
+    __atomic_store_n(&entry_p->claimed, 0, __ATOMIC_RELEASE);
+}
 
-                /* Left justification. */
-                if (flags == '-') {
-                    formats(std_putc, arg_p, s_p, flags, width, negative_sign);
-                }
-            }
+static void vcprintf_cached(output_write_fn_t output_write,
+                            void *arg_p,
+                            far_string_t fmt_p,
+                            va_list *ap_p,
+                            struct format_cache_entry_t *entry_p)
+{
+    struct format_cache_directive_t *cache_directive_p;
+    size_t pos;
+    int i;
+
+    pos = 0;
+
+    for (i = 0; i < entry_p->number_of_directives; i++) {
+        cache_directive_p = &entry_p->directives[i];
+        output_far(output_write,
+                   arg_p,
+                   &fmt_p[pos],
+                   cache_directive_p->offset - pos);
+        output_directive(output_write,
+                         arg_p,
+                         &cache_directive_p->directive,
+                         ap_p);
+        pos = (cache_directive_p->offset + cache_directive_p->size);
+    }
+
+    output_far(output_write, arg_p, &fmt_p[pos], entry_p->end - pos);
+}
 
-            continue;
 #endif
 
-        case 's':
-            s_p = va_arg(*ap_p, char*);
+static void vcprintf(output_write_fn_t output_write,
+                     void *arg_p,
+                     far_string_t fmt_p,
+                     va_list *ap_p)
+{
+    struct directive_t directive;
+    far_string_t begin_p;
 
-            if (s_p == NULL) {
-                s_p = "(null)";
-            }
+#if CONFIG_STD_FORMAT_CACHE == 1
+    struct format_cache_entry_t *entry_p;
 
-            break;
+    entry_p = format_cache_get(fmt_p);
 
-        case 'c':
-            buf[sizeof(buf) - 2] = (char)va_arg(*ap_p, int);
-            s_p = &buf[sizeof(buf) - 2];
-            break;
+    if (entry_p != NULL) {
+        vcprintf_cached(output_write, arg_p, fmt_p, ap_p, entry_p);
 
-        case 'i':
-        case 'd':
-        case 'u':
-            s_p = formati(c, &buf[sizeof(buf) - 1], 10, ap_p, length, &negative_sign);
-            break;
+        return;
+    }
 
-        case 'x':
-            s_p = formati(c, &buf[sizeof(buf) - 1], 16, ap_p, length, &negative_sign);
-            break;
+    format_cache_add(fmt_p);
+#endif
 
-#if CONFIG_FLOAT == 1
-        case 'f':
-            s_p = formatf(c, &buf[sizeof(buf) - 1], ap_p, length, &negative_sign);
+    while (1) {
+        /* Write characters up to the next conversion specification
+           as one span. */
+        begin_p = fmt_p;
+
+        while ((*fmt_p != '%') && (*fmt_p != '\0')) {
+            fmt_p++;
+        }
+
+        output_far(output_write, arg_p, begin_p, fmt_p - begin_p);
+
+        if (*fmt_p == '\0') {
             break;
-#endif
+        }
 
-        default:
-            std_putc(c, arg_p);
-            continue;
+        fmt_p = parse_directive(fmt_p + 1, &directive);
+
+        if (directive.specifier == '\0') {
+            break;
         }
 
-        formats(std_putc, arg_p, s_p, flags, width, negative_sign);
+        output_directive(output_write, arg_p, &directive, ap_p);
     }
 }
 
@@ -419,7 +752,7 @@ static void cvcprintf(struct buffered_output_t *output_p,
                       va_list *ap_p)
 {
     chan_control(output_p->chan_p, CHAN_CONTROL_PRINTF_BEGIN);
-    vcprintf(fprintf_putc, output_p, fmt_p, ap_p);
+    vcprintf(fprintf_write, output_p, fmt_p, ap_p);
     output_flush(output_p);
     chan_control(output_p->chan_p, CHAN_CONTROL_PRINTF_END);
 }
@@ -482,8 +815,8 @@ ssize_t std_vsprintf(char *dst_p, far_string_t fmt_p, va_list *ap_p)
 
     char *d_p = dst_p;
 
-    vcprintf(sprintf_putc, &d_p, fmt_p, ap_p);
-    sprintf_putc('\0', &d_p);
+    vcprintf(sprintf_write, &d_p, fmt_p, ap_p);
+    sprintf_write("", 1, &d_p);
 
     return (d_p - dst_p - 1);
 }
@@ -506,8 +839,8 @@ ssize_t std_vsnprintf(char *dst_p,
     output.size = 0;
     output.size_max = size;
 
-    vcprintf(snprintf_putc, &output, fmt_p, ap_p);
-    snprintf_putc('\0', &output);
+    vcprintf(snprintf_write, &output, fmt_p, ap_p);
+    snprintf_write("", 1, &output);
 
     /* Force the string to be NULL terminated. */
     dst_p[size - 1] = '\0';
@@ -599,7 +932,7 @@ ssize_t std_printf_isr(far_string_t fmt_p, ...)
     output.chan_p = sys_get_stdout();
 
     va_start(ap, fmt_p);
-    vcprintf(fprintf_putc_isr, &output, fmt_p, &ap);
+    vcprintf(fprintf_write_isr, &output, fmt_p, &ap);
     output_flush_isr(&output);
     va_end(ap);
 
@@ -616,7 +949,7 @@ ssize_t std_fprintf_isr(void *chan_p, far_string_t fmt_p, ...)
     output.chan_p = chan_p;
 
     va_start(ap, fmt_p);
-    vcprintf(fprintf_putc_isr, &output, fmt_p, &ap);
+    vcprintf(fprintf_write_isr, &output, fmt_p, &ap);
     output_flush_isr(&output);
     va_end(ap);
 
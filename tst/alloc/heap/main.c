@@ -30,6 +30,13 @@
 
 #include "simba.h"
 
+struct trace_entry_t {
+    uint8_t slot;
+    uint16_t size;
+};
+
+#include "trace.i"
+
 static char buffer[2048];
 
 static int test_alloc_free(void)
@@ -65,6 +72,8 @@ static int test_alloc_free(void)
         BTASSERT(heap_free(&heap, buffers[i]) == 0);
     }
 
+    BTASSERT(heap_flush(&heap) == 0);
+
     return (0);
 }
 
@@ -81,6 +90,8 @@ static int test_double_free(void)
     BTASSERT(heap_free(&heap, buf_p) == 0);
     BTASSERT(heap_free(&heap, buf_p) == -1);
 
+    BTASSERT(heap_flush(&heap) == 0);
+
     return (0);
 }
 
@@ -98,6 +109,8 @@ static int test_share(void)
     BTASSERT(heap_free(&heap, buf_p) == 1);
     BTASSERT(heap_free(&heap, buf_p) == 0);
 
+    BTASSERT(heap_flush(&heap) == 0);
+
     return (0);
 }
 
@@ -135,6 +148,8 @@ static int test_big_buffer(void)
     memset(buffers[0], -1, 514);
     BTASSERT(heap_free(&heap, buffers[0]) == 0);
 
+    BTASSERT(heap_flush(&heap) == 0);
+
     return (0);
 }
 
@@ -156,9 +171,308 @@ static int test_out_of_memory(void)
     buf_p = heap_alloc(&heap, 3000);
     BTASSERT(buf_p == NULL);
 
+    BTASSERT(heap_flush(&heap) == 0);
+
+    return (0);
+}
+
+static int test_split_and_coalesce(void)
+{
+    struct heap_t heap;
+    char *a_p;
+    char *b_p;
+    char *c_p;
+    char *d_p;
+    size_t sizes[8] = { 8, 8, 8, 8, 8, 8, 8, 16 };
+
+    BTASSERT(heap_init(&heap, buffer, sizeof(buffer), sizes) == 0);
+
+    a_p = heap_alloc(&heap, 1000);
+    BTASSERT(a_p != NULL);
+    b_p = heap_alloc(&heap, 100);
+    BTASSERT(b_p != NULL);
+    BTASSERT(heap_free(&heap, a_p) == 0);
+
+    /* Both buffers are split from the free block. */
+    c_p = heap_alloc(&heap, 200);
+    BTASSERT(c_p == a_p);
+    d_p = heap_alloc(&heap, 600);
+    BTASSERT(d_p > c_p);
+    BTASSERT(d_p < a_p + 1000);
+
+    /* Coalesce them into the original block. */
+    BTASSERT(heap_free(&heap, c_p) == 0);
+    BTASSERT(heap_free(&heap, d_p) == 0);
+    c_p = heap_alloc(&heap, 1000);
+    BTASSERT(c_p == a_p);
+
+    /* All memory is given back when everything is freed. */
+    BTASSERT(heap_free(&heap, c_p) == 0);
+    BTASSERT(heap_free(&heap, b_p) == 0);
+    BTASSERT(heap.dynamic.begin_p == heap.dynamic.end_p);
+    BTASSERT(heap_alloc(&heap, 1900) != NULL);
+
+    BTASSERT(heap_flush(&heap) == 0);
+
     return (0);
 }
 
+static int test_trace_benchmark(void)
+{
+    static char trace_buffer[12288];
+    struct heap_t heap;
+    void *slots[16];
+    size_t sizes[8] = { 16, 32, 64, 128, 256, 512, 512, 512 };
+    size_t peak;
+    size_t used;
+    int failed;
+    int round;
+    int start;
+    int time;
+    size_t i;
+
+    BTASSERT(heap_init(&heap, trace_buffer, sizeof(trace_buffer), sizes) == 0);
+
+    memset(&slots[0], 0, sizeof(slots));
+    peak = 0;
+    failed = 0;
+    time = 0;
+
+    for (round = 0; round < 20; round++) {
+        start = time_micros();
+
+        for (i = 0; i < membersof(trace); i++) {
+            if (trace[i].size == 0) {
+                if (slots[trace[i].slot] != NULL) {
+                    heap_free(&heap, slots[trace[i].slot]);
+                    slots[trace[i].slot] = NULL;
+                }
+            } else {
+                slots[trace[i].slot] = heap_alloc(&heap, trace[i].size);
+
+                if (slots[trace[i].slot] == NULL) {
+                    failed++;
+                }
+
+                used = (((char *)heap.next_p - (char *)heap.buf_p)
+                        + ((char *)heap.dynamic.end_p
+                           - (char *)heap.dynamic.begin_p));
+
+                if (used > peak) {
+                    peak = used;
+                }
+            }
+        }
+
+        time += time_micros_elapsed(start, time_micros());
+    }
+
+    std_printf(OSTR("Replayed %d allocations and frees in %d us with %d "
+                    "failed allocations and a peak heap usage of %u bytes.\r\n"),
+               20 * (int)membersof(trace),
+               time,
+               failed,
+               (unsigned)peak);
+
+    BTASSERTI(failed, ==, 0);
+    BTASSERT(heap.dynamic.begin_p == heap.dynamic.end_p);
+
+    BTASSERT(heap_flush(&heap) == 0);
+
+    return (0);
+}
+
+#if CONFIG_HEAP_MAGAZINES > 0
+
+static struct heap_t magazine_heap;
+static THRD_STACK(magazine_stack, 1024);
+
+static void *magazine_main(void *arg_p)
+{
+    void *buf_p;
+
+    buf_p = heap_alloc(&magazine_heap, 20);
+    heap_free(&magazine_heap, buf_p);
+    thrd_resume(arg_p, 0);
+    thrd_suspend(NULL);
+
+    return (NULL);
+}
+
+static int test_magazines(void)
+{
+    struct queue_t queue;
+    char qbuf[256];
+    char command[64];
+    void *buffers[32];
+    size_t sizes[8] = { 16, 32, 64, 128, 256, 512, 512, 512 };
+    int i;
+    int j;
+
+    BTASSERT(heap_init(&magazine_heap, buffer, sizeof(buffer), sizes) == 0);
+    BTASSERT(heap_stats_register(&magazine_heap,
+                                 "/alloc/heap/stats") == 0);
+
+    /* Allocate and free from the main thread's cache. */
+    for (j = 0; j < 2; j++) {
+        for (i = 0; i < membersof(buffers); i++) {
+            buffers[i] = heap_alloc(&magazine_heap, 16);
+            BTASSERT(buffers[i] != NULL);
+        }
+
+        for (i = 0; i < membersof(buffers); i++) {
+            BTASSERT(heap_free(&magazine_heap, buffers[i]) == 0);
+        }
+    }
+
+    BTASSERT(heap_free(&magazine_heap, buffers[0]) == -1);
+
+    /* The last reference of a shared buffer is freed to the cache. */
+    buffers[0] = heap_alloc(&magazine_heap, 16);
+    BTASSERT(heap_share(&magazine_heap, buffers[0], 1) == 0);
+    BTASSERT(heap_free(&magazine_heap, buffers[0]) == 1);
+    BTASSERT(heap_free(&magazine_heap, buffers[0]) == 0);
+
+    /* A second thread gets its own cache. */
+    thrd_spawn(magazine_main,
+               thrd_self(),
+               0,
+               magazine_stack,
+               sizeof(magazine_stack));
+    thrd_suspend(NULL);
+
+    BTASSERT(queue_init(&queue, &qbuf[0], sizeof(qbuf)) == 0);
+    strcpy(command, "/alloc/heap/stats");
+    BTASSERT(fs_call(command, NULL, &queue, NULL) == 0);
+    BTASSERT(harness_expect(&queue,
+                            "mutex_allocs: 0\r\n"
+                            "mutex_frees: 0\r\n"
+                            "magazine_allocs: 66\r\n"
+                            "magazine_frees: 66\r\n"
+                            "refills: 39\r\n"
+                            "flushes: 12\r\n"
+                            "reclaims: 0\r\n"
+                            "failed_allocs: 0\r\n"
+                            "magazines: 2/4\r\n",
+                            NULL) > 0);
+
+    /* Give the cached buffers back. */
+    BTASSERT(heap_flush(&magazine_heap) == 0);
+    BTASSERT(magazine_heap.magazines[0].thrd_p == NULL);
+    BTASSERT(magazine_heap.magazines[0].fixed[0].length == 0);
+
+    return (0);
+}
+
+static struct heap_t reclaim_heap;
+static THRD_STACK(consumer_stack, 1024);
+#if CONFIG_THRD_TERMINATE == 1
+static THRD_STACK(terminated_stack, 1024);
+#endif
+static void *reclaim_buffers[32];
+static int reclaim_length;
+
+static int alloc_all(void)
+{
+    int length;
+
+    length = 0;
+
+    while (length < membersof(reclaim_buffers)) {
+        reclaim_buffers[length] = heap_alloc(&reclaim_heap, 16);
+
+        if (reclaim_buffers[length] == NULL) {
+            break;
+        }
+
+        length++;
+    }
+
+    return (length);
+}
+
+static void free_all(int length)
+{
+    int i;
+
+    for (i = 0; i < length; i++) {
+        heap_free(&reclaim_heap, reclaim_buffers[i]);
+    }
+}
+
+static void *consumer_main(void *arg_p)
+{
+    reclaim_length = alloc_all();
+    free_all(reclaim_length);
+    thrd_resume(arg_p, 0);
+    thrd_suspend(NULL);
+
+    return (NULL);
+}
+
+#if CONFIG_THRD_TERMINATE == 1
+
+static void *terminated_main(void *arg_p)
+{
+    reclaim_length = alloc_all();
+    free_all(reclaim_length);
+
+    return (NULL);
+}
+
+#endif
+
+static int test_magazines_reclaim(void)
+{
+    size_t sizes[8] = { 16, 32, 64, 128, 256, 512, 512, 512 };
+    int length;
+#if CONFIG_THRD_TERMINATE == 1
+    struct thrd_t *thrd_p;
+#endif
+
+    BTASSERT(heap_init(&reclaim_heap, buffer, 512, sizes) == 0);
+
+    /* Fill the main thread's cache. */
+    length = alloc_all();
+    BTASSERT(length > 0);
+    BTASSERT(length < membersof(reclaim_buffers));
+    free_all(length);
+    BTASSERT(reclaim_heap.magazines[0].fixed[0].length > 0);
+
+    /* Another thread can allocate the buffers in the main thread's
+       cache. */
+    thrd_spawn(consumer_main,
+               thrd_self(),
+               0,
+               consumer_stack,
+               sizeof(consumer_stack));
+    thrd_suspend(NULL);
+
+    BTASSERTI(reclaim_length, ==, length);
+    BTASSERT(reclaim_heap.magazines[0].fixed[0].free_p == NULL);
+    BTASSERT(reclaim_heap.magazines[1].fixed[0].length > 0);
+
+#if CONFIG_THRD_TERMINATE == 1
+    /* The cache of a thread is released when it terminates. */
+    thrd_p = thrd_spawn(terminated_main,
+                        NULL,
+                        0,
+                        terminated_stack,
+                        sizeof(terminated_stack));
+    BTASSERT(thrd_join(thrd_p) == 0);
+    BTASSERTI(reclaim_length, ==, length);
+    BTASSERT(reclaim_heap.magazines[2].thrd_p == NULL);
+    BTASSERT(reclaim_heap.magazines[2].fixed[0].free_p == NULL);
+
+    BTASSERTI(alloc_all(), ==, length);
+    free_all(length);
+#endif
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -167,6 +481,12 @@ int main()
         { test_share, "test_share" },
         { test_big_buffer, "test_big_buffer" },
         { test_out_of_memory, "test_out_of_memory" },
+        { test_split_and_coalesce, "test_split_and_coalesce" },
+        { test_trace_benchmark, "test_trace_benchmark" },
+#if CONFIG_HEAP_MAGAZINES > 0
+        { test_magazines, "test_magazines" },
+        { test_magazines_reclaim, "test_magazines_reclaim" },
+#endif
         { NULL, NULL }
     };
 
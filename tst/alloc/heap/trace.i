@@ -0,0 +1,143 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+/**
+ * Dynamic memory allocation trace replayed by the benchmark, mimicking
+ * a long running node with mostly short lived buffers of varying
+ * size. Each entry allocates a buffer of given size into given slot,
+ * or frees the buffer in given slot if the size is zero(0).
+ */
+static const struct trace_entry_t trace[] = {
+    { 6, 597 }, { 1, 794 }, { 1, 0 }, { 7, 564 }, { 6, 0 }, { 7, 0 },
+    { 3, 583 }, { 7, 551 }, { 3, 0 }, { 7, 0 }, { 8, 593 }, { 8, 0 },
+    { 1, 612 }, { 2, 1181 }, { 5, 550 }, { 6, 680 }, { 3, 673 }, { 0, 1049 },
+    { 9, 695 }, { 0, 0 }, { 5, 0 }, { 3, 0 }, { 9, 0 }, { 6, 0 }, { 2, 0 },
+    { 1, 0 }, { 1, 753 }, { 2, 2570 }, { 2, 0 }, { 5, 2512 }, { 0, 1155 },
+    { 6, 579 }, { 5, 0 }, { 0, 0 }, { 6, 0 }, { 1, 0 }, { 2, 662 },
+    { 7, 1085 }, { 4, 1189 }, { 2, 0 }, { 4, 0 }, { 7, 0 }, { 2, 522 },
+    { 2, 0 }, { 2, 1126 }, { 8, 547 }, { 7, 1496 }, { 7, 0 }, { 8, 0 },
+    { 2, 0 }, { 2, 2502 }, { 2, 0 }, { 8, 597 }, { 8, 0 }, { 3, 872 },
+    { 6, 649 }, { 9, 579 }, { 2, 767 }, { 2, 0 }, { 8, 1290 }, { 5, 625 },
+    { 9, 0 }, { 9, 1105 }, { 7, 1067 }, { 5, 0 }, { 6, 0 }, { 6, 1137 },
+    { 6, 0 }, { 1, 1557 }, { 8, 0 }, { 1, 0 }, { 2, 1283 }, { 7, 0 },
+    { 9, 0 }, { 1, 2346 }, { 1, 0 }, { 3, 0 }, { 2, 0 }, { 1, 696 },
+    { 4, 718 }, { 1, 0 }, { 4, 0 }, { 7, 722 }, { 7, 0 }, { 2, 974 },
+    { 2, 0 }, { 9, 949 }, { 5, 2946 }, { 5, 0 }, { 9, 0 }, { 6, 591 },
+    { 0, 628 }, { 6, 0 }, { 5, 1133 }, { 7, 862 }, { 4, 1329 }, { 8, 933 },
+    { 8, 0 }, { 7, 0 }, { 9, 1594 }, { 4, 0 }, { 9, 0 }, { 0, 0 }, { 5, 0 },
+    { 8, 908 }, { 8, 0 }, { 8, 570 }, { 8, 0 }, { 7, 864 }, { 7, 0 },
+    { 8, 1263 }, { 9, 646 }, { 3, 2131 }, { 4, 582 }, { 3, 0 }, { 6, 628 },
+    { 4, 0 }, { 1, 707 }, { 6, 0 }, { 4, 568 }, { 2, 634 }, { 5, 2427 },
+    { 4, 0 }, { 5, 0 }, { 9, 0 }, { 1, 0 }, { 8, 0 }, { 1, 637 }, { 2, 0 },
+    { 1, 0 }, { 6, 586 }, { 7, 1064 }, { 7, 0 }, { 2, 549 }, { 2, 0 },
+    { 6, 0 }, { 1, 1066 }, { 2, 655 }, { 2, 0 }, { 3, 657 }, { 1, 0 },
+    { 0, 2136 }, { 3, 0 }, { 5, 625 }, { 0, 0 }, { 5, 0 }, { 0, 1675 },
+    { 0, 0 }, { 7, 645 }, { 7, 0 }, { 6, 1359 }, { 3, 630 }, { 3, 0 },
+    { 6, 0 }, { 0, 1865 }, { 0, 0 }, { 1, 548 }, { 5, 779 }, { 9, 846 },
+    { 5, 0 }, { 9, 0 }, { 1, 0 }, { 5, 2720 }, { 5, 0 }, { 0, 613 }, { 0, 0 },
+    { 3, 777 }, { 3, 0 }, { 2, 565 }, { 2, 0 }, { 4, 673 }, { 2, 790 },
+    { 8, 1410 }, { 1, 1306 }, { 2, 0 }, { 8, 0 }, { 3, 1551 }, { 9, 1382 },
+    { 0, 637 }, { 1, 0 }, { 6, 2371 }, { 0, 0 }, { 0, 794 }, { 0, 0 },
+    { 1, 625 }, { 9, 0 }, { 4, 0 }, { 7, 1436 }, { 7, 0 }, { 3, 0 },
+    { 9, 631 }, { 9, 0 }, { 6, 0 }, { 1, 0 }, { 3, 2724 }, { 3, 0 },
+    { 4, 1635 }, { 4, 0 }, { 3, 2392 }, { 1, 1752 }, { 3, 0 }, { 5, 780 },
+    { 9, 1036 }, { 2, 532 }, { 9, 0 }, { 6, 592 }, { 5, 0 }, { 2, 0 },
+    { 6, 0 }, { 0, 620 }, { 3, 710 }, { 3, 0 }, { 1, 0 }, { 2, 1087 },
+    { 2, 0 }, { 7, 656 }, { 8, 711 }, { 4, 1446 }, { 2, 2724 }, { 6, 730 },
+    { 6, 0 }, { 4, 0 }, { 7, 0 }, { 0, 0 }, { 8, 0 }, { 2, 0 }, { 7, 776 },
+    { 8, 690 }, { 7, 0 }, { 8, 0 }, { 5, 566 }, { 5, 0 }, { 0, 1006 },
+    { 9, 731 }, { 9, 0 }, { 0, 0 }, { 2, 704 }, { 1, 630 }, { 1, 0 },
+    { 2, 0 }, { 0, 679 }, { 0, 0 }, { 9, 1284 }, { 7, 790 }, { 3, 575 },
+    { 9, 0 }, { 1, 754 }, { 2, 584 }, { 4, 675 }, { 0, 743 }, { 2, 0 },
+    { 6, 718 }, { 6, 0 }, { 7, 0 }, { 4, 0 }, { 1, 0 }, { 5, 1286 },
+    { 8, 730 }, { 6, 619 }, { 4, 883 }, { 5, 0 }, { 5, 537 }, { 2, 722 },
+    { 3, 0 }, { 9, 625 }, { 1, 619 }, { 5, 0 }, { 7, 773 }, { 4, 0 },
+    { 5, 1715 }, { 8, 0 }, { 0, 0 }, { 0, 546 }, { 5, 0 }, { 3, 1550 },
+    { 7, 0 }, { 7, 832 }, { 5, 711 }, { 1, 0 }, { 3, 0 }, { 6, 0 },
+    { 6, 626 }, { 5, 0 }, { 5, 545 }, { 7, 0 }, { 7, 706 }, { 6, 0 },
+    { 7, 0 }, { 0, 0 }, { 2, 0 }, { 5, 0 }, { 5, 659 }, { 6, 1068 },
+    { 0, 553 }, { 4, 758 }, { 2, 2610 }, { 3, 675 }, { 9, 0 }, { 9, 621 },
+    { 4, 0 }, { 8, 735 }, { 5, 0 }, { 9, 0 }, { 8, 0 }, { 5, 924 }, { 6, 0 },
+    { 3, 0 }, { 3, 646 }, { 2, 0 }, { 5, 0 }, { 0, 0 }, { 3, 0 }, { 1, 638 },
+    { 0, 1809 }, { 0, 0 }, { 5, 1682 }, { 1, 0 }, { 5, 0 }, { 8, 2362 },
+    { 0, 653 }, { 8, 0 }, { 0, 0 }, { 3, 542 }, { 0, 624 }, { 4, 710 },
+    { 9, 536 }, { 1, 728 }, { 8, 958 }, { 1, 0 }, { 4, 0 }, { 8, 0 },
+    { 4, 546 }, { 6, 1224 }, { 4, 0 }, { 2, 727 }, { 7, 600 }, { 0, 0 },
+    { 6, 0 }, { 3, 0 }, { 2, 0 }, { 1, 1206 }, { 2, 2633 }, { 7, 0 },
+    { 1, 0 }, { 4, 771 }, { 2, 0 }, { 7, 547 }, { 9, 0 }, { 3, 964 },
+    { 9, 1000 }, { 4, 0 }, { 9, 0 }, { 7, 0 }, { 3, 0 }, { 0, 1994 },
+    { 1, 1488 }, { 9, 719 }, { 7, 1113 }, { 1, 0 }, { 9, 0 }, { 7, 0 },
+    { 0, 0 }, { 7, 1301 }, { 7, 0 }, { 6, 1284 }, { 6, 0 }, { 1, 707 },
+    { 0, 540 }, { 3, 680 }, { 3, 0 }, { 2, 939 }, { 4, 1824 }, { 4, 0 },
+    { 0, 0 }, { 3, 1026 }, { 4, 1058 }, { 3, 0 }, { 7, 650 }, { 8, 654 },
+    { 3, 538 }, { 2, 0 }, { 6, 687 }, { 4, 0 }, { 8, 0 }, { 6, 0 },
+    { 6, 786 }, { 8, 1058 }, { 4, 710 }, { 4, 0 }, { 5, 561 }, { 7, 0 },
+    { 4, 784 }, { 6, 0 }, { 0, 1550 }, { 9, 668 }, { 3, 0 }, { 2, 636 },
+    { 0, 0 }, { 6, 787 }, { 7, 674 }, { 7, 0 }, { 0, 588 }, { 7, 596 },
+    { 2, 0 }, { 3, 1211 }, { 9, 0 }, { 3, 0 }, { 0, 0 }, { 2, 620 }, { 6, 0 },
+    { 3, 732 }, { 9, 544 }, { 6, 806 }, { 8, 0 }, { 2, 0 }, { 7, 0 },
+    { 4, 0 }, { 0, 2139 }, { 6, 0 }, { 6, 1335 }, { 1, 0 }, { 9, 0 },
+    { 5, 0 }, { 2, 1007 }, { 5, 719 }, { 8, 794 }, { 6, 0 }, { 4, 1247 },
+    { 5, 0 }, { 2, 0 }, { 0, 0 }, { 8, 0 }, { 0, 592 }, { 0, 0 }, { 1, 1513 },
+    { 2, 706 }, { 0, 1480 }, { 6, 625 }, { 0, 0 }, { 3, 0 }, { 2, 0 },
+    { 6, 0 }, { 4, 0 }, { 1, 0 }, { 4, 651 }, { 4, 0 }, { 8, 2832 }, { 8, 0 },
+    { 6, 831 }, { 6, 0 }, { 8, 544 }, { 4, 893 }, { 4, 0 }, { 0, 547 },
+    { 0, 0 }, { 7, 988 }, { 4, 2655 }, { 6, 629 }, { 6, 0 }, { 8, 0 },
+    { 6, 573 }, { 6, 0 }, { 1, 1563 }, { 7, 0 }, { 1, 0 }, { 4, 0 },
+    { 2, 2626 }, { 2, 0 }, { 8, 1859 }, { 0, 1419 }, { 8, 0 }, { 9, 1261 },
+    { 5, 744 }, { 7, 756 }, { 3, 618 }, { 9, 0 }, { 3, 0 }, { 6, 1417 },
+    { 5, 0 }, { 0, 0 }, { 6, 0 }, { 7, 0 }, { 2, 597 }, { 5, 1245 }, { 2, 0 },
+    { 5, 0 }, { 6, 526 }, { 9, 633 }, { 2, 531 }, { 9, 0 }, { 2, 0 },
+    { 3, 735 }, { 4, 1592 }, { 5, 1264 }, { 3, 0 }, { 8, 724 }, { 3, 736 },
+    { 8, 0 }, { 9, 613 }, { 3, 0 }, { 9, 0 }, { 7, 648 }, { 5, 0 },
+    { 5, 753 }, { 7, 0 }, { 7, 1178 }, { 7, 0 }, { 6, 0 }, { 4, 0 },
+    { 0, 1452 }, { 5, 0 }, { 0, 0 }, { 5, 735 }, { 7, 675 }, { 8, 632 },
+    { 5, 0 }, { 7, 0 }, { 9, 1280 }, { 5, 949 }, { 3, 1223 }, { 1, 1465 },
+    { 4, 637 }, { 6, 663 }, { 4, 0 }, { 6, 0 }, { 1, 0 }, { 4, 675 },
+    { 9, 0 }, { 7, 943 }, { 0, 815 }, { 0, 0 }, { 9, 571 }, { 4, 0 },
+    { 8, 0 }, { 5, 0 }, { 7, 0 }, { 5, 566 }, { 9, 0 }, { 3, 0 }, { 9, 579 },
+    { 9, 0 }, { 5, 0 }, { 7, 549 }, { 7, 0 }, { 7, 1052 }, { 7, 0 },
+    { 7, 684 }, { 8, 671 }, { 8, 0 }, { 5, 984 }, { 6, 543 }, { 3, 767 },
+    { 9, 629 }, { 5, 0 }, { 7, 0 }, { 9, 0 }, { 8, 2181 }, { 6, 0 },
+    { 6, 1099 }, { 2, 777 }, { 9, 624 }, { 4, 618 }, { 0, 564 }, { 6, 0 },
+    { 7, 545 }, { 0, 0 }, { 7, 0 }, { 7, 1312 }, { 2, 0 }, { 0, 609 },
+    { 3, 0 }, { 3, 652 }, { 0, 0 }, { 8, 0 }, { 5, 547 }, { 6, 580 },
+    { 0, 2514 }, { 5, 0 }, { 3, 0 }, { 1, 524 }, { 5, 529 }, { 4, 0 },
+    { 2, 536 }, { 7, 0 }, { 7, 1198 }, { 6, 0 }, { 5, 0 }, { 6, 744 },
+    { 5, 579 }, { 9, 0 }, { 2, 0 }, { 7, 0 }, { 0, 0 }, { 7, 1116 }, { 5, 0 },
+    { 7, 0 }, { 1, 0 }, { 5, 520 }, { 6, 0 }, { 5, 0 }, { 9, 592 }, { 9, 0 },
+    { 8, 563 }, { 3, 1005 }, { 3, 0 }, { 4, 625 }, { 9, 717 }, { 7, 701 },
+    { 9, 0 }, { 2, 1334 }, { 4, 0 }, { 2, 0 }, { 8, 0 }, { 7, 0 }, { 2, 784 },
+    { 2, 0 }, { 5, 574 }, { 6, 959 }, { 0, 785 }, { 0, 0 }, { 3, 1297 },
+    { 5, 0 }, { 6, 0 }, { 5, 934 }, { 8, 612 }, { 3, 0 }, { 8, 0 },
+    { 7, 552 }, { 4, 892 }, { 4, 0 }, { 8, 2971 }, { 5, 0 }, { 7, 0 },
+    { 4, 539 }, { 0, 534 }, { 8, 0 }, { 1, 1295 }, { 1, 0 }, { 6, 2986 },
+    { 5, 573 }, { 0, 0 }, { 4, 0 }, { 5, 0 }, { 6, 0 },
+};
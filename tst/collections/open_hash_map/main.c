@@ -0,0 +1,422 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+static uint32_t constant_hash(const void *key_p, size_t size)
+{
+    return (0);
+}
+
+static int test_add_get_remove(void)
+{
+    struct open_hash_map_t map;
+    struct open_hash_map_entry_t entries[8];
+    int values[3];
+
+    BTASSERT(open_hash_map_init(&map,
+                                entries,
+                                membersof(entries),
+                                NULL) == 0);
+
+    /* Add three entries. */
+    BTASSERT(open_hash_map_add(&map, "foo", 3, &values[0]) == 0);
+    BTASSERT(open_hash_map_add(&map, "bar", 3, &values[1]) == 0);
+    BTASSERT(open_hash_map_add(&map, "fie", 3, &values[1]) == 0);
+    BTASSERT(open_hash_map_add(&map, "fie", 3, &values[2]) == 0);
+    BTASSERT(open_hash_map_length(&map) == 3);
+
+    /* Get them. Keys are byte strings. */
+    BTASSERT(open_hash_map_get(&map, "foo", 3) == &values[0]);
+    BTASSERT(open_hash_map_get(&map, "bar", 3) == &values[1]);
+    BTASSERT(open_hash_map_get(&map, "fie", 3) == &values[2]);
+    BTASSERT(open_hash_map_get(&map, "fo", 2) == NULL);
+    BTASSERT(open_hash_map_get(&map, "foo\0", 4) == NULL);
+
+    /* Remove first two. */
+    BTASSERT(open_hash_map_remove(&map, "foo", 3) == 0);
+    BTASSERT(open_hash_map_remove(&map, "bar", 3) == 0);
+    BTASSERT(open_hash_map_remove(&map, "bar", 3) == -ENODATA);
+    BTASSERT(open_hash_map_get(&map, "foo", 3) == NULL);
+    BTASSERT(open_hash_map_get(&map, "bar", 3) == NULL);
+    BTASSERT(open_hash_map_get(&map, "fie", 3) == &values[2]);
+    BTASSERT(open_hash_map_length(&map) == 1);
+
+    /* At most 7 of 8 entries can be used. */
+    BTASSERT(open_hash_map_add(&map, "1", 1, NULL) == 0);
+    BTASSERT(open_hash_map_add(&map, "2", 1, NULL) == 0);
+    BTASSERT(open_hash_map_add(&map, "3", 1, NULL) == 0);
+    BTASSERT(open_hash_map_add(&map, "4", 1, NULL) == 0);
+    BTASSERT(open_hash_map_add(&map, "5", 1, NULL) == 0);
+    BTASSERT(open_hash_map_add(&map, "6", 1, NULL) == 0);
+    BTASSERT(open_hash_map_add(&map, "7", 1, NULL) == -ENOMEM);
+
+    return (0);
+}
+
+static int test_collisions(void)
+{
+    struct open_hash_map_t map;
+    struct open_hash_map_entry_t entries[8];
+    int values[5];
+
+    BTASSERT(open_hash_map_init(&map,
+                                entries,
+                                membersof(entries),
+                                constant_hash) == 0);
+
+    BTASSERT(open_hash_map_add(&map, "a", 1, &values[0]) == 0);
+    BTASSERT(open_hash_map_add(&map, "b", 1, &values[1]) == 0);
+    BTASSERT(open_hash_map_add(&map, "c", 1, &values[2]) == 0);
+    BTASSERT(open_hash_map_add(&map, "d", 1, &values[3]) == 0);
+
+    /* Entries following a removed entry are shifted backwards. */
+    BTASSERT(open_hash_map_remove(&map, "b", 1) == 0);
+    BTASSERT(open_hash_map_get(&map, "a", 1) == &values[0]);
+    BTASSERT(open_hash_map_get(&map, "b", 1) == NULL);
+    BTASSERT(open_hash_map_get(&map, "c", 1) == &values[2]);
+    BTASSERT(open_hash_map_get(&map, "d", 1) == &values[3]);
+    BTASSERT(open_hash_map_add(&map, "e", 1, &values[4]) == 0);
+    BTASSERT(open_hash_map_get(&map, "e", 1) == &values[4]);
+    BTASSERT(open_hash_map_remove(&map, "a", 1) == 0);
+    BTASSERT(open_hash_map_get(&map, "d", 1) == &values[3]);
+    BTASSERT(open_hash_map_length(&map) == 3);
+
+    return (0);
+}
+
+static int test_key_storage(void)
+{
+    struct open_hash_map_t map;
+    struct open_hash_map_entry_t entries[8];
+    struct open_hash_map_iter_t iter;
+    struct open_hash_map_entry_t *entry_p;
+    char short_key[8];
+    const char *long_key_p;
+    int values[2];
+
+    BTASSERT(open_hash_map_init(&map,
+                                entries,
+                                membersof(entries),
+                                NULL) == 0);
+
+    /* Short keys are copied into the map. */
+    memcpy(&short_key[0], "12345678", 8);
+    BTASSERT(open_hash_map_add(&map, &short_key[0], 8, &values[0]) == 0);
+    memset(&short_key[0], 0, sizeof(short_key));
+    BTASSERT(open_hash_map_get(&map, "12345678", 8) == &values[0]);
+    BTASSERT(open_hash_map_get(&map, &short_key[0], 8) == NULL);
+
+    /* Longer keys are stored by reference. */
+    long_key_p = "123456789";
+    BTASSERT(open_hash_map_add(&map, long_key_p, 9, &values[1]) == 0);
+    BTASSERT(open_hash_map_get(&map, "123456789", 9) == &values[1]);
+    BTASSERT(open_hash_map_get(&map, "12345678", 9) == NULL);
+
+    BTASSERT(open_hash_map_iter_init(&iter, &map) == 0);
+
+    while ((entry_p = open_hash_map_iter_next(&iter)) != NULL) {
+        if (entry_p->key_size == 9) {
+            BTASSERT(open_hash_map_entry_key(entry_p) == long_key_p);
+        } else {
+            BTASSERTI(entry_p->key_size, ==, 8);
+            BTASSERTM(open_hash_map_entry_key(entry_p), "12345678", 8);
+        }
+    }
+
+    return (0);
+}
+
+static int test_resize(void)
+{
+    struct open_hash_map_t map;
+    static struct open_hash_map_entry_t small_entries[128];
+    static struct open_hash_map_entry_t big_entries[512];
+    static uint32_t keys[400];
+    size_t i;
+
+    BTASSERT(open_hash_map_init(&map,
+                                small_entries,
+                                membersof(small_entries),
+                                NULL) == 0);
+
+    for (i = 0; i < membersof(keys); i++) {
+        keys[i] = i;
+    }
+
+    for (i = 0; i < 112; i++) {
+        BTASSERT(open_hash_map_add(&map, &keys[i], 4, &keys[i]) == 0);
+    }
+
+    BTASSERT(open_hash_map_add(&map, &keys[112], 4, NULL) == -ENOMEM);
+    BTASSERT(open_hash_map_resize(&map, big_entries, 64) == -ENOMEM);
+    BTASSERT(open_hash_map_resize(&map,
+                                  big_entries,
+                                  membersof(big_entries)) == 0);
+    BTASSERT(open_hash_map_is_resizing(&map) == 1);
+    BTASSERT(open_hash_map_resize(&map, big_entries, 512) == -EBUSY);
+
+    /* The map is usable while entries are moved. */
+    for (i = 112; i < 212; i++) {
+        BTASSERT(open_hash_map_add(&map, &keys[i], 4, &keys[i]) == 0);
+        BTASSERT(open_hash_map_remove(&map, &keys[i - 112], 4) == 0);
+        BTASSERT(open_hash_map_get(&map, &keys[i - 56], 4) == &keys[i - 56]);
+    }
+
+    BTASSERT(open_hash_map_is_resizing(&map) == 0);
+    BTASSERT(open_hash_map_length(&map) == 112);
+
+    for (i = 212; i < 400; i++) {
+        BTASSERT(open_hash_map_add(&map, &keys[i], 4, &keys[i]) == 0);
+    }
+
+    for (i = 0; i < 400; i++) {
+        if (i < 100) {
+            BTASSERT(open_hash_map_get(&map, &keys[i], 4) == NULL);
+        } else {
+            BTASSERT(open_hash_map_get(&map, &keys[i], 4) == &keys[i]);
+        }
+    }
+
+    /* Shrink and finish at once. */
+    for (i = 100; i < 350; i++) {
+        BTASSERT(open_hash_map_remove(&map, &keys[i], 4) == 0);
+    }
+
+    BTASSERT(open_hash_map_resize(&map,
+                                  small_entries,
+                                  membersof(small_entries)) == 0);
+    BTASSERT(open_hash_map_resize_finish(&map) == 0);
+    BTASSERT(open_hash_map_is_resizing(&map) == 0);
+
+    for (i = 350; i < 400; i++) {
+        BTASSERT(open_hash_map_get(&map, &keys[i], 4) == &keys[i]);
+    }
+
+    return (0);
+}
+
+static int test_iter(void)
+{
+    struct open_hash_map_t map;
+    struct open_hash_map_entry_t entries[16];
+    struct open_hash_map_entry_t big_entries[32];
+    struct open_hash_map_iter_t iter;
+    struct open_hash_map_entry_t *entry_p;
+    uint8_t keys[10];
+    int found;
+    int count;
+    int i;
+
+    BTASSERT(open_hash_map_init(&map,
+                                entries,
+                                membersof(entries),
+                                NULL) == 0);
+
+    for (i = 0; i < membersof(keys); i++) {
+        keys[i] = i;
+        BTASSERT(open_hash_map_add(&map, &keys[i], 1, NULL) == 0);
+    }
+
+    /* Iterate over a map in the middle of a resize. */
+    BTASSERT(open_hash_map_resize(&map,
+                                  big_entries,
+                                  membersof(big_entries)) == 0);
+    BTASSERT(open_hash_map_remove(&map, &keys[3], 1) == 0);
+    BTASSERT(open_hash_map_is_resizing(&map) == 1);
+
+    found = 0;
+    count = 0;
+    BTASSERT(open_hash_map_iter_init(&iter, &map) == 0);
+
+    while ((entry_p = open_hash_map_iter_next(&iter)) != NULL) {
+        BTASSERTI(entry_p->key_size, ==, 1);
+        found |= (1 << *(const uint8_t *)open_hash_map_entry_key(entry_p));
+        count++;
+    }
+
+    BTASSERTI(count, ==, 9);
+    BTASSERTI(found, ==, 0x3f7);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+#define BENCHMARK_KEYS_MAX 100000
+
+/**
+ * Both maps hash the integer keys with the same function, so only
+ * the table layouts differ.
+ */
+static uint32_t benchmark_hash(uint32_t key)
+{
+    return ((uint32_t)(((uint64_t)key * 0x9e3779b97f4a7c15ULL) >> 32));
+}
+
+static int chained_hash(longptr_t key)
+{
+    return ((int)(benchmark_hash(key) >> 1));
+}
+
+static uint32_t open_hash(const void *key_p, size_t size)
+{
+    uint32_t key;
+
+    memcpy(&key, key_p, sizeof(key));
+
+    return (benchmark_hash(key));
+}
+
+/**
+ * Compare the open addressing map to the chained map with the same
+ * 32 bits integer keys and hash function. The suite is built with
+ * profiling and coverage instrumentation, so the printed times are
+ * only indicative.
+ */
+static int test_benchmark(void)
+{
+    static struct hash_map_bucket_t buckets[BENCHMARK_KEYS_MAX];
+    static struct hash_map_entry_t chained_entries[BENCHMARK_KEYS_MAX];
+    static struct open_hash_map_entry_t entries[131072];
+    static uint32_t keys[BENCHMARK_KEYS_MAX];
+    struct hash_map_t chained_map;
+    struct open_hash_map_t map;
+    longptr_t value;
+    uint32_t key;
+    size_t sizes[3] = { 1000, 10000, 100000 };
+    size_t entries_max;
+    size_t size;
+    size_t i;
+    size_t j;
+    size_t k;
+    int start;
+    int chained_add;
+    int chained_get;
+    int add;
+    int get;
+
+    for (i = 0; i < membersof(keys); i++) {
+        keys[i] = (i * 7919);
+    }
+
+    for (j = 0; j < membersof(sizes); j++) {
+        size = sizes[j];
+
+        /* Chained hash map with as many buckets as keys. */
+        BTASSERT(hash_map_init(&chained_map,
+                               buckets,
+                               size,
+                               chained_entries,
+                               size,
+                               chained_hash) == 0);
+
+        /* Keys are looked up in a different order than they are
+           added. */
+        start = time_micros();
+
+        for (i = 0; i < size; i++) {
+            BTASSERT(hash_map_add(&chained_map, keys[i], i) == 0);
+        }
+
+        chained_add = time_micros_elapsed(start, time_micros());
+        start = time_micros();
+
+        for (i = 0; i < size; i++) {
+            k = ((i * 7907) % size);
+            BTASSERT(hash_map_get(&chained_map, keys[k], &value) == 0);
+        }
+
+        chained_get = time_micros_elapsed(start, time_micros());
+
+        /* Open addressing hash map in the smallest table that fits
+           all keys. */
+        entries_max = 1;
+
+        while ((entries_max - entries_max / 8) < size) {
+            entries_max *= 2;
+        }
+
+        BTASSERT(open_hash_map_init(&map,
+                                    entries,
+                                    entries_max,
+                                    open_hash) == 0);
+
+        start = time_micros();
+
+        for (i = 0; i < size; i++) {
+            BTASSERT(open_hash_map_add(&map, &keys[i], 4, &keys[i]) == 0);
+        }
+
+        add = time_micros_elapsed(start, time_micros());
+        start = time_micros();
+
+        for (i = 0; i < size; i++) {
+            k = ((i * 7907) % size);
+            key = keys[k];
+            BTASSERT(open_hash_map_get(&map, &key, 4) == &keys[k]);
+        }
+
+        get = time_micros_elapsed(start, time_micros());
+
+        std_printf(OSTR("%6u keys: chained add %6d us, get %6d us, "
+                        "open addressing add %6d us, get %6d us\r\n"),
+                   (unsigned)size,
+                   chained_add,
+                   chained_get,
+                   add,
+                   get);
+    }
+
+    return (0);
+}
+
+#endif
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_add_get_remove, "test_add_get_remove" },
+        { test_collisions, "test_collisions" },
+        { test_key_storage, "test_key_storage" },
+        { test_resize, "test_resize" },
+        { test_iter, "test_iter" },
+#if defined(ARCH_LINUX)
+        { test_benchmark, "test_benchmark" },
+#endif
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
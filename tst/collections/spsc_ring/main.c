@@ -0,0 +1,206 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+
+#include "simba.h"
+
+int test_init(void)
+{
+    struct spsc_ring_t foo;
+    uint8_t foobuf[16];
+
+    /* The size must be a power of two. */
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], 0) == -EINVAL);
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], 3) == -EINVAL);
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], 12) == -EINVAL);
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], 1) == 0);
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], 16) == 0);
+
+    BTASSERT(spsc_ring_used_size(&foo) == 0);
+    BTASSERT(spsc_ring_unused_size(&foo) == 16);
+
+    return (0);
+}
+
+int test_read_write(void)
+{
+    struct spsc_ring_t foo;
+    uint8_t foobuf[32];
+    uint8_t buf[64];
+
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], sizeof(foobuf)) == 0);
+
+    /* Read from empty ring. */
+    BTASSERT(spsc_ring_read(&foo, &buf[0], 0) == 0);
+    BTASSERT(spsc_ring_read(&foo, &buf[0], 1) == 0);
+    BTASSERT(spsc_ring_read(&foo, &buf[0], sizeof(foobuf)) == 0);
+
+    /* Write some data. */
+    memset(&buf[0], '1', 3);
+    BTASSERT(spsc_ring_write(&foo, &buf[0], 3) == 3);
+    memset(&buf[0], '2', 4);
+    BTASSERT(spsc_ring_write(&foo, &buf[0], 4) == 4);
+    BTASSERT(spsc_ring_used_size(&foo) == 7);
+
+    /* Read the written data. */
+    memset(&buf[0], '0', 2);
+    BTASSERT(spsc_ring_read(&foo, &buf[0], 2) == 2);
+    BTASSERT(memcmp(&buf[0], "11", 2) == 0);
+    memset(&buf[0], '0', 5);
+    BTASSERT(spsc_ring_read(&foo, &buf[0], 20) == 5);
+    BTASSERT(memcmp(&buf[0], "12222", 5) == 0);
+    BTASSERT(spsc_ring_used_size(&foo) == 0);
+
+    /* All bytes of the buffer are usable. Write wraps around. */
+    memset(&buf[0], '3', 33);
+    BTASSERT(spsc_ring_write(&foo, &buf[0], 33) == 32);
+    BTASSERT(spsc_ring_unused_size(&foo) == 0);
+    BTASSERT(spsc_ring_write(&foo, &buf[0], 1) == 0);
+    memset(&buf[0], '0', 32);
+    BTASSERT(spsc_ring_read(&foo, &buf[0], 64) == 32);
+    BTASSERT(memcmp(&buf[0], "33333333333333333333333333333333", 32) == 0);
+
+    /* Wrap around the indices a couple of times with data crossing
+       the end of the buffer. */
+    for (int i = 0; i < 100; i++) {
+        memset(&buf[0], 'a' + (i % 26), 13);
+        BTASSERT(spsc_ring_write(&foo, &buf[0], 13) == 13);
+        memset(&buf[0], '0', 13);
+        BTASSERT(spsc_ring_read(&foo, &buf[0], 13) == 13);
+        BTASSERT(buf[0] == 'a' + (i % 26));
+        BTASSERT(buf[12] == 'a' + (i % 26));
+    }
+
+    return (0);
+}
+
+int test_array(void)
+{
+    struct spsc_ring_t foo;
+    uint8_t foobuf[8];
+    void *buf_p;
+
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], sizeof(foobuf)) == 0);
+
+    /* No data to read in an empty ring. */
+    BTASSERT(spsc_ring_read_array_one(&foo, &buf_p, 3) == 0);
+    BTASSERT(spsc_ring_read_array_two(&foo, &buf_p, 3) == 0);
+
+    /* The whole buffer is available to the producer. */
+    BTASSERT(spsc_ring_write_array_one(&foo, &buf_p, 10) == 8);
+    BTASSERT(buf_p == &foobuf[0]);
+    BTASSERT(spsc_ring_write_array_two(&foo, &buf_p, 2) == 0);
+
+    /* Write six bytes in place. */
+    BTASSERT(spsc_ring_write_array_one(&foo, &buf_p, 6) == 6);
+    memcpy(buf_p, "123456", 6);
+    BTASSERT(spsc_ring_write_commit(&foo, 6) == 0);
+
+    /* Nothing is available to the consumer until committed. */
+    BTASSERT(spsc_ring_write_array_one(&foo, &buf_p, 2) == 2);
+    BTASSERT(buf_p == &foobuf[6]);
+    BTASSERT(spsc_ring_used_size(&foo) == 6);
+
+    /* Read four bytes in place. */
+    BTASSERT(spsc_ring_read_array_one(&foo, &buf_p, 4) == 4);
+    BTASSERT(buf_p == &foobuf[0]);
+    BTASSERT(memcmp(buf_p, "1234", 4) == 0);
+    BTASSERT(spsc_ring_read_array_two(&foo, &buf_p, 4) == 0);
+    BTASSERT(spsc_ring_read_commit(&foo, 4) == 0);
+
+    /* Write across the end of the buffer. */
+    BTASSERT(spsc_ring_write_array_one(&foo, &buf_p, 5) == 2);
+    BTASSERT(buf_p == &foobuf[6]);
+    memcpy(buf_p, "78", 2);
+    BTASSERT(spsc_ring_write_array_two(&foo, &buf_p, 3) == 3);
+    BTASSERT(buf_p == &foobuf[0]);
+    memcpy(buf_p, "9ab", 3);
+    BTASSERT(spsc_ring_write_commit(&foo, 5) == 0);
+    BTASSERT(spsc_ring_used_size(&foo) == 7);
+
+    /* Read across the end of the buffer. */
+    BTASSERT(spsc_ring_read_array_one(&foo, &buf_p, 8) == 4);
+    BTASSERT(buf_p == &foobuf[4]);
+    BTASSERT(memcmp(buf_p, "5678", 4) == 0);
+    BTASSERT(spsc_ring_read_array_two(&foo, &buf_p, 8) == 3);
+    BTASSERT(buf_p == &foobuf[0]);
+    BTASSERT(memcmp(buf_p, "9ab", 3) == 0);
+    BTASSERT(spsc_ring_read_commit(&foo, 7) == 0);
+    BTASSERT(spsc_ring_used_size(&foo) == 0);
+
+    return (0);
+}
+
+int test_array_snapshot(void)
+{
+    struct spsc_ring_t foo;
+    uint8_t foobuf[8];
+    uint8_t buf[8];
+    void *buf_p;
+
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], sizeof(foobuf)) == 0);
+    BTASSERT(spsc_ring_write(&foo, "123456", 6) == 6);
+    BTASSERT(spsc_ring_read(&foo, &buf[0], 4) == 4);
+    BTASSERT(spsc_ring_write(&foo, "78", 2) == 2);
+
+    /* Array two is calculated from the write index seen by array
+       one, even if the producer writes more data in between. */
+    BTASSERT(spsc_ring_read_array_one(&foo, &buf_p, 8) == 4);
+    BTASSERT(spsc_ring_write(&foo, "9a", 2) == 2);
+    BTASSERT(spsc_ring_read_array_two(&foo, &buf_p, 8) == 0);
+    BTASSERT(spsc_ring_read_commit(&foo, 4) == 0);
+    BTASSERT(spsc_ring_read_array_one(&foo, &buf_p, 8) == 2);
+    BTASSERT(memcmp(buf_p, "9a", 2) == 0);
+
+    /* Same for the producer. */
+    BTASSERT(spsc_ring_write_array_one(&foo, &buf_p, 8) == 6);
+    BTASSERT(buf_p == &foobuf[2]);
+    BTASSERT(spsc_ring_read_commit(&foo, 2) == 0);
+    BTASSERT(spsc_ring_write_array_two(&foo, &buf_p, 8) == 0);
+
+    return (0);
+}
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_init, "test_init" },
+        { test_read_write, "test_read_write" },
+        { test_array, "test_array" },
+        { test_array_snapshot, "test_array_snapshot" },
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
@@ -229,6 +229,291 @@ int test_fs(void)
     return (0);
 }
 
+#if CONFIG_LOG_ASYNC == 1
+
+static struct queue_t async_queue;
+static uint8_t async_queue_buf[2048];
+static struct log_handler_t async_handler;
+
+/**
+ * Read all buffered log entries written to the async handler.
+ */
+static ssize_t async_read_output(char *buf_p, size_t size)
+{
+    ssize_t length;
+
+    BTASSERT(log_async_flush() == 0);
+
+    length = queue_size(&async_queue);
+    BTASSERT(length < size);
+    BTASSERT(queue_read(&async_queue, buf_p, length) == length);
+    buf_p[length] = '\0';
+
+    return (length);
+}
+
+int test_async_print(void)
+{
+    struct log_object_t foo;
+    struct log_async_stats_t stats;
+    char buf[256];
+    char name[32];
+
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    BTASSERT(queue_init(&async_queue,
+                        &async_queue_buf[0],
+                        sizeof(async_queue_buf)) == 0);
+    BTASSERT(log_handler_init(&async_handler, &async_queue) == 0);
+    BTASSERT(log_add_handler(&async_handler) == 0);
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(log_async_flush() == 0);
+    async_read_output(&buf[0], sizeof(buf));
+
+    /* The entry is formatted once in the log thread. */
+    strcpy(&name[0], "bar");
+    BTASSERT(log_object_print(&foo,
+                              LOG_INFO,
+                              FSTR("%d %5u|%-4s|%lx %c %s%s\r\n"),
+                              -3,
+                              17,
+                              &name[0],
+                              0xdeadbeeful,
+                              'q',
+                              NULL,
+                              "") == 2);
+
+    /* The string argument is copied to the record. */
+    strcpy(&name[0], "fie");
+
+    async_read_output(&buf[0], sizeof(buf));
+    BTASSERT(strstr(&buf[0],
+                    ":info:main:foo: -3    17|bar |deadbeef q (null)\r\n")
+             != NULL, "%s", &buf[0]);
+
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    BTASSERT(stats.records > 0);
+
+    return (0);
+}
+
+int test_async_truncated(void)
+{
+    struct log_object_t foo;
+    struct log_async_stats_t stats;
+    char buf[512];
+    char string[2 * CONFIG_LOG_ASYNC_RECORD_SIZE_MAX];
+    uint32_t truncated;
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    truncated = stats.truncated;
+
+    memset(&string[0], 'a', sizeof(string) - 1);
+    string[sizeof(string) - 1] = '\0';
+
+    BTASSERT(log_object_print(&foo,
+                              LOG_INFO,
+                              FSTR("%s %d\r\n"),
+                              &string[0],
+                              5) == 2);
+
+    async_read_output(&buf[0], sizeof(buf));
+    BTASSERT(strstr(&buf[0], ":info:main:foo: aaaa") != NULL);
+    BTASSERT(strlen(&buf[0]) < CONFIG_LOG_ASYNC_LINE_SIZE_MAX);
+
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    BTASSERT(stats.truncated == truncated + 1);
+
+    return (0);
+}
+
+int test_async_overflow_policies(void)
+{
+    struct log_object_t foo;
+    struct log_async_stats_t stats;
+    char buf[2048];
+    int i;
+    uint32_t records;
+    uint32_t dropped_newest;
+    uint32_t dropped_oldest;
+    uint32_t blocked;
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    records = stats.records;
+    dropped_newest = stats.dropped_newest;
+    dropped_oldest = stats.dropped_oldest;
+    blocked = stats.blocked;
+
+    /* The log thread has lower priority than this thread, so the
+       buffer is not drained until the flush. */
+    for (i = 0; i < 40; i++) {
+        log_object_print(&foo, LOG_INFO, FSTR("%d\r\n"), i);
+    }
+
+    async_read_output(&buf[0], sizeof(buf));
+    BTASSERT(strstr(&buf[0], ": 0\r\n") != NULL);
+    BTASSERT(strstr(&buf[0], ": 39\r\n") == NULL);
+
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    BTASSERT(stats.dropped_newest > dropped_newest);
+    BTASSERT(stats.dropped_oldest == dropped_oldest);
+    BTASSERT(stats.records + stats.dropped_newest
+             == records + dropped_newest + 40);
+
+    /* Drop oldest. */
+    BTASSERT(log_async_set_overflow_policy(
+                 LOG_OVERFLOW_POLICY_DROP_OLDEST) == 0);
+    dropped_newest = stats.dropped_newest;
+
+    for (i = 0; i < 40; i++) {
+        log_object_print(&foo, LOG_INFO, FSTR("%d\r\n"), i);
+    }
+
+    async_read_output(&buf[0], sizeof(buf));
+    BTASSERT(strstr(&buf[0], ": 0\r\n") == NULL);
+    BTASSERT(strstr(&buf[0], ": 39\r\n") != NULL);
+
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    BTASSERT(stats.dropped_newest == dropped_newest);
+    BTASSERT(stats.dropped_oldest > dropped_oldest);
+
+    /* Block. */
+    BTASSERT(log_async_set_overflow_policy(LOG_OVERFLOW_POLICY_BLOCK) == 0);
+    dropped_oldest = stats.dropped_oldest;
+    records = stats.records;
+
+    for (i = 0; i < 40; i++) {
+        BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("%d\r\n"), i) == 2);
+    }
+
+    async_read_output(&buf[0], sizeof(buf));
+    BTASSERT(strstr(&buf[0], ": 0\r\n") != NULL);
+    BTASSERT(strstr(&buf[0], ": 39\r\n") != NULL);
+
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    BTASSERT(stats.records == records + 40);
+    BTASSERT(stats.dropped_newest == dropped_newest);
+    BTASSERT(stats.dropped_oldest == dropped_oldest);
+    BTASSERT(stats.blocked > blocked);
+
+    BTASSERT(log_async_set_overflow_policy(
+                 LOG_OVERFLOW_POLICY_DROP_NEWEST) == 0);
+
+    return (0);
+}
+
+static THRD_STACK(writer_stacks[3], 1024);
+static struct sem_t writers_sem;
+
+static void *writer_main(void *arg_p)
+{
+    struct log_object_t foo;
+    int i;
+
+    log_object_init(&foo, "foo", LOG_UPTO(INFO));
+
+    for (i = 0; i < 100; i++) {
+        log_object_print(&foo,
+                         LOG_INFO,
+                         FSTR("%d %d\r\n"),
+                         (int)(long)arg_p,
+                         i);
+
+        if ((i % 10) == 0) {
+            thrd_yield();
+        }
+    }
+
+    sem_give(&writers_sem, 1);
+    thrd_suspend(NULL);
+
+    return (NULL);
+}
+
+int test_async_multiple_writers(void)
+{
+    struct log_async_stats_t stats;
+    uint32_t records;
+    uint32_t dropped_newest;
+    long i;
+
+    BTASSERT(log_async_set_overflow_policy(LOG_OVERFLOW_POLICY_BLOCK) == 0);
+    BTASSERT(log_remove_handler(&async_handler) == 0);
+    BTASSERT(log_set_default_handler_output_channel(NULL) == 0);
+    BTASSERT(sem_init(&writers_sem, 3, 3) == 0);
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    records = stats.records;
+    dropped_newest = stats.dropped_newest;
+
+    for (i = 0; i < membersof(writer_stacks); i++) {
+        BTASSERT(thrd_spawn(writer_main,
+                            (void *)i,
+                            0,
+                            writer_stacks[i],
+                            sizeof(writer_stacks[i])) != NULL);
+    }
+
+    for (i = 0; i < membersof(writer_stacks); i++) {
+        BTASSERT(sem_take(&writers_sem, NULL) == 0);
+    }
+
+    BTASSERT(log_async_flush() == 0);
+    BTASSERT(log_async_get_stats(&stats) == 0);
+    BTASSERT(stats.records == records + 300);
+    BTASSERT(stats.dropped_newest == dropped_newest);
+
+    BTASSERT(log_set_default_handler_output_channel(sys_get_stdout()) == 0);
+    BTASSERT(log_add_handler(&async_handler) == 0);
+    BTASSERT(log_async_set_overflow_policy(
+                 LOG_OVERFLOW_POLICY_DROP_NEWEST) == 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+int test_async_benchmark(void)
+{
+    struct log_object_t foo;
+    struct time_t start;
+    struct time_t stop;
+    struct time_t elapsed;
+    int i;
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(log_async_set_overflow_policy(LOG_OVERFLOW_POLICY_BLOCK) == 0);
+    BTASSERT(log_remove_handler(&async_handler) == 0);
+    BTASSERT(log_set_default_handler_output_channel(NULL) == 0);
+
+    time_get(&start);
+
+    for (i = 0; i < 100000; i++) {
+        log_object_print(&foo,
+                         LOG_INFO,
+                         FSTR("value %d of %s\r\n"),
+                         i,
+                         "benchmark");
+    }
+
+    BTASSERT(log_async_flush() == 0);
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, &start);
+
+    std_printf(OSTR("100000 log entries in %lu ms.\r\n"),
+               elapsed.seconds * 1000 + elapsed.nanoseconds / 1000000);
+
+    BTASSERT(log_set_default_handler_output_channel(sys_get_stdout()) == 0);
+    BTASSERT(log_async_set_overflow_policy(
+                 LOG_OVERFLOW_POLICY_DROP_NEWEST) == 0);
+
+    return (0);
+}
+
+#endif
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -238,6 +523,15 @@ int main()
         { test_handler, "test_handler" },
         { test_log_mask, "test_log_mask" },
         { test_fs, "test_fs" },
+#if CONFIG_LOG_ASYNC == 1
+        { test_async_print, "test_async_print" },
+        { test_async_truncated, "test_async_truncated" },
+        { test_async_overflow_policies, "test_async_overflow_policies" },
+        { test_async_multiple_writers, "test_async_multiple_writers" },
+#    if defined(ARCH_LINUX)
+        { test_async_benchmark, "test_async_benchmark" },
+#    endif
+#endif
         { NULL, NULL }
     };
 
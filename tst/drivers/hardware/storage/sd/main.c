@@ -275,6 +275,37 @@ static int test_read_write(void)
     return (0);
 }
 
+static int test_read_write_blocks(void)
+{
+    static uint8_t blocks[4 * SD_BLOCK_SIZE];
+    int i, res;
+
+    /* Write four blocks with one command and read them back. */
+    for (i = 0; i < membersof(blocks); i++) {
+        blocks[i] = ((i / SD_BLOCK_SIZE) + i);
+    }
+
+    BTASSERT((res = sd_write_blocks(&sd, 8, blocks, 4)) == sizeof(blocks),
+             ", res = %d\r\n", res);
+    memset(blocks, 0, sizeof(blocks));
+    BTASSERT((res = sd_read_blocks(&sd, blocks, 8, 4)) == sizeof(blocks),
+             ", res = %d\r\n", res);
+
+    for (i = 0; i < membersof(blocks); i++) {
+        BTASSERT(blocks[i] == (((i / SD_BLOCK_SIZE) + i) & 0xff));
+    }
+
+    /* The second block written above. */
+    BTASSERT((res = sd_read_block(&sd, buf, 9)) == SD_BLOCK_SIZE,
+             ", res = %d\r\n", res);
+
+    for (i = 0; i < membersof(buf); i++) {
+        BTASSERT(buf[i] == ((1 + SD_BLOCK_SIZE + i) & 0xff));
+    }
+
+    return (0);
+}
+
 static int test_write_performance(void)
 {
     int i, block, res;
@@ -352,6 +383,7 @@ int main()
         { test_read_cid, "test_read_cid" },
         { test_read_csd, "test_read_csd" },
         { test_read_write, "test_read_write" },
+        { test_read_write_blocks, "test_read_write_blocks" },
         { test_write_performance, "test_write_performance" },
         { test_read_performance, "test_read_performance" },
         { NULL, NULL }
@@ -0,0 +1,287 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+#include "drivers/storage/sd_card_emulator.h"
+
+/* Size of the emulated SD card. */
+#define NUMBER_OF_BLOCKS                                 2048
+
+static struct spi_driver_t spi;
+static struct sd_driver_t sd;
+
+static uint8_t buf[16 * SD_BLOCK_SIZE];
+
+static void fill(uint8_t *buf_p, size_t size, int seed)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        buf_p[i] = ((seed + i) & 0xff);
+    }
+}
+
+static int is_filled(const uint8_t *buf_p, size_t size, int seed)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        if (buf_p[i] != ((seed + i) & 0xff)) {
+            return (0);
+        }
+    }
+
+    return (1);
+}
+
+static int test_init(void)
+{
+    FILE *file_p;
+    int res;
+
+    /* Create an empty image file. */
+    file_p = fopen("sdcard", "wb");
+    BTASSERT(file_p != NULL);
+    BTASSERT(fseek(file_p, NUMBER_OF_BLOCKS * SD_BLOCK_SIZE - 1, SEEK_SET) == 0);
+    BTASSERT(fputc(0, file_p) == 0);
+    fclose(file_p);
+
+    BTASSERT(sd_card_emulator_init("sdcard") == 0);
+    BTASSERT(spi_init(&spi,
+                      &spi_device[0],
+                      &pin_d6_dev,
+                      SPI_MODE_MASTER,
+                      SPI_SPEED_250KBPS,
+                      0,
+                      0) == 0);
+    BTASSERT(sd_init(&sd, &spi) == 0);
+    BTASSERT((res = sd_start(&sd)) == 0, ", res = %d\r\n", res);
+
+    return (0);
+}
+
+static int test_read_cid(void)
+{
+    struct sd_cid_t cid;
+
+    BTASSERT(sd_read_cid(&sd, &cid) == sizeof(cid));
+    BTASSERT(cid.mid == 0x03);
+    BTASSERT(memcmp(&cid.oid[0], "SD", 2) == 0);
+    BTASSERT(memcmp(&cid.pnm[0], "SDEMU", 5) == 0);
+
+    return (0);
+}
+
+static int test_read_csd(void)
+{
+    union sd_csd_t csd;
+    uint32_t c_size;
+
+    BTASSERT(sd_read_csd(&sd, &csd) == sizeof(csd));
+    BTASSERT(csd.v2.csd_structure == SD_CSD_STRUCTURE_V2);
+
+    c_size = (((uint32_t)csd.v2.c_size_high << 16)
+              | ((uint32_t)csd.v2.c_size_mid << 8)
+              | csd.v2.c_size_low);
+    BTASSERT((c_size + 1) * 1024 == NUMBER_OF_BLOCKS);
+
+    return (0);
+}
+
+static int test_read_write_block(void)
+{
+    struct sd_card_emulator_stats_t *stats_p;
+
+    stats_p = sd_card_emulator_get_stats();
+    sd_card_emulator_reset_stats();
+
+    fill(&buf[0], SD_BLOCK_SIZE, 3);
+    BTASSERT(sd_write_block(&sd, 3, &buf[0]) == SD_BLOCK_SIZE);
+    memset(&buf[0], 0, SD_BLOCK_SIZE);
+    BTASSERT(sd_read_block(&sd, &buf[0], 3) == SD_BLOCK_SIZE);
+    BTASSERT(is_filled(&buf[0], SD_BLOCK_SIZE, 3));
+
+    /* A single block is transferred using the single block
+       commands. */
+    fill(&buf[0], SD_BLOCK_SIZE, 4);
+    BTASSERT(sd_write_blocks(&sd, 4, &buf[0], 1) == SD_BLOCK_SIZE);
+    memset(&buf[0], 0, SD_BLOCK_SIZE);
+    BTASSERT(sd_read_blocks(&sd, &buf[0], 4, 1) == SD_BLOCK_SIZE);
+    BTASSERT(is_filled(&buf[0], SD_BLOCK_SIZE, 4));
+
+    BTASSERT(stats_p->commands[24] == 2);
+    BTASSERT(stats_p->commands[17] == 2);
+    BTASSERT(stats_p->commands[25] == 0);
+    BTASSERT(stats_p->commands[18] == 0);
+
+    return (0);
+}
+
+static int test_read_write_blocks(void)
+{
+    struct sd_card_emulator_stats_t *stats_p;
+
+    stats_p = sd_card_emulator_get_stats();
+    sd_card_emulator_reset_stats();
+
+    /* Write 16 blocks with one command. */
+    fill(&buf[0], sizeof(buf), 10);
+    BTASSERT(sd_write_blocks(&sd, 100, &buf[0], 16) == sizeof(buf));
+    BTASSERT(stats_p->application_commands[23] == 1);
+    BTASSERT(stats_p->commands[25] == 1);
+    BTASSERT(stats_p->commands[24] == 0);
+    BTASSERT(stats_p->blocks_written == 16);
+
+    /* Read them back with one command. */
+    memset(&buf[0], 0, sizeof(buf));
+    BTASSERT(sd_read_blocks(&sd, &buf[0], 100, 16) == sizeof(buf));
+    BTASSERT(is_filled(&buf[0], sizeof(buf), 10));
+    BTASSERT(stats_p->commands[18] == 1);
+    BTASSERT(stats_p->commands[12] == 1);
+    BTASSERT(stats_p->commands[17] == 0);
+
+    /* Read a part of the written blocks one by one. */
+    BTASSERT(sd_read_block(&sd, &buf[0], 101) == SD_BLOCK_SIZE);
+    BTASSERT(is_filled(&buf[0], SD_BLOCK_SIZE, 10 + SD_BLOCK_SIZE));
+
+    /* Blocks after the written ones are untouched. */
+    BTASSERT(sd_read_blocks(&sd, &buf[0], 115, 2) == 2 * SD_BLOCK_SIZE);
+    BTASSERT(is_filled(&buf[0], SD_BLOCK_SIZE, 10 + 15 * SD_BLOCK_SIZE));
+    BTASSERT(buf[SD_BLOCK_SIZE] == 0);
+
+    return (0);
+}
+
+static int test_out_of_range(void)
+{
+    /* First block outside the card. */
+    BTASSERT(sd_read_blocks(&sd,
+                            &buf[0],
+                            NUMBER_OF_BLOCKS,
+                            2) == -SD_ERR_READ_COMMAND);
+    BTASSERT(sd_write_blocks(&sd,
+                             NUMBER_OF_BLOCKS,
+                             &buf[0],
+                             2) == -SD_ERR_WRITE_BLOCK);
+
+    /* Last block outside the card. */
+    BTASSERT(sd_read_blocks(&sd,
+                            &buf[0],
+                            NUMBER_OF_BLOCKS - 1,
+                            2) == -SD_ERR_READ_DATA_START_BLOCK);
+    BTASSERT(sd_write_blocks(&sd, NUMBER_OF_BLOCKS - 1, &buf[0], 2)
+             == -SD_ERR_WRITE_BLOCK_TOKEN_DATA_RES_ACCEPTED);
+
+    /* The card is still usable. */
+    fill(&buf[0], 2 * SD_BLOCK_SIZE, 7);
+    BTASSERT(sd_write_blocks(&sd,
+                             NUMBER_OF_BLOCKS - 2,
+                             &buf[0],
+                             2) == 2 * SD_BLOCK_SIZE);
+    memset(&buf[0], 0, sizeof(buf));
+    BTASSERT(sd_read_blocks(&sd,
+                            &buf[0],
+                            NUMBER_OF_BLOCKS - 2,
+                            2) == 2 * SD_BLOCK_SIZE);
+    BTASSERT(is_filled(&buf[0], 2 * SD_BLOCK_SIZE, 7));
+
+    return (0);
+}
+
+static int test_benchmark(void)
+{
+    struct sd_card_emulator_stats_t *stats_p;
+    int block;
+    uint32_t commands;
+
+    stats_p = sd_card_emulator_get_stats();
+    fill(&buf[0], sizeof(buf), 0);
+
+    /* The number of commands is the cost on real hardware, as each
+       command is followed by a wait for the card. */
+    sd_card_emulator_reset_stats();
+
+    for (block = 0; block < 1024; block++) {
+        BTASSERT(sd_write_block(&sd, block, &buf[0]) == SD_BLOCK_SIZE);
+    }
+
+    for (block = 0; block < 1024; block++) {
+        BTASSERT(sd_read_block(&sd, &buf[0], block) == SD_BLOCK_SIZE);
+    }
+
+    commands = stats_p->commands[13] + stats_p->commands[17] + stats_p->commands[24];
+    std_printf(FSTR("Single block: %lu commands for 1024 blocks.\r\n"),
+               (unsigned long)commands);
+
+    sd_card_emulator_reset_stats();
+
+    for (block = 0; block < 1024; block += 16) {
+        BTASSERT(sd_write_blocks(&sd, block, &buf[0], 16) == sizeof(buf));
+    }
+
+    for (block = 0; block < 1024; block += 16) {
+        BTASSERT(sd_read_blocks(&sd, &buf[0], block, 16) == sizeof(buf));
+    }
+
+    commands = (stats_p->commands[12]
+                + stats_p->commands[13]
+                + stats_p->commands[18]
+                + stats_p->commands[25]
+                + stats_p->commands[55]
+                + stats_p->application_commands[23]);
+    std_printf(FSTR("Multiple blocks: %lu commands for 1024 blocks.\r\n"),
+               (unsigned long)commands);
+
+    BTASSERT(stats_p->blocks_written == 1024);
+
+    return (0);
+}
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_init, "test_init" },
+        { test_read_cid, "test_read_cid" },
+        { test_read_csd, "test_read_csd" },
+        { test_read_write_block, "test_read_write_block" },
+        { test_read_write_blocks, "test_read_write_blocks" },
+        { test_out_of_range, "test_out_of_range" },
+        { test_benchmark, "test_benchmark" },
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    BTASSERT(sd_stop(&sd) == 0);
+
+    return (0);
+}
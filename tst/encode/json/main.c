@@ -833,6 +833,460 @@ static int test_get(void)
     return (0);
 }
 
+static int test_get_path(void)
+{
+    struct json_t json;
+    struct json_tok_t tokens[64];
+    struct json_tok_t *token_p;
+    char js_p[] = "{"
+        "\"a\":{\"b\":[1,{\"x\":[]},3,{\"c\":\"d\"}],\"bb\":2},"
+        "\"ab\":5,"
+        "\"e\":[[7,8],[9]]"
+        "}";
+
+    BTASSERT(json_init(&json, tokens, membersof(tokens)) == 0);
+    BTASSERT(json_parse(&json, js_p, strlen(js_p)) == 24);
+
+    /* Subtree spans. */
+    BTASSERT(tokens[0].span == 24);
+    BTASSERT(tokens[1].span == 14);
+    BTASSERT(tokens[2].span == 13);
+
+    token_p = json_get_path(&json, "a.b[3].c");
+    BTASSERT(token_p != NULL);
+    BTASSERT(token_p->type == JSON_STRING);
+    BTASSERT(token_p->size == 1);
+    BTASSERT(token_p->buf_p[0] == 'd');
+
+    token_p = json_get_path(&json, "a.bb");
+    BTASSERT(token_p != NULL);
+    BTASSERT(token_p->buf_p[0] == '2');
+
+    token_p = json_get_path(&json, "ab");
+    BTASSERT(token_p != NULL);
+    BTASSERT(token_p->buf_p[0] == '5');
+
+    token_p = json_get_path(&json, "e[1][0]");
+    BTASSERT(token_p != NULL);
+    BTASSERT(token_p->buf_p[0] == '9');
+
+    BTASSERT(json_get_path(&json, "") == json_root(&json));
+    BTASSERT(json_get_path(&json, "a.b[1].x") == &tokens[8]);
+
+    /* Missing keys and bad paths. */
+    BTASSERT(json_get_path(&json, "a.c") == NULL);
+    BTASSERT(json_get_path(&json, "a.b[4]") == NULL);
+    BTASSERT(json_get_path(&json, "a.b[3]c") == NULL);
+    BTASSERT(json_get_path(&json, "a.b[x]") == NULL);
+    BTASSERT(json_get_path(&json, "a.b[-1]") == NULL);
+    BTASSERT(json_get_path(&json, "a.b[1") == NULL);
+    BTASSERT(json_get_path(&json, "a..b") == NULL);
+    BTASSERT(json_get_path(&json, "[0]") == NULL);
+
+    return (0);
+}
+
+/**
+ * Record streaming parser events as a string.
+ */
+struct events_t {
+    char buf[512];
+    size_t size;
+    int abort_event;
+};
+
+static int on_event(void *arg_p,
+                    enum json_event_t event,
+                    const char *buf_p,
+                    size_t size)
+{
+    struct events_t *events_p;
+    static const char names[] = "{}[]ksp";
+
+    events_p = arg_p;
+
+    if (events_p->size + size + 3 > sizeof(events_p->buf)) {
+        return (-ENOMEM);
+    }
+
+    events_p->buf[events_p->size++] = names[event];
+
+    if (size > 0) {
+        events_p->buf[events_p->size++] = '=';
+        memcpy(&events_p->buf[events_p->size], buf_p, size);
+        events_p->size += size;
+    }
+
+    events_p->buf[events_p->size++] = ' ';
+    events_p->buf[events_p->size] = '\0';
+
+    if ((int)event == events_p->abort_event) {
+        return (-ECANCELED);
+    }
+
+    return (0);
+}
+
+static int stream_parse(const char *js_p,
+                        const char *expected_p,
+                        size_t chunk_size)
+{
+    struct json_stream_t stream;
+    struct events_t events;
+    char buf[16];
+    size_t offset;
+    size_t size;
+    ssize_t res;
+
+    events.size = 0;
+    events.abort_event = -1;
+    BTASSERT(json_stream_init(&stream,
+                              &buf[0],
+                              sizeof(buf),
+                              on_event,
+                              &events) == 0);
+    offset = 0;
+
+    do {
+        size = MIN(chunk_size, strlen(js_p) - offset);
+        res = json_stream_parse(&stream, &js_p[offset], size);
+        offset += size;
+    } while ((res == JSON_ERROR_PART) && (offset < strlen(js_p)));
+
+    BTASSERTI(res, >, 0);
+    BTASSERT(offset - size + res == strlen(js_p));
+    BTASSERTM(&events.buf[0], expected_p, strlen(expected_p) + 1);
+
+    return (0);
+}
+
+static int test_stream_parse(void)
+{
+    size_t chunk_size;
+    const char *js_p = "{ \"a\" : [1, true,\"b\\\"\\u00e5\"],"
+        "\"c\":{},\"d\":[[]] ,e:null}";
+
+    /* The result must be the same for all chunk sizes. */
+    for (chunk_size = 1; chunk_size <= strlen(js_p); chunk_size++) {
+        BTASSERT(stream_parse(js_p,
+                              "{ k=a [ p=1 p=true s=b\\\"\\u00e5 ] k=c { } "
+                              "k=d [ [ ] ] k=e p=null } ",
+                              chunk_size) == 0);
+    }
+
+    BTASSERT(stream_parse("[]", "[ ] ", 1) == 0);
+    BTASSERT(stream_parse(" [-1.5e3 ]", "[ p=-1.5e3 ] ", 3) == 0);
+
+    return (0);
+}
+
+static int test_stream_parse_fail(void)
+{
+    struct json_stream_t stream;
+    struct events_t events;
+    char buf[4];
+    char deep[JSON_STREAM_DEPTH_MAX + 2];
+    int i;
+    struct {
+        const char *js_p;
+        ssize_t res;
+    } datas[] = {
+        { "{", JSON_ERROR_PART },
+        { "[1,", JSON_ERROR_PART },
+        { "{\"a\"", JSON_ERROR_PART },
+        { "1", JSON_ERROR_INVAL },
+        { "}", JSON_ERROR_INVAL },
+        { "[}", JSON_ERROR_INVAL },
+        { "{\"a\"}", JSON_ERROR_INVAL },
+        { "{\"a\":1]", JSON_ERROR_INVAL },
+        { "[1 2]", JSON_ERROR_INVAL },
+        { "[1,]", JSON_ERROR_INVAL },
+        { "[\"\\x\"]", JSON_ERROR_INVAL },
+        { "[\"\\u12g4\"]", JSON_ERROR_INVAL },
+        { "[\"\n\"]", JSON_ERROR_INVAL },
+        { "{[]:1}", JSON_ERROR_INVAL },
+        { "[\"abcde\"]", JSON_ERROR_NOMEM },
+        { "[12345]", JSON_ERROR_NOMEM }
+    };
+
+    events.abort_event = -1;
+
+    for (i = 0; i < membersof(datas); i++) {
+        events.size = 0;
+        BTASSERT(json_stream_init(&stream,
+                                  &buf[0],
+                                  sizeof(buf),
+                                  on_event,
+                                  &events) == 0);
+        BTASSERTI(json_stream_parse(&stream,
+                                    datas[i].js_p,
+                                    strlen(datas[i].js_p)), ==, datas[i].res);
+    }
+
+    /* Too deep nesting. */
+    memset(&deep[0], '[', sizeof(deep) - 1);
+    deep[sizeof(deep) - 1] = '\0';
+    events.size = 0;
+    BTASSERT(json_stream_init(&stream,
+                              &buf[0],
+                              sizeof(buf),
+                              on_event,
+                              &events) == 0);
+    BTASSERT(json_stream_parse(&stream,
+                               &deep[0],
+                               strlen(deep)) == JSON_ERROR_NOMEM);
+
+    /* Aborted by the callback. */
+    events.size = 0;
+    events.abort_event = JSON_EVENT_KEY;
+    BTASSERT(json_stream_init(&stream,
+                              &buf[0],
+                              sizeof(buf),
+                              on_event,
+                              &events) == 0);
+    BTASSERT(json_stream_parse(&stream, "{\"a\":1}", 7) == -ECANCELED);
+
+    return (0);
+}
+
+static int test_stream_read(void)
+{
+    struct json_stream_t stream;
+    struct events_t events;
+    struct queue_t queue;
+    char queue_buf[64];
+    char buf[8];
+    const char *js_p = "{\"a\":[1,2]}{\"b\":3}";
+
+    BTASSERT(queue_init(&queue, &queue_buf[0], sizeof(queue_buf)) == 0);
+    BTASSERT(queue_write(&queue, js_p, strlen(js_p)) == strlen(js_p));
+
+    events.size = 0;
+    events.abort_event = -1;
+    BTASSERT(json_stream_init(&stream,
+                              &buf[0],
+                              sizeof(buf),
+                              on_event,
+                              &events) == 0);
+
+    /* Both documents are available and read at once, and the second
+       document is kept for the next call. */
+    BTASSERT(json_stream_read(&stream, &queue) == 0);
+    BTASSERTM(&events.buf[0],
+              "{ k=a [ p=1 p=2 ] } ",
+              strlen("{ k=a [ p=1 p=2 ] } ") + 1);
+    BTASSERT(queue_size(&queue) == 0);
+
+    events.size = 0;
+    BTASSERT(json_stream_read(&stream, &queue) == 0);
+    BTASSERTM(&events.buf[0], "{ k=b p=3 } ", strlen("{ k=b p=3 } ") + 1);
+
+    /* Written in two parts. */
+    events.size = 0;
+    BTASSERT(queue_write(&queue, "[tr", 3) == 3);
+    BTASSERT(queue_write(&queue, "ue]", 3) == 3);
+    BTASSERT(json_stream_read(&stream, &queue) == 0);
+    BTASSERTM(&events.buf[0], "[ p=true ] ", strlen("[ p=true ] ") + 1);
+
+    return (0);
+}
+
+static int test_writer(void)
+{
+    struct json_writer_t writer;
+    char buf[128];
+
+    BTASSERT(json_writer_init(&writer, &qout) == 0);
+    BTASSERT(json_writer_object_begin(&writer) == 0);
+    BTASSERT(json_writer_key(&writer, "a") == 0);
+    BTASSERT(json_writer_array_begin(&writer) == 0);
+    BTASSERT(json_writer_integer(&writer, -17) == 0);
+    BTASSERT(json_writer_boolean(&writer, 1) == 0);
+    BTASSERT(json_writer_boolean(&writer, 0) == 0);
+    BTASSERT(json_writer_null(&writer) == 0);
+    BTASSERT(json_writer_string(&writer, "s\\n", 3) == 0);
+    BTASSERT(json_writer_object_begin(&writer) == 0);
+    BTASSERT(json_writer_object_end(&writer) == 0);
+    BTASSERT(json_writer_array_end(&writer) == 0);
+    BTASSERT(json_writer_key(&writer, "b") == 0);
+    BTASSERT(json_writer_primitive(&writer, "1.5", 3) == 0);
+
+    /* Structure errors. */
+    BTASSERT(json_writer_null(&writer) == JSON_ERROR_INVAL);
+    BTASSERT(json_writer_array_end(&writer) == JSON_ERROR_INVAL);
+    BTASSERT(json_writer_key(&writer, "c") == 0);
+    BTASSERT(json_writer_key(&writer, "d") == JSON_ERROR_INVAL);
+    BTASSERT(json_writer_object_end(&writer) == JSON_ERROR_INVAL);
+    BTASSERT(json_writer_array_begin(&writer) == 0);
+    BTASSERT(json_writer_key(&writer, "e") == JSON_ERROR_INVAL);
+    BTASSERT(json_writer_array_end(&writer) == 0);
+
+    BTASSERT(json_writer_object_end(&writer) == 0);
+    BTASSERT(json_writer_object_end(&writer) == JSON_ERROR_INVAL);
+    BTASSERT(json_writer_integer(&writer, 1) == JSON_ERROR_INVAL);
+
+    BTASSERT(json_writer_size(&writer) == 51);
+    BTASSERT(queue_read(&qout, &buf[0], 51) == 51);
+    buf[51] = '\0';
+    BTASSERTM(&buf[0],
+              "{\"a\":[-17,true,false,null,\"s\\n\",{}],\"b\":1.5,"
+              "\"c\":[]}",
+              52);
+
+    return (0);
+}
+
+/**
+ * Write each streaming parser event with given writer.
+ */
+static int on_event_write(void *arg_p,
+                          enum json_event_t event,
+                          const char *buf_p,
+                          size_t size)
+{
+    struct json_writer_t *writer_p;
+    char key[16];
+
+    writer_p = arg_p;
+
+    switch (event) {
+
+    case JSON_EVENT_OBJECT_BEGIN:
+        return (json_writer_object_begin(writer_p));
+
+    case JSON_EVENT_OBJECT_END:
+        return (json_writer_object_end(writer_p));
+
+    case JSON_EVENT_ARRAY_BEGIN:
+        return (json_writer_array_begin(writer_p));
+
+    case JSON_EVENT_ARRAY_END:
+        return (json_writer_array_end(writer_p));
+
+    case JSON_EVENT_KEY:
+        memcpy(&key[0], buf_p, size);
+        key[size] = '\0';
+
+        return (json_writer_key(writer_p, &key[0]));
+
+    case JSON_EVENT_STRING:
+        return (json_writer_string(writer_p, buf_p, size));
+
+    default:
+        return (json_writer_primitive(writer_p, buf_p, size));
+    }
+}
+
+static int test_stream_to_writer(void)
+{
+    struct json_stream_t stream;
+    struct json_writer_t writer;
+    char buf[16];
+    char out[64];
+    const char *js_p = "[ {\"id\": 1, \"v\": [2.5, \"x\"]},\n {} ]";
+    const char *expected_p = "[{\"id\":1,\"v\":[2.5,\"x\"]},{}]";
+
+    BTASSERT(json_writer_init(&writer, &qout) == 0);
+    BTASSERT(json_stream_init(&stream,
+                              &buf[0],
+                              sizeof(buf),
+                              on_event_write,
+                              &writer) == 0);
+    BTASSERT(json_stream_parse(&stream, js_p, 10) == JSON_ERROR_PART);
+    BTASSERT(json_stream_parse(&stream,
+                               &js_p[10],
+                               strlen(js_p) - 10) == strlen(js_p) - 10);
+    BTASSERT(json_writer_size(&writer) == strlen(expected_p));
+    BTASSERT(queue_read(&qout, &out[0], strlen(expected_p))
+             == strlen(expected_p));
+    BTASSERTM(&out[0], expected_p, strlen(expected_p));
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+static int test_get_benchmark(void)
+{
+    static struct json_tok_t tokens[8192];
+    static char js[32768];
+    struct json_t json;
+    struct json_tok_t *token_p;
+    struct time_t start;
+    struct time_t stop;
+    struct time_t elapsed;
+    unsigned long ns[2];
+    int iterations[2] = { 1000, 10 };
+    size_t size;
+    int i;
+    int j;
+    int k;
+    int res;
+
+    /* A nested document with 256 sensors. */
+    size = std_sprintf(&js[0], FSTR("{\"sensors\":["));
+
+    for (i = 0; i < 256; i++) {
+        size += std_sprintf(&js[size],
+                            FSTR("%s{\"id\":%d,\"values\":[1,2,3,4],"
+                                 "\"meta\":{\"unit\":\"C\","
+                                 "\"range\":[-40,125]}}"),
+                            (i == 0 ? "" : ","),
+                            i);
+    }
+
+    size += std_sprintf(&js[size], FSTR("]}"));
+    BTASSERT(size < sizeof(js));
+
+    time_get(&start);
+
+    for (i = 0; i < 100; i++) {
+        BTASSERT(json_init(&json, tokens, membersof(tokens)) == 0);
+        res = json_parse(&json, js, size);
+        BTASSERT(res > 0);
+    }
+
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, &start);
+    std_printf(OSTR("%d bytes, %d tokens: %lu us per parse.\r\n"),
+               (int)size,
+               res,
+               (elapsed.seconds * 1000000ul + elapsed.nanoseconds / 1000) / 100);
+
+    /* Look up a value in each sensor, first using the spans and then
+       without them. */
+    for (k = 0; k < 2; k++) {
+        time_get(&start);
+
+        for (j = 0; j < iterations[k]; j++) {
+            for (i = 0; i < 256; i++) {
+                token_p = json_get_path(&json, "sensors");
+                token_p = json_array_get(&json, i, token_p);
+                token_p = json_object_get(&json, "meta", token_p);
+                token_p = json_object_get(&json, "unit", token_p);
+                BTASSERT(token_p != NULL);
+            }
+        }
+
+        time_get(&stop);
+        time_subtract(&elapsed, &stop, &start);
+        ns[k] = ((elapsed.seconds * 1000000000ul + elapsed.nanoseconds)
+                 / (256ul * iterations[k]));
+
+        for (i = 0; i < res; i++) {
+            tokens[i].span = 0;
+        }
+    }
+
+    std_printf(OSTR("%lu ns per lookup with spans, %lu ns without.\r\n"),
+               ns[0],
+               ns[1]);
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -854,6 +1308,15 @@ int main()
         { test_dumps_fail, "test_dumps_fail" },
         { test_dump, "test_dump" },
         { test_get, "test_get" },
+        { test_get_path, "test_get_path" },
+        { test_stream_parse, "test_stream_parse" },
+        { test_stream_parse_fail, "test_stream_parse_fail" },
+        { test_stream_read, "test_stream_read" },
+        { test_writer, "test_writer" },
+        { test_stream_to_writer, "test_stream_to_writer" },
+#if defined(ARCH_LINUX)
+        { test_get_benchmark, "test_get_benchmark" },
+#endif
         { NULL, NULL }
     };
 
@@ -30,67 +30,22 @@
 
 #include "simba.h"
 
-#if !defined(ARCH_LINUX)
-static struct spi_driver_t spi;
-static struct sd_driver_t sd;
+#if defined(ARCH_LINUX)
+#    include "drivers/storage/sd_card_emulator.h"
 #endif
 
+static struct spi_driver_t spi;
+static struct sd_driver_t sd;
 static struct fat16_t fs;
 
-#if defined(ARCH_LINUX)
-static FILE *file_p = NULL;
-
-static ssize_t linux_read_block(void *arg_p,
-                                void *dst_p,
-                                uint32_t src_block)
-{
-    size_t block_start;
-
-    /* Find given block. */
-    block_start = (SD_BLOCK_SIZE * src_block);
-
-    if (fseek(arg_p, block_start, SEEK_SET) != 0) {
-        return (1);
-    }
-
-    return (fread(dst_p, 1, SD_BLOCK_SIZE, arg_p));
-}
-
-static ssize_t linux_write_block(void *arg_p,
-                                 uint32_t dst_block,
-                                 const void *src_p)
-{
-    size_t block_start;
-
-    /* Find given block. */
-    block_start = (SD_BLOCK_SIZE * dst_block);
-
-    if (fseek(arg_p, block_start, SEEK_SET) != 0) {
-        return (1);
-    }
-
-    if (fwrite(src_p, 1, SD_BLOCK_SIZE, arg_p) != SD_BLOCK_SIZE) {
-        return (-1);
-    }
-
-    fflush(file_p);
-
-    return (SD_BLOCK_SIZE);
-}
-#endif
-
 int test_init(void)
 {
 #if defined(ARCH_LINUX)
     /* Create an empty sd card file. */
-    system("../../create_sdcard_linux.sh");
-    file_p = fopen("sdcard", "r+b");
-    BTASSERT(fat16_init(&fs,
-                        linux_read_block,
-                        linux_write_block,
-                        file_p,
-                        0) == 0);
-#else
+    BTASSERT(system("../../create_sdcard_linux.sh") == 0);
+    BTASSERT(sd_card_emulator_init("sdcard") == 0);
+#endif
+
     BTASSERT(spi_init(&spi,
                       &spi_device[0],
                       &pin_d6_dev,
@@ -105,7 +60,10 @@ int test_init(void)
                         (fat16_write_t)sd_write_block,
                         &sd,
                         0) == 0);
-#endif
+    BTASSERT(fat16_set_multiple_blocks_callbacks(
+                 &fs,
+                 (fat16_read_blocks_t)sd_read_blocks,
+                 (fat16_write_blocks_t)sd_write_blocks) == 0);
 
     return (0);
 }
@@ -439,13 +397,190 @@ static int test_seek(void)
     return (0);
 }
 
+/**
+ * Expected byte at given position in BLOCKS.BIN.
+ */
+static uint8_t blocks_byte(size_t position)
+{
+    if (position < 100) {
+        return (position % 251);
+    }
+
+    return (((position - 100) % 8192) % 251);
+}
+
+static int test_multiple_blocks(void)
+{
+    struct fat16_file_t foo;
+    static uint8_t buf[8192];
+    size_t i;
+#if defined(ARCH_LINUX)
+    struct sd_card_emulator_stats_t *stats_p;
+
+    stats_p = sd_card_emulator_get_stats();
+    sd_card_emulator_reset_stats();
+#endif
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (i % 251);
+    }
+
+    /* An unaligned head, whole blocks spanning several clusters and
+       an unaligned tail. */
+    BTASSERT(fat16_file_open(&fs,
+                             &foo,
+                             "BLOCKS.BIN",
+                             O_CREAT | O_WRITE | O_TRUNC) == 0);
+    BTASSERT(fat16_file_write(&foo, &buf[0], 100) == 100);
+
+    for (i = 0; i < 4; i++) {
+        BTASSERT(fat16_file_write(&foo, &buf[0], sizeof(buf)) == sizeof(buf));
+    }
+
+    BTASSERT(fat16_file_write(&foo, &buf[0], 100) == 100);
+    BTASSERT(fat16_file_close(&foo) == 0);
+    BTASSERT(fat16_file_size(&foo) == 4 * sizeof(buf) + 200);
+
+#if defined(ARCH_LINUX)
+    BTASSERT(stats_p->commands[25] > 0);
+    sd_card_emulator_reset_stats();
+#endif
+
+    /* Read it back, first aligned and then unaligned. */
+    BTASSERT(fat16_file_open(&fs, &foo, "BLOCKS.BIN", O_READ) == 0);
+    BTASSERT(fat16_file_read(&foo, &buf[0], 100) == 100);
+
+    for (i = 0; i < 100; i++) {
+        BTASSERT(buf[i] == blocks_byte(i));
+    }
+
+    BTASSERT(fat16_file_seek(&foo, 512, FAT16_SEEK_SET) == 0);
+    BTASSERT(fat16_file_read(&foo, &buf[0], sizeof(buf)) == sizeof(buf));
+
+    for (i = 0; i < sizeof(buf); i++) {
+        BTASSERT(buf[i] == blocks_byte(i + 512));
+    }
+
+    BTASSERT(fat16_file_seek(&foo, 1000, FAT16_SEEK_SET) == 0);
+    BTASSERT(fat16_file_read(&foo, &buf[0], sizeof(buf)) == sizeof(buf));
+
+    for (i = 0; i < sizeof(buf); i++) {
+        BTASSERT(buf[i] == blocks_byte(i + 1000));
+    }
+
+    BTASSERT(fat16_file_close(&foo) == 0);
+
+#if defined(ARCH_LINUX)
+    BTASSERT(stats_p->commands[18] > 0);
+#endif
+
+    /* Read it one block at a time as well. */
+    BTASSERT(fat16_set_multiple_blocks_callbacks(&fs, NULL, NULL) == 0);
+    BTASSERT(fat16_file_open(&fs, &foo, "BLOCKS.BIN", O_READ) == 0);
+    BTASSERT(fat16_file_read(&foo, &buf[0], sizeof(buf)) == sizeof(buf));
+
+    for (i = 0; i < sizeof(buf); i++) {
+        BTASSERT(buf[i] == blocks_byte(i));
+    }
+
+    BTASSERT(fat16_file_close(&foo) == 0);
+    BTASSERT(fat16_set_multiple_blocks_callbacks(
+                 &fs,
+                 (fat16_read_blocks_t)sd_read_blocks,
+                 (fat16_write_blocks_t)sd_write_blocks) == 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+static unsigned long read_counter(const char *path_p)
+{
+    struct queue_t queue;
+    char buf[32];
+    char command[64];
+
+    strcpy(command, path_p);
+    BTASSERT(queue_init(&queue, &buf[0], sizeof(buf)) == 0);
+    BTASSERT(fs_call(command, NULL, &queue, NULL) == 0);
+    BTASSERT(queue_read(&queue, &buf[0], 18) == 18);
+    buf[16] = '\0';
+
+    return (strtoul(&buf[0], NULL, 16));
+}
+
+#endif
+
+static int test_cache(void)
+{
+#if defined(ARCH_LINUX)
+    struct fat16_file_t foo;
+    struct sd_card_emulator_stats_t *stats_p;
+    char record[64];
+    char command[64];
+    unsigned long hits;
+    unsigned long misses;
+    int i;
+
+    stats_p = sd_card_emulator_get_stats();
+
+    /* Append small records to a log file, crossing several cluster
+       boundaries. */
+    memset(&record[0], 'a', sizeof(record));
+    BTASSERT(fat16_file_open(&fs,
+                             &foo,
+                             "LOG.TXT",
+                             O_CREAT | O_WRITE | O_APPEND) == 0);
+    strcpy(command, "/filesystems/fat16/cache/hits reset");
+    BTASSERT(fs_call(command, NULL, NULL, NULL) == 0);
+    strcpy(command, "/filesystems/fat16/cache/misses reset");
+    BTASSERT(fs_call(command, NULL, NULL, NULL) == 0);
+    sd_card_emulator_reset_stats();
+
+    for (i = 0; i < 200; i++) {
+        BTASSERT(fat16_file_write(&foo,
+                                  &record[0],
+                                  sizeof(record)) == sizeof(record));
+    }
+
+    /* Only full data blocks have been written so far, each one
+       once. */
+    BTASSERT(stats_p->blocks_written <= 25);
+    BTASSERT(stats_p->blocks_read <= 1);
+
+    /* Write back the remaining data blocks, the modified FAT block
+       and its mirror, and the directory block. */
+    BTASSERT(fat16_file_close(&foo) == 0);
+    BTASSERT(stats_p->blocks_written == 25 + 3);
+
+    hits = read_counter("/filesystems/fat16/cache/hits");
+    misses = read_counter("/filesystems/fat16/cache/misses");
+    std_printf(FSTR("cache hits: %lu, misses: %lu\r\n"), hits, misses);
+    BTASSERT(hits > 0);
+    BTASSERT(misses <= 25 + 2);
+
+    /* Read it back. */
+    BTASSERT(fat16_file_open(&fs, &foo, "LOG.TXT", O_READ) == 0);
+
+    for (i = 0; i < 200; i++) {
+        memset(&record[0], 0, sizeof(record));
+        BTASSERT(fat16_file_read(&foo,
+                                 &record[0],
+                                 sizeof(record)) == sizeof(record));
+        BTASSERT(record[0] == 'a');
+        BTASSERT(record[sizeof(record) - 1] == 'a');
+    }
+
+    BTASSERT(fat16_file_close(&foo) == 0);
+#endif
+
+    return (0);
+}
+
 static int test_unmount(void)
 {
     BTASSERT(fat16_unmount(&fs) == 0);
-
-#if !defined(ARCH_LINUX)
     BTASSERT(sd_stop(&sd) == 0);
-#endif
 
     return (0);
 }
@@ -465,6 +600,8 @@ int main()
         { test_truncate, "test_truncate" },
         { test_append, "test_append" },
         { test_seek, "test_seek" },
+        { test_multiple_blocks, "test_multiple_blocks" },
+        { test_cache, "test_cache" },
         { test_unmount, "test_unmount" },
         { NULL, NULL }
     };
@@ -99,6 +99,154 @@ static int test_crc_8(void)
     return (0);
 }
 
+static uint32_t reference_crc_32(uint32_t crc,
+                                 const uint8_t *buf_p,
+                                 size_t size)
+{
+    int i;
+
+    crc = ~crc;
+
+    while (size--) {
+        crc ^= *buf_p++;
+
+        for (i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+        }
+    }
+
+    return (~crc);
+}
+
+static uint16_t reference_crc_ccitt(uint16_t crc,
+                                    const uint8_t *buf_p,
+                                    size_t size)
+{
+    int i;
+
+    while (size--) {
+        crc ^= (*buf_p++ << 8);
+
+        for (i = 0; i < 8; i++) {
+            if (crc & 0x8000) {
+                crc = ((crc << 1) ^ 0x1021);
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return (crc);
+}
+
+static uint8_t buf[1024 * 1024];
+
+static int test_crc_sizes_and_offsets(void)
+{
+    size_t i;
+    size_t offset;
+    size_t size;
+    uint32_t crc;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (i * 7919 + (i >> 8));
+    }
+
+    /* Unaligned starts and tails of all lengths around the block
+       sizes. */
+    for (offset = 0; offset < 16; offset++) {
+        for (size = 0; size < 300; size++) {
+            BTASSERT(crc_32(0, &buf[offset], size)
+                     == reference_crc_32(0, &buf[offset], size));
+            BTASSERT(crc_32(0x12345678, &buf[offset], size)
+                     == reference_crc_32(0x12345678, &buf[offset], size));
+            BTASSERT(crc_ccitt(0xffff, &buf[offset], size)
+                     == reference_crc_ccitt(0xffff, &buf[offset], size));
+        }
+    }
+
+    /* Large buffers. */
+    BTASSERT(crc_32(0, &buf[0], sizeof(buf))
+             == reference_crc_32(0, &buf[0], sizeof(buf)));
+    BTASSERT(crc_32(0, &buf[3], 65536 + 9)
+             == reference_crc_32(0, &buf[3], 65536 + 9));
+    BTASSERT(crc_ccitt(0, &buf[0], sizeof(buf))
+             == reference_crc_ccitt(0, &buf[0], sizeof(buf)));
+
+    /* Calculated in pieces. */
+    crc = crc_32(0, &buf[0], 100);
+    crc = crc_32(crc, &buf[100], 1000);
+    BTASSERT(crc == reference_crc_32(0, &buf[0], 1100));
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+#define BENCHMARK_TOTAL_SIZE                       (128 * 1024 * 1024)
+
+static unsigned long elapsed_ms(struct time_t *start_p)
+{
+    struct time_t stop;
+    struct time_t elapsed;
+
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, start_p);
+
+    return (elapsed.seconds * 1000 + elapsed.nanoseconds / 1000000);
+}
+
+static int test_benchmark(void)
+{
+    static const size_t sizes[] = {
+        16, 256, 4096, 65536, 1024 * 1024
+    };
+    struct time_t start;
+    unsigned long crc_32_ms;
+    unsigned long crc_ccitt_ms;
+    uint32_t crc32;
+    uint16_t crc16;
+    size_t i;
+    size_t j;
+    size_t rounds;
+
+    crc32 = 0;
+    crc16 = 0;
+
+    for (i = 0; i < membersof(sizes); i++) {
+        rounds = (BENCHMARK_TOTAL_SIZE / sizes[i]);
+
+        time_get(&start);
+
+        for (j = 0; j < rounds; j++) {
+            crc32 = crc_32(crc32, &buf[0], sizes[i]);
+        }
+
+        crc_32_ms = elapsed_ms(&start);
+        time_get(&start);
+
+        for (j = 0; j < rounds; j++) {
+            crc16 = crc_ccitt(crc16, &buf[0], sizes[i]);
+        }
+
+        crc_ccitt_ms = elapsed_ms(&start);
+
+        std_printf(OSTR("%7u bytes x %7u: crc_32 %4lu ms, "
+                        "crc_ccitt %4lu ms\r\n"),
+                   (unsigned)sizes[i],
+                   (unsigned)rounds,
+                   crc_32_ms,
+                   crc_ccitt_ms);
+    }
+
+    /* Use the results. */
+    BTASSERT((crc32 != 0) || (crc16 != 0));
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -107,6 +255,10 @@ int main()
         { test_crc_xmodem, "test_crc_xmodem" },
         { test_crc_7, "test_crc_7" },
         { test_crc_8, "test_crc_8" },
+        { test_crc_sizes_and_offsets, "test_crc_sizes_and_offsets" },
+#if defined(ARCH_LINUX)
+        { test_benchmark, "test_benchmark" },
+#endif
         { NULL, NULL }
     };
 
@@ -118,10 +118,169 @@ int test_sha1(void)
     return (0);
 }
 
+static uint8_t buf[1024 * 1024];
+
+static int test_long(void)
+{
+    struct sha1_t foo;
+    uint8_t hash[20];
+
+    /* One million a. */
+    memset(&buf[0], 'a', 1000000);
+    BTASSERT(sha1_init(&foo) == 0);
+    BTASSERT(sha1_update(&foo, &buf[1], 999999) == 0);
+    BTASSERT(sha1_update(&foo, &buf[0], 1) == 0);
+    BTASSERT(sha1_digest(&foo, hash) == 0);
+
+    BTASSERT(memcmp(hash,
+                    "\x34\xaa\x97\x3c\xd4\xc4\xda\xa4\xf6\x1e"
+                    "\xeb\x2b\xdb\xad\x27\x31\x65\x34\x01\x6f",
+                    20) == 0);
+
+    return (0);
+}
+
+static int test_update_multi(void)
+{
+    struct sha1_t objects[19];
+    struct sha1_t *objects_p[membersof(objects)];
+    void *bufs[membersof(objects)];
+    size_t sizes[membersof(objects)];
+    struct sha1_t expected;
+    uint8_t hash[20];
+    uint8_t expected_hash[20];
+    size_t i;
+    int j;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (i * 31 + (i >> 9));
+    }
+
+    /* Unaligned buffers of different sizes, first with a partial
+       block already in the objects. */
+    for (j = 0; j < membersof(objects); j++) {
+        BTASSERT(sha1_init(&objects[j]) == 0);
+        BTASSERT(sha1_update(&objects[j], &buf[0], j) == 0);
+        objects_p[j] = &objects[j];
+        bufs[j] = &buf[1000 * j + j];
+        sizes[j] = (64 * j * j + 3 * j);
+    }
+
+    BTASSERT(sha1_update_multi(&objects_p[0],
+                               &bufs[0],
+                               &sizes[0],
+                               membersof(objects)) == 0);
+
+    for (j = 0; j < membersof(objects); j++) {
+        BTASSERT(sha1_init(&expected) == 0);
+        BTASSERT(sha1_update(&expected, &buf[0], j) == 0);
+        BTASSERT(sha1_update(&expected, bufs[j], sizes[j]) == 0);
+        BTASSERT(sha1_digest(&expected, expected_hash) == 0);
+        BTASSERT(sha1_digest(&objects[j], hash) == 0);
+        BTASSERT(memcmp(hash, expected_hash, 20) == 0);
+    }
+
+    /* No objects. */
+    BTASSERT(sha1_update_multi(&objects_p[0], &bufs[0], &sizes[0], 0) == 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+#define BENCHMARK_TOTAL_SIZE                       (64 * 1024 * 1024)
+
+static unsigned long elapsed_ms(struct time_t *start_p)
+{
+    struct time_t stop;
+    struct time_t elapsed;
+
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, start_p);
+
+    return (elapsed.seconds * 1000 + elapsed.nanoseconds / 1000000);
+}
+
+static unsigned long mb_per_second(unsigned long ms)
+{
+    return ((BENCHMARK_TOTAL_SIZE / (1024 * 1024)) * 1000 / MAX(ms, 1));
+}
+
+static int test_benchmark(void)
+{
+    static const size_t sizes[] = { 64, 1024, 65536 };
+    struct sha1_t objects[8];
+    struct sha1_t *objects_p[membersof(objects)];
+    void *bufs[membersof(objects)];
+    size_t multi_sizes[membersof(objects)];
+    struct time_t start;
+    unsigned long update_ms;
+    unsigned long multi_ms;
+    uint8_t hash[20];
+    size_t i;
+    size_t j;
+    size_t k;
+    size_t rounds;
+
+    for (i = 0; i < membersof(sizes); i++) {
+        rounds = (BENCHMARK_TOTAL_SIZE / sizes[i]);
+
+        time_get(&start);
+
+        for (j = 0; j < rounds; j++) {
+            BTASSERT(sha1_init(&objects[0]) == 0);
+            BTASSERT(sha1_update(&objects[0], &buf[0], sizes[i]) == 0);
+            BTASSERT(sha1_digest(&objects[0], hash) == 0);
+        }
+
+        update_ms = elapsed_ms(&start);
+
+        for (j = 0; j < membersof(objects); j++) {
+            objects_p[j] = &objects[j];
+            bufs[j] = &buf[j * sizes[i]];
+            multi_sizes[j] = sizes[i];
+        }
+
+        time_get(&start);
+
+        for (j = 0; j < rounds; j += membersof(objects)) {
+            for (k = 0; k < membersof(objects); k++) {
+                BTASSERT(sha1_init(&objects[k]) == 0);
+            }
+
+            BTASSERT(sha1_update_multi(&objects_p[0],
+                                       &bufs[0],
+                                       &multi_sizes[0],
+                                       membersof(objects)) == 0);
+
+            for (k = 0; k < membersof(objects); k++) {
+                BTASSERT(sha1_digest(&objects[k], hash) == 0);
+            }
+        }
+
+        multi_ms = elapsed_ms(&start);
+
+        std_printf(OSTR("%5u bytes messages: sha1_update %4lu MB/s, "
+                        "sha1_update_multi %4lu MB/s\r\n"),
+                   (unsigned)sizes[i],
+                   mb_per_second(update_ms),
+                   mb_per_second(multi_ms));
+    }
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
         { test_sha1, "test_sha1" },
+        { test_long, "test_long" },
+        { test_update_multi, "test_update_multi" },
+#if defined(ARCH_LINUX)
+        { test_benchmark, "test_benchmark" },
+#endif
         { NULL, NULL }
     };
 
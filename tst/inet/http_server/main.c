@@ -52,6 +52,8 @@ static int request_form(struct http_server_connection_t *connection_p,
                         struct http_server_request_t *request_p);
 static int request_websocket_echo(struct http_server_connection_t *connection_p,
                                   struct http_server_request_t *request_p);
+static int request_sensor_get(struct http_server_connection_t *connection_p,
+                              struct http_server_request_t *request_p);
 static int request_404_not_found(struct http_server_connection_t *connection_p,
                                  struct http_server_request_t *request_p);
 
@@ -62,6 +64,7 @@ static struct http_server_route_t routes[] = {
     { .path_p = "/auth.html", .callback = request_auth },
     { .path_p = "/form.html", .callback = request_form },
     { .path_p = "/websocket/echo", .callback = request_websocket_echo },
+    { .path_p = "/sensors/{id}", .methods = { .get = request_sensor_get } },
     { .path_p = NULL, .callback = NULL }
 };
 
@@ -182,6 +185,32 @@ static int request_websocket_echo(struct http_server_connection_t *connection_p,
     return (0);
 }
 
+/**
+ * Handler for the sensor GET request.
+ */
+static int request_sensor_get(struct http_server_connection_t *connection_p,
+                              struct http_server_request_t *request_p)
+{
+    struct http_server_response_t response;
+    char content[32];
+    char id[8];
+
+    BTASSERT(http_server_request_get_param(request_p,
+                                           "id",
+                                           &id[0],
+                                           sizeof(id)) > 0);
+
+    /* Create the response. */
+    response.code = http_server_response_code_200_ok_t;
+    response.content.type = http_server_content_type_text_plain_t;
+    response.content.buf_p = &content[0];
+    response.content.size = std_sprintf(&content[0],
+                                        FSTR("Sensor %s."),
+                                        &id[0]);
+
+    return (http_server_response_write(connection_p, request_p, &response));
+}
+
 /**
  * Handler for all requests except those in the route array.
  */
@@ -275,7 +304,7 @@ static int test_request_index(void)
     str_p =
         "GET /index.html HTTP/1.1\r\n"
         "User-Agent: TestcaseRequestIndex\r\n"
-        "Connection: keep-alive\r\n"
+        "Connection: close\r\n"
         "\r\n";
 
     socket_stub_input(str_p, strlen(str_p));
@@ -309,7 +338,7 @@ static int test_request_index_with_query_string(void)
     str_p =
         "GET /index.html?hello=world HTTP/1.1\r\n"
         "User-Agent: TestcaseRequestIndex\r\n"
-        "Connection: keep-alive\r\n"
+        "Connection: close\r\n"
         "\r\n";
 
     socket_stub_input(str_p, strlen(str_p));
@@ -344,7 +373,7 @@ static int test_request_auth(void)
         "GET /auth.html HTTP/1.1\r\n"
         "Authorization: Basic YWRtaW46YWRtaW4=\r\n"
         "User-Agent: TestcaseRequestIndex\r\n"
-        "Connection: keep-alive\r\n"
+        "Connection: close\r\n"
         "\r\n";
 
     socket_stub_input(str_p, strlen(str_p));
@@ -378,7 +407,7 @@ static int test_request_form(void)
     str_p =
         "POST /form.html HTTP/1.1\r\n"
         "User-Agent: TestcaseRequestIndex\r\n"
-        "Connection: keep-alive\r\n"
+        "Connection: close\r\n"
         "Content-Type: application/x-www-form-urlencoded\r\n"
         "Content-Length: 9\r\n"
         "\r\n"
@@ -403,6 +432,288 @@ static int test_request_form(void)
     return (0);
 }
 
+static int test_request_keep_alive(void)
+{
+    char *str_p;
+    char buf[256];
+    int i;
+
+    /* Input the accept answer. */
+    socket_stub_accept();
+
+    /* HTTP/1.1 connections are persistent by default. */
+    for (i = 0; i < 3; i++) {
+        str_p =
+            "GET /index.html HTTP/1.1\r\n"
+            "User-Agent: TestcaseRequestKeepAlive\r\n"
+            "\r\n";
+        socket_stub_input(str_p, strlen(str_p));
+
+        str_p =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/html\r\n"
+            "Content-Length: 8\r\n"
+            "\r\n"
+            "Welcome!";
+        socket_stub_output(buf, strlen(str_p));
+        buf[strlen(str_p)] = '\0';
+        BTASSERT(strcmp(buf, str_p) == 0);
+    }
+
+    /* The server closes the connection after this request. */
+    str_p =
+        "GET /index.html HTTP/1.1\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    socket_stub_input(str_p, strlen(str_p));
+
+    str_p =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Content-Length: 8\r\n"
+        "\r\n"
+        "Welcome!";
+    socket_stub_output(buf, strlen(str_p));
+    buf[strlen(str_p)] = '\0';
+    BTASSERT(strcmp(buf, str_p) == 0);
+
+    socket_stub_wait_closed();
+
+    return (0);
+}
+
+static int test_request_idle_timeout(void)
+{
+    char *str_p;
+    char buf[256];
+    struct time_t start;
+    struct time_t stop;
+    struct time_t elapsed;
+
+    /* Input the accept answer. */
+    socket_stub_accept();
+
+    str_p =
+        "GET /index.html HTTP/1.1\r\n"
+        "\r\n";
+    socket_stub_input(str_p, strlen(str_p));
+
+    str_p =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Content-Length: 8\r\n"
+        "\r\n"
+        "Welcome!";
+    socket_stub_output(buf, strlen(str_p));
+    buf[strlen(str_p)] = '\0';
+    BTASSERT(strcmp(buf, str_p) == 0);
+
+    /* The server closes the persistent connection when no more
+       requests are received. */
+    time_get(&start);
+    socket_stub_wait_closed();
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, &start);
+    BTASSERT(elapsed.seconds * 1000 + elapsed.nanoseconds / 1000000
+             >= CONFIG_HTTP_SERVER_IDLE_TIMEOUT_MS - 20);
+
+    return (0);
+}
+
+static int test_request_keep_alive_requests_max(void)
+{
+    char *str_p;
+    char buf[256];
+    int i;
+
+    /* Input the accept answer. */
+    socket_stub_accept();
+
+    /* The server closes the connection after the maximum number of
+       requests, even if the client wants to keep it open. */
+    for (i = 0; i < CONFIG_HTTP_SERVER_KEEP_ALIVE_REQUESTS_MAX; i++) {
+        str_p =
+            "GET /index.html HTTP/1.1\r\n"
+            "Connection: keep-alive\r\n"
+            "\r\n";
+        socket_stub_input(str_p, strlen(str_p));
+
+        str_p =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/html\r\n"
+            "Content-Length: 8\r\n"
+            "\r\n"
+            "Welcome!";
+        socket_stub_output(buf, strlen(str_p));
+        buf[strlen(str_p)] = '\0';
+        BTASSERT(strcmp(buf, str_p) == 0);
+    }
+
+    socket_stub_wait_closed();
+
+    return (0);
+}
+
+static int test_request_pipelined(void)
+{
+    char *str_p;
+    char buf[512];
+
+    /* Input the accept answer. */
+    socket_stub_accept();
+
+    /* Three requests in one write. The form body must not be parsed
+       as the start of the next request. HTTP/1.0 closes the
+       connection after the last request. */
+    str_p =
+        "GET /index.html HTTP/1.1\r\n"
+        "\r\n"
+        "POST /form.html HTTP/1.1\r\n"
+        "Content-Type: application/x-www-form-urlencoded\r\n"
+        "Content-Length: 9\r\n"
+        "\r\n"
+        "key=value"
+        "GET /missing.html HTTP/1.0\r\n"
+        "\r\n";
+    socket_stub_input(str_p, strlen(str_p));
+
+    str_p =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Content-Length: 8\r\n"
+        "\r\n"
+        "Welcome!"
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "Form!"
+        "HTTP/1.1 404 Not Found\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 54\r\n"
+        "\r\n"
+        "The requested page '/missing.html' could not be found.";
+    socket_stub_output(buf, strlen(str_p));
+    buf[strlen(str_p)] = '\0';
+    BTASSERT(strcmp(buf, str_p) == 0);
+
+    socket_stub_wait_closed();
+
+    return (0);
+}
+
+static int test_request_unread_body(void)
+{
+    char *str_p;
+    char buf[256];
+
+    /* Input the accept answer. */
+    socket_stub_accept();
+
+    /* The 404 callback does not read the body. It is discarded, in
+       part from the input buffer and in part from the socket, before
+       the next request is parsed. */
+    str_p =
+        "POST /missing.html HTTP/1.1\r\n"
+        "Content-Length: 200\r\n"
+        "\r\n";
+    socket_stub_input(str_p, strlen(str_p));
+    memset(&buf[0], 'x', 200);
+    socket_stub_input(buf, 200);
+
+    str_p =
+        "HTTP/1.1 404 Not Found\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 54\r\n"
+        "\r\n"
+        "The requested page '/missing.html' could not be found.";
+    socket_stub_output(buf, strlen(str_p));
+    buf[strlen(str_p)] = '\0';
+    BTASSERT(strcmp(buf, str_p) == 0);
+
+    str_p =
+        "GET /index.html HTTP/1.1\r\n"
+        "\r\n";
+    socket_stub_input(str_p, strlen(str_p));
+
+    str_p =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Content-Length: 8\r\n"
+        "\r\n"
+        "Welcome!";
+    socket_stub_output(buf, strlen(str_p));
+    buf[strlen(str_p)] = '\0';
+    BTASSERT(strcmp(buf, str_p) == 0);
+
+    /* A body too large to discard closes the connection. */
+    str_p =
+        "POST /missing.html HTTP/1.1\r\n"
+        "Content-Length: 100000\r\n"
+        "\r\n";
+    socket_stub_input(str_p, strlen(str_p));
+
+    str_p =
+        "HTTP/1.1 404 Not Found\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 54\r\n"
+        "\r\n"
+        "The requested page '/missing.html' could not be found.";
+    socket_stub_output(buf, strlen(str_p));
+    buf[strlen(str_p)] = '\0';
+    BTASSERT(strcmp(buf, str_p) == 0);
+
+    socket_stub_wait_closed();
+
+    return (0);
+}
+
+static int test_request_sensor(void)
+{
+    char *str_p;
+    char buf[256];
+
+    /* Input the accept answer. */
+    socket_stub_accept();
+
+    /* The path parameter is passed to the GET callback. */
+    str_p =
+        "GET /sensors/12 HTTP/1.1\r\n"
+        "\r\n";
+    socket_stub_input(str_p, strlen(str_p));
+
+    str_p =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 10\r\n"
+        "\r\n"
+        "Sensor 12.";
+    socket_stub_output(buf, strlen(str_p));
+    buf[strlen(str_p)] = '\0';
+    BTASSERT(strcmp(buf, str_p) == 0);
+
+    /* No POST callback. */
+    str_p =
+        "POST /sensors/12 HTTP/1.1\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    socket_stub_input(str_p, strlen(str_p));
+
+    str_p =
+        "HTTP/1.1 404 Not Found\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 52\r\n"
+        "\r\n"
+        "The requested page '/sensors/12' could not be found.";
+    socket_stub_output(buf, strlen(str_p));
+    buf[strlen(str_p)] = '\0';
+    BTASSERT(strcmp(buf, str_p) == 0);
+
+    socket_stub_wait_closed();
+
+    return (0);
+}
+
 static int test_request_websocket(void)
 {
     int i;
@@ -473,7 +784,7 @@ static int test_request_no_route(void)
     str_p =
         "GET /missing.html HTTP/1.1\r\n"
         "User-Agent: TestcaseRequestIndex\r\n"
-        "Connection: keep-alive\r\n"
+        "Connection: close\r\n"
         "\r\n";
 
     socket_stub_input(str_p, strlen(str_p));
@@ -568,6 +879,361 @@ static int test_request_header_field_too_long(void)
     return (0);
 }
 
+#if defined(ARCH_LINUX)
+
+#define LOAD_REQUESTS_MAX 30000
+#define LOAD_PIPELINE_DEPTH 3
+
+/**
+ * Load generator. Requests per second with a connection per request
+ * and with pipelined requests on a persistent connection.
+ */
+static int test_load(void)
+{
+    char *request_p;
+    char *response_p;
+    char requests[128];
+    char buf[256];
+    size_t request_size;
+    size_t response_size;
+    struct time_t start;
+    struct time_t stop;
+    struct time_t elapsed;
+    int i;
+    int j;
+    int per_connection;
+    int pipelined;
+
+    /* Logging each request would dominate the measurement. */
+    thrd_set_log_mask(foo.connections_p[0].thrd.id_p, LOG_UPTO(INFO));
+
+    response_p =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Content-Length: 8\r\n"
+        "\r\n"
+        "Welcome!";
+    response_size = strlen(response_p);
+
+    /* A new connection for each request. */
+    request_p =
+        "GET /index.html HTTP/1.1\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    request_size = strlen(request_p);
+    time_get(&start);
+
+    for (i = 0; i < LOAD_REQUESTS_MAX; i++) {
+        socket_stub_accept();
+        socket_stub_input(request_p, request_size);
+        socket_stub_output(buf, response_size);
+        BTASSERT(memcmp(buf, response_p, response_size) == 0);
+        socket_stub_wait_closed();
+    }
+
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, &start);
+    per_connection = (LOAD_REQUESTS_MAX
+                      / (elapsed.seconds + elapsed.nanoseconds / 1e9));
+
+    /* Pipelined requests on a persistent connection. */
+    request_p = "GET /index.html HTTP/1.1\r\n\r\n";
+    request_size = strlen(request_p);
+
+    for (j = 0; j < LOAD_PIPELINE_DEPTH; j++) {
+        memcpy(&requests[j * request_size], request_p, request_size);
+    }
+
+    socket_stub_accept();
+    time_get(&start);
+
+    for (i = 0; i < LOAD_REQUESTS_MAX; i += LOAD_PIPELINE_DEPTH) {
+        socket_stub_input(requests, LOAD_PIPELINE_DEPTH * request_size);
+        socket_stub_output(buf, LOAD_PIPELINE_DEPTH * response_size);
+
+        for (j = 0; j < LOAD_PIPELINE_DEPTH; j++) {
+            BTASSERT(memcmp(&buf[j * response_size],
+                            response_p,
+                            response_size) == 0);
+        }
+
+        /* Reconnect when the server closes the connection after the
+           maximum number of requests, which is a multiple of the
+           pipeline depth. */
+        if (((i + LOAD_PIPELINE_DEPTH)
+             % CONFIG_HTTP_SERVER_KEEP_ALIVE_REQUESTS_MAX) == 0) {
+            socket_stub_wait_closed();
+            socket_stub_accept();
+        }
+    }
+
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, &start);
+    pipelined = (LOAD_REQUESTS_MAX
+                 / (elapsed.seconds + elapsed.nanoseconds / 1e9));
+
+    request_p =
+        "GET /index.html HTTP/1.1\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    socket_stub_input(request_p, strlen(request_p));
+    socket_stub_output(buf, response_size);
+    socket_stub_wait_closed();
+
+    thrd_set_log_mask(foo.connections_p[0].thrd.id_p, LOG_UPTO(DEBUG));
+
+    std_printf(OSTR("%d requests: %d requests/s with a connection per "
+                    "request, %d requests/s pipelined\r\n"),
+               LOAD_REQUESTS_MAX,
+               per_connection,
+               pipelined);
+
+    return (0);
+}
+
+#endif
+
+static int route_a(struct http_server_connection_t *connection_p,
+                   struct http_server_request_t *request_p)
+{
+    return (0);
+}
+
+static int route_b(struct http_server_connection_t *connection_p,
+                   struct http_server_request_t *request_p)
+{
+    return (0);
+}
+
+static int route_c(struct http_server_connection_t *connection_p,
+                   struct http_server_request_t *request_p)
+{
+    return (0);
+}
+
+static int route_d(struct http_server_connection_t *connection_p,
+                   struct http_server_request_t *request_p)
+{
+    return (0);
+}
+
+static int test_routes(void)
+{
+    static struct http_server_listener_t listener;
+    static struct http_server_connection_t connections[] = {
+        {
+            .thrd = {
+                .name_p = NULL
+            }
+        }
+    };
+    static const struct http_server_route_t routes[] = {
+        { .path_p = "/", .callback = route_a },
+        { .path_p = "/api", .callback = route_b },
+        { .path_p = "/api/{group}", .callback = route_b },
+        { .path_p = "/api/sensors/{id}", .callback = route_c },
+        { .path_p = "/api/sensors/all", .methods = { .get = route_d } },
+        { .path_p = "/api/sensors/{id}/{field}",
+          .methods = { .get = route_d, .post = route_a } },
+        { .path_p = NULL, .callback = NULL }
+    };
+    static struct http_server_t server;
+    struct http_server_request_t request;
+    char buf[8];
+
+    BTASSERT(http_server_init(&server,
+                              &listener,
+                              connections,
+                              NULL,
+                              routes,
+                              request_404_not_found) == 0);
+
+    /* Root route matches everything else. */
+    request.action = http_server_request_action_get_t;
+    strcpy(&request.path[0], "/foo/bar");
+    BTASSERT(http_server_find_route(&server, &request) == route_a);
+    BTASSERT(request.params.length == 0);
+
+    /* Longest prefix, independent of route order. */
+    strcpy(&request.path[0], "/api?x=/api/sensors/1");
+    BTASSERT(http_server_find_route(&server, &request) == route_b);
+    strcpy(&request.path[0], "/api/foo");
+    BTASSERT(http_server_find_route(&server, &request) == route_b);
+    BTASSERT(http_server_request_get_param(&request,
+                                           "group",
+                                           &buf[0],
+                                           sizeof(buf)) == 3);
+    strcpy(&request.path[0], "/apis");
+    BTASSERT(http_server_find_route(&server, &request) == route_a);
+
+    /* Path parameters. */
+    strcpy(&request.path[0], "/api/sensors/5?x=y");
+    BTASSERT(http_server_find_route(&server, &request) == route_c);
+    BTASSERT(request.params.length == 1);
+    BTASSERT(http_server_request_get_param(&request,
+                                           "id",
+                                           &buf[0],
+                                           sizeof(buf)) == 1);
+    BTASSERT(strcmp(&buf[0], "5") == 0);
+    BTASSERT(http_server_request_get_param(&request,
+                                           "i",
+                                           &buf[0],
+                                           sizeof(buf)) == -ENOENT);
+
+    strcpy(&request.path[0], "/api/sensors/12345678");
+    BTASSERT(http_server_find_route(&server, &request) == route_c);
+    BTASSERT(http_server_request_get_param(&request,
+                                           "id",
+                                           &buf[0],
+                                           sizeof(buf)) == -ENOMEM);
+
+    strcpy(&request.path[0], "/api/sensors/7/temperature/");
+    BTASSERT(http_server_find_route(&server, &request) == route_d);
+    BTASSERT(request.params.length == 2);
+    BTASSERT(http_server_request_get_param(&request,
+                                           "field",
+                                           &buf[0],
+                                           sizeof(buf)) == -ENOMEM);
+    BTASSERT(http_server_request_get_param(&request,
+                                           "id",
+                                           &buf[0],
+                                           sizeof(buf)) == 1);
+    BTASSERT(strcmp(&buf[0], "7") == 0);
+
+    /* Literal segments take precedence over parameters. */
+    strcpy(&request.path[0], "/api/sensors/all");
+    BTASSERT(http_server_find_route(&server, &request) == route_d);
+    BTASSERT(request.params.length == 0);
+
+    /* A parameter is tried if the literal segment next to it does
+       not lead to a deeper route. */
+    request.action = http_server_request_action_post_t;
+    strcpy(&request.path[0], "/api/sensors/all/temperature");
+    BTASSERT(http_server_find_route(&server, &request) == route_a);
+    BTASSERT(request.params.length == 2);
+    BTASSERT(http_server_request_get_param(&request,
+                                           "id",
+                                           &buf[0],
+                                           sizeof(buf)) == 3);
+    BTASSERT(strcmp(&buf[0], "all") == 0);
+
+    /* Method specific callbacks. */
+    strcpy(&request.path[0], "/api/sensors/all");
+    BTASSERT(http_server_find_route(&server, &request) == NULL);
+    strcpy(&request.path[0], "/api/sensors/7/temperature");
+    BTASSERT(http_server_find_route(&server, &request) == route_a);
+    strcpy(&request.path[0], "/api/sensors/7");
+    BTASSERT(http_server_find_route(&server, &request) == route_c);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+#define BENCHMARK_GROUPS_MAX 10
+#define BENCHMARK_RESOURCES_MAX 15
+#define BENCHMARK_ROUTES_MAX (BENCHMARK_GROUPS_MAX * BENCHMARK_RESOURCES_MAX)
+#define BENCHMARK_ITERATIONS 50
+
+/**
+ * The route lookup before the route trie; the first route that is a
+ * prefix of the path.
+ */
+static http_server_route_callback_t
+linear_find_route(const struct http_server_route_t *route_p,
+                  const char *path_p)
+{
+    while (route_p->path_p != NULL) {
+        if (strncmp(route_p->path_p, path_p, strlen(route_p->path_p)) == 0) {
+            return (route_p->callback);
+        }
+
+        route_p++;
+    }
+
+    return (NULL);
+}
+
+static int test_route_benchmark(void)
+{
+    static struct http_server_listener_t listener;
+    static struct http_server_connection_t connections[] = {
+        {
+            .thrd = {
+                .name_p = NULL
+            }
+        }
+    };
+    static struct http_server_route_t routes[BENCHMARK_ROUTES_MAX + 1];
+    static char paths[BENCHMARK_ROUTES_MAX][40];
+    static char requests[BENCHMARK_ROUTES_MAX][40];
+    static struct http_server_t server;
+    struct http_server_request_t request;
+    int i;
+    int j;
+    int k;
+    int start;
+    int linear;
+    int trie;
+
+    /* A REST API with 150 routes. */
+    for (i = 0; i < BENCHMARK_GROUPS_MAX; i++) {
+        for (j = 0; j < BENCHMARK_RESOURCES_MAX; j++) {
+            k = (i * BENCHMARK_RESOURCES_MAX + j);
+            std_sprintf(&paths[k][0],
+                        FSTR("/api/v1/group%d/resource%d"),
+                        i,
+                        j);
+            std_sprintf(&requests[k][0],
+                        FSTR("/api/v1/group%d/resource%d?id=%d"),
+                        i,
+                        j,
+                        k);
+            routes[k].path_p = &paths[k][0];
+            routes[k].callback = route_a;
+        }
+    }
+
+    routes[BENCHMARK_ROUTES_MAX].path_p = NULL;
+
+    BTASSERT(http_server_init(&server,
+                              &listener,
+                              connections,
+                              NULL,
+                              routes,
+                              request_404_not_found) == 0);
+
+    request.action = http_server_request_action_get_t;
+    start = time_micros();
+
+    for (i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        for (k = 0; k < BENCHMARK_ROUTES_MAX; k++) {
+            BTASSERT(linear_find_route(&routes[0], &requests[k][0]) == route_a);
+        }
+    }
+
+    linear = time_micros_elapsed(start, time_micros());
+    start = time_micros();
+
+    for (i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        for (k = 0; k < BENCHMARK_ROUTES_MAX; k++) {
+            strcpy(&request.path[0], &requests[k][0]);
+            BTASSERT(http_server_find_route(&server, &request) == route_a);
+        }
+    }
+
+    trie = time_micros_elapsed(start, time_micros());
+
+    std_printf(OSTR("%d routes: linear %d ns, trie %d ns per lookup\r\n"),
+               BENCHMARK_ROUTES_MAX,
+               (1000 * linear) / (BENCHMARK_ITERATIONS * BENCHMARK_ROUTES_MAX),
+               (1000 * trie) / (BENCHMARK_ITERATIONS * BENCHMARK_ROUTES_MAX));
+
+    return (0);
+}
+
+#endif
+
 static int test_stop(void)
 {
     BTASSERT(http_server_stop(&foo) == 0);
@@ -634,11 +1300,11 @@ static int test_https_stop(void)
 #if CONFIG_HTTP_SERVER_SSL == 1
     BTASSERT(http_server_stop(&foo) == 0);
 
-    BTASSERT(ssl_open_counter == 6);
-    BTASSERT(ssl_close_counter == 6);
-    BTASSERT(ssl_write_counter == 9);
-    BTASSERT(ssl_read_counter == 730);
-    BTASSERT(ssl_size_counter == 0);
+    BTASSERT(ssl_open_counter == 8);
+    BTASSERT(ssl_close_counter == 8);
+    BTASSERT(ssl_write_counter == 14);
+    BTASSERT(ssl_read_counter == 15);
+    BTASSERT(ssl_size_counter == 27);
 
     return (0);
 #else
@@ -654,10 +1320,24 @@ int main()
         { test_request_index_with_query_string, "test_request_index_with_query_string" },
         { test_request_auth, "test_request_auth" },
         { test_request_form, "test_request_form" },
+        { test_request_keep_alive, "test_request_keep_alive" },
+        { test_request_idle_timeout, "test_request_idle_timeout" },
+        { test_request_keep_alive_requests_max,
+          "test_request_keep_alive_requests_max" },
+        { test_request_pipelined, "test_request_pipelined" },
+        { test_request_unread_body, "test_request_unread_body" },
+        { test_request_sensor, "test_request_sensor" },
         { test_request_websocket, "test_request_websocket" },
         { test_request_no_route, "test_request_no_route" },
         { test_request_url_too_long, "test_request_url_too_long" },
         { test_request_header_field_too_long, "test_request_header_field_too_long" },
+#if defined(ARCH_LINUX)
+        { test_load, "test_load" },
+#endif
+        { test_routes, "test_routes" },
+#if defined(ARCH_LINUX)
+        { test_route_benchmark, "test_route_benchmark" },
+#endif
         { test_stop, "test_stop" },
         { test_https_start, "test_https_start" },
 #if CONFIG_HTTP_SERVER_SSL == 1
@@ -665,6 +1345,8 @@ int main()
         { test_request_index_with_query_string, "test_https_request_index_with_query_string" },
         { test_request_auth, "test_https_request_auth" },
         { test_request_form, "test_https_request_form" },
+        { test_request_keep_alive, "test_https_request_keep_alive" },
+        { test_request_pipelined, "test_https_request_pipelined" },
         { test_request_websocket, "test_https_request_websocket" },
         { test_request_no_route, "test_https_request_no_route" },
 #endif
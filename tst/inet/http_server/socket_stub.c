@@ -36,6 +36,20 @@ static char qinputbuf[256];
 static char qoutputbuf[256];
 static struct event_t accept_events;
 static struct event_t closed_events;
+static struct socket_t *accepted_socket_p = NULL;
+
+static void resume_if_polled(void)
+{
+    sys_lock();
+
+    if ((accepted_socket_p != NULL)
+        && (chan_is_polled_isr(&accepted_socket_p->base) == 1)) {
+        thrd_resume_isr(accepted_socket_p->base.reader_p, 0);
+        accepted_socket_p->base.reader_p = NULL;
+    }
+
+    sys_unlock();
+}
 
 static ssize_t read(void *self_p,
                     void *buf_p,
@@ -53,7 +67,7 @@ static ssize_t write(void *self_p,
 
 static size_t size(void *self_p)
 {
-    return (0);
+    return (queue_size(&qinput));
 }
 
 int socket_module_init()
@@ -114,7 +128,8 @@ int socket_accept(struct socket_t *self_p,
     uint32_t mask;
 
     chan_init(&accepted_p->base, read, write, size);
-    
+    accepted_socket_p = accepted_p;
+
     mask = 0x1;
     event_read(&accept_events, &mask, sizeof(mask));
 
@@ -153,6 +168,11 @@ ssize_t socket_read(struct socket_t *self_p,
     return (read(NULL, buf_p, size));
 }
 
+ssize_t socket_size(struct socket_t *self_p)
+{
+    return (size(NULL));
+}
+
 void socket_stub_init()
 {
     queue_init(&qinput, qinputbuf, sizeof(qinputbuf));
@@ -172,6 +192,7 @@ void socket_stub_accept()
 void socket_stub_input(void *buf_p, size_t size)
 {
     chan_write(&qinput, buf_p, size);
+    resume_if_polled();
 }
 
 void socket_stub_output(void *buf_p, size_t size)
@@ -200,4 +221,5 @@ void socket_stub_close_connection(void)
 {
     queue_stop(&qinput);
     queue_start(&qinput);
+    resume_if_polled();
 }
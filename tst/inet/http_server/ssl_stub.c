@@ -91,10 +91,9 @@ ssize_t ssl_socket_read(struct ssl_socket_t *self_p,
 
 ssize_t ssl_socket_size(struct ssl_socket_t *self_p)
 {
-    PRINT_FILE_LINE();
     BTASSERT(self_p != NULL);
 
     ssl_size_counter++;
 
-    return (0);
+    return (socket_size(NULL));
 }
@@ -43,7 +43,7 @@ static struct queue_t qserverout;
 static struct queue_t qserverin;
 static char qoutbuf[64];
 static char qinbuf[64];
-static char qserveroutbuf[64];
+static char qserveroutbuf[256];
 static char qserverinbuf[64];
 static struct thrd_t *self_p;
 
@@ -82,6 +82,8 @@ static void *server_main(void *arg_p)
 static char published_topic[16];
 static uint8_t published_message[16];
 static size_t published_message_size;
+static int published_count;
+static int error_count;
 
 static size_t on_publish(struct mqtt_client_t *client_p,
                          const char *topic_p,
@@ -95,6 +97,7 @@ static size_t on_publish(struct mqtt_client_t *client_p,
     strncpy(&published_topic[0], topic_p, sizeof(published_topic));
     chan_read(chin_p, &published_message[0], size);
     published_message_size = size;
+    published_count++;
 
     thrd_resume(self_p, 0);
 
@@ -105,6 +108,55 @@ static int on_error(struct mqtt_client_t *client_p,
                     int error)
 {
     std_printf(FSTR("error = %d\r\n"), error);
+    error_count++;
+
+    return (0);
+}
+
+/**
+ * Prepare the server to read given number of bytes written by the
+ * client.
+ */
+static void server_read(size_t size)
+{
+    struct message_t message;
+
+    message.buf_p = NULL;
+    message.size = size;
+    queue_write(&qserverin, &message, sizeof(message));
+}
+
+/**
+ * Prepare the server to write given packet to the client.
+ */
+static void server_write(uint8_t *buf_p, size_t size)
+{
+    struct message_t message;
+
+    message.buf_p = buf_p;
+    message.size = size;
+    queue_write(&qserverin, &message, sizeof(message));
+}
+
+/**
+ * A ping round trip. All packets written by the server before the
+ * ping response have been handled by the client when this function
+ * returns.
+ */
+static int ping(void)
+{
+    uint8_t buf[2];
+
+    server_read(2);
+    server_write((uint8_t *)"\xd0\x00", 2);
+
+    if (mqtt_client_ping(&client) != 0) {
+        return (-1);
+    }
+
+    if (queue_read(&qserverout, buf, 2) != 2) {
+        return (-1);
+    }
 
     return (0);
 }
@@ -332,7 +384,7 @@ static int test_subscribe(void)
     buf[0] = (9 << 4);
     buf[1] = 3;
     buf[2] = 0;
-    buf[3] = 1;
+    buf[3] = 2;
     buf[4] = 0;
     message.buf_p = buf;
     message.size = 5;
@@ -348,7 +400,7 @@ static int test_subscribe(void)
     BTASSERT(buf[0] == ((8 << 4) | 2));
     BTASSERT(buf[1] == 12);
     BTASSERT(buf[2] == 0);
-    BTASSERT(buf[3] == 1);
+    BTASSERT(buf[3] == 2);
     BTASSERT(buf[4] == 0);
     BTASSERT(buf[5] == 7);
     BTASSERT(buf[6] == 'f');
@@ -393,7 +445,7 @@ static int test_subscribe(void)
     buf[0] = (11 << 4);
     buf[1] = 2;
     buf[2] = 0;
-    buf[3] = 2;
+    buf[3] = 3;
     message.buf_p = buf;
     message.size = 4;
     BTASSERT(queue_write(&qserverin, &message, sizeof(message)) == sizeof(message));
@@ -407,7 +459,7 @@ static int test_subscribe(void)
     BTASSERT(buf[0] == ((10 << 4) | 2));
     BTASSERT(buf[1] == 11);
     BTASSERT(buf[2] == 0);
-    BTASSERT(buf[3] == 2);
+    BTASSERT(buf[3] == 3);
     BTASSERT(buf[4] == 0);
     BTASSERT(buf[5] == 7);
     BTASSERT(buf[6] == 'f');
@@ -562,6 +614,393 @@ static int test_incoming_publish_qos2(void)
     BTASSERT(buf[2] == 0);
     BTASSERT(buf[3] == 1);
 
+    /* The server retransmits the publish message with the DUP flag
+       set. It is acknowledged again but not given to the
+       application. */
+    buf[0] = ((3 << 4) | 0x8 | (2 << 1));
+    buf[1] = 14;
+    buf[2] = 0;
+    buf[3] = 7;
+    memcpy(&buf[4], "foo/bar", 7);
+    buf[11] = 0;
+    buf[12] = 1;
+    memcpy(&buf[13], "fie", 3);
+    published_count = 0;
+    server_write(buf, 16);
+    server_read(4);
+    BTASSERT(queue_read(&qserverout, buf, 4) == 4);
+    BTASSERT(buf[0] == (5 << 4));
+    BTASSERT(buf[1] == 2);
+    BTASSERT(buf[2] == 0);
+    BTASSERT(buf[3] == 1);
+
+    /* Release the message. */
+    buf[0] = ((6 << 4) | 2);
+    buf[1] = 2;
+    buf[2] = 0;
+    buf[3] = 1;
+    server_write(buf, 4);
+    server_read(4);
+    BTASSERT(queue_read(&qserverout, buf, 4) == 4);
+    BTASSERT(buf[0] == (7 << 4));
+    BTASSERT(buf[1] == 2);
+    BTASSERT(buf[2] == 0);
+    BTASSERT(buf[3] == 1);
+
+    BTASSERT(published_count == 0);
+    BTASSERT(error_count == 0);
+
+    return (0);
+}
+
+static int test_publish_qos0(void)
+{
+    struct mqtt_application_message_t message;
+    uint8_t buf[8];
+
+    server_read(8);
+
+    message.topic.buf_p = "a";
+    message.topic.size = 1;
+    message.payload.buf_p = "01234";
+    message.payload.size = 3;
+    message.qos = mqtt_qos_0_t;
+    BTASSERT(mqtt_client_publish(&client, &message) == 0);
+
+    BTASSERT(queue_read(&qserverout, buf, 8) == 8);
+    BTASSERTM(buf, "\x30\x06\x00\x01" "a012", 8);
+
+    return (0);
+}
+
+static int test_publish_window(void)
+{
+    struct mqtt_application_message_t messages[5];
+    uint8_t buf[32];
+    int i;
+
+    /* Fill the in-flight window without receiving any
+       acknowledgements. */
+    server_read(32);
+
+    for (i = 0; i < 5; i++) {
+        messages[i].topic.buf_p = "a";
+        messages[i].topic.size = 1;
+        messages[i].payload.buf_p = &"01234"[i];
+        messages[i].payload.size = 1;
+        messages[i].qos = mqtt_qos_1_t;
+    }
+
+    for (i = 0; i < 4; i++) {
+        BTASSERT(mqtt_client_publish(&client, &messages[i]) == 0);
+    }
+
+    BTASSERT(queue_read(&qserverout, buf, 32) == 32);
+    BTASSERTM(&buf[0], "\x32\x06\x00\x01" "a\x00\x04" "0", 8);
+    BTASSERTM(&buf[8], "\x32\x06\x00\x01" "a\x00\x05" "1", 8);
+    BTASSERTM(&buf[16], "\x32\x06\x00\x01" "a\x00\x06" "2", 8);
+    BTASSERTM(&buf[24], "\x32\x06\x00\x01" "a\x00\x07" "3", 8);
+
+    /* The window is full. Acknowledge the second packet to make room
+       for the fifth. */
+    server_write((uint8_t *)"\x40\x02\x00\x05", 4);
+    server_read(8);
+    BTASSERT(mqtt_client_publish(&client, &messages[4]) == 0);
+    BTASSERT(queue_read(&qserverout, buf, 8) == 8);
+    BTASSERTM(&buf[0], "\x32\x06\x00\x01" "a\x00\x08" "4", 8);
+
+    /* Acknowledge the rest out of order. */
+    server_write((uint8_t *)"\x40\x02\x00\x08", 4);
+    server_write((uint8_t *)"\x40\x02\x00\x04", 4);
+    server_write((uint8_t *)"\x40\x02\x00\x07", 4);
+    server_write((uint8_t *)"\x40\x02\x00\x06", 4);
+    BTASSERT(ping() == 0);
+
+    BTASSERT(error_count == 0);
+
+    return (0);
+}
+
+static int test_publish_qos2(void)
+{
+    struct mqtt_application_message_t message;
+    uint8_t buf[8];
+
+    server_read(8);
+
+    message.topic.buf_p = "a";
+    message.topic.size = 1;
+    message.payload.buf_p = "5";
+    message.payload.size = 1;
+    message.qos = mqtt_qos_2_t;
+    BTASSERT(mqtt_client_publish(&client, &message) == 0);
+
+    BTASSERT(queue_read(&qserverout, buf, 8) == 8);
+    BTASSERTM(&buf[0], "\x34\x06\x00\x01" "a\x00\x09" "5", 8);
+
+    /* Received, the client releases the message. */
+    server_write((uint8_t *)"\x50\x02\x00\x09", 4);
+    server_read(4);
+    BTASSERT(queue_read(&qserverout, buf, 4) == 4);
+    BTASSERTM(&buf[0], "\x62\x02\x00\x09", 4);
+
+    /* Complete. */
+    server_write((uint8_t *)"\x70\x02\x00\x09", 4);
+    BTASSERT(ping() == 0);
+
+    BTASSERT(error_count == 0);
+
+    return (0);
+}
+
+static int test_publish_retransmit(void)
+{
+    struct mqtt_application_message_t message;
+    uint8_t buf[8];
+
+    server_read(8);
+
+    message.topic.buf_p = "a";
+    message.topic.size = 1;
+    message.payload.buf_p = "6";
+    message.payload.size = 1;
+    message.qos = mqtt_qos_1_t;
+    BTASSERT(mqtt_client_publish(&client, &message) == 0);
+
+    BTASSERT(queue_read(&qserverout, buf, 8) == 8);
+    BTASSERTM(&buf[0], "\x32\x06\x00\x01" "a\x00\x0a" "6", 8);
+
+    /* Not acknowledged in time, retransmitted with the DUP flag
+       set. */
+    server_read(8);
+    BTASSERT(queue_read(&qserverout, buf, 8) == 8);
+    BTASSERTM(&buf[0], "\x3a\x06\x00\x01" "a\x00\x0a" "6", 8);
+
+    server_write((uint8_t *)"\x40\x02\x00\x0a", 4);
+    BTASSERT(ping() == 0);
+
+    BTASSERT(error_count == 0);
+
+    return (0);
+}
+
+static int test_publish_big(void)
+{
+    struct mqtt_application_message_t message;
+    uint8_t payload[150];
+    uint8_t buf[158];
+
+    /* Bigger than the in-flight packet buffer, so the call blocks
+       until the packet is acknowledged. */
+    server_read(158);
+    server_write((uint8_t *)"\x40\x02\x00\x0b", 4);
+
+    memset(&payload[0], 'x', sizeof(payload));
+    message.topic.buf_p = "a";
+    message.topic.size = 1;
+    message.payload.buf_p = &payload[0];
+    message.payload.size = sizeof(payload);
+    message.qos = mqtt_qos_1_t;
+    BTASSERT(mqtt_client_publish(&client, &message) == 0);
+
+    BTASSERT(queue_read(&qserverout, buf, 158) == 158);
+    BTASSERTM(&buf[0], "\x32\x9b\x01\x00\x01" "a\x00\x0b", 8);
+    BTASSERTM(&buf[8], &payload[0], sizeof(payload));
+
+    BTASSERT(error_count == 0);
+
+    return (0);
+}
+
+static struct mqtt_client_topic_node_t nodes[8];
+static struct mqtt_client_subscription_t subscriptions[5];
+static struct mqtt_client_subscription_t *matched_subscription_p;
+static size_t matched_topic_size;
+static uint8_t matched_payload[4];
+static uint8_t publish_buf[320];
+static char topic_buf[301];
+
+static size_t on_subscription_publish(struct mqtt_client_t *client_p,
+                                      struct mqtt_client_subscription_t *subscription_p,
+                                      const char *topic_p,
+                                      void *chin_p,
+                                      size_t size)
+{
+    matched_subscription_p = subscription_p;
+    matched_topic_size = strlen(topic_p);
+
+    /* Only read the first byte. The client discards the rest. */
+    chan_read(chin_p, &matched_payload[0], 1);
+
+    thrd_resume(self_p, 0);
+
+    return (1);
+}
+
+/**
+ * Create a QoS 0 publish packet with given topic and payload "fie".
+ */
+static size_t create_publish(uint8_t *buf_p, const char *topic_p)
+{
+    size_t topic_size;
+    size_t size;
+    size_t pos;
+
+    topic_size = strlen(topic_p);
+    size = (2 + topic_size + 3);
+    buf_p[0] = (3 << 4);
+
+    if (size < 128) {
+        buf_p[1] = size;
+        pos = 2;
+    } else {
+        buf_p[1] = (0x80 | (size % 128));
+        buf_p[2] = (size / 128);
+        pos = 3;
+    }
+
+    buf_p[pos++] = (topic_size >> 8);
+    buf_p[pos++] = topic_size;
+    memcpy(&buf_p[pos], topic_p, topic_size);
+    pos += topic_size;
+    memcpy(&buf_p[pos], "fie", 3);
+
+    return (pos + 3);
+}
+
+/**
+ * Publish given topic from the server and return the subscription
+ * it matched, or NULL if it was given to the on-publish callback of
+ * the client.
+ */
+static struct mqtt_client_subscription_t *server_publish(const char *topic_p)
+{
+    matched_subscription_p = NULL;
+    published_topic[0] = '\0';
+    server_write(&publish_buf[0], create_publish(&publish_buf[0], topic_p));
+
+    /* Resumed from the callback. */
+    thrd_suspend(NULL);
+
+    /* Wait for the server to write the whole packet. */
+    if (ping() != 0) {
+        return (NULL);
+    }
+
+    return (matched_subscription_p);
+}
+
+static int add_subscription(int index,
+                            const char *filter_p,
+                            uint8_t packet_id)
+{
+    uint8_t buf[32];
+    uint8_t suback[5];
+    size_t filter_size;
+
+    filter_size = strlen(filter_p);
+    BTASSERT(mqtt_client_subscription_init(&subscriptions[index],
+                                           filter_p,
+                                           mqtt_qos_0_t,
+                                           on_subscription_publish,
+                                           NULL) == 0);
+
+    server_read(filter_size + 7);
+    suback[0] = (9 << 4);
+    suback[1] = 3;
+    suback[2] = 0;
+    suback[3] = packet_id;
+    suback[4] = 0;
+    server_write(&suback[0], 5);
+
+    BTASSERT(mqtt_client_add_subscription(&client,
+                                          &subscriptions[index]) == 0);
+
+    BTASSERT(queue_read(&qserverout, buf, filter_size + 7)
+             == filter_size + 7);
+    BTASSERTI(buf[0], ==, ((8 << 4) | 2));
+    BTASSERTI(buf[1], ==, filter_size + 5);
+    BTASSERTI(buf[3], ==, packet_id);
+    BTASSERTM(&buf[6], filter_p, filter_size);
+
+    return (0);
+}
+
+static int test_subscriptions(void)
+{
+    struct mqtt_client_subscription_t subscription;
+    uint8_t buf[11];
+    char topic[301];
+
+    BTASSERT(mqtt_client_init_subscriptions(&client,
+                                            &nodes[0],
+                                            membersof(nodes)) == 0);
+
+    BTASSERT(add_subscription(0, "foo/bar", 12) == 0);
+    BTASSERT(add_subscription(1, "foo/+", 13) == 0);
+    BTASSERT(add_subscription(2, "foo/#", 14) == 0);
+    BTASSERT(add_subscription(3, "#", 15) == 0);
+    BTASSERT(add_subscription(4, "long/+", 16) == 0);
+
+    /* Already subscribed and bad filters. */
+    BTASSERT(mqtt_client_subscription_init(&subscription,
+                                           "foo/bar",
+                                           mqtt_qos_0_t,
+                                           on_subscription_publish,
+                                           NULL) == 0);
+    BTASSERT(mqtt_client_add_subscription(&client, &subscription)
+             == -EEXIST);
+    subscription.filter.buf_p = "foo/b#";
+    subscription.filter.size = 6;
+    BTASSERT(mqtt_client_add_subscription(&client, &subscription)
+             == -EINVAL);
+    subscription.filter.buf_p = "#/foo";
+    subscription.filter.size = 5;
+    BTASSERT(mqtt_client_add_subscription(&client, &subscription)
+             == -EINVAL);
+
+    /* The most specific filter is matched. */
+    BTASSERT(server_publish("foo/bar") == &subscriptions[0]);
+    BTASSERTM(&matched_payload[0], "f", 1);
+    BTASSERT(server_publish("foo/baz") == &subscriptions[1]);
+    BTASSERT(server_publish("foo/baz/x") == &subscriptions[2]);
+    BTASSERT(server_publish("foo") == &subscriptions[2]);
+    BTASSERT(server_publish("bar") == &subscriptions[3]);
+    BTASSERT(server_publish("foo//") == &subscriptions[2]);
+
+    /* Wildcards do not match topics starting with '$'. */
+    BTASSERT(server_publish("$SYS/x") == NULL);
+    BTASSERTM(&published_topic[0], "$SYS/x", 7);
+
+    /* A topic that does not fit in the default topic buffer is
+       discarded. */
+    memset(&topic[0], 'x', 300);
+    memcpy(&topic[0], "long/", 5);
+    topic[300] = '\0';
+    server_write(&publish_buf[0], create_publish(&publish_buf[0], &topic[0]));
+    BTASSERT(ping() == 0);
+    BTASSERT(error_count == 1);
+    error_count = 0;
+
+    /* Long topics are received into the application's topic
+       buffer. */
+    BTASSERT(mqtt_client_set_topic_buffer(&client,
+                                          &topic_buf[0],
+                                          sizeof(topic_buf)) == 0);
+    BTASSERT(server_publish(&topic[0]) == &subscriptions[4]);
+    BTASSERT(matched_topic_size == 300);
+
+    /* Remove a subscription. */
+    server_read(11);
+    server_write((uint8_t *)"\xb0\x02\x00\x11", 4);
+    BTASSERT(mqtt_client_remove_subscription(&client,
+                                             &subscriptions[1]) == 0);
+    BTASSERT(queue_read(&qserverout, buf, 11) == 11);
+    BTASSERTM(&buf[0], "\xa2\x09\x00\x11\x00\x05" "foo/+", 11);
+
+    BTASSERT(server_publish("foo/baz") == &subscriptions[2]);
+    BTASSERT(server_publish("foo/bar") == &subscriptions[0]);
+
     return (0);
 }
 
@@ -596,6 +1035,12 @@ int main()
         { test_incoming_publish_qos0, "test_incoming_publish_qos0" },
         { test_incoming_publish_qos1, "test_incoming_publish_qos1" },
         { test_incoming_publish_qos2, "test_incoming_publish_qos2" },
+        { test_publish_qos0, "test_publish_qos0" },
+        { test_publish_window, "test_publish_window" },
+        { test_publish_qos2, "test_publish_qos2" },
+        { test_publish_retransmit, "test_publish_retransmit" },
+        { test_publish_big, "test_publish_big" },
+        { test_subscriptions, "test_subscriptions" },
         { test_disconnect, "test_disconnect" },
         { NULL, NULL }
     };
@@ -118,6 +118,299 @@ static int test_truncate_input(void)
     return (0);
 }
 
+struct sink_t {
+    struct chan_t base;
+    uint8_t buf[4096];
+    size_t size;
+    int number_of_writes;
+};
+
+static struct sink_t sink;
+
+static ssize_t sink_write(void *chan_p, const void *buf_p, size_t size)
+{
+    struct sink_t *self_p;
+
+    self_p = chan_p;
+
+    if (self_p->size + size <= sizeof(self_p->buf)) {
+        memcpy(&self_p->buf[self_p->size], buf_p, size);
+    }
+
+    self_p->size += size;
+    self_p->number_of_writes++;
+
+    return (size);
+}
+
+static void sink_init(void)
+{
+    chan_init(&sink.base, chan_read_null, sink_write, chan_size_null);
+    sink.size = 0;
+    sink.number_of_writes = 0;
+}
+
+static uint8_t random_byte(uint32_t *seed_p)
+{
+    *seed_p = (*seed_p * 1103515245 + 12345);
+
+    return (*seed_p >> 16);
+}
+
+/* Every 16th byte is a special character. */
+static void random_packet(uint8_t *buf_p, size_t size, uint32_t *seed_p)
+{
+    static const uint8_t specials[] = { 0xc0, 0xdb, 0xdc, 0xdd };
+    size_t i;
+    uint8_t value;
+
+    for (i = 0; i < size; i++) {
+        value = random_byte(seed_p);
+
+        if ((value & 0xf) == 0) {
+            value = specials[value >> 6];
+        }
+
+        buf_p[i] = value;
+    }
+}
+
+static int test_output_single_write(void)
+{
+    struct slip_t slip_out;
+    /* Two escaped bytes and the frame ends. */
+    uint8_t packet[CONFIG_SLIP_OUTPUT_BUFFER_SIZE - 4];
+
+    sink_init();
+    BTASSERT(slip_init(&slip_out,
+                       &slip_buf[0],
+                       sizeof(slip_buf),
+                       &sink) == 0);
+    memset(&packet[0], 'a', sizeof(packet));
+    packet[3] = 0xc0;
+    packet[7] = 0xdb;
+
+    /* A frame that fits in the output buffer is written at once. */
+    BTASSERT(chan_write(slip_get_output_channel(&slip_out),
+                        &packet[0],
+                        sizeof(packet)) == sizeof(packet));
+    BTASSERT(sink.number_of_writes == 1);
+
+    return (0);
+}
+
+static int test_output_input_buffer(void)
+{
+    struct slip_t slip_out;
+    struct slip_t slip_in;
+    uint8_t packet[700];
+    uint8_t frame[sizeof(packet)];
+    uint32_t seed;
+    size_t size;
+    size_t pos;
+    size_t consumed;
+    ssize_t res;
+
+    seed = 2;
+
+    for (size = 1; size < sizeof(packet); size += 33) {
+        sink_init();
+        BTASSERT(slip_init(&slip_out, &frame[0], sizeof(frame), &sink) == 0);
+        BTASSERT(slip_init(&slip_in, &frame[0], sizeof(frame), &sink) == 0);
+        random_packet(&packet[0], size, &seed);
+        BTASSERT(chan_write(slip_get_output_channel(&slip_out),
+                            &packet[0],
+                            size) == size);
+        BTASSERT(sink.size <= sizeof(sink.buf));
+        BTASSERT(sink.buf[0] == 0xc0);
+        BTASSERT(sink.buf[sink.size - 1] == 0xc0);
+        BTASSERT(memchr(&sink.buf[1], 0xc0, sink.size - 2) == NULL);
+
+        /* Decode it in pieces of different sizes. */
+        pos = 0;
+        res = 0;
+
+        while (res == 0) {
+            BTASSERT(pos < sink.size);
+            res = slip_input_buffer(&slip_in,
+                                    &sink.buf[pos],
+                                    MIN(1 + size / 7, sink.size - pos),
+                                    &consumed);
+            pos += consumed;
+        }
+
+        BTASSERT(res == size);
+        BTASSERT(pos == sink.size);
+        BTASSERT(memcmp(&frame[0], &packet[0], size) == 0);
+    }
+
+    return (0);
+}
+
+/**
+ * Input random data, containing frames, protocol errors and too long
+ * frames, one byte at a time and in bulk. The results must be equal.
+ */
+static int test_input_buffer_equal_to_input(void)
+{
+    struct slip_t slip_bytes;
+    struct slip_t slip_bulk;
+    uint8_t bytes_buf[32];
+    uint8_t bulk_buf[32];
+    uint8_t stream[2048];
+    uint32_t seed;
+    size_t i;
+    size_t pos;
+    size_t consumed;
+    ssize_t res;
+    ssize_t expected;
+    int frames;
+
+    BTASSERT(slip_init(&slip_bytes,
+                       &bytes_buf[0],
+                       sizeof(bytes_buf),
+                       &sink) == 0);
+    BTASSERT(slip_init(&slip_bulk,
+                       &bulk_buf[0],
+                       sizeof(bulk_buf),
+                       &sink) == 0);
+    seed = 3;
+    random_packet(&stream[0], sizeof(stream), &seed);
+    pos = 0;
+    frames = 0;
+
+    for (i = 0; i < sizeof(stream); i++) {
+        expected = slip_input(&slip_bytes, stream[i]);
+
+        if (expected == 0) {
+            continue;
+        }
+
+        res = slip_input_buffer(&slip_bulk,
+                                &stream[pos],
+                                sizeof(stream) - pos,
+                                &consumed);
+        BTASSERT(res == expected);
+        BTASSERT(pos + consumed == i + 1);
+        pos += consumed;
+
+        if (res > 0) {
+            BTASSERT(memcmp(&bulk_buf[0], &bytes_buf[0], res) == 0);
+            frames++;
+        }
+    }
+
+    BTASSERT(slip_input_buffer(&slip_bulk,
+                               &stream[pos],
+                               sizeof(stream) - pos,
+                               &consumed) == 0);
+    BTASSERT(pos + consumed == sizeof(stream));
+    BTASSERT(frames > 10);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+#define BENCHMARK_PACKET_SIZE                                    256
+#define BENCHMARK_PACKETS                                     100000
+
+static unsigned long elapsed_ms(struct time_t *start_p)
+{
+    struct time_t stop;
+    struct time_t elapsed;
+
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, start_p);
+
+    return (elapsed.seconds * 1000 + elapsed.nanoseconds / 1000000);
+}
+
+static unsigned long mb_per_second(unsigned long ms)
+{
+    return ((unsigned long)((uint64_t)BENCHMARK_PACKET_SIZE
+                            * BENCHMARK_PACKETS
+                            * 1000
+                            / (1024 * 1024)
+                            / MAX(ms, 1)));
+}
+
+static int test_benchmark(void)
+{
+    struct slip_t slip_out;
+    struct slip_t slip_in;
+    uint8_t packet[BENCHMARK_PACKET_SIZE];
+    uint8_t frame[BENCHMARK_PACKET_SIZE];
+    struct time_t start;
+    unsigned long output_ms;
+    unsigned long input_ms;
+    unsigned long input_buffer_ms;
+    size_t encoded_size;
+    size_t pos;
+    size_t consumed;
+    uint32_t seed;
+    int i;
+
+    /* Mostly binary data with a few special characters. */
+    seed = 4;
+
+    for (i = 0; i < sizeof(packet); i++) {
+        packet[i] = random_byte(&seed);
+    }
+
+    sink_init();
+    BTASSERT(slip_init(&slip_out, &frame[0], sizeof(frame), &sink) == 0);
+    BTASSERT(slip_init(&slip_in, &frame[0], sizeof(frame), &sink) == 0);
+
+    time_get(&start);
+
+    for (i = 0; i < BENCHMARK_PACKETS; i++) {
+        sink.size = 0;
+        BTASSERT(chan_write(slip_get_output_channel(&slip_out),
+                            &packet[0],
+                            sizeof(packet)) == sizeof(packet));
+    }
+
+    output_ms = elapsed_ms(&start);
+    encoded_size = sink.size;
+    std_printf(OSTR("Output of %d frames took %d writes.\r\n"),
+               BENCHMARK_PACKETS,
+               sink.number_of_writes);
+
+    time_get(&start);
+
+    for (i = 0; i < BENCHMARK_PACKETS; i++) {
+        for (pos = 0; pos < encoded_size - 1; pos++) {
+            BTASSERT(slip_input(&slip_in, sink.buf[pos]) == 0);
+        }
+
+        BTASSERT(slip_input(&slip_in, sink.buf[pos]) == sizeof(packet));
+    }
+
+    input_ms = elapsed_ms(&start);
+    time_get(&start);
+
+    for (i = 0; i < BENCHMARK_PACKETS; i++) {
+        BTASSERT(slip_input_buffer(&slip_in,
+                                   &sink.buf[0],
+                                   encoded_size,
+                                   &consumed) == sizeof(packet));
+        BTASSERT(consumed == encoded_size);
+    }
+
+    input_buffer_ms = elapsed_ms(&start);
+
+    std_printf(OSTR("Output: %lu MB/s, slip_input(): %lu MB/s, "
+                    "slip_input_buffer(): %lu MB/s.\r\n"),
+               mb_per_second(output_ms),
+               mb_per_second(input_ms),
+               mb_per_second(input_buffer_ms));
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -126,6 +419,13 @@ int main()
         { test_output, "test_output" },
         { test_bad_input, "test_bad_input" },
         { test_truncate_input, "test_truncate_input" },
+        { test_output_single_write, "test_output_single_write" },
+        { test_output_input_buffer, "test_output_input_buffer" },
+        { test_input_buffer_equal_to_input,
+          "test_input_buffer_equal_to_input" },
+#if defined(ARCH_LINUX)
+        { test_benchmark, "test_benchmark" },
+#endif
         { NULL, NULL }
     };
 
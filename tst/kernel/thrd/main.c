@@ -93,6 +93,34 @@ int test_suspend_resume(void)
     return (0);
 }
 
+int test_suspend_zero_timeout(void)
+{
+    static char buf[4096];
+    struct queue_t queue;
+    struct time_t timeout;
+    char line[40];
+    ssize_t size;
+
+    /* Returns immediately, without suspending the thread. */
+    timeout.seconds = 0;
+    timeout.nanoseconds = 0;
+    BTASSERT(thrd_suspend(&timeout) == -ETIMEDOUT);
+
+    /* This thread is still listed as the current thread. */
+    BTASSERT(queue_init(&queue, &buf[0], sizeof(buf)) == 0);
+    strcpy(&line[0], "/kernel/thrd/list");
+    BTASSERT(fs_call(&line[0], NULL, &queue, NULL) == 0);
+    size = queue_size(&queue);
+    BTASSERT(size > 0);
+    BTASSERT(size < sizeof(buf));
+    BTASSERT(queue_read(&queue, &buf[0], size) == size);
+    buf[size] = '\0';
+    std_sprintf(&line[0], FSTR("%20s %12s"), "main", "current");
+    BTASSERT(strstr(&buf[0], &line[0]) != NULL);
+
+    return (0);
+}
+
 int test_terminate(void)
 {
     struct thrd_t *thrd_p;
@@ -393,12 +421,352 @@ int test_prio_list(void)
     return (0);
 }
 
+#if defined(ARCH_LINUX)
+#    define READY_QUEUE_THREADS_MAX                          40
+#else
+#    define READY_QUEUE_THREADS_MAX                           8
+#endif
+
+#define READY_QUEUE_ROUNDS                                  100
+
+#if defined(ARCH_ESP32)
+static THRD_STACK(ready_queue_order_stacks[4], 512);
+static THRD_STACK(ready_queue_stacks[READY_QUEUE_THREADS_MAX], 512);
+#elif defined(ARCH_ARM64)
+static THRD_STACK(ready_queue_order_stacks[4], 4096);
+static THRD_STACK(ready_queue_stacks[READY_QUEUE_THREADS_MAX], 4096);
+#else
+static THRD_STACK(ready_queue_order_stacks[4], 256);
+static THRD_STACK(ready_queue_stacks[READY_QUEUE_THREADS_MAX], 256);
+#endif
+
+static struct thrd_t *ready_queue_threads[READY_QUEUE_THREADS_MAX];
+static char ready_queue_order[4];
+static int ready_queue_order_length;
+
+static void *ready_queue_order_main(void *arg_p)
+{
+    ready_queue_order[ready_queue_order_length++] = (char)(uintptr_t)arg_p;
+
+    return (NULL);
+}
+
+static void *ready_queue_main(void *arg_p)
+{
+    thrd_set_name("ready_queue");
+
+    while (1) {
+        thrd_suspend(NULL);
+    }
+
+    return (NULL);
+}
+
+int test_ready_queue(void)
+{
+    int i;
+    int prio;
+    struct thrd_t *thrd_p;
+
+    /* Threads with the same priority are scheduled in FIFO order,
+       after all higher priority threads. */
+    prio = thrd_get_prio();
+    ready_queue_order_length = 0;
+
+    for (i = 0; i < 3; i++) {
+        thrd_p = thrd_spawn(ready_queue_order_main,
+                            (void *)(uintptr_t)('a' + i),
+                            prio + (i == 2 ? 1 : 2),
+                            ready_queue_order_stacks[i],
+                            sizeof(ready_queue_order_stacks[i]));
+        BTASSERT(thrd_p != NULL);
+    }
+
+    thrd_p = thrd_spawn(ready_queue_order_main,
+                        (void *)(uintptr_t)'d',
+                        prio + 2,
+                        ready_queue_order_stacks[3],
+                        sizeof(ready_queue_order_stacks[3]));
+    BTASSERT(thrd_p != NULL);
+
+    /* Lower this threads' priority to let all spawned threads run. */
+    BTASSERT(thrd_set_prio(thrd_self(), prio + 3) == 0);
+    BTASSERT(thrd_yield() == 0);
+    BTASSERT(thrd_set_prio(thrd_self(), prio) == 0);
+
+    BTASSERTI(ready_queue_order_length, ==, 4);
+    BTASSERTM(&ready_queue_order[0], "cabd", 4);
+
+    return (0);
+}
+
+int test_ready_queue_benchmark(void)
+{
+    int i;
+    int round;
+    int start;
+    int stop;
+    long elapsed;
+
+    /* Spawn threads with higher priority than this thread. They
+       suspend themselves immediately. */
+    for (i = 0; i < READY_QUEUE_THREADS_MAX; i++) {
+        ready_queue_threads[i] = thrd_spawn(ready_queue_main,
+                                            NULL,
+                                            -100 + i,
+                                            ready_queue_stacks[i],
+                                            sizeof(ready_queue_stacks[i]));
+        BTASSERT(ready_queue_threads[i] != NULL);
+    }
+
+    BTASSERT(thrd_yield() == 0);
+
+    elapsed = 0;
+
+    for (round = 0; round < READY_QUEUE_ROUNDS; round++) {
+        /* Resume all threads in priority order, which is the worst
+           case for the sorted list, and only measure the time it
+           takes to push them onto the ready queue. */
+        start = time_micros();
+
+        for (i = 0; i < READY_QUEUE_THREADS_MAX; i++) {
+            BTASSERT(thrd_resume(ready_queue_threads[i], 0) == 0);
+        }
+
+        stop = time_micros();
+        elapsed += time_micros_elapsed(start, stop);
+
+        /* Let all resumed threads run and suspend again. */
+        BTASSERT(thrd_yield() == 0);
+    }
+
+    std_printf(OSTR("Resumed %d threads %d times in %ld us "
+                    "(ready queue bitmap: %d).\r\n"),
+               READY_QUEUE_THREADS_MAX,
+               READY_QUEUE_ROUNDS,
+               elapsed,
+               CONFIG_THRD_READY_QUEUE_BITMAP);
+
+    for (i = 0; i < READY_QUEUE_THREADS_MAX; i++) {
+        BTASSERT(thrd_terminate(ready_queue_threads[i]) == 0);
+    }
+
+    return (0);
+}
+
+#if CONFIG_THRD_TRACE == 1
+
+#if defined(ARCH_ESP32)
+static THRD_STACK(trace_stack, 512);
+static THRD_STACK(trace_long_sleep_stack, 512);
+#elif defined(ARCH_ARM64)
+static THRD_STACK(trace_stack, 4096);
+static THRD_STACK(trace_long_sleep_stack, 4096);
+#else
+static THRD_STACK(trace_stack, 256);
+static THRD_STACK(trace_long_sleep_stack, 256);
+#endif
+
+static struct sem_t trace_sem;
+static struct thrd_trace_event_t trace_events[CONFIG_THRD_TRACE_EVENTS_MAX];
+static char trace_output[16384];
+static size_t trace_output_size;
+
+static void *trace_main(void *arg_p)
+{
+    thrd_set_name("trace");
+    sem_take(&trace_sem, NULL);
+    thrd_sleep_ms(10);
+
+    return (NULL);
+}
+
+static ssize_t trace_output_write(void *self_p,
+                                  const void *buf_p,
+                                  size_t size)
+{
+    size_t left;
+
+    left = (sizeof(trace_output) - trace_output_size - 1);
+
+    if (size > left) {
+        size = left;
+    }
+
+    memcpy(&trace_output[trace_output_size], buf_p, size);
+    trace_output_size += size;
+    trace_output[trace_output_size] = '\0';
+
+    return (size);
+}
+
+int test_trace(void)
+{
+    struct thrd_t *thrd_p;
+    struct thrd_trace_statistics_t statistics;
+    struct thrd_trace_event_t *event_p;
+    struct chan_t output;
+    ssize_t length;
+    ssize_t i;
+    int woken_by_main;
+    int terminated;
+    char command[64];
+
+    BTASSERT(sem_init(&trace_sem, 1, 1) == 0);
+    BTASSERT(thrd_trace_reset() == 0);
+    BTASSERT(thrd_trace_start() == 0);
+
+    /* The spawned thread waits for the semaphore for about 20 ms and
+       then sleeps for 10 ms. */
+    thrd_p = thrd_spawn(trace_main,
+                        NULL,
+                        thrd_get_prio() - 1,
+                        trace_stack,
+                        sizeof(trace_stack));
+    BTASSERT(thrd_p != NULL);
+
+    BTASSERT(thrd_sleep_ms(20) == 0);
+    BTASSERT(sem_give(&trace_sem, 1) == 0);
+    BTASSERT(thrd_join(thrd_p) == 0);
+
+    BTASSERT(thrd_trace_stop() == 0);
+
+    BTASSERT(thrd_trace_get_statistics(thrd_p, &statistics) == 0);
+    std_printf(OSTR("run: %lu us, ready: %lu us, sem: %lu us, "
+                    "sleep: %lu us, voluntary: %lu, involuntary: %lu\r\n"),
+               (unsigned long)statistics.run_time,
+               (unsigned long)statistics.ready_time,
+               (unsigned long)statistics.suspended_time[THRD_TRACE_REASON_SEM],
+               (unsigned long)statistics.suspended_time[THRD_TRACE_REASON_SLEEP],
+               (unsigned long)statistics.voluntary_switches,
+               (unsigned long)statistics.involuntary_switches);
+    BTASSERTI(statistics.suspended_time[THRD_TRACE_REASON_SEM], >=, 10000);
+    BTASSERTI(statistics.suspended_time[THRD_TRACE_REASON_SLEEP], >=, 5000);
+    BTASSERTI(statistics.voluntary_switches, ==, 3);
+    BTASSERTI(statistics.involuntary_switches, ==, 0);
+
+    /* The semaphore wake up by this thread and the termination must
+       be recorded. */
+    length = thrd_trace_get_events(&trace_events[0],
+                                   membersof(trace_events));
+    BTASSERTI(length, >, 0);
+    woken_by_main = 0;
+    terminated = 0;
+
+    for (i = 0; i < length; i++) {
+        event_p = &trace_events[i];
+
+        if (event_p->thrd_p != thrd_p) {
+            continue;
+        }
+
+        if ((event_p->type == THRD_TRACE_EVENT_WAKE)
+            && (event_p->reason == THRD_TRACE_REASON_SEM)
+            && (event_p->other_p == thrd_self())) {
+            woken_by_main++;
+        }
+
+        if ((event_p->type == THRD_TRACE_EVENT_SWITCH_OUT)
+            && (event_p->reason == THRD_TRACE_REASON_TERMINATE)) {
+            terminated++;
+        }
+
+        if (i > 0) {
+            BTASSERT(event_p->time >= trace_events[i - 1].time);
+        }
+    }
+
+    BTASSERTI(woken_by_main, ==, 1);
+    BTASSERTI(terminated, ==, 1);
+
+    /* Nothing is recorded when stopped. */
+    BTASSERT(thrd_yield() == 0);
+    BTASSERTI(thrd_trace_get_events(&trace_events[0],
+                                    membersof(trace_events)), ==, length);
+
+    /* Export. */
+    BTASSERT(chan_init(&output,
+                       chan_read_null,
+                       trace_output_write,
+                       chan_size_null) == 0);
+    trace_output_size = 0;
+    BTASSERT(thrd_trace_export_chrome(&output) == 0);
+    BTASSERT(strncmp(&trace_output[0], "{\"traceEvents\":[", 16) == 0);
+    BTASSERT(strstr(&trace_output[0], "\"args\":{\"name\":\"trace\"}") != NULL);
+    BTASSERT(strstr(&trace_output[0], "\"ph\":\"B\"") != NULL);
+    BTASSERT(strstr(&trace_output[0], "\"reason\":\"terminate\"") != NULL);
+    BTASSERT(strcmp(&trace_output[trace_output_size - 4], "\n]}\n") == 0);
+
+    /* Shell commands. */
+    strcpy(command, "/kernel/thrd/trace/list");
+    BTASSERT(fs_call(command, NULL, sys_get_stdout(), NULL) == 0);
+    strcpy(command, "/kernel/thrd/trace/print");
+    BTASSERT(fs_call(command, NULL, sys_get_stdout(), NULL) == 0);
+
+    /* Reset. */
+    BTASSERT(thrd_trace_reset() == 0);
+    BTASSERTI(thrd_trace_get_events(&trace_events[0],
+                                    membersof(trace_events)), ==, 0);
+    BTASSERT(thrd_trace_get_statistics(thrd_p, &statistics) == 0);
+    BTASSERTI(statistics.voluntary_switches, ==, 0);
+
+    return (0);
+}
+
+static void *trace_long_sleep_main(void *arg_p)
+{
+    /* Longer than time_micros() wraps. */
+    thrd_sleep_ms(1100);
+
+    return (NULL);
+}
+
+int test_trace_long_sleep(void)
+{
+    struct thrd_t *thrd_p;
+    struct thrd_trace_statistics_t statistics;
+#if CONFIG_MONITOR_THREAD == 1
+    char command[64];
+
+    /* No scheduler events during the sleep. */
+    strcpy(command, "/kernel/thrd/monitor/set_period_ms 10000");
+    BTASSERT(fs_call(command, NULL, chan_null(), NULL) == 0);
+    thrd_sleep_ms(50);
+#endif
+
+    BTASSERT(thrd_trace_reset() == 0);
+    BTASSERT(thrd_trace_start() == 0);
+
+    thrd_p = thrd_spawn(trace_long_sleep_main,
+                        NULL,
+                        thrd_get_prio() - 1,
+                        trace_long_sleep_stack,
+                        sizeof(trace_long_sleep_stack));
+    BTASSERT(thrd_p != NULL);
+    BTASSERT(thrd_join(thrd_p) == 0);
+
+    BTASSERT(thrd_trace_stop() == 0);
+
+    BTASSERT(thrd_trace_get_statistics(thrd_p, &statistics) == 0);
+    BTASSERTI(statistics.suspended_time[THRD_TRACE_REASON_SLEEP],
+              >=,
+              1000000);
+    BTASSERTI(statistics.suspended_time[THRD_TRACE_REASON_SLEEP],
+              <,
+              2000000);
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
         { test_init, "test_init" },
 #if !defined(BOARD_ARDUINO_NANO) && !defined(BOARD_ARDUINO_UNO) && !defined(BOARD_ARDUINO_PRO_MICRO)
         { test_suspend_resume, "test_suspend_resume" },
+        { test_suspend_zero_timeout, "test_suspend_zero_timeout" },
         { test_terminate, "test_terminate" },
 #endif
         { test_yield, "test_yield" },
@@ -419,6 +787,12 @@ int main()
 #    endif
         { test_stack_heap, "test_stack_heap" },
         { test_prio_list, "test_prio_list" },
+        { test_ready_queue, "test_ready_queue" },
+        { test_ready_queue_benchmark, "test_ready_queue_benchmark" },
+#    if CONFIG_THRD_TRACE == 1
+        { test_trace, "test_trace" },
+        { test_trace_long_sleep, "test_trace_long_sleep" },
+#    endif
 #endif
         { NULL, NULL }
     };
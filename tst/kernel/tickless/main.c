@@ -0,0 +1,163 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+
+#include "simba.h"
+
+static struct event_t event;
+
+static void callback(void *arg_p)
+{
+    uint32_t mask;
+
+    mask = 0x1;
+    event_write_isr(&event, &mask, sizeof(mask));
+}
+
+static int elapsed_ms(struct time_t *start_p)
+{
+    struct time_t stop;
+    struct time_t elapsed;
+
+    sys_uptime(&stop);
+    time_subtract(&elapsed, &stop, start_p);
+
+    return (elapsed.seconds * 1000 + elapsed.nanoseconds / 1000000);
+}
+
+int test_sleep(void)
+{
+    int i;
+    struct time_t start;
+
+    /* The uptime must catch up the ticks that elapsed while the
+       system tick was stopped. */
+    for (i = 0; i < 3; i++) {
+        BTASSERT(sys_uptime(&start) == 0);
+        BTASSERT(thrd_sleep_ms(1000) == 0);
+        BTASSERTI(elapsed_ms(&start), >=, 1000);
+        BTASSERTI(elapsed_ms(&start), <, 1100);
+    }
+
+    /* Short sleeps still work. */
+    BTASSERT(sys_uptime(&start) == 0);
+    BTASSERT(thrd_sleep_ms(20) == 0);
+    BTASSERTI(elapsed_ms(&start), >=, 20);
+    BTASSERTI(elapsed_ms(&start), <, 100);
+
+    return (0);
+}
+
+int test_time_get(void)
+{
+    struct time_t uptime;
+    struct time_t now;
+    struct time_t new;
+
+    new.seconds = 1000;
+    new.nanoseconds = 0;
+    BTASSERT(time_set(&new) == 0);
+    BTASSERT(thrd_sleep_ms(1500) == 0);
+    BTASSERT(time_get(&now) == 0);
+    BTASSERT(now.seconds == 1001);
+    BTASSERTI(now.nanoseconds, >=, 500000000);
+
+    BTASSERT(sys_uptime(&uptime) == 0);
+    BTASSERTI(uptime.seconds, >=, 4);
+
+    return (0);
+}
+
+int test_timers(void)
+{
+    uint32_t mask;
+    struct timer_t timers[2];
+    struct time_t timeout;
+    struct time_t start;
+    int i;
+
+    event_init(&event);
+
+    /* The first expiring timer programs the next tick. */
+    timeout.seconds = 0;
+    timeout.nanoseconds = 300000000;
+    BTASSERT(timer_init(&timers[0], &timeout, callback, NULL, 0) == 0);
+    timeout.seconds = 5;
+    timeout.nanoseconds = 0;
+    BTASSERT(timer_init(&timers[1], &timeout, callback, NULL, 0) == 0);
+
+    BTASSERT(sys_uptime(&start) == 0);
+    BTASSERT(timer_start(&timers[1]) == 0);
+    BTASSERT(timer_start(&timers[0]) == 0);
+
+    mask = 0x1;
+    BTASSERT(event_read(&event, &mask, sizeof(mask)) == sizeof(mask));
+    BTASSERTI(elapsed_ms(&start), >=, 300);
+    BTASSERTI(elapsed_ms(&start), <, 400);
+    BTASSERT(timer_stop(&timers[1]) == 1);
+
+    /* A periodic timer. */
+    timeout.seconds = 0;
+    timeout.nanoseconds = 250000000;
+    BTASSERT(timer_init(&timers[0],
+                        &timeout,
+                        callback,
+                        NULL,
+                        TIMER_PERIODIC) == 0);
+    BTASSERT(sys_uptime(&start) == 0);
+    BTASSERT(timer_start(&timers[0]) == 0);
+
+    for (i = 1; i <= 4; i++) {
+        mask = 0x1;
+        BTASSERT(event_read(&event, &mask, sizeof(mask)) == sizeof(mask));
+        BTASSERTI(elapsed_ms(&start), >=, 250 * i);
+        BTASSERTI(elapsed_ms(&start), <, 250 * i + 100);
+    }
+
+    BTASSERT(timer_stop(&timers[0]) == 1);
+
+    return (0);
+}
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_sleep, "test_sleep" },
+        { test_time_get, "test_time_get" },
+        { test_timers, "test_timers" },
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
@@ -204,6 +204,128 @@ int test_multiple_timers(void)
     return (0);
 }
 
+int test_long_timeout(void)
+{
+    uint32_t mask;
+    uint32_t callback_masks[2];
+    struct timer_t timers[2];
+    struct time_t timeout;
+    struct time_t start, stop, elapsed;
+
+    event_init(&event);
+
+    /* A timeout longer than one revolution of the fastest timing
+       wheel level, and a stopped timer with an even longer timeout. */
+    callback_masks[0] = 0x1;
+    timeout.seconds = 0;
+    timeout.nanoseconds = 700000000;
+    BTASSERT(timer_init(&timers[0],
+                        &timeout,
+                        callback,
+                        &callback_masks[0],
+                        0) == 0);
+
+    callback_masks[1] = 0x2;
+    timeout.seconds = 1;
+    timeout.nanoseconds = 0;
+    BTASSERT(timer_init(&timers[1],
+                        &timeout,
+                        callback,
+                        &callback_masks[1],
+                        0) == 0);
+
+    BTASSERT(sys_uptime(&start) == 0);
+    BTASSERT(timer_start(&timers[0]) == 0);
+    BTASSERT(timer_start(&timers[1]) == 0);
+    BTASSERT(timer_stop(&timers[1]) == 1);
+    BTASSERT(timer_stop(&timers[1]) == 0);
+
+    mask = 0x3;
+    BTASSERT(event_read(&event, &mask, sizeof(mask)) == sizeof(mask));
+    BTASSERT(mask == 0x1);
+
+    BTASSERT(sys_uptime(&stop) == 0);
+    BTASSERT(time_subtract(&elapsed, &stop, &start) == 0);
+    BTASSERT(elapsed.seconds == 0);
+    BTASSERTI(elapsed.nanoseconds, >=, 700000000);
+
+    /* The stopped timer must not expire. */
+    thrd_sleep_ms(500);
+    BTASSERT(event_size(&event) == 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+static struct timer_t benchmark_timers[1000];
+
+static void benchmark_callback(void *arg_p)
+{
+}
+
+static int benchmark(int number_of_timers)
+{
+    int i;
+    int start;
+    int stop;
+    int start_time;
+    int stop_time;
+    struct time_t timeout;
+
+    /* Increasing timeouts is the worst case for the sorted list. */
+    for (i = 0; i < number_of_timers; i++) {
+        timeout.seconds = 10 + i;
+        timeout.nanoseconds = 0;
+        BTASSERT(timer_init(&benchmark_timers[i],
+                            &timeout,
+                            benchmark_callback,
+                            NULL,
+                            0) == 0);
+    }
+
+    sys_lock();
+
+    start = time_micros();
+
+    for (i = 0; i < number_of_timers; i++) {
+        timer_start_isr(&benchmark_timers[i]);
+    }
+
+    stop = time_micros();
+    start_time = time_micros_elapsed(start, stop);
+    start = time_micros();
+
+    for (i = 0; i < number_of_timers; i++) {
+        BTASSERT(timer_stop_isr(&benchmark_timers[i]) == 1);
+    }
+
+    stop = time_micros();
+    stop_time = time_micros_elapsed(start, stop);
+
+    sys_unlock();
+
+    std_printf(OSTR("%4d timers: start %6d us, stop %6d us\r\n"),
+               number_of_timers,
+               start_time,
+               stop_time);
+
+    return (0);
+}
+
+int test_benchmark(void)
+{
+    std_printf(OSTR("Timer wheel: %d\r\n"), CONFIG_TIMER_WHEEL);
+
+    BTASSERT(benchmark(10) == 0);
+    BTASSERT(benchmark(100) == 0);
+    BTASSERT(benchmark(1000) == 0);
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -211,6 +333,10 @@ int main()
         { test_periodic, "test_periodic" },
 #if !defined(BOARD_ARDUINO_NANO) && !defined(BOARD_ARDUINO_UNO) && !defined(BOARD_ARDUINO_PRO_MICRO)
         { test_multiple_timers, "test_multiple_timers" },
+#endif
+        { test_long_timeout, "test_long_timeout" },
+#if defined(ARCH_LINUX)
+        { test_benchmark, "test_benchmark" },
 #endif
         { NULL, NULL }
     };
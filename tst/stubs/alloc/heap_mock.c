@@ -180,3 +180,82 @@ int __attribute__ ((weak)) STUB(heap_share)(struct heap_t *self_p,
 
     return (res);
 }
+
+int mock_write_heap_flush(int res)
+{
+    harness_mock_write("heap_flush(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(heap_flush)(struct heap_t *self_p)
+{
+    int res;
+
+    harness_mock_read("heap_flush(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_heap_release_magazines(struct thrd_t *thrd_p,
+                                      int res)
+{
+    harness_mock_write("heap_release_magazines(thrd_p)",
+                       thrd_p,
+                       sizeof(*thrd_p));
+
+    harness_mock_write("heap_release_magazines(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(heap_release_magazines)(struct thrd_t *thrd_p)
+{
+    int res;
+
+    harness_mock_assert("heap_release_magazines(thrd_p)",
+                        thrd_p,
+                        sizeof(*thrd_p));
+
+    harness_mock_read("heap_release_magazines(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_heap_stats_register(far_string_t path_p,
+                                   int res)
+{
+    harness_mock_write("heap_stats_register(path_p)",
+                       &path_p,
+                       sizeof(path_p));
+
+    harness_mock_write("heap_stats_register(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(heap_stats_register)(struct heap_t *self_p,
+                                                     far_string_t path_p)
+{
+    int res;
+
+    harness_mock_assert("heap_stats_register(path_p)",
+                        &path_p,
+                        sizeof(path_p));
+
+    harness_mock_read("heap_stats_register(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -48,4 +48,12 @@ int mock_write_heap_share(const void *buf_p,
                           int count,
                           int res);
 
+int mock_write_heap_flush(int res);
+
+int mock_write_heap_release_magazines(struct thrd_t *thrd_p,
+                                      int res);
+
+int mock_write_heap_stats_register(far_string_t path_p,
+                                   int res);
+
 #endif
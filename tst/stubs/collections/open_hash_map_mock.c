@@ -0,0 +1,391 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+#include "open_hash_map_mock.h"
+
+int mock_write_open_hash_map_init(struct open_hash_map_entry_t *entries_p,
+                                  size_t entries_max,
+                                  open_hash_map_hash_t hash,
+                                  int res)
+{
+    harness_mock_write("open_hash_map_init(entries_p)",
+                       entries_p,
+                       sizeof(*entries_p));
+
+    harness_mock_write("open_hash_map_init(entries_max)",
+                       &entries_max,
+                       sizeof(entries_max));
+
+    harness_mock_write("open_hash_map_init(hash)",
+                       &hash,
+                       sizeof(hash));
+
+    harness_mock_write("open_hash_map_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(open_hash_map_init)(struct open_hash_map_t *self_p,
+                                                    struct open_hash_map_entry_t *entries_p,
+                                                    size_t entries_max,
+                                                    open_hash_map_hash_t hash)
+{
+    int res;
+
+    harness_mock_assert("open_hash_map_init(entries_p)",
+                        entries_p,
+                        sizeof(*entries_p));
+
+    harness_mock_assert("open_hash_map_init(entries_max)",
+                        &entries_max,
+                        sizeof(entries_max));
+
+    harness_mock_assert("open_hash_map_init(hash)",
+                        &hash,
+                        sizeof(hash));
+
+    harness_mock_read("open_hash_map_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_add(const void *key_p,
+                                 size_t key_size,
+                                 void *value_p,
+                                 int res)
+{
+    harness_mock_write("open_hash_map_add(key_p)",
+                       key_p,
+                       sizeof(key_p));
+
+    harness_mock_write("open_hash_map_add(key_size)",
+                       &key_size,
+                       sizeof(key_size));
+
+    harness_mock_write("open_hash_map_add(value_p)",
+                       value_p,
+                       sizeof(value_p));
+
+    harness_mock_write("open_hash_map_add(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(open_hash_map_add)(struct open_hash_map_t *self_p,
+                                                   const void *key_p,
+                                                   size_t key_size,
+                                                   void *value_p)
+{
+    int res;
+
+    harness_mock_assert("open_hash_map_add(key_p)",
+                        key_p,
+                        sizeof(*key_p));
+
+    harness_mock_assert("open_hash_map_add(key_size)",
+                        &key_size,
+                        sizeof(key_size));
+
+    harness_mock_assert("open_hash_map_add(value_p)",
+                        value_p,
+                        sizeof(*value_p));
+
+    harness_mock_read("open_hash_map_add(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_remove(const void *key_p,
+                                    size_t key_size,
+                                    int res)
+{
+    harness_mock_write("open_hash_map_remove(key_p)",
+                       key_p,
+                       sizeof(key_p));
+
+    harness_mock_write("open_hash_map_remove(key_size)",
+                       &key_size,
+                       sizeof(key_size));
+
+    harness_mock_write("open_hash_map_remove(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(open_hash_map_remove)(struct open_hash_map_t *self_p,
+                                                      const void *key_p,
+                                                      size_t key_size)
+{
+    int res;
+
+    harness_mock_assert("open_hash_map_remove(key_p)",
+                        key_p,
+                        sizeof(*key_p));
+
+    harness_mock_assert("open_hash_map_remove(key_size)",
+                        &key_size,
+                        sizeof(key_size));
+
+    harness_mock_read("open_hash_map_remove(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_get(const void *key_p,
+                                 size_t key_size,
+                                 void *res)
+{
+    harness_mock_write("open_hash_map_get(key_p)",
+                       key_p,
+                       sizeof(key_p));
+
+    harness_mock_write("open_hash_map_get(key_size)",
+                       &key_size,
+                       sizeof(key_size));
+
+    harness_mock_write("open_hash_map_get(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+void *__attribute__ ((weak)) STUB(open_hash_map_get)(struct open_hash_map_t *self_p,
+                                                     const void *key_p,
+                                                     size_t key_size)
+{
+    void *res;
+
+    harness_mock_assert("open_hash_map_get(key_p)",
+                        key_p,
+                        sizeof(*key_p));
+
+    harness_mock_assert("open_hash_map_get(key_size)",
+                        &key_size,
+                        sizeof(key_size));
+
+    harness_mock_read("open_hash_map_get(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_length(size_t res)
+{
+    harness_mock_write("open_hash_map_length(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+size_t __attribute__ ((weak)) STUB(open_hash_map_length)(struct open_hash_map_t *self_p)
+{
+    size_t res;
+
+    harness_mock_read("open_hash_map_length(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_resize(struct open_hash_map_entry_t *entries_p,
+                                    size_t entries_max,
+                                    int res)
+{
+    harness_mock_write("open_hash_map_resize(entries_p)",
+                       entries_p,
+                       sizeof(*entries_p));
+
+    harness_mock_write("open_hash_map_resize(entries_max)",
+                       &entries_max,
+                       sizeof(entries_max));
+
+    harness_mock_write("open_hash_map_resize(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(open_hash_map_resize)(struct open_hash_map_t *self_p,
+                                                      struct open_hash_map_entry_t *entries_p,
+                                                      size_t entries_max)
+{
+    int res;
+
+    harness_mock_assert("open_hash_map_resize(entries_p)",
+                        entries_p,
+                        sizeof(*entries_p));
+
+    harness_mock_assert("open_hash_map_resize(entries_max)",
+                        &entries_max,
+                        sizeof(entries_max));
+
+    harness_mock_read("open_hash_map_resize(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_resize_finish(int res)
+{
+    harness_mock_write("open_hash_map_resize_finish(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(open_hash_map_resize_finish)(struct open_hash_map_t *self_p)
+{
+    int res;
+
+    harness_mock_read("open_hash_map_resize_finish(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_is_resizing(int res)
+{
+    harness_mock_write("open_hash_map_is_resizing(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(open_hash_map_is_resizing)(struct open_hash_map_t *self_p)
+{
+    int res;
+
+    harness_mock_read("open_hash_map_is_resizing(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_iter_init(struct open_hash_map_t *map_p,
+                                       int res)
+{
+    harness_mock_write("open_hash_map_iter_init(map_p)",
+                       map_p,
+                       sizeof(*map_p));
+
+    harness_mock_write("open_hash_map_iter_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(open_hash_map_iter_init)(struct open_hash_map_iter_t *self_p,
+                                                         struct open_hash_map_t *map_p)
+{
+    int res;
+
+    harness_mock_assert("open_hash_map_iter_init(map_p)",
+                        map_p,
+                        sizeof(*map_p));
+
+    harness_mock_read("open_hash_map_iter_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_iter_next(struct open_hash_map_entry_t *res)
+{
+    harness_mock_write("open_hash_map_iter_next(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+struct open_hash_map_entry_t *__attribute__ ((weak)) STUB(open_hash_map_iter_next)(struct open_hash_map_iter_t *self_p)
+{
+    struct open_hash_map_entry_t *res;
+
+    harness_mock_read("open_hash_map_iter_next(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_open_hash_map_entry_key(struct open_hash_map_entry_t *entry_p,
+                                       const void *res)
+{
+    harness_mock_write("open_hash_map_entry_key(entry_p)",
+                       entry_p,
+                       sizeof(*entry_p));
+
+    harness_mock_write("open_hash_map_entry_key(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+const void *__attribute__ ((weak)) STUB(open_hash_map_entry_key)(struct open_hash_map_entry_t *entry_p)
+{
+    const void *res;
+
+    harness_mock_assert("open_hash_map_entry_key(entry_p)",
+                        entry_p,
+                        sizeof(*entry_p));
+
+    harness_mock_read("open_hash_map_entry_key(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -0,0 +1,72 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __OPEN_HASH_MAP_MOCK_H__
+#define __OPEN_HASH_MAP_MOCK_H__
+
+#include "simba.h"
+
+int mock_write_open_hash_map_init(struct open_hash_map_entry_t *entries_p,
+                                  size_t entries_max,
+                                  open_hash_map_hash_t hash,
+                                  int res);
+
+int mock_write_open_hash_map_add(const void *key_p,
+                                 size_t key_size,
+                                 void *value_p,
+                                 int res);
+
+int mock_write_open_hash_map_remove(const void *key_p,
+                                    size_t key_size,
+                                    int res);
+
+int mock_write_open_hash_map_get(const void *key_p,
+                                 size_t key_size,
+                                 void *res);
+
+int mock_write_open_hash_map_length(size_t res);
+
+int mock_write_open_hash_map_resize(struct open_hash_map_entry_t *entries_p,
+                                    size_t entries_max,
+                                    int res);
+
+int mock_write_open_hash_map_resize_finish(int res);
+
+int mock_write_open_hash_map_is_resizing(int res);
+
+int mock_write_open_hash_map_iter_init(struct open_hash_map_t *map_p,
+                                       int res);
+
+int mock_write_open_hash_map_iter_next(struct open_hash_map_entry_t *res);
+
+int mock_write_open_hash_map_entry_key(struct open_hash_map_entry_t *entry_p,
+                                       const void *res);
+
+#endif
@@ -393,3 +393,89 @@ int __attribute__ ((weak)) STUB(log_set_default_handler_output_channel)(void *ch
 
     return (res);
 }
+
+int mock_write_log_async_set_overflow_policy(int policy,
+                                             int res)
+{
+    harness_mock_write("log_async_set_overflow_policy(policy)",
+                       &policy,
+                       sizeof(policy));
+
+    harness_mock_write("log_async_set_overflow_policy(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(log_async_set_overflow_policy)(int policy)
+{
+    int res;
+
+    harness_mock_assert("log_async_set_overflow_policy(policy)",
+                        &policy,
+                        sizeof(policy));
+
+    harness_mock_read("log_async_set_overflow_policy(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_async_flush(int res)
+{
+    harness_mock_write("log_async_flush()",
+                       NULL,
+                       0);
+
+    harness_mock_write("log_async_flush(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(log_async_flush)()
+{
+    int res;
+
+    harness_mock_assert("log_async_flush()",
+                        NULL,
+                        0);
+
+    harness_mock_read("log_async_flush(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_async_get_stats(struct log_async_stats_t *stats_p,
+                                   int res)
+{
+    harness_mock_write("log_async_get_stats(): return (stats_p)",
+                       stats_p,
+                       sizeof(*stats_p));
+
+    harness_mock_write("log_async_get_stats(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(log_async_get_stats)(struct log_async_stats_t *stats_p)
+{
+    int res;
+
+    harness_mock_read("log_async_get_stats(): return (stats_p)",
+                      stats_p,
+                      sizeof(*stats_p));
+
+    harness_mock_read("log_async_get_stats(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
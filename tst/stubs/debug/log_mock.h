@@ -69,4 +69,12 @@ int mock_write_log_remove_object(struct log_object_t *object_p,
 int mock_write_log_set_default_handler_output_channel(void *chout_p,
                                                       int res);
 
+int mock_write_log_async_set_overflow_policy(int policy,
+                                             int res);
+
+int mock_write_log_async_flush(int res);
+
+int mock_write_log_async_get_stats(struct log_async_stats_t *stats_p,
+                                   int res);
+
 #endif
@@ -0,0 +1,631 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+#include "sd_card_emulator.h"
+
+/* Commands used by the SD card driver. */
+#define CMD_GO_IDLE_STATE          0
+#define CMD_SEND_IF_COND           8
+#define CMD_SEND_CSD               9
+#define CMD_SEND_CID              10
+#define CMD_STOP_TRANSMISSION     12
+#define CMD_SEND_STATUS           13
+#define CMD_READ_SINGLE_BLOCK     17
+#define CMD_READ_MULTIPLE_BLOCK   18
+#define CMD_WRITE_BLOCK           24
+#define CMD_WRITE_MULTIPLE_BLOCK  25
+#define CMD_APP_CMD               55
+#define CMD_READ_OCR              58
+#define CMD_CRC_ON_OFF            59
+
+#define ACMD_SET_WR_BLK_ERASE_COUNT 23
+#define ACMD_SD_SEND_OP_COND        41
+
+#define R1_IDLE_STATE              0x01
+#define R1_ILLEGAL_COMMAND         0x04
+#define R1_COM_CRC_ERROR           0x08
+#define R1_ADDRESS_ERROR           0x20
+
+#define TOKEN_DATA_START_BLOCK     0xfe
+#define TOKEN_WRITE_MULTIPLE_TOKEN 0xfc
+#define TOKEN_STOP_TRAN_TOKEN      0xfd
+#define TOKEN_DATA_RES_ACCEPTED    0xe5
+#define TOKEN_DATA_RES_CRC_ERR     0xeb
+
+/* Number of busy bytes sent after a write. */
+#define BUSY_SIZE                     4
+
+#define WRITE_NONE                    0
+#define WRITE_SINGLE                  1
+#define WRITE_MULTIPLE                2
+
+struct module_t {
+    FILE *file_p;
+    uint32_t number_of_blocks;
+    int idle;
+    int application_command;
+    struct {
+        uint8_t buf[6];
+        size_t size;
+    } command;
+    struct {
+        uint8_t buf[SD_BLOCK_SIZE + 8];
+        size_t pos;
+        size_t size;
+        int busy;
+    } output;
+    struct {
+        int state;
+        uint8_t buf[SD_BLOCK_SIZE + 2];
+        size_t size;
+        int receiving;
+    } write;
+    int reading;
+    uint32_t block;
+    struct sd_card_emulator_stats_t stats;
+};
+
+static struct module_t module;
+
+static void output_append(const void *buf_p, size_t size)
+{
+    memcpy(&module.output.buf[module.output.size], buf_p, size);
+    module.output.size += size;
+}
+
+static void output_append_byte(uint8_t value)
+{
+    output_append(&value, 1);
+}
+
+static void output_clear(void)
+{
+    module.output.pos = 0;
+    module.output.size = 0;
+    module.output.busy = 0;
+}
+
+/**
+ * Append a data block with start token and checksum to the output.
+ */
+static void output_append_data_block(const uint8_t *buf_p, size_t size)
+{
+    uint16_t crc;
+
+    crc = crc_xmodem(0, buf_p, size);
+    output_append_byte(0xff);
+    output_append_byte(TOKEN_DATA_START_BLOCK);
+    output_append(buf_p, size);
+    output_append_byte(crc >> 8);
+    output_append_byte(crc);
+}
+
+static int read_block(uint8_t *buf_p, uint32_t block)
+{
+    size_t size;
+
+    if (block >= module.number_of_blocks) {
+        return (-1);
+    }
+
+    if (fseek(module.file_p, block * SD_BLOCK_SIZE, SEEK_SET) != 0) {
+        return (-1);
+    }
+
+    size = fread(buf_p, 1, SD_BLOCK_SIZE, module.file_p);
+    memset(&buf_p[size], 0, SD_BLOCK_SIZE - size);
+    module.stats.blocks_read++;
+
+    return (0);
+}
+
+static int write_block(const uint8_t *buf_p, uint32_t block)
+{
+    if (block >= module.number_of_blocks) {
+        return (-1);
+    }
+
+    if (fseek(module.file_p, block * SD_BLOCK_SIZE, SEEK_SET) != 0) {
+        return (-1);
+    }
+
+    if (fwrite(buf_p, 1, SD_BLOCK_SIZE, module.file_p) != SD_BLOCK_SIZE) {
+        return (-1);
+    }
+
+    fflush(module.file_p);
+    module.stats.blocks_written++;
+
+    return (0);
+}
+
+/**
+ * Append the next block of an ongoing multiple block read.
+ */
+static void output_append_next_block(void)
+{
+    uint8_t buf[SD_BLOCK_SIZE];
+
+    if (read_block(&buf[0], module.block) != 0) {
+        module.reading = 0;
+
+        return;
+    }
+
+    module.block++;
+    output_append_data_block(&buf[0], sizeof(buf));
+}
+
+static void output_append_csd(void)
+{
+    uint8_t csd[16];
+    uint32_t c_size;
+
+    /* Version 2.00, 512 kB units. */
+    c_size = ((module.number_of_blocks / 1024) - 1);
+
+    memset(&csd[0], 0, sizeof(csd));
+    csd[0] = 0x40;
+    csd[1] = 0x0e;
+    csd[3] = 0x32;
+    csd[4] = 0x5b;
+    csd[5] = 0x59;
+    csd[7] = ((c_size >> 16) & 0x3f);
+    csd[8] = (c_size >> 8);
+    csd[9] = c_size;
+    csd[10] = 0x7f;
+    csd[11] = 0x80;
+    csd[12] = 0x0a;
+    csd[13] = 0x40;
+    csd[15] = crc_7(&csd[0], 15);
+    output_append_data_block(&csd[0], sizeof(csd));
+}
+
+static void output_append_cid(void)
+{
+    uint8_t cid[16];
+
+    memset(&cid[0], 0, sizeof(cid));
+    cid[0] = 0x03;
+    memcpy(&cid[1], "SDSDEMU", 7);
+    cid[8] = 0x10;
+    cid[12] = 1;
+    cid[14] = 0x21;
+    cid[15] = crc_7(&cid[0], 15);
+    output_append_data_block(&cid[0], sizeof(cid));
+}
+
+static void output_append_r1(uint8_t r1)
+{
+    /* The response is preceded by at least one byte. */
+    output_append_byte(0xff);
+    output_append_byte(r1 | (module.idle ? R1_IDLE_STATE : 0));
+}
+
+static void execute_application_command(uint8_t index, uint32_t arg)
+{
+    module.stats.application_commands[index]++;
+
+    switch (index) {
+
+    case ACMD_SD_SEND_OP_COND:
+        module.idle = 0;
+        output_append_r1(0);
+        break;
+
+    case ACMD_SET_WR_BLK_ERASE_COUNT:
+        output_append_r1(0);
+        break;
+
+    default:
+        output_append_r1(R1_ILLEGAL_COMMAND);
+        break;
+    }
+}
+
+static void execute_command(void)
+{
+    uint8_t index;
+    uint32_t arg;
+    uint8_t buf[SD_BLOCK_SIZE];
+    int application_command;
+
+    index = (module.command.buf[0] & 0x3f);
+    arg = (((uint32_t)module.command.buf[1] << 24)
+           | ((uint32_t)module.command.buf[2] << 16)
+           | ((uint32_t)module.command.buf[3] << 8)
+           | module.command.buf[4]);
+    application_command = module.application_command;
+    module.application_command = 0;
+
+    if (crc_7(&module.command.buf[0], 5) != module.command.buf[5]) {
+        output_append_r1(R1_COM_CRC_ERROR);
+
+        return;
+    }
+
+    if (application_command == 1) {
+        execute_application_command(index, arg);
+
+        return;
+    }
+
+    module.stats.commands[index]++;
+
+    switch (index) {
+
+    case CMD_GO_IDLE_STATE:
+        module.idle = 1;
+        module.reading = 0;
+        module.write.state = WRITE_NONE;
+        output_append_r1(0);
+        break;
+
+    case CMD_CRC_ON_OFF:
+        output_append_r1(0);
+        break;
+
+    case CMD_SEND_IF_COND:
+        output_append_r1(0);
+        output_append_byte(0);
+        output_append_byte(0);
+        output_append_byte((arg >> 8) & 0xf);
+        output_append_byte(arg);
+        break;
+
+    case CMD_APP_CMD:
+        module.application_command = 1;
+        output_append_r1(0);
+        break;
+
+    case CMD_READ_OCR:
+        /* Powered up and high capacity. */
+        output_append_r1(0);
+        output_append_byte(0xc0);
+        output_append_byte(0xff);
+        output_append_byte(0x80);
+        output_append_byte(0x00);
+        break;
+
+    case CMD_SEND_CSD:
+        output_append_r1(0);
+        output_append_csd();
+        break;
+
+    case CMD_SEND_CID:
+        output_append_r1(0);
+        output_append_cid();
+        break;
+
+    case CMD_SEND_STATUS:
+        output_append_r1(0);
+        output_append_byte(0);
+        break;
+
+    case CMD_READ_SINGLE_BLOCK:
+        if (read_block(&buf[0], arg) != 0) {
+            output_append_r1(R1_ADDRESS_ERROR);
+        } else {
+            output_append_r1(0);
+            output_append_data_block(&buf[0], sizeof(buf));
+        }
+
+        break;
+
+    case CMD_READ_MULTIPLE_BLOCK:
+        if (arg >= module.number_of_blocks) {
+            output_append_r1(R1_ADDRESS_ERROR);
+        } else {
+            output_append_r1(0);
+            module.block = arg;
+            module.reading = 1;
+        }
+
+        break;
+
+    case CMD_STOP_TRANSMISSION:
+        /* Stuff byte, response and busy. */
+        module.reading = 0;
+        output_clear();
+        output_append_byte(0xff);
+        output_append_r1(0);
+        module.output.busy = BUSY_SIZE;
+        break;
+
+    case CMD_WRITE_BLOCK:
+    case CMD_WRITE_MULTIPLE_BLOCK:
+        if (arg >= module.number_of_blocks) {
+            output_append_r1(R1_ADDRESS_ERROR);
+        } else {
+            output_append_r1(0);
+            module.block = arg;
+
+            if (index == CMD_WRITE_BLOCK) {
+                module.write.state = WRITE_SINGLE;
+            } else {
+                module.write.state = WRITE_MULTIPLE;
+            }
+        }
+
+        break;
+
+    default:
+        output_append_r1(R1_ILLEGAL_COMMAND);
+        break;
+    }
+}
+
+/**
+ * A complete data block has been received from the host.
+ */
+static void data_block_received(void)
+{
+    uint16_t crc;
+
+    crc = ((module.write.buf[SD_BLOCK_SIZE] << 8)
+           | module.write.buf[SD_BLOCK_SIZE + 1]);
+
+    if (crc != crc_xmodem(0, &module.write.buf[0], SD_BLOCK_SIZE)) {
+        output_append_byte(TOKEN_DATA_RES_CRC_ERR);
+    } else if (write_block(&module.write.buf[0], module.block) != 0) {
+        output_append_byte(TOKEN_DATA_RES_CRC_ERR);
+    } else {
+        output_append_byte(TOKEN_DATA_RES_ACCEPTED);
+        module.block++;
+    }
+
+    module.output.busy = BUSY_SIZE;
+
+    if (module.write.state == WRITE_SINGLE) {
+        module.write.state = WRITE_NONE;
+    }
+}
+
+static void input(uint8_t value)
+{
+    if (module.write.receiving == 1) {
+        module.write.buf[module.write.size++] = value;
+
+        if (module.write.size == sizeof(module.write.buf)) {
+            module.write.receiving = 0;
+            data_block_received();
+        }
+
+        return;
+    }
+
+    if (module.command.size > 0) {
+        module.command.buf[module.command.size++] = value;
+
+        if (module.command.size == sizeof(module.command.buf)) {
+            module.command.size = 0;
+            execute_command();
+        }
+
+        return;
+    }
+
+    /* Start of a command. */
+    if ((value & 0xc0) == 0x40) {
+        module.command.buf[0] = value;
+        module.command.size = 1;
+
+        return;
+    }
+
+    switch (module.write.state) {
+
+    case WRITE_SINGLE:
+        if (value == TOKEN_DATA_START_BLOCK) {
+            module.write.receiving = 1;
+            module.write.size = 0;
+        }
+
+        break;
+
+    case WRITE_MULTIPLE:
+        if (value == TOKEN_WRITE_MULTIPLE_TOKEN) {
+            module.write.receiving = 1;
+            module.write.size = 0;
+        } else if (value == TOKEN_STOP_TRAN_TOKEN) {
+            module.write.state = WRITE_NONE;
+            output_append_byte(0xff);
+            module.output.busy = BUSY_SIZE;
+        }
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+static uint8_t output(void)
+{
+    if ((module.output.pos == module.output.size)
+        && (module.output.busy == 0)
+        && (module.reading == 1)) {
+        output_clear();
+        output_append_next_block();
+    }
+
+    if (module.output.pos < module.output.size) {
+        return (module.output.buf[module.output.pos++]);
+    }
+
+    module.output.pos = 0;
+    module.output.size = 0;
+
+    if (module.output.busy > 0) {
+        module.output.busy--;
+
+        return (0x00);
+    }
+
+    return (0xff);
+}
+
+int sd_card_emulator_init(const char *path_p)
+{
+    long size;
+
+    memset(&module, 0, sizeof(module));
+    module.file_p = fopen(path_p, "r+b");
+
+    if (module.file_p == NULL) {
+        return (-ENOENT);
+    }
+
+    fseek(module.file_p, 0, SEEK_END);
+    size = ftell(module.file_p);
+    module.number_of_blocks = (size / SD_BLOCK_SIZE);
+
+    return (0);
+}
+
+struct sd_card_emulator_stats_t *sd_card_emulator_get_stats(void)
+{
+    return (&module.stats);
+}
+
+void sd_card_emulator_reset_stats(void)
+{
+    memset(&module.stats, 0, sizeof(module.stats));
+}
+
+int spi_module_init(void)
+{
+    return (0);
+}
+
+int spi_init(struct spi_driver_t *self_p,
+             struct spi_device_t *dev_p,
+             struct pin_device_t *ss_pin_p,
+             int mode,
+             int speed,
+             int polarity,
+             int phase)
+{
+    self_p->dev_p = dev_p;
+    self_p->mode = mode;
+    self_p->speed = speed;
+    self_p->polarity = polarity;
+    self_p->phase = phase;
+
+    return (0);
+}
+
+int spi_start(struct spi_driver_t *self_p)
+{
+    return (0);
+}
+
+int spi_stop(struct spi_driver_t *self_p)
+{
+    return (0);
+}
+
+int spi_take_bus(struct spi_driver_t *self_p)
+{
+    return (0);
+}
+
+int spi_give_bus(struct spi_driver_t *self_p)
+{
+    return (0);
+}
+
+int spi_select(struct spi_driver_t *self_p)
+{
+    return (0);
+}
+
+int spi_deselect(struct spi_driver_t *self_p)
+{
+    return (0);
+}
+
+ssize_t spi_transfer(struct spi_driver_t *self_p,
+                     void *rxbuf_p,
+                     const void *txbuf_p,
+                     size_t size)
+{
+    uint8_t *u8rxbuf_p;
+    const uint8_t *u8txbuf_p;
+    uint8_t value;
+    size_t i;
+
+    u8rxbuf_p = rxbuf_p;
+    u8txbuf_p = txbuf_p;
+
+    /* Full duplex, one byte at a time. */
+    for (i = 0; i < size; i++) {
+        value = output();
+
+        if (u8rxbuf_p != NULL) {
+            u8rxbuf_p[i] = value;
+        }
+
+        if (u8txbuf_p != NULL) {
+            input(u8txbuf_p[i]);
+        } else {
+            input(0xff);
+        }
+    }
+
+    return (size);
+}
+
+ssize_t spi_read(struct spi_driver_t *self_p,
+                 void *rxbuf_p,
+                 size_t size)
+{
+    return (spi_transfer(self_p, rxbuf_p, NULL, size));
+}
+
+ssize_t spi_write(struct spi_driver_t *self_p,
+                  const void *txbuf_p,
+                  size_t size)
+{
+    return (spi_transfer(self_p, NULL, txbuf_p, size));
+}
+
+ssize_t spi_get(struct spi_driver_t *self_p,
+                uint8_t *data_p)
+{
+    return (spi_read(self_p, data_p, 1));
+}
+
+ssize_t spi_put(struct spi_driver_t *self_p,
+                uint8_t data)
+{
+    return (spi_write(self_p, &data, 1));
+}
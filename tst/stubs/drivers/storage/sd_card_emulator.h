@@ -0,0 +1,69 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __SD_CARD_EMULATOR_H__
+#define __SD_CARD_EMULATOR_H__
+
+#include "simba.h"
+
+/**
+ * Number of received commands and transferred blocks.
+ */
+struct sd_card_emulator_stats_t {
+    uint32_t commands[64];
+    uint32_t application_commands[64];
+    uint32_t blocks_read;
+    uint32_t blocks_written;
+};
+
+/**
+ * Initialize the SD card emulator. The SPI driver functions are
+ * replaced by an SD card in SPI mode, backed by given image file.
+ *
+ * @param[in] path_p Path of the image file. Its size is the card
+ *                   capacity.
+ *
+ * @return zero(0) or negative error code.
+ */
+int sd_card_emulator_init(const char *path_p);
+
+/**
+ * Get the emulator statistics.
+ *
+ * @return Statistics object.
+ */
+struct sd_card_emulator_stats_t *sd_card_emulator_get_stats(void);
+
+/**
+ * Reset the emulator statistics.
+ */
+void sd_card_emulator_reset_stats(void);
+
+#endif
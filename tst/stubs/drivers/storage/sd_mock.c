@@ -280,3 +280,103 @@ ssize_t __attribute__ ((weak)) STUB(sd_write_block)(struct sd_driver_t *self_p,
 
     return (res);
 }
+
+int mock_write_sd_read_blocks(void *dst_p,
+                              uint32_t src_block,
+                              size_t count,
+                              ssize_t res)
+{
+    harness_mock_write("sd_read_blocks(): return (dst_p)",
+                       dst_p,
+                       sizeof(dst_p));
+
+    harness_mock_write("sd_read_blocks(src_block)",
+                       &src_block,
+                       sizeof(src_block));
+
+    harness_mock_write("sd_read_blocks(count)",
+                       &count,
+                       sizeof(count));
+
+    harness_mock_write("sd_read_blocks(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(sd_read_blocks)(struct sd_driver_t *self_p,
+                                                    void *dst_p,
+                                                    uint32_t src_block,
+                                                    size_t count)
+{
+    ssize_t res;
+
+    harness_mock_read("sd_read_blocks(): return (dst_p)",
+                      dst_p,
+                      sizeof(*dst_p));
+
+    harness_mock_assert("sd_read_blocks(src_block)",
+                        &src_block,
+                        sizeof(src_block));
+
+    harness_mock_assert("sd_read_blocks(count)",
+                        &count,
+                        sizeof(count));
+
+    harness_mock_read("sd_read_blocks(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_sd_write_blocks(uint32_t dst_block,
+                               const void *src_p,
+                               size_t count,
+                               ssize_t res)
+{
+    harness_mock_write("sd_write_blocks(dst_block)",
+                       &dst_block,
+                       sizeof(dst_block));
+
+    harness_mock_write("sd_write_blocks(src_p)",
+                       src_p,
+                       sizeof(src_p));
+
+    harness_mock_write("sd_write_blocks(count)",
+                       &count,
+                       sizeof(count));
+
+    harness_mock_write("sd_write_blocks(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(sd_write_blocks)(struct sd_driver_t *self_p,
+                                                     uint32_t dst_block,
+                                                     const void *src_p,
+                                                     size_t count)
+{
+    ssize_t res;
+
+    harness_mock_assert("sd_write_blocks(dst_block)",
+                        &dst_block,
+                        sizeof(dst_block));
+
+    harness_mock_assert("sd_write_blocks(src_p)",
+                        src_p,
+                        sizeof(*src_p));
+
+    harness_mock_assert("sd_write_blocks(count)",
+                        &count,
+                        sizeof(count));
+
+    harness_mock_read("sd_write_blocks(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
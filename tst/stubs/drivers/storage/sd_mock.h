@@ -58,4 +58,14 @@ int mock_write_sd_write_block(uint32_t dst_block,
                               const void *src_p,
                               ssize_t res);
 
+int mock_write_sd_read_blocks(void *dst_p,
+                              uint32_t src_block,
+                              size_t count,
+                              ssize_t res);
+
+int mock_write_sd_write_blocks(uint32_t dst_block,
+                               const void *src_p,
+                               size_t count,
+                               ssize_t res);
+
 #endif
@@ -331,6 +331,36 @@ struct json_tok_t *__attribute__ ((weak)) STUB(json_array_get)(struct json_t *se
     return (res);
 }
 
+int mock_write_json_get_path(const char *path_p,
+                             struct json_tok_t *res)
+{
+    harness_mock_write("json_get_path(path_p)",
+                       path_p,
+                       strlen(path_p) + 1);
+
+    harness_mock_write("json_get_path(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+struct json_tok_t *__attribute__ ((weak)) STUB(json_get_path)(struct json_t *self_p,
+                                                              const char *path_p)
+{
+    struct json_tok_t *res;
+
+    harness_mock_assert("json_get_path(path_p)",
+                        path_p,
+                        sizeof(*path_p));
+
+    harness_mock_read("json_get_path(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_json_token_object(struct json_tok_t *token_p,
                                  int num_keys)
 {
@@ -502,3 +532,453 @@ void __attribute__ ((weak)) STUB(json_token_string)(struct json_tok_t *token_p,
                         &size,
                         sizeof(size));
 }
+
+int mock_write_json_stream_init(char *buf_p,
+                                size_t size,
+                                json_stream_callback_t callback,
+                                void *arg_p,
+                                int res)
+{
+    harness_mock_write("json_stream_init(buf_p)",
+                       buf_p,
+                       strlen(buf_p) + 1);
+
+    harness_mock_write("json_stream_init(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("json_stream_init(callback)",
+                       &callback,
+                       sizeof(callback));
+
+    harness_mock_write("json_stream_init(arg_p)",
+                       arg_p,
+                       size);
+
+    harness_mock_write("json_stream_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_stream_init)(struct json_stream_t *self_p,
+                                                  char *buf_p,
+                                                  size_t size,
+                                                  json_stream_callback_t callback,
+                                                  void *arg_p)
+{
+    int res;
+
+    harness_mock_assert("json_stream_init(buf_p)",
+                        buf_p,
+                        sizeof(*buf_p));
+
+    harness_mock_assert("json_stream_init(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_assert("json_stream_init(callback)",
+                        &callback,
+                        sizeof(callback));
+
+    harness_mock_assert("json_stream_init(arg_p)",
+                        arg_p,
+                        size);
+
+    harness_mock_read("json_stream_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_stream_parse(const char *buf_p,
+                                 size_t size,
+                                 ssize_t res)
+{
+    harness_mock_write("json_stream_parse(buf_p)",
+                       buf_p,
+                       strlen(buf_p) + 1);
+
+    harness_mock_write("json_stream_parse(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("json_stream_parse(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(json_stream_parse)(struct json_stream_t *self_p,
+                                                       const char *buf_p,
+                                                       size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("json_stream_parse(buf_p)",
+                        buf_p,
+                        sizeof(*buf_p));
+
+    harness_mock_assert("json_stream_parse(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("json_stream_parse(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_stream_read(void *chan_p,
+                                int res)
+{
+    harness_mock_write("json_stream_read(chan_p)",
+                       chan_p,
+                       sizeof(chan_p));
+
+    harness_mock_write("json_stream_read(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_stream_read)(struct json_stream_t *self_p,
+                                                  void *chan_p)
+{
+    int res;
+
+    harness_mock_assert("json_stream_read(chan_p)",
+                        chan_p,
+                        sizeof(*chan_p));
+
+    harness_mock_read("json_stream_read(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_init(void *chout_p,
+                                int res)
+{
+    harness_mock_write("json_writer_init(chout_p)",
+                       chout_p,
+                       sizeof(chout_p));
+
+    harness_mock_write("json_writer_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_init)(struct json_writer_t *self_p,
+                                                  void *chout_p)
+{
+    int res;
+
+    harness_mock_assert("json_writer_init(chout_p)",
+                        chout_p,
+                        sizeof(*chout_p));
+
+    harness_mock_read("json_writer_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_object_begin(int res)
+{
+    harness_mock_write("json_writer_object_begin(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_object_begin)(struct json_writer_t *self_p)
+{
+    int res;
+
+    harness_mock_read("json_writer_object_begin(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_object_end(int res)
+{
+    harness_mock_write("json_writer_object_end(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_object_end)(struct json_writer_t *self_p)
+{
+    int res;
+
+    harness_mock_read("json_writer_object_end(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_array_begin(int res)
+{
+    harness_mock_write("json_writer_array_begin(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_array_begin)(struct json_writer_t *self_p)
+{
+    int res;
+
+    harness_mock_read("json_writer_array_begin(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_array_end(int res)
+{
+    harness_mock_write("json_writer_array_end(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_array_end)(struct json_writer_t *self_p)
+{
+    int res;
+
+    harness_mock_read("json_writer_array_end(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_key(const char *key_p,
+                               int res)
+{
+    harness_mock_write("json_writer_key(key_p)",
+                       key_p,
+                       strlen(key_p) + 1);
+
+    harness_mock_write("json_writer_key(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_key)(struct json_writer_t *self_p,
+                                                 const char *key_p)
+{
+    int res;
+
+    harness_mock_assert("json_writer_key(key_p)",
+                        key_p,
+                        sizeof(*key_p));
+
+    harness_mock_read("json_writer_key(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_string(const char *buf_p,
+                                  size_t size,
+                                  int res)
+{
+    harness_mock_write("json_writer_string(buf_p)",
+                       buf_p,
+                       strlen(buf_p) + 1);
+
+    harness_mock_write("json_writer_string(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("json_writer_string(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_string)(struct json_writer_t *self_p,
+                                                    const char *buf_p,
+                                                    size_t size)
+{
+    int res;
+
+    harness_mock_assert("json_writer_string(buf_p)",
+                        buf_p,
+                        sizeof(*buf_p));
+
+    harness_mock_assert("json_writer_string(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("json_writer_string(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_integer(long value,
+                                   int res)
+{
+    harness_mock_write("json_writer_integer(value)",
+                       &value,
+                       sizeof(value));
+
+    harness_mock_write("json_writer_integer(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_integer)(struct json_writer_t *self_p,
+                                                     long value)
+{
+    int res;
+
+    harness_mock_assert("json_writer_integer(value)",
+                        &value,
+                        sizeof(value));
+
+    harness_mock_read("json_writer_integer(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_boolean(int value,
+                                   int res)
+{
+    harness_mock_write("json_writer_boolean(value)",
+                       &value,
+                       sizeof(value));
+
+    harness_mock_write("json_writer_boolean(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_boolean)(struct json_writer_t *self_p,
+                                                     int value)
+{
+    int res;
+
+    harness_mock_assert("json_writer_boolean(value)",
+                        &value,
+                        sizeof(value));
+
+    harness_mock_read("json_writer_boolean(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_null(int res)
+{
+    harness_mock_write("json_writer_null(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_null)(struct json_writer_t *self_p)
+{
+    int res;
+
+    harness_mock_read("json_writer_null(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_primitive(const char *buf_p,
+                                     size_t size,
+                                     int res)
+{
+    harness_mock_write("json_writer_primitive(buf_p)",
+                       buf_p,
+                       strlen(buf_p) + 1);
+
+    harness_mock_write("json_writer_primitive(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("json_writer_primitive(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(json_writer_primitive)(struct json_writer_t *self_p,
+                                                       const char *buf_p,
+                                                       size_t size)
+{
+    int res;
+
+    harness_mock_assert("json_writer_primitive(buf_p)",
+                        buf_p,
+                        sizeof(*buf_p));
+
+    harness_mock_assert("json_writer_primitive(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("json_writer_primitive(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_json_writer_size(ssize_t res)
+{
+    harness_mock_write("json_writer_size(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(json_writer_size)(struct json_writer_t *self_p)
+{
+    ssize_t res;
+
+    harness_mock_read("json_writer_size(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -63,6 +63,9 @@ int mock_write_json_array_get(int index,
                               struct json_tok_t *array_p,
                               struct json_tok_t *res);
 
+int mock_write_json_get_path(const char *path_p,
+                             struct json_tok_t *res);
+
 int mock_write_json_token_object(struct json_tok_t *token_p,
                                  int num_keys);
 
@@ -83,4 +86,49 @@ int mock_write_json_token_string(struct json_tok_t *token_p,
                                  const char *buf_p,
                                  size_t size);
 
+int mock_write_json_stream_init(char *buf_p,
+                                size_t size,
+                                json_stream_callback_t callback,
+                                void *arg_p,
+                                int res);
+
+int mock_write_json_stream_parse(const char *buf_p,
+                                 size_t size,
+                                 ssize_t res);
+
+int mock_write_json_stream_read(void *chan_p,
+                                int res);
+
+int mock_write_json_writer_init(void *chout_p,
+                                int res);
+
+int mock_write_json_writer_object_begin(int res);
+
+int mock_write_json_writer_object_end(int res);
+
+int mock_write_json_writer_array_begin(int res);
+
+int mock_write_json_writer_array_end(int res);
+
+int mock_write_json_writer_key(const char *key_p,
+                               int res);
+
+int mock_write_json_writer_string(const char *buf_p,
+                                  size_t size,
+                                  int res);
+
+int mock_write_json_writer_integer(long value,
+                                   int res);
+
+int mock_write_json_writer_boolean(int value,
+                                   int res);
+
+int mock_write_json_writer_null(int res);
+
+int mock_write_json_writer_primitive(const char *buf_p,
+                                     size_t size,
+                                     int res);
+
+int mock_write_json_writer_size(ssize_t res);
+
 #endif
@@ -21,6 +21,34 @@
 #include "simba.h"
 #include "fat16_mock.h"
 
+int mock_write_fat16_module_init(int res)
+{
+    harness_mock_write("fat16_module_init()",
+                       NULL,
+                       0);
+
+    harness_mock_write("fat16_module_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(fat16_module_init)()
+{
+    int res;
+
+    harness_mock_assert("fat16_module_init()",
+                        NULL,
+                        0);
+
+    harness_mock_read("fat16_module_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_fat16_init(fat16_read_t read,
                           fat16_write_t write,
                           void *arg_p,
@@ -81,6 +109,46 @@ int __attribute__ ((weak)) STUB(fat16_init)(struct fat16_t *self_p,
     return (res);
 }
 
+int mock_write_fat16_set_multiple_blocks_callbacks(fat16_read_blocks_t read_blocks,
+                                                   fat16_write_blocks_t write_blocks,
+                                                   int res)
+{
+    harness_mock_write("fat16_set_multiple_blocks_callbacks(read_blocks)",
+                       &read_blocks,
+                       sizeof(read_blocks));
+
+    harness_mock_write("fat16_set_multiple_blocks_callbacks(write_blocks)",
+                       &write_blocks,
+                       sizeof(write_blocks));
+
+    harness_mock_write("fat16_set_multiple_blocks_callbacks(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(fat16_set_multiple_blocks_callbacks)(struct fat16_t *self_p,
+                                                                     fat16_read_blocks_t read_blocks,
+                                                                     fat16_write_blocks_t write_blocks)
+{
+    int res;
+
+    harness_mock_assert("fat16_set_multiple_blocks_callbacks(read_blocks)",
+                        &read_blocks,
+                        sizeof(read_blocks));
+
+    harness_mock_assert("fat16_set_multiple_blocks_callbacks(write_blocks)",
+                        &write_blocks,
+                        sizeof(write_blocks));
+
+    harness_mock_read("fat16_set_multiple_blocks_callbacks(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_fat16_mount(int res)
 {
     harness_mock_write("fat16_mount(): return (res)",
@@ -23,12 +23,18 @@
 
 #include "simba.h"
 
+int mock_write_fat16_module_init(int res);
+
 int mock_write_fat16_init(fat16_read_t read,
                           fat16_write_t write,
                           void *arg_p,
                           unsigned int partition,
                           int res);
 
+int mock_write_fat16_set_multiple_blocks_callbacks(fat16_read_blocks_t read_blocks,
+                                                   fat16_write_blocks_t write_blocks,
+                                                   int res);
+
 int mock_write_fat16_mount(int res);
 
 int mock_write_fat16_unmount(int res);
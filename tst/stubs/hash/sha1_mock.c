@@ -120,3 +120,62 @@ int __attribute__ ((weak)) STUB(sha1_digest)(struct sha1_t *self_p,
 
     return (res);
 }
+
+int mock_write_sha1_update_multi(struct sha1_t **selfs_pp,
+                                 void **bufs_pp,
+                                 size_t *sizes_p,
+                                 int length,
+                                 int res)
+{
+    harness_mock_write("sha1_update_multi(selfs_pp)",
+                       selfs_pp,
+                       sizeof(*selfs_pp));
+
+    harness_mock_write("sha1_update_multi(bufs_pp)",
+                       bufs_pp,
+                       sizeof(bufs_pp));
+
+    harness_mock_write("sha1_update_multi(sizes_p)",
+                       sizes_p,
+                       sizeof(*sizes_p));
+
+    harness_mock_write("sha1_update_multi(length)",
+                       &length,
+                       sizeof(length));
+
+    harness_mock_write("sha1_update_multi(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(sha1_update_multi)(struct sha1_t **selfs_pp,
+                                                   void **bufs_pp,
+                                                   size_t *sizes_p,
+                                                   int length)
+{
+    int res;
+
+    harness_mock_assert("sha1_update_multi(selfs_pp)",
+                        selfs_pp,
+                        sizeof(*selfs_pp));
+
+    harness_mock_assert("sha1_update_multi(bufs_pp)",
+                        bufs_pp,
+                        sizeof(*bufs_pp));
+
+    harness_mock_assert("sha1_update_multi(sizes_p)",
+                        sizes_p,
+                        sizeof(*sizes_p));
+
+    harness_mock_assert("sha1_update_multi(length)",
+                        &length,
+                        sizeof(length));
+
+    harness_mock_read("sha1_update_multi(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -42,4 +42,10 @@ int mock_write_sha1_update(void *buf_p,
 int mock_write_sha1_digest(uint8_t *hash_p,
                            int res);
 
+int mock_write_sha1_update_multi(struct sha1_t **selfs_pp,
+                                 void **bufs_pp,
+                                 size_t *sizes_p,
+                                 int length,
+                                 int res);
+
 #endif
@@ -171,6 +171,95 @@ int __attribute__ ((weak)) STUB(http_server_stop)(struct http_server_t *self_p)
     return (res);
 }
 
+int mock_write_http_server_find_route(struct http_server_request_t *request_p,
+                                      http_server_route_callback_t res)
+{
+    harness_mock_write("http_server_find_route(): return (request_p)",
+                       request_p,
+                       sizeof(*request_p));
+
+    harness_mock_write("http_server_find_route(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+http_server_route_callback_t __attribute__ ((weak)) STUB(http_server_find_route)(struct http_server_t *self_p,
+                                                                                 struct http_server_request_t *request_p)
+{
+    http_server_route_callback_t res;
+
+    harness_mock_read("http_server_find_route(): return (request_p)",
+                      request_p,
+                      sizeof(*request_p));
+
+    harness_mock_read("http_server_find_route(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_http_server_request_get_param(struct http_server_request_t *request_p,
+                                             const char *name_p,
+                                             char *buf_p,
+                                             size_t size,
+                                             ssize_t res)
+{
+    harness_mock_write("http_server_request_get_param(request_p)",
+                       request_p,
+                       sizeof(*request_p));
+
+    harness_mock_write("http_server_request_get_param(name_p)",
+                       name_p,
+                       strlen(name_p) + 1);
+
+    harness_mock_write("http_server_request_get_param(): return (buf_p)",
+                       buf_p,
+                       strlen(buf_p) + 1);
+
+    harness_mock_write("http_server_request_get_param(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("http_server_request_get_param(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(http_server_request_get_param)(struct http_server_request_t *request_p,
+                                                                   const char *name_p,
+                                                                   char *buf_p,
+                                                                   size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("http_server_request_get_param(request_p)",
+                        request_p,
+                        sizeof(*request_p));
+
+    harness_mock_assert("http_server_request_get_param(name_p)",
+                        name_p,
+                        sizeof(*name_p));
+
+    harness_mock_read("http_server_request_get_param(): return (buf_p)",
+                      buf_p,
+                      sizeof(*buf_p));
+
+    harness_mock_assert("http_server_request_get_param(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("http_server_request_get_param(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_http_server_response_write(struct http_server_connection_t *connection_p,
                                           struct http_server_request_t *request_p,
                                           struct http_server_response_t *response_p,
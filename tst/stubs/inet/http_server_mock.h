@@ -47,6 +47,15 @@ int mock_write_http_server_start(int res);
 
 int mock_write_http_server_stop(int res);
 
+int mock_write_http_server_find_route(struct http_server_request_t *request_p,
+                                      http_server_route_callback_t res);
+
+int mock_write_http_server_request_get_param(struct http_server_request_t *request_p,
+                                             const char *name_p,
+                                             char *buf_p,
+                                             size_t size,
+                                             ssize_t res);
+
 int mock_write_http_server_response_write(struct http_server_connection_t *connection_p,
                                           struct http_server_request_t *request_p,
                                           struct http_server_response_t *response_p,
@@ -140,8 +140,13 @@ void *__attribute__ ((weak)) STUB(mqtt_client_main)(void *arg_p)
     return (res);
 }
 
-int mock_write_mqtt_client_connect(int res)
+int mock_write_mqtt_client_connect(struct mqtt_conn_options_t *options_p,
+                                   int res)
 {
+    harness_mock_write("mqtt_client_connect(options_p)",
+                       options_p,
+                       sizeof(*options_p));
+
     harness_mock_write("mqtt_client_connect(): return (res)",
                        &res,
                        sizeof(res));
@@ -149,10 +154,15 @@ int mock_write_mqtt_client_connect(int res)
     return (0);
 }
 
-int __attribute__ ((weak)) STUB(mqtt_client_connect)(struct mqtt_client_t *self_p)
+int __attribute__ ((weak)) STUB(mqtt_client_connect)(struct mqtt_client_t *self_p,
+                                                     struct mqtt_conn_options_t *options_p)
 {
     int res;
 
+    harness_mock_assert("mqtt_client_connect(options_p)",
+                        options_p,
+                        sizeof(*options_p));
+
     harness_mock_read("mqtt_client_connect(): return (res)",
                       &res,
                       sizeof(res));
@@ -203,7 +213,7 @@ int __attribute__ ((weak)) STUB(mqtt_client_ping)(struct mqtt_client_t *self_p)
 int mock_write_mqtt_client_publish(struct mqtt_application_message_t *message_p,
                                    int res)
 {
-    harness_mock_write("mqtt_client_publish(): return (message_p)",
+    harness_mock_write("mqtt_client_publish(message_p)",
                        message_p,
                        sizeof(*message_p));
 
@@ -219,9 +229,9 @@ int __attribute__ ((weak)) STUB(mqtt_client_publish)(struct mqtt_client_t *self_
 {
     int res;
 
-    harness_mock_read("mqtt_client_publish(): return (message_p)",
-                      message_p,
-                      sizeof(*message_p));
+    harness_mock_assert("mqtt_client_publish(message_p)",
+                        message_p,
+                        sizeof(*message_p));
 
     harness_mock_read("mqtt_client_publish(): return (res)",
                       &res,
@@ -289,3 +299,203 @@ int __attribute__ ((weak)) STUB(mqtt_client_unsubscribe)(struct mqtt_client_t *s
 
     return (res);
 }
+
+int mock_write_mqtt_client_subscription_init(const char *filter_p,
+                                             enum mqtt_qos_t qos,
+                                             mqtt_on_subscription_publish_t on_publish,
+                                             void *arg_p,
+                                             int res)
+{
+    harness_mock_write("mqtt_client_subscription_init(filter_p)",
+                       filter_p,
+                       strlen(filter_p) + 1);
+
+    harness_mock_write("mqtt_client_subscription_init(qos)",
+                       &qos,
+                       sizeof(qos));
+
+    harness_mock_write("mqtt_client_subscription_init(on_publish)",
+                       &on_publish,
+                       sizeof(on_publish));
+
+    harness_mock_write("mqtt_client_subscription_init(arg_p)",
+                       arg_p,
+                       sizeof(arg_p));
+
+    harness_mock_write("mqtt_client_subscription_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(mqtt_client_subscription_init)(struct mqtt_client_subscription_t *self_p,
+                                                               const char *filter_p,
+                                                               enum mqtt_qos_t qos,
+                                                               mqtt_on_subscription_publish_t on_publish,
+                                                               void *arg_p)
+{
+    int res;
+
+    harness_mock_assert("mqtt_client_subscription_init(filter_p)",
+                        filter_p,
+                        sizeof(*filter_p));
+
+    harness_mock_assert("mqtt_client_subscription_init(qos)",
+                        &qos,
+                        sizeof(qos));
+
+    harness_mock_assert("mqtt_client_subscription_init(on_publish)",
+                        &on_publish,
+                        sizeof(on_publish));
+
+    harness_mock_assert("mqtt_client_subscription_init(arg_p)",
+                        arg_p,
+                        sizeof(*arg_p));
+
+    harness_mock_read("mqtt_client_subscription_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_mqtt_client_init_subscriptions(struct mqtt_client_topic_node_t *nodes_p,
+                                              int length,
+                                              int res)
+{
+    harness_mock_write("mqtt_client_init_subscriptions(nodes_p)",
+                       nodes_p,
+                       sizeof(*nodes_p));
+
+    harness_mock_write("mqtt_client_init_subscriptions(length)",
+                       &length,
+                       sizeof(length));
+
+    harness_mock_write("mqtt_client_init_subscriptions(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(mqtt_client_init_subscriptions)(struct mqtt_client_t *self_p,
+                                                                struct mqtt_client_topic_node_t *nodes_p,
+                                                                int length)
+{
+    int res;
+
+    harness_mock_assert("mqtt_client_init_subscriptions(nodes_p)",
+                        nodes_p,
+                        sizeof(*nodes_p));
+
+    harness_mock_assert("mqtt_client_init_subscriptions(length)",
+                        &length,
+                        sizeof(length));
+
+    harness_mock_read("mqtt_client_init_subscriptions(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_mqtt_client_set_topic_buffer(char *buf_p,
+                                            size_t size,
+                                            int res)
+{
+    harness_mock_write("mqtt_client_set_topic_buffer(buf_p)",
+                       buf_p,
+                       strlen(buf_p) + 1);
+
+    harness_mock_write("mqtt_client_set_topic_buffer(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("mqtt_client_set_topic_buffer(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(mqtt_client_set_topic_buffer)(struct mqtt_client_t *self_p,
+                                                              char *buf_p,
+                                                              size_t size)
+{
+    int res;
+
+    harness_mock_assert("mqtt_client_set_topic_buffer(buf_p)",
+                        buf_p,
+                        sizeof(*buf_p));
+
+    harness_mock_assert("mqtt_client_set_topic_buffer(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("mqtt_client_set_topic_buffer(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_mqtt_client_add_subscription(struct mqtt_client_subscription_t *subscription_p,
+                                            int res)
+{
+    harness_mock_write("mqtt_client_add_subscription(subscription_p)",
+                       subscription_p,
+                       sizeof(*subscription_p));
+
+    harness_mock_write("mqtt_client_add_subscription(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(mqtt_client_add_subscription)(struct mqtt_client_t *self_p,
+                                                              struct mqtt_client_subscription_t *subscription_p)
+{
+    int res;
+
+    harness_mock_assert("mqtt_client_add_subscription(subscription_p)",
+                        subscription_p,
+                        sizeof(*subscription_p));
+
+    harness_mock_read("mqtt_client_add_subscription(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_mqtt_client_remove_subscription(struct mqtt_client_subscription_t *subscription_p,
+                                               int res)
+{
+    harness_mock_write("mqtt_client_remove_subscription(subscription_p)",
+                       subscription_p,
+                       sizeof(*subscription_p));
+
+    harness_mock_write("mqtt_client_remove_subscription(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(mqtt_client_remove_subscription)(struct mqtt_client_t *self_p,
+                                                                 struct mqtt_client_subscription_t *subscription_p)
+{
+    int res;
+
+    harness_mock_assert("mqtt_client_remove_subscription(subscription_p)",
+                        subscription_p,
+                        sizeof(*subscription_p));
+
+    harness_mock_read("mqtt_client_remove_subscription(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -44,7 +44,8 @@ int mock_write_mqtt_client_init(const char *name_p,
 int mock_write_mqtt_client_main(void *arg_p,
                                 void *res);
 
-int mock_write_mqtt_client_connect(int res);
+int mock_write_mqtt_client_connect(struct mqtt_conn_options_t *options_p,
+                                   int res);
 
 int mock_write_mqtt_client_disconnect(int res);
 
@@ -59,4 +60,24 @@ int mock_write_mqtt_client_subscribe(struct mqtt_application_message_t *message_
 int mock_write_mqtt_client_unsubscribe(struct mqtt_application_message_t *message_p,
                                        int res);
 
+int mock_write_mqtt_client_subscription_init(const char *filter_p,
+                                             enum mqtt_qos_t qos,
+                                             mqtt_on_subscription_publish_t on_publish,
+                                             void *arg_p,
+                                             int res);
+
+int mock_write_mqtt_client_init_subscriptions(struct mqtt_client_topic_node_t *nodes_p,
+                                              int length,
+                                              int res);
+
+int mock_write_mqtt_client_set_topic_buffer(char *buf_p,
+                                            size_t size,
+                                            int res);
+
+int mock_write_mqtt_client_add_subscription(struct mqtt_client_subscription_t *subscription_p,
+                                            int res);
+
+int mock_write_mqtt_client_remove_subscription(struct mqtt_client_subscription_t *subscription_p,
+                                               int res);
+
 #endif
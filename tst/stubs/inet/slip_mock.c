@@ -111,6 +111,56 @@ ssize_t __attribute__ ((weak)) STUB(slip_input)(struct slip_t *self_p,
     return (res);
 }
 
+int mock_write_slip_input_buffer(const void *buf_p,
+                                 size_t size,
+                                 size_t *consumed_p,
+                                 ssize_t res)
+{
+    harness_mock_write("slip_input_buffer(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("slip_input_buffer(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("slip_input_buffer(): return (consumed_p)",
+                       consumed_p,
+                       sizeof(*consumed_p));
+
+    harness_mock_write("slip_input_buffer(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(slip_input_buffer)(struct slip_t *self_p,
+                                                       const void *buf_p,
+                                                       size_t size,
+                                                       size_t *consumed_p)
+{
+    ssize_t res;
+
+    harness_mock_assert("slip_input_buffer(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("slip_input_buffer(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("slip_input_buffer(): return (consumed_p)",
+                      consumed_p,
+                      sizeof(*consumed_p));
+
+    harness_mock_read("slip_input_buffer(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_slip_get_output_channel(void *res)
 {
     harness_mock_write("slip_get_output_channel(): return (res)",
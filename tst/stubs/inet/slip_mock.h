@@ -41,6 +41,11 @@ int mock_write_slip_init(void *buf_p,
 int mock_write_slip_input(uint8_t data,
                           ssize_t res);
 
+int mock_write_slip_input_buffer(const void *buf_p,
+                                 size_t size,
+                                 size_t *consumed_p,
+                                 ssize_t res);
+
 int mock_write_slip_get_output_channel(void *res);
 
 #endif
@@ -253,6 +253,35 @@ int __attribute__ ((weak)) STUB(thrd_join)(struct thrd_t *thrd_p)
     return (res);
 }
 
+int mock_write_thrd_terminate(struct thrd_t *thrd_p,
+                              int res)
+{
+    harness_mock_write("thrd_terminate(thrd_p)",
+                       thrd_p,
+                       sizeof(*thrd_p));
+
+    harness_mock_write("thrd_terminate(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_terminate)(struct thrd_t *thrd_p)
+{
+    int res;
+
+    harness_mock_assert("thrd_terminate(thrd_p)",
+                        thrd_p,
+                        sizeof(*thrd_p));
+
+    harness_mock_read("thrd_terminate(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_thrd_sleep(float seconds,
                           int res)
 {
@@ -588,6 +617,45 @@ int __attribute__ ((weak)) STUB(thrd_get_prio)()
     return (res);
 }
 
+int mock_write_thrd_set_inherited_prio_isr(struct thrd_t *thrd_p,
+                                           int prio,
+                                           int res)
+{
+    harness_mock_write("thrd_set_inherited_prio_isr(thrd_p)",
+                       thrd_p,
+                       sizeof(*thrd_p));
+
+    harness_mock_write("thrd_set_inherited_prio_isr(prio)",
+                       &prio,
+                       sizeof(prio));
+
+    harness_mock_write("thrd_set_inherited_prio_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_set_inherited_prio_isr)(struct thrd_t *thrd_p,
+                                                             int prio)
+{
+    int res;
+
+    harness_mock_assert("thrd_set_inherited_prio_isr(thrd_p)",
+                        thrd_p,
+                        sizeof(*thrd_p));
+
+    harness_mock_assert("thrd_set_inherited_prio_isr(prio)",
+                        &prio,
+                        sizeof(prio));
+
+    harness_mock_read("thrd_set_inherited_prio_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_thrd_init_global_env(struct thrd_environment_variable_t *variables_p,
                                     int length,
                                     int res)
@@ -1100,3 +1168,223 @@ int __attribute__ ((weak)) STUB(thrd_prio_list_remove_isr)(struct thrd_prio_list
 
     return (res);
 }
+
+int mock_write_thrd_trace_start(int res)
+{
+    harness_mock_write("thrd_trace_start()",
+                       NULL,
+                       0);
+
+    harness_mock_write("thrd_trace_start(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_start)()
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_start()",
+                        NULL,
+                        0);
+
+    harness_mock_read("thrd_trace_start(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_trace_stop(int res)
+{
+    harness_mock_write("thrd_trace_stop()",
+                       NULL,
+                       0);
+
+    harness_mock_write("thrd_trace_stop(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_stop)()
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_stop()",
+                        NULL,
+                        0);
+
+    harness_mock_read("thrd_trace_stop(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_trace_reset(int res)
+{
+    harness_mock_write("thrd_trace_reset()",
+                       NULL,
+                       0);
+
+    harness_mock_write("thrd_trace_reset(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_reset)()
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_reset()",
+                        NULL,
+                        0);
+
+    harness_mock_read("thrd_trace_reset(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_trace_get_events(struct thrd_trace_event_t *events_p,
+                                     size_t length,
+                                     ssize_t res)
+{
+    harness_mock_write("thrd_trace_get_events(): return (events_p)",
+                       events_p,
+                       sizeof(*events_p));
+
+    harness_mock_write("thrd_trace_get_events(length)",
+                       &length,
+                       sizeof(length));
+
+    harness_mock_write("thrd_trace_get_events(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(thrd_trace_get_events)(struct thrd_trace_event_t *events_p,
+                                                           size_t length)
+{
+    ssize_t res;
+
+    harness_mock_read("thrd_trace_get_events(): return (events_p)",
+                      events_p,
+                      sizeof(*events_p));
+
+    harness_mock_assert("thrd_trace_get_events(length)",
+                        &length,
+                        sizeof(length));
+
+    harness_mock_read("thrd_trace_get_events(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_trace_get_statistics(struct thrd_t *thrd_p,
+                                         struct thrd_trace_statistics_t *statistics_p,
+                                         int res)
+{
+    harness_mock_write("thrd_trace_get_statistics(thrd_p)",
+                       thrd_p,
+                       sizeof(*thrd_p));
+
+    harness_mock_write("thrd_trace_get_statistics(): return (statistics_p)",
+                       statistics_p,
+                       sizeof(*statistics_p));
+
+    harness_mock_write("thrd_trace_get_statistics(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_get_statistics)(struct thrd_t *thrd_p,
+                                                           struct thrd_trace_statistics_t *statistics_p)
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_get_statistics(thrd_p)",
+                        thrd_p,
+                        sizeof(*thrd_p));
+
+    harness_mock_read("thrd_trace_get_statistics(): return (statistics_p)",
+                      statistics_p,
+                      sizeof(*statistics_p));
+
+    harness_mock_read("thrd_trace_get_statistics(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_trace_export_chrome(void *chan_p,
+                                        int res)
+{
+    harness_mock_write("thrd_trace_export_chrome(chan_p)",
+                       chan_p,
+                       sizeof(chan_p));
+
+    harness_mock_write("thrd_trace_export_chrome(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_export_chrome)(void *chan_p)
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_export_chrome(chan_p)",
+                        chan_p,
+                        sizeof(*chan_p));
+
+    harness_mock_read("thrd_trace_export_chrome(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_trace_set_reason_isr(int reason,
+                                         int res)
+{
+    harness_mock_write("thrd_trace_set_reason_isr(reason)",
+                       &reason,
+                       sizeof(reason));
+
+    harness_mock_write("thrd_trace_set_reason_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_set_reason_isr)(int reason)
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_set_reason_isr(reason)",
+                        &reason,
+                        sizeof(reason));
+
+    harness_mock_read("thrd_trace_set_reason_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -54,6 +54,9 @@ int mock_write_thrd_yield(int res);
 int mock_write_thrd_join(struct thrd_t *thrd_p,
                          int res);
 
+int mock_write_thrd_terminate(struct thrd_t *thrd_p,
+                              int res);
+
 int mock_write_thrd_sleep(float seconds,
                           int res);
 
@@ -85,6 +88,10 @@ int mock_write_thrd_set_prio(struct thrd_t *thrd_p,
 
 int mock_write_thrd_get_prio(int res);
 
+int mock_write_thrd_set_inherited_prio_isr(struct thrd_t *thrd_p,
+                                           int prio,
+                                           int res);
+
 int mock_write_thrd_init_global_env(struct thrd_environment_variable_t *variables_p,
                                     int length,
                                     int res);
@@ -137,4 +144,24 @@ int mock_write_thrd_prio_list_pop_isr(struct thrd_prio_list_elem_t *res);
 int mock_write_thrd_prio_list_remove_isr(struct thrd_prio_list_elem_t *elem_p,
                                          int res);
 
+int mock_write_thrd_trace_start(int res);
+
+int mock_write_thrd_trace_stop(int res);
+
+int mock_write_thrd_trace_reset(int res);
+
+int mock_write_thrd_trace_get_events(struct thrd_trace_event_t *events_p,
+                                     size_t length,
+                                     ssize_t res);
+
+int mock_write_thrd_trace_get_statistics(struct thrd_t *thrd_p,
+                                         struct thrd_trace_statistics_t *statistics_p,
+                                         int res);
+
+int mock_write_thrd_trace_export_chrome(void *chan_p,
+                                        int res);
+
+int mock_write_thrd_trace_set_reason_isr(int reason,
+                                         int res);
+
 #endif
@@ -119,6 +119,56 @@ int __attribute__ ((weak)) STUB(bus_listener_init)(struct bus_listener_t *self_p
     return (res);
 }
 
+int mock_write_bus_listener_init_range(int min_id,
+                                       int max_id,
+                                       void *chan_p,
+                                       int res)
+{
+    harness_mock_write("bus_listener_init_range(min_id)",
+                       &min_id,
+                       sizeof(min_id));
+
+    harness_mock_write("bus_listener_init_range(max_id)",
+                       &max_id,
+                       sizeof(max_id));
+
+    harness_mock_write("bus_listener_init_range(chan_p)",
+                       chan_p,
+                       sizeof(chan_p));
+
+    harness_mock_write("bus_listener_init_range(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(bus_listener_init_range)(struct bus_listener_t *self_p,
+                                                         int min_id,
+                                                         int max_id,
+                                                         void *chan_p)
+{
+    int res;
+
+    harness_mock_assert("bus_listener_init_range(min_id)",
+                        &min_id,
+                        sizeof(min_id));
+
+    harness_mock_assert("bus_listener_init_range(max_id)",
+                        &max_id,
+                        sizeof(max_id));
+
+    harness_mock_assert("bus_listener_init_range(chan_p)",
+                        chan_p,
+                        sizeof(*chan_p));
+
+    harness_mock_read("bus_listener_init_range(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_bus_attach(struct bus_listener_t *listener_p,
                           int res)
 {
@@ -228,3 +278,133 @@ int __attribute__ ((weak)) STUB(bus_write)(struct bus_t *self_p,
 
     return (res);
 }
+
+int mock_write_bus_set_heap(struct heap_t *heap_p,
+                            int res)
+{
+    harness_mock_write("bus_set_heap(heap_p)",
+                       heap_p,
+                       sizeof(*heap_p));
+
+    harness_mock_write("bus_set_heap(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(bus_set_heap)(struct bus_t *self_p,
+                                              struct heap_t *heap_p)
+{
+    int res;
+
+    harness_mock_assert("bus_set_heap(heap_p)",
+                        heap_p,
+                        sizeof(*heap_p));
+
+    harness_mock_read("bus_set_heap(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_bus_message_alloc(int id,
+                                 size_t size,
+                                 struct bus_message_t *res)
+{
+    harness_mock_write("bus_message_alloc(id)",
+                       &id,
+                       sizeof(id));
+
+    harness_mock_write("bus_message_alloc(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("bus_message_alloc(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+struct bus_message_t *__attribute__ ((weak)) STUB(bus_message_alloc)(struct bus_t *self_p,
+                                                                     int id,
+                                                                     size_t size)
+{
+    struct bus_message_t *res;
+
+    harness_mock_assert("bus_message_alloc(id)",
+                        &id,
+                        sizeof(id));
+
+    harness_mock_assert("bus_message_alloc(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("bus_message_alloc(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_bus_write_message(struct bus_message_t *message_p,
+                                 int res)
+{
+    harness_mock_write("bus_write_message(message_p)",
+                       message_p,
+                       sizeof(*message_p));
+
+    harness_mock_write("bus_write_message(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(bus_write_message)(struct bus_t *self_p,
+                                                   struct bus_message_t *message_p)
+{
+    int res;
+
+    harness_mock_assert("bus_write_message(message_p)",
+                        message_p,
+                        sizeof(*message_p));
+
+    harness_mock_read("bus_write_message(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_bus_message_release(struct bus_message_t *message_p,
+                                   int res)
+{
+    harness_mock_write("bus_message_release(message_p)",
+                       message_p,
+                       sizeof(*message_p));
+
+    harness_mock_write("bus_message_release(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(bus_message_release)(struct bus_t *self_p,
+                                                     struct bus_message_t *message_p)
+{
+    int res;
+
+    harness_mock_assert("bus_message_release(message_p)",
+                        message_p,
+                        sizeof(*message_p));
+
+    harness_mock_read("bus_message_release(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
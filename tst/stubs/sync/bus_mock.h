@@ -41,6 +41,11 @@ int mock_write_bus_listener_init(int id,
                                  void *chan_p,
                                  int res);
 
+int mock_write_bus_listener_init_range(int min_id,
+                                       int max_id,
+                                       void *chan_p,
+                                       int res);
+
 int mock_write_bus_attach(struct bus_listener_t *listener_p,
                           int res);
 
@@ -52,4 +57,17 @@ int mock_write_bus_write(int id,
                          size_t size,
                          int res);
 
+int mock_write_bus_set_heap(struct heap_t *heap_p,
+                            int res);
+
+int mock_write_bus_message_alloc(int id,
+                                 size_t size,
+                                 struct bus_message_t *res);
+
+int mock_write_bus_write_message(struct bus_message_t *message_p,
+                                 int res);
+
+int mock_write_bus_message_release(struct bus_message_t *message_p,
+                                   int res);
+
 #endif
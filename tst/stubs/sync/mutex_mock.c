@@ -79,6 +79,36 @@ int __attribute__ ((weak)) STUB(mutex_init)(struct mutex_t *self_p)
     return (res);
 }
 
+int mock_write_mutex_init_flags(int flags,
+                                int res)
+{
+    harness_mock_write("mutex_init_flags(flags)",
+                       &flags,
+                       sizeof(flags));
+
+    harness_mock_write("mutex_init_flags(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(mutex_init_flags)(struct mutex_t *self_p,
+                                                  int flags)
+{
+    int res;
+
+    harness_mock_assert("mutex_init_flags(flags)",
+                        &flags,
+                        sizeof(flags));
+
+    harness_mock_read("mutex_init_flags(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_mutex_lock(int res)
 {
     harness_mock_write("mutex_lock(): return (res)",
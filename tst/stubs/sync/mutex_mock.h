@@ -37,6 +37,9 @@ int mock_write_mutex_module_init(int res);
 
 int mock_write_mutex_init(int res);
 
+int mock_write_mutex_init_flags(int flags,
+                                int res);
+
 int mock_write_mutex_lock(int res);
 
 int mock_write_mutex_unlock(int res);
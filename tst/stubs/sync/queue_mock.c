@@ -71,6 +71,46 @@ int __attribute__ ((weak)) STUB(queue_init)(struct queue_t *self_p,
     return (res);
 }
 
+int mock_write_queue_init_spsc(void *buf_p,
+                               size_t size,
+                               int res)
+{
+    harness_mock_write("queue_init_spsc(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("queue_init_spsc(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("queue_init_spsc(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(queue_init_spsc)(struct queue_t *self_p,
+                                                 void *buf_p,
+                                                 size_t size)
+{
+    int res;
+
+    harness_mock_assert("queue_init_spsc(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("queue_init_spsc(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("queue_init_spsc(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_queue_start(int res)
 {
     harness_mock_write("queue_start(): return (res)",
@@ -251,6 +291,46 @@ ssize_t __attribute__ ((weak)) STUB(queue_write_isr)(struct queue_t *self_p,
     return (res);
 }
 
+int mock_write_queue_write_spsc_isr(const void *buf_p,
+                                    size_t size,
+                                    ssize_t res)
+{
+    harness_mock_write("queue_write_spsc_isr(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("queue_write_spsc_isr(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("queue_write_spsc_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(queue_write_spsc_isr)(struct queue_t *self_p,
+                                                          const void *buf_p,
+                                                          size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("queue_write_spsc_isr(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("queue_write_spsc_isr(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("queue_write_spsc_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_queue_size(ssize_t res)
 {
     harness_mock_write("queue_size(): return (res)",
@@ -37,6 +37,10 @@ int mock_write_queue_init(void *buf_p,
                           size_t size,
                           int res);
 
+int mock_write_queue_init_spsc(void *buf_p,
+                               size_t size,
+                               int res);
+
 int mock_write_queue_start(int res);
 
 int mock_write_queue_stop(int res);
@@ -55,6 +59,10 @@ int mock_write_queue_write_isr(const void *buf_p,
                                size_t size,
                                ssize_t res);
 
+int mock_write_queue_write_spsc_isr(const void *buf_p,
+                                    size_t size,
+                                    ssize_t res);
+
 int mock_write_queue_size(ssize_t res);
 
 int mock_write_queue_unused_size(ssize_t res);
@@ -0,0 +1,392 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+#include "record_queue_mock.h"
+
+int mock_write_record_queue_init(void *buf_p,
+                                 size_t size,
+                                 int res)
+{
+    harness_mock_write("record_queue_init(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("record_queue_init(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("record_queue_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(record_queue_init)(struct record_queue_t *self_p,
+                                                   void *buf_p,
+                                                   size_t size)
+{
+    int res;
+
+    harness_mock_assert("record_queue_init(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("record_queue_init(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("record_queue_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_reserve(size_t size,
+                                    void *res)
+{
+    harness_mock_write("record_queue_reserve(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("record_queue_reserve(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+void *__attribute__ ((weak)) STUB(record_queue_reserve)(struct record_queue_t *self_p,
+                                                        size_t size)
+{
+    void *res;
+
+    harness_mock_assert("record_queue_reserve(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("record_queue_reserve(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_reserve_isr(size_t size,
+                                        void *res)
+{
+    harness_mock_write("record_queue_reserve_isr(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("record_queue_reserve_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+void *__attribute__ ((weak)) STUB(record_queue_reserve_isr)(struct record_queue_t *self_p,
+                                                            size_t size)
+{
+    void *res;
+
+    harness_mock_assert("record_queue_reserve_isr(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("record_queue_reserve_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_commit(void *record_p,
+                                   int res)
+{
+    harness_mock_write("record_queue_commit(record_p)",
+                       record_p,
+                       sizeof(record_p));
+
+    harness_mock_write("record_queue_commit(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(record_queue_commit)(struct record_queue_t *self_p,
+                                                     void *record_p)
+{
+    int res;
+
+    harness_mock_assert("record_queue_commit(record_p)",
+                        record_p,
+                        sizeof(*record_p));
+
+    harness_mock_read("record_queue_commit(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_commit_isr(void *record_p,
+                                       int res)
+{
+    harness_mock_write("record_queue_commit_isr(): return (record_p)",
+                       record_p,
+                       sizeof(record_p));
+
+    harness_mock_write("record_queue_commit_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(record_queue_commit_isr)(struct record_queue_t *self_p,
+                                                         void *record_p)
+{
+    int res;
+
+    harness_mock_read("record_queue_commit_isr(): return (record_p)",
+                      record_p,
+                      sizeof(*record_p));
+
+    harness_mock_read("record_queue_commit_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_peek(size_t *size_p,
+                                 const struct time_t *timeout_p,
+                                 void *res)
+{
+    harness_mock_write("record_queue_peek(): return (size_p)",
+                       size_p,
+                       sizeof(*size_p));
+
+    harness_mock_write("record_queue_peek(timeout_p)",
+                       timeout_p,
+                       sizeof(*timeout_p));
+
+    harness_mock_write("record_queue_peek(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+void *__attribute__ ((weak)) STUB(record_queue_peek)(struct record_queue_t *self_p,
+                                                     size_t *size_p,
+                                                     const struct time_t *timeout_p)
+{
+    void *res;
+
+    harness_mock_read("record_queue_peek(): return (size_p)",
+                      size_p,
+                      sizeof(*size_p));
+
+    harness_mock_assert("record_queue_peek(timeout_p)",
+                        timeout_p,
+                        sizeof(*timeout_p));
+
+    harness_mock_read("record_queue_peek(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_release(int res)
+{
+    harness_mock_write("record_queue_release(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(record_queue_release)(struct record_queue_t *self_p)
+{
+    int res;
+
+    harness_mock_read("record_queue_release(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_read(void *buf_p,
+                                 size_t size,
+                                 ssize_t res)
+{
+    harness_mock_write("record_queue_read(): return (buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("record_queue_read(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("record_queue_read(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(record_queue_read)(struct record_queue_t *self_p,
+                                                       void *buf_p,
+                                                       size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("record_queue_read(): return (buf_p)",
+                      buf_p,
+                      size);
+
+    harness_mock_assert("record_queue_read(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("record_queue_read(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_write(const void *buf_p,
+                                  size_t size,
+                                  ssize_t res)
+{
+    harness_mock_write("record_queue_write(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("record_queue_write(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("record_queue_write(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(record_queue_write)(struct record_queue_t *self_p,
+                                                        const void *buf_p,
+                                                        size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("record_queue_write(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("record_queue_write(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("record_queue_write(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_write_isr(const void *buf_p,
+                                      size_t size,
+                                      ssize_t res)
+{
+    harness_mock_write("record_queue_write_isr(): return (buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("record_queue_write_isr(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("record_queue_write_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(record_queue_write_isr)(struct record_queue_t *self_p,
+                                                            const void *buf_p,
+                                                            size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("record_queue_write_isr(): return (buf_p)",
+                      buf_p,
+                      size);
+
+    harness_mock_assert("record_queue_write_isr(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("record_queue_write_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_record_queue_size(ssize_t res)
+{
+    harness_mock_write("record_queue_size(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(record_queue_size)(struct record_queue_t *self_p)
+{
+    ssize_t res;
+
+    harness_mock_read("record_queue_size(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -0,0 +1,72 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __RECORD_QUEUE_MOCK_H__
+#define __RECORD_QUEUE_MOCK_H__
+
+#include "simba.h"
+
+int mock_write_record_queue_init(void *buf_p,
+                                 size_t size,
+                                 int res);
+
+int mock_write_record_queue_reserve(size_t size,
+                                    void *res);
+
+int mock_write_record_queue_reserve_isr(size_t size,
+                                        void *res);
+
+int mock_write_record_queue_commit(void *record_p,
+                                   int res);
+
+int mock_write_record_queue_commit_isr(void *record_p,
+                                       int res);
+
+int mock_write_record_queue_peek(size_t *size_p,
+                                 const struct time_t *timeout_p,
+                                 void *res);
+
+int mock_write_record_queue_release(int res);
+
+int mock_write_record_queue_read(void *buf_p,
+                                 size_t size,
+                                 ssize_t res);
+
+int mock_write_record_queue_write(const void *buf_p,
+                                  size_t size,
+                                  ssize_t res);
+
+int mock_write_record_queue_write_isr(const void *buf_p,
+                                      size_t size,
+                                      ssize_t res);
+
+int mock_write_record_queue_size(ssize_t res);
+
+#endif
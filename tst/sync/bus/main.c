@@ -165,6 +165,244 @@ static int test_multiple_ids(void)
     return (0);
 }
 
+static int test_range(void)
+{
+    struct bus_t bus;
+    struct bus_listener_t listeners[3];
+    struct queue_t queues[3];
+    char bufs[3][32];
+    int foo;
+    int value;
+    int i;
+
+    BTASSERT(bus_init(&bus) == 0);
+
+    for (i = 0; i < 3; i++) {
+        BTASSERT(queue_init(&queues[i], bufs[i], sizeof(bufs[i])) == 0);
+    }
+
+    /* One exact, one range and one wildcard listener. */
+    BTASSERT(bus_listener_init(&listeners[0], 5, &queues[0]) == 0);
+    BTASSERT(bus_listener_init_range(&listeners[1], 3, 7, &queues[1]) == 0);
+    BTASSERT(bus_listener_init_range(&listeners[2],
+                                     BUS_ID_MIN,
+                                     BUS_ID_MAX,
+                                     &queues[2]) == 0);
+
+    for (i = 0; i < 3; i++) {
+        BTASSERT(bus_attach(&bus, &listeners[i]) == 0);
+    }
+
+    foo = 1;
+    BTASSERT(bus_write(&bus, 5, &foo, sizeof(foo)) == 3);
+    foo = 2;
+    BTASSERT(bus_write(&bus, 7, &foo, sizeof(foo)) == 2);
+    foo = 3;
+    BTASSERT(bus_write(&bus, 8, &foo, sizeof(foo)) == 1);
+    foo = 4;
+    BTASSERT(bus_write(&bus, -100, &foo, sizeof(foo)) == 1);
+
+    BTASSERT(queue_size(&queues[0]) == sizeof(int));
+    BTASSERT(queue_read(&queues[0], &value, sizeof(value)) == sizeof(value));
+    BTASSERT(value == 1);
+
+    BTASSERT(queue_size(&queues[1]) == 2 * sizeof(int));
+    BTASSERT(queue_read(&queues[1], &value, sizeof(value)) == sizeof(value));
+    BTASSERT(value == 1);
+    BTASSERT(queue_read(&queues[1], &value, sizeof(value)) == sizeof(value));
+    BTASSERT(value == 2);
+
+    for (i = 1; i <= 4; i++) {
+        BTASSERT(queue_read(&queues[2],
+                            &value,
+                            sizeof(value)) == sizeof(value));
+        BTASSERT(value == i);
+    }
+
+    /* Detach the range listener. */
+    BTASSERT(bus_detach(&bus, &listeners[1]) == 0);
+    BTASSERT(bus_detach(&bus, &listeners[1]) == -1);
+    BTASSERT(bus_write(&bus, 6, &foo, sizeof(foo)) == 1);
+    BTASSERT(bus_detach(&bus, &listeners[2]) == 0);
+    BTASSERT(bus_write(&bus, 6, &foo, sizeof(foo)) == 0);
+    BTASSERT(bus_detach(&bus, &listeners[0]) == 0);
+
+    return (0);
+}
+
+static int test_message(void)
+{
+    struct bus_t bus;
+    struct bus_listener_t listeners[3];
+    struct queue_t queues[2];
+    void *bufs[2][2];
+    static char heap_buf[512];
+    size_t sizes[HEAP_FIXED_SIZES_MAX] = {
+        8, 16, 32, 64, 64, 64, 64, 64
+    };
+    struct heap_t heap;
+    struct bus_message_t *message_p;
+    struct bus_message_t *messages[2];
+    struct queue_t full;
+
+    BTASSERT(heap_init(&heap, &heap_buf[0], sizeof(heap_buf), sizes) == 0);
+    BTASSERT(bus_init(&bus) == 0);
+    BTASSERT(bus_set_heap(&bus, &heap) == 0);
+    BTASSERT(queue_init(&queues[0], bufs[0], sizeof(bufs[0])) == 0);
+    BTASSERT(queue_init(&queues[1], bufs[1], sizeof(bufs[1])) == 0);
+    BTASSERT(queue_init(&full, NULL, 0) == 0);
+    BTASSERT(queue_stop(&full) == 0);
+    BTASSERT(bus_listener_init(&listeners[0], ID_FOO, &queues[0]) == 0);
+    BTASSERT(bus_listener_init_range(&listeners[1],
+                                     ID_FOO,
+                                     ID_BAR,
+                                     &queues[1]) == 0);
+    BTASSERT(bus_listener_init(&listeners[2], ID_BAR, &full) == 0);
+
+    /* No listeners. The message is freed at once. */
+    message_p = bus_message_alloc(&bus, ID_FOO, 100);
+    BTASSERT(message_p != NULL);
+    BTASSERT(bus_write_message(&bus, message_p) == 0);
+
+    BTASSERT(bus_attach(&bus, &listeners[0]) == 0);
+    BTASSERT(bus_attach(&bus, &listeners[1]) == 0);
+    BTASSERT(bus_attach(&bus, &listeners[2]) == 0);
+
+    /* Both listeners receive a pointer to the same message. */
+    message_p = bus_message_alloc(&bus, ID_FOO, 100);
+    BTASSERT(message_p != NULL);
+    memset(&message_p->buf[0], 0xa5, 100);
+    BTASSERT(bus_write_message(&bus, message_p) == 2);
+    BTASSERT(queue_read(&queues[0],
+                        &messages[0],
+                        sizeof(messages[0])) == sizeof(messages[0]));
+    BTASSERT(queue_read(&queues[1],
+                        &messages[1],
+                        sizeof(messages[1])) == sizeof(messages[1]));
+    BTASSERT(messages[0] == message_p);
+    BTASSERT(messages[1] == message_p);
+    BTASSERT(message_p->id == ID_FOO);
+    BTASSERT(message_p->size == 100);
+    BTASSERT(message_p->buf[99] == 0xa5);
+
+    /* The last release frees the message. */
+    BTASSERT(bus_message_release(&bus, messages[0]) == 1);
+    BTASSERT(bus_message_release(&bus, messages[1]) == 0);
+
+    /* The reference of a listener failing to receive the message is
+       released by the bus. */
+    message_p = bus_message_alloc(&bus, ID_BAR, 100);
+    BTASSERT(message_p != NULL);
+    BTASSERT(bus_write_message(&bus, message_p) == 2);
+    BTASSERT(queue_read(&queues[1],
+                        &messages[1],
+                        sizeof(messages[1])) == sizeof(messages[1]));
+    BTASSERT(messages[1] == message_p);
+    BTASSERT(bus_message_release(&bus, messages[1]) == 0);
+
+    /* All messages are freed, so the whole heap is available. */
+    message_p = bus_message_alloc(&bus, ID_FOO, 400);
+    BTASSERT(message_p != NULL);
+    BTASSERT(bus_message_release(&bus, message_p) == 0);
+
+    BTASSERT(bus_detach(&bus, &listeners[0]) == 0);
+    BTASSERT(bus_detach(&bus, &listeners[1]) == 0);
+    BTASSERT(bus_detach(&bus, &listeners[2]) == 0);
+    BTASSERT(heap_flush(&heap) == 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+static int test_benchmark(void)
+{
+    static struct bus_listener_t listeners[8];
+    static struct queue_t queues[8];
+    static char bufs[8][1024 + 1];
+    static char heap_buf[4096];
+    static char frame[1024];
+    static struct heap_t heap;
+    static struct bus_t bus;
+    size_t sizes[HEAP_FIXED_SIZES_MAX] = {
+        8, 16, 32, 64, 64, 64, 64, 64
+    };
+    struct bus_message_t *message_p;
+    struct time_t start;
+    struct time_t stop;
+    struct time_t elapsed[2];
+    int number_of_listeners;
+    int i;
+    int j;
+
+    BTASSERT(heap_init(&heap, &heap_buf[0], sizeof(heap_buf), sizes) == 0);
+
+    for (number_of_listeners = 1;
+         number_of_listeners <= 8;
+         number_of_listeners *= 2) {
+        BTASSERT(bus_init(&bus) == 0);
+        BTASSERT(bus_set_heap(&bus, &heap) == 0);
+
+        for (i = 0; i < number_of_listeners; i++) {
+            BTASSERT(queue_init(&queues[i],
+                                &bufs[i][0],
+                                sizeof(bufs[i])) == 0);
+            BTASSERT(bus_listener_init(&listeners[i],
+                                       ID_FOO,
+                                       &queues[i]) == 0);
+            BTASSERT(bus_attach(&bus, &listeners[i]) == 0);
+        }
+
+        /* Each listener receives a copy of the frame. */
+        time_get(&start);
+
+        for (i = 0; i < 20000; i++) {
+            bus_write(&bus, ID_FOO, &frame[0], sizeof(frame));
+
+            for (j = 0; j < number_of_listeners; j++) {
+                queue_read(&queues[j], &frame[0], sizeof(frame));
+            }
+        }
+
+        time_get(&stop);
+        time_subtract(&elapsed[0], &stop, &start);
+
+        /* Each listener receives a reference to the frame. */
+        time_get(&start);
+
+        for (i = 0; i < 20000; i++) {
+            message_p = bus_message_alloc(&bus, ID_FOO, sizeof(frame));
+            memcpy(&message_p->buf[0], &frame[0], sizeof(frame));
+            bus_write_message(&bus, message_p);
+
+            for (j = 0; j < number_of_listeners; j++) {
+                queue_read(&queues[j], &message_p, sizeof(message_p));
+                bus_message_release(&bus, message_p);
+            }
+        }
+
+        time_get(&stop);
+        time_subtract(&elapsed[1], &stop, &start);
+
+        std_printf(OSTR("20000 frames of %d bytes to %d listener(s): "
+                        "copy %lu ms, shared %lu ms.\r\n"),
+                   (int)sizeof(frame),
+                   number_of_listeners,
+                   (elapsed[0].seconds * 1000
+                    + elapsed[0].nanoseconds / 1000000),
+                   (elapsed[1].seconds * 1000
+                    + elapsed[1].nanoseconds / 1000000));
+
+        for (i = 0; i < number_of_listeners; i++) {
+            BTASSERT(bus_detach(&bus, &listeners[i]) == 0);
+        }
+    }
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -172,6 +410,11 @@ int main()
         { test_attach_detach, "test_attach_detach" },
         { test_write_read, "test_write_read" },
         { test_multiple_ids, "test_multiple_ids" },
+        { test_range, "test_range" },
+        { test_message, "test_message" },
+#if defined(ARCH_LINUX)
+        { test_benchmark, "test_benchmark" },
+#endif
         { NULL, NULL }
     };
 
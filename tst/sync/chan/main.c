@@ -277,6 +277,207 @@ static int test_putc(void)
     return (0);
 }
 
+static struct queue_t poll_set_queues[4];
+static char poll_set_queue_buffers[4][16];
+static THRD_STACK(poll_set_writer_stack, 1024);
+
+static void *poll_set_writer_main(void *arg_p)
+{
+    BTASSERTN(queue_write(arg_p, "w", 1) == 1);
+    thrd_suspend(NULL);
+
+    return (NULL);
+}
+
+static int test_poll_set(void)
+{
+    struct chan_poll_set_t set;
+    struct chan_poll_set_elem_t elements[3];
+    struct queue_t *queues_p;
+    void *chans[4];
+    struct time_t timeout;
+    char buf[4];
+    int i;
+
+    queues_p = &poll_set_queues[0];
+
+    for (i = 0; i < 4; i++) {
+        BTASSERT(queue_init(&queues_p[i],
+                            &poll_set_queue_buffers[i][0],
+                            sizeof(poll_set_queue_buffers[i])) == 0);
+    }
+
+    timeout.seconds = 0;
+    timeout.nanoseconds = 0;
+
+    BTASSERT(chan_poll_set_init(&set,
+                                &elements[0],
+                                membersof(elements)) == 0);
+
+    /* Data written before the channel is added is reported. */
+    BTASSERT(queue_write(&queues_p[0], "a", 1) == 1);
+    BTASSERT(chan_poll_set_add(&set, &queues_p[0], 0) == 0);
+    BTASSERT(chan_poll_set_add(&set, &queues_p[0], 0) == -EEXIST);
+    BTASSERT(chan_poll_set_add(&set,
+                               &queues_p[1],
+                               CHAN_POLL_SET_FLAGS_EDGE_TRIGGERED) == 0);
+    BTASSERT(chan_poll_set_add(&set, &queues_p[2], 0) == 0);
+    BTASSERT(chan_poll_set_add(&set, &queues_p[3], 0) == -ENOMEM);
+
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout), ==, 1);
+    BTASSERT(chans[0] == &queues_p[0]);
+    BTASSERT(queue_read(&queues_p[0], &buf[0], 1) == 1);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout),
+              ==,
+              -ETIMEDOUT);
+
+    /* Level triggered channels are reported as long as they have
+       data, and edge triggered channels once per write. */
+    BTASSERT(queue_write(&queues_p[1], "b", 1) == 1);
+    BTASSERT(queue_write(&queues_p[2], "c", 1) == 1);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout), ==, 2);
+    BTASSERT(chans[0] == &queues_p[1]);
+    BTASSERT(chans[1] == &queues_p[2]);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout), ==, 1);
+    BTASSERT(chans[0] == &queues_p[2]);
+    BTASSERT(queue_read(&queues_p[2], &buf[0], 1) == 1);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout),
+              ==,
+              -ETIMEDOUT);
+    BTASSERT(queue_write(&queues_p[1], "d", 1) == 1);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout), ==, 1);
+    BTASSERT(chans[0] == &queues_p[1]);
+    BTASSERT(queue_read(&queues_p[1], &buf[0], 2) == 2);
+    BTASSERTM(&buf[0], "bd", 2);
+
+    /* Ready channels not returned by a wait are returned first by the
+       next wait. */
+    BTASSERT(queue_write(&queues_p[0], "e", 1) == 1);
+    BTASSERT(queue_write(&queues_p[1], "f", 1) == 1);
+    BTASSERT(queue_write(&queues_p[2], "g", 1) == 1);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 1, &timeout), ==, 1);
+    BTASSERT(chans[0] == &queues_p[0]);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout), ==, 3);
+    BTASSERT(chans[0] == &queues_p[1]);
+    BTASSERT(chans[1] == &queues_p[2]);
+    BTASSERT(chans[2] == &queues_p[0]);
+
+    /* A removed channel is no longer reported. */
+    BTASSERT(chan_poll_set_remove(&set, &queues_p[0]) == 0);
+    BTASSERT(chan_poll_set_remove(&set, &queues_p[0]) == -ENOENT);
+    BTASSERT(queue_read(&queues_p[1], &buf[0], 1) == 1);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout), ==, 1);
+    BTASSERT(chans[0] == &queues_p[2]);
+    BTASSERT(queue_read(&queues_p[2], &buf[0], 1) == 1);
+    BTASSERT(queue_read(&queues_p[0], &buf[0], 1) == 1);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, &timeout),
+              ==,
+              -ETIMEDOUT);
+
+    /* Wait for another thread to write to a channel. */
+    BTASSERT(thrd_spawn(poll_set_writer_main,
+                        &queues_p[2],
+                        thrd_get_prio() + 1,
+                        poll_set_writer_stack,
+                        sizeof(poll_set_writer_stack)) != NULL);
+    BTASSERTI(chan_poll_set_wait(&set, &chans[0], 4, NULL), ==, 1);
+    BTASSERT(chans[0] == &queues_p[2]);
+    BTASSERT(queue_read(&queues_p[2], &buf[0], 1) == 1);
+    BTASSERTI(buf[0], ==, 'w');
+
+    BTASSERT(chan_poll_set_remove(&set, &queues_p[1]) == 0);
+    BTASSERT(chan_poll_set_remove(&set, &queues_p[2]) == 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+#define POLL_BENCHMARK_CHANNELS                            200
+#define POLL_BENCHMARK_ROUNDS                            20000
+
+static struct queue_t poll_benchmark_queues[POLL_BENCHMARK_CHANNELS];
+static char poll_benchmark_buffers[POLL_BENCHMARK_CHANNELS][4];
+static struct chan_list_elem_t poll_benchmark_list_elements[
+    POLL_BENCHMARK_CHANNELS];
+static struct chan_poll_set_elem_t poll_benchmark_set_elements[
+    POLL_BENCHMARK_CHANNELS];
+
+static int test_poll_benchmark(void)
+{
+    struct chan_list_t list;
+    struct chan_poll_set_t set;
+    struct queue_t *queue_p;
+    void *chan_p;
+    struct time_t start;
+    struct time_t stop;
+    struct time_t list_elapsed;
+    struct time_t set_elapsed;
+    char value;
+    int i;
+
+    BTASSERT(chan_list_init(&list,
+                            &poll_benchmark_list_elements[0],
+                            POLL_BENCHMARK_CHANNELS) == 0);
+    BTASSERT(chan_poll_set_init(&set,
+                                &poll_benchmark_set_elements[0],
+                                POLL_BENCHMARK_CHANNELS) == 0);
+
+    for (i = 0; i < POLL_BENCHMARK_CHANNELS; i++) {
+        queue_p = &poll_benchmark_queues[i];
+        BTASSERT(queue_init(queue_p,
+                            &poll_benchmark_buffers[i][0],
+                            sizeof(poll_benchmark_buffers[i])) == 0);
+        BTASSERT(chan_list_add(&list, queue_p) == 0);
+        BTASSERT(chan_poll_set_add(&set, queue_p, 0) == 0);
+    }
+
+    /* Data on the last channel in the list is the worst case for a
+       list poll. */
+    queue_p = &poll_benchmark_queues[POLL_BENCHMARK_CHANNELS - 1];
+
+    time_get(&start);
+
+    for (i = 0; i < POLL_BENCHMARK_ROUNDS; i++) {
+        BTASSERT(queue_write(queue_p, "x", 1) == 1);
+        BTASSERT(chan_list_poll(&list, NULL) == queue_p);
+        BTASSERT(queue_read(queue_p, &value, 1) == 1);
+    }
+
+    time_get(&stop);
+    time_subtract(&list_elapsed, &stop, &start);
+
+    time_get(&start);
+
+    for (i = 0; i < POLL_BENCHMARK_ROUNDS; i++) {
+        BTASSERT(queue_write(queue_p, "x", 1) == 1);
+        BTASSERT(chan_poll_set_wait(&set, &chan_p, 1, NULL) == 1);
+        BTASSERT(chan_p == queue_p);
+        BTASSERT(queue_read(queue_p, &value, 1) == 1);
+    }
+
+    time_get(&stop);
+    time_subtract(&set_elapsed, &stop, &start);
+
+    std_printf(OSTR("Polled %d channels %d times. List: %lu ms, "
+                    "poll set: %lu ms.\r\n"),
+               POLL_BENCHMARK_CHANNELS,
+               POLL_BENCHMARK_ROUNDS,
+               (unsigned long)(list_elapsed.seconds * 1000
+                               + list_elapsed.nanoseconds / 1000000),
+               (unsigned long)(set_elapsed.seconds * 1000
+                               + set_elapsed.nanoseconds / 1000000));
+
+    for (i = 0; i < POLL_BENCHMARK_CHANNELS; i++) {
+        BTASSERT(chan_poll_set_remove(&set,
+                                      &poll_benchmark_queues[i]) == 0);
+    }
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -285,6 +486,10 @@ int main()
         { test_list, "test_list" },
         { test_getc, "test_getc" },
         { test_putc, "test_putc" },
+        { test_poll_set, "test_poll_set" },
+#if defined(ARCH_LINUX)
+        { test_poll_benchmark, "test_poll_benchmark" },
+#endif
         { NULL, NULL }
     };
 
@@ -31,6 +31,7 @@
 #include "simba.h"
 
 #define ITERATIONS 100
+#define MEDIUM_BUSY_MS 50
 
 static struct mutex_t mutex;
 static int global_counter = 0;
@@ -49,6 +50,25 @@ static THRD_STACK(t0_stack, 224);
 static THRD_STACK(t1_stack, 224);
 #endif
 
+#if defined(ARCH_ESP32) || defined(ARCH_PPC) || defined(ARCH_LINUX)
+#    define LATENCY_STACK_SIZE 1024
+#else
+#    define LATENCY_STACK_SIZE 256
+#endif
+
+static struct {
+    struct mutex_t mutex;
+    struct thrd_t *main_p;
+    struct thrd_t *low_p;
+    int medium_done;
+    int blocked_us;
+} latency;
+
+/* One set of stacks per measurement as threads can not be reused. */
+static THRD_STACK(low_stacks[2], LATENCY_STACK_SIZE);
+static THRD_STACK(medium_stacks[2], LATENCY_STACK_SIZE);
+static THRD_STACK(high_stacks[2], LATENCY_STACK_SIZE);
+
 static void *mutex_main(void *arg_p)
 {
     int i;
@@ -112,10 +132,149 @@ static int test_multi_thread(void)
     return (0);
 }
 
+/**
+ * Low priority thread holding the mutex while doing some work.
+ */
+static void *low_main(void *arg_p)
+{
+    int i;
+
+    mutex_lock(&latency.mutex);
+    thrd_suspend(NULL);
+
+    for (i = 0; i < 10; i++) {
+        thrd_yield();
+    }
+
+    mutex_unlock(&latency.mutex);
+    thrd_suspend(NULL);
+
+    return (NULL);
+}
+
+/**
+ * Medium priority thread keeping the CPU busy, starving the low
+ * priority thread unless it has inherited a higher priority.
+ */
+static void *medium_main(void *arg_p)
+{
+    struct time_t start;
+    struct time_t now;
+    struct time_t elapsed;
+
+    time_get(&start);
+
+    do {
+        thrd_yield();
+        time_get(&now);
+        time_subtract(&elapsed, &now, &start);
+    } while ((elapsed.seconds == 0)
+             && (elapsed.nanoseconds < 1000000L * MEDIUM_BUSY_MS));
+
+    latency.medium_done = 1;
+    thrd_suspend(NULL);
+
+    return (NULL);
+}
+
+/**
+ * High priority thread measuring the time it is blocked on the
+ * mutex.
+ */
+static void *high_main(void *arg_p)
+{
+    int start;
+
+    start = time_micros();
+    mutex_lock(&latency.mutex);
+    latency.blocked_us = time_micros_elapsed(start, time_micros());
+    mutex_unlock(&latency.mutex);
+    thrd_resume(latency.main_p, 0);
+    thrd_suspend(NULL);
+
+    return (NULL);
+}
+
+/**
+ * Let a high priority thread block on a mutex held by a low priority
+ * thread while a medium priority thread is running. Returns the time
+ * in microseconds the high priority thread was blocked.
+ */
+static int measure_blocked_time(int flags, int run)
+{
+    latency.main_p = thrd_self();
+    latency.medium_done = 0;
+    latency.blocked_us = -1;
+
+    if (mutex_init_flags(&latency.mutex, flags) != 0) {
+        return (-1);
+    }
+
+    latency.low_p = thrd_spawn(low_main,
+                               NULL,
+                               30,
+                               low_stacks[run],
+                               sizeof(low_stacks[run]));
+
+    /* Let the low priority thread lock the mutex. */
+    thrd_sleep_ms(1);
+
+    thrd_spawn(high_main,
+               NULL,
+               -20,
+               high_stacks[run],
+               sizeof(high_stacks[run]));
+    thrd_resume(latency.low_p, 0);
+    thrd_spawn(medium_main,
+               NULL,
+               10,
+               medium_stacks[run],
+               sizeof(medium_stacks[run]));
+
+    /* Resumed by the high priority thread. */
+    thrd_suspend(NULL);
+
+    while (latency.medium_done == 0) {
+        thrd_sleep_ms(1);
+    }
+
+    return (latency.blocked_us);
+}
+
+static int test_priority_inheritance(void)
+{
+    int without_us;
+    int with_us;
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    with_us = measure_blocked_time(MUTEX_PRIORITY_INHERITANCE, 0);
+#else
+    BTASSERTI(mutex_init_flags(&latency.mutex, MUTEX_PRIORITY_INHERITANCE),
+              ==,
+              -ENOSYS);
+    with_us = -1;
+#endif
+    without_us = measure_blocked_time(0, 1);
+
+    std_printf(OSTR("High priority thread blocked for %d us with and "
+                    "%d us without priority inheritance.\r\n"),
+               with_us,
+               without_us);
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    BTASSERTI(with_us, >=, 0);
+    BTASSERTI(with_us, <, 1000 * MEDIUM_BUSY_MS / 5);
+#endif
+    BTASSERTI(without_us, >=, 1000 * MEDIUM_BUSY_MS / 2);
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
         { test_multi_thread, "test_multi_thread" },
+        { test_priority_inheritance, "test_priority_inheritance" },
         { NULL, NULL }
     };
 
@@ -30,6 +30,11 @@
 
 #include "simba.h"
 
+#if defined(ARCH_LINUX)
+#    include <pthread.h>
+#    include <unistd.h>
+#endif
+
 static struct queue_t queue[2];
 static struct queue_t buffered_queue;
 static char buffer[8];
@@ -550,6 +555,143 @@ static int test_read_write_zero(void)
     return (0);
 }
 
+static int test_spsc(void)
+{
+    struct queue_t foo;
+    char foobuf[8];
+    char buf[16];
+
+    /* The buffer size must be a power of two. */
+    BTASSERTI(queue_init_spsc(&foo, &foobuf[0], 6), ==, -EINVAL);
+    BTASSERTI(queue_init_spsc(&foo, &foobuf[0], sizeof(foobuf)), ==, 0);
+
+    BTASSERTI(queue_size(&foo), ==, 0);
+    BTASSERTI(queue_unused_size(&foo), ==, 8);
+
+    /* Writes do not block when the buffer is full. */
+    BTASSERTI(queue_write_spsc_isr(&foo, "12345", 5), ==, 5);
+    BTASSERTI(queue_write(&foo, "6789a", 5), ==, 3);
+    BTASSERTI(queue_size(&foo), ==, 8);
+    BTASSERTI(queue_unused_size(&foo), ==, 0);
+
+    /* Read across the end of the buffer. */
+    BTASSERTI(queue_read(&foo, &buf[0], 3), ==, 3);
+    BTASSERTM(&buf[0], "123", 3);
+    sys_lock();
+    BTASSERTI(queue_write_isr(&foo, "abc", 3), ==, 3);
+    sys_unlock();
+    BTASSERTI(queue_ignore(&foo, 2), ==, 2);
+    BTASSERTI(queue_read(&foo, &buf[0], 6), ==, 6);
+    BTASSERTM(&buf[0], "678abc", 6);
+
+    /* Non-blocking read of an empty queue. */
+    BTASSERTI(chan_control(&foo, CHAN_CONTROL_NON_BLOCKING_READ), ==, 0);
+    BTASSERTI(queue_read(&foo, &buf[0], 1), ==, -EAGAIN);
+    BTASSERTI(queue_write(&foo, "d", 1), ==, 1);
+    BTASSERTI(queue_read(&foo, &buf[0], 2), ==, 1);
+    BTASSERTI(buf[0], ==, 'd');
+    BTASSERTI(chan_control(&foo, CHAN_CONTROL_BLOCKING_READ), ==, 0);
+
+    /* Poll for data. */
+    BTASSERTI(queue_write(&foo, "e", 1), ==, 1);
+    BTASSERT(chan_poll(&foo, NULL) == &foo);
+    BTASSERTI(queue_read(&foo, &buf[0], 1), ==, 1);
+    BTASSERTI(buf[0], ==, 'e');
+
+    /* Stopped queue. */
+    BTASSERTI(queue_write(&foo, "f", 1), ==, 1);
+    BTASSERTI(queue_stop(&foo), ==, 0);
+    BTASSERTI(queue_write(&foo, "g", 1), ==, -1);
+    BTASSERTI(queue_read(&foo, &buf[0], 2), ==, 1);
+    BTASSERTI(buf[0], ==, 'f');
+    BTASSERTI(queue_read(&foo, &buf[0], 2), ==, 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+#define SPSC_PRODUCER_SIZE                                  2000
+
+static struct queue_t spsc_queue;
+static char spsc_buffer[16];
+
+/**
+ * Writes a byte sequence to the queue from a pthread, just like the
+ * Linux socket device does.
+ */
+static void *spsc_producer_main(void *arg_p)
+{
+    int i;
+    ssize_t size;
+    uint8_t byte;
+
+    i = 0;
+
+    while (i < SPSC_PRODUCER_SIZE) {
+        byte = i;
+        size = queue_write_spsc_isr(&spsc_queue, &byte, sizeof(byte));
+
+        if (size == sizeof(byte)) {
+            i++;
+        } else {
+            usleep(10);
+        }
+    }
+
+    return (NULL);
+}
+
+static int test_spsc_producer(void)
+{
+    pthread_t thrd;
+    uint8_t buf[7];
+    int i;
+    int j;
+    int size;
+
+    BTASSERTI(queue_init_spsc(&spsc_queue,
+                              &spsc_buffer[0],
+                              sizeof(spsc_buffer)), ==, 0);
+    BTASSERTI(pthread_create(&thrd,
+                             NULL,
+                             spsc_producer_main,
+                             NULL), ==, 0);
+
+    /* Alternate between blocking reads and polling. */
+    i = 0;
+
+    while (i < SPSC_PRODUCER_SIZE) {
+        size = MIN(sizeof(buf), SPSC_PRODUCER_SIZE - i);
+
+        if ((i % 2) == 0) {
+            BTASSERT(chan_poll(&spsc_queue, NULL) == &spsc_queue);
+        }
+
+        BTASSERTI(queue_read(&spsc_queue, &buf[0], size), ==, size);
+
+        for (j = 0; j < size; j++) {
+            BTASSERTI(buf[j], ==, (uint8_t)(i + j));
+        }
+
+        i += size;
+    }
+
+    BTASSERTI(pthread_join(thrd, NULL), ==, 0);
+    BTASSERTI(queue_size(&spsc_queue), ==, 0);
+
+    return (0);
+}
+
+#else
+
+static int test_spsc_producer(void)
+{
+    return (1);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -564,6 +706,8 @@ int main()
         { test_non_blocking, "test_non_blocking" },
         { test_ignore, "test_ignore" },
         { test_read_write_zero, "test_read_write_zero" },
+        { test_spsc, "test_spsc" },
+        { test_spsc_producer, "test_spsc_producer" },
         { NULL, NULL }
     };
 
@@ -0,0 +1,345 @@
+/**
+ * @section License
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+static struct record_queue_t queue;
+static union {
+    long long align;
+    char buf[256];
+} queue_buf;
+
+static struct sem_t producer_sem;
+static THRD_STACK(producer_stack, 4096);
+
+/**
+ * Commit two records after a while, one from a thread and one with
+ * the system lock taken as in an interrupt handler.
+ */
+static void *producer_main(void *arg_p)
+{
+    char *record_p;
+
+    thrd_set_name("producer");
+
+    while (1) {
+        sem_take(&producer_sem, NULL);
+        thrd_sleep_ms(10);
+
+        record_p = record_queue_reserve(&queue, 3);
+        BTASSERTN(record_p != NULL);
+        memcpy(record_p, "foo", 3);
+        BTASSERTN(record_queue_commit(&queue, record_p) == 0);
+
+        thrd_sleep_ms(10);
+
+        sys_lock();
+        BTASSERTN(record_queue_write_isr(&queue, "fie", 3) == 3);
+        sys_unlock();
+    }
+
+    return (NULL);
+}
+
+static int test_init(void)
+{
+    BTASSERT(record_queue_init(&queue,
+                               &queue_buf.buf[0],
+                               sizeof(queue_buf.buf)) == 0);
+    BTASSERT(record_queue_size(&queue) == 0);
+
+    return (0);
+}
+
+static int test_reserve_commit(void)
+{
+    char *a_p;
+    char *b_p;
+    char *record_p;
+    size_t size;
+    struct time_t timeout;
+
+    timeout.seconds = 0;
+    timeout.nanoseconds = 0;
+
+    a_p = record_queue_reserve(&queue, 5);
+    BTASSERT(a_p != NULL);
+    b_p = record_queue_reserve(&queue, 1);
+    BTASSERT(b_p != NULL);
+    memcpy(a_p, "hello", 5);
+    b_p[0] = '!';
+
+    /* Records are committed in reservation order. */
+    BTASSERT(record_queue_commit(&queue, b_p) == 0);
+    BTASSERT(record_queue_size(&queue) == 0);
+    BTASSERT(record_queue_peek(&queue, &size, &timeout) == NULL);
+    BTASSERT(record_queue_release(&queue) == -ENOMSG);
+
+    BTASSERT(record_queue_commit(&queue, a_p) == 0);
+    BTASSERT(record_queue_size(&queue) == 5);
+
+    /* Records are used in place. */
+    record_p = record_queue_peek(&queue, &size, NULL);
+    BTASSERT(record_p == a_p);
+    BTASSERT(size == 5);
+    BTASSERTM(record_p, "hello", 5);
+    BTASSERT(record_queue_release(&queue) == 0);
+
+    record_p = record_queue_peek(&queue, &size, NULL);
+    BTASSERT(record_p == b_p);
+    BTASSERT(size == 1);
+    BTASSERT(record_p[0] == '!');
+    BTASSERT(record_queue_release(&queue) == 0);
+
+    BTASSERT(record_queue_size(&queue) == 0);
+
+    return (0);
+}
+
+static int test_full_and_wrap(void)
+{
+    char *records[8];
+    char *record_p;
+    size_t size;
+    int i;
+    int length;
+
+    /* Fill the queue. */
+    length = 0;
+
+    while (1) {
+        record_p = record_queue_reserve(&queue, 50);
+
+        if (record_p == NULL) {
+            break;
+        }
+
+        BTASSERT(length < membersof(records));
+        memset(record_p, length, 50);
+        BTASSERT(record_queue_commit(&queue, record_p) == 0);
+        records[length++] = record_p;
+    }
+
+    BTASSERT(length > 2);
+
+    /* Release the first two records. The next record does not fit at
+       the end of the buffer and is written at the beginning. */
+    for (i = 0; i < 2; i++) {
+        record_p = record_queue_peek(&queue, &size, NULL);
+        BTASSERT(record_p == records[i]);
+        BTASSERT(size == 50);
+        BTASSERT(record_p[49] == i);
+        BTASSERT(record_queue_release(&queue) == 0);
+    }
+
+    record_p = record_queue_reserve(&queue, 60);
+    BTASSERT(record_p == records[0]);
+    memset(record_p, 0x55, 60);
+    BTASSERT(record_queue_commit(&queue, record_p) == 0);
+    BTASSERT(record_queue_reserve(&queue, 60) == NULL);
+
+    for (i = 2; i < length; i++) {
+        BTASSERT(record_queue_size(&queue) == 50);
+        record_p = record_queue_peek(&queue, &size, NULL);
+        BTASSERT(record_p == records[i]);
+        BTASSERT(record_p[0] == i);
+        BTASSERT(record_queue_release(&queue) == 0);
+    }
+
+    /* The wrapped record, after the padding. */
+    BTASSERT(record_queue_size(&queue) == 60);
+    record_p = record_queue_peek(&queue, &size, NULL);
+    BTASSERT(record_p == records[0]);
+    BTASSERT(size == 60);
+    BTASSERT(record_p[59] == 0x55);
+    BTASSERT(record_queue_release(&queue) == 0);
+    BTASSERT(record_queue_size(&queue) == 0);
+
+    /* Too big. */
+    BTASSERT(record_queue_reserve(&queue, sizeof(queue_buf.buf)) == NULL);
+
+    return (0);
+}
+
+static int test_chan(void)
+{
+    char buf[8];
+    struct chan_list_t list;
+    struct chan_list_elem_t elements[1];
+    size_t size;
+    char *record_p;
+
+    /* Message boundaries are kept. */
+    BTASSERT(chan_write(&queue, "ab", 2) == 2);
+    BTASSERT(chan_write(&queue, "cde", 3) == 3);
+    BTASSERT(chan_size(&queue) == 2);
+    BTASSERT(chan_read(&queue, &buf[0], sizeof(buf)) == 2);
+    BTASSERTM(&buf[0], "ab", 2);
+    BTASSERT(chan_read(&queue, &buf[0], 2) == 2);
+    BTASSERTM(&buf[0], "cd", 2);
+    BTASSERT(chan_size(&queue) == 0);
+
+    /* Wait for records committed by another thread. */
+    BTASSERT(sem_init(&producer_sem, 1, 1) == 0);
+    BTASSERT(thrd_spawn(producer_main,
+                        NULL,
+                        -1,
+                        producer_stack,
+                        sizeof(producer_stack)) != NULL);
+    BTASSERT(sem_give(&producer_sem, 1) == 0);
+
+    record_p = record_queue_peek(&queue, &size, NULL);
+    BTASSERT(size == 3);
+    BTASSERTM(record_p, "foo", 3);
+    BTASSERT(record_queue_release(&queue) == 0);
+
+    BTASSERT(chan_list_init(&list, &elements[0], membersof(elements)) == 0);
+    BTASSERT(chan_list_add(&list, &queue) == 0);
+    BTASSERT(chan_list_poll(&list, NULL) == &queue);
+    BTASSERT(chan_read(&queue, &buf[0], sizeof(buf)) == 3);
+    BTASSERTM(&buf[0], "fie", 3);
+
+    /* Poll again. */
+    BTASSERT(sem_give(&producer_sem, 1) == 0);
+    BTASSERT(chan_list_poll(&list, NULL) == &queue);
+    BTASSERT(chan_read(&queue, &buf[0], sizeof(buf)) == 3);
+    BTASSERTM(&buf[0], "foo", 3);
+    BTASSERT(chan_list_poll(&list, NULL) == &queue);
+    BTASSERT(chan_read(&queue, &buf[0], sizeof(buf)) == 3);
+    BTASSERTM(&buf[0], "fie", 3);
+    BTASSERT(chan_list_destroy(&list) == 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+static int test_benchmark(void)
+{
+    static struct queue_t byte_queue;
+    static char byte_queue_buf[4096];
+    static union {
+        long long align;
+        char buf[4096];
+    } record_queue_buf;
+    char message[32];
+    struct time_t start;
+    struct time_t stop;
+    struct time_t elapsed[2];
+    void *record_p;
+    size_t size;
+    uint32_t sum;
+    int i;
+    int j;
+
+    memset(&message[0], 1, sizeof(message));
+
+    /* Messages written and read with the byte queue. */
+    BTASSERT(queue_init(&byte_queue,
+                        &byte_queue_buf[0],
+                        sizeof(byte_queue_buf)) == 0);
+    sum = 0;
+    time_get(&start);
+
+    for (i = 0; i < 10000; i++) {
+        for (j = 0; j < 64; j++) {
+            size = sizeof(message);
+            queue_write(&byte_queue, &size, sizeof(size));
+            queue_write(&byte_queue, &message[0], size);
+        }
+
+        for (j = 0; j < 64; j++) {
+            queue_read(&byte_queue, &size, sizeof(size));
+            queue_read(&byte_queue, &message[0], size);
+            sum += message[j % size];
+        }
+    }
+
+    time_get(&stop);
+    time_subtract(&elapsed[0], &stop, &start);
+    BTASSERT(sum == 640000);
+
+    /* Messages reserved, committed, peeked and released in place. */
+    BTASSERT(record_queue_init(&queue,
+                               &record_queue_buf.buf[0],
+                               sizeof(record_queue_buf.buf)) == 0);
+    sum = 0;
+    time_get(&start);
+
+    for (i = 0; i < 10000; i++) {
+        for (j = 0; j < 64; j++) {
+            record_p = record_queue_reserve(&queue, sizeof(message));
+            memset(record_p, 1, sizeof(message));
+            record_queue_commit(&queue, record_p);
+        }
+
+        for (j = 0; j < 64; j++) {
+            record_p = record_queue_peek(&queue, &size, NULL);
+            sum += ((char *)record_p)[j % size];
+            record_queue_release(&queue);
+        }
+    }
+
+    time_get(&stop);
+    time_subtract(&elapsed[1], &stop, &start);
+    BTASSERT(sum == 640000);
+
+    std_printf(OSTR("640000 messages of %d bytes: queue %lu ms, "
+                    "record queue %lu ms.\r\n"),
+               (int)sizeof(message),
+               (elapsed[0].seconds * 1000
+                + elapsed[0].nanoseconds / 1000000),
+               (elapsed[1].seconds * 1000
+                + elapsed[1].nanoseconds / 1000000));
+
+    return (0);
+}
+
+#endif
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_init, "test_init" },
+        { test_reserve_commit, "test_reserve_commit" },
+        { test_full_and_wrap, "test_full_and_wrap" },
+        { test_chan, "test_chan" },
+#if defined(ARCH_LINUX)
+        { test_benchmark, "test_benchmark" },
+#endif
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
@@ -732,6 +732,135 @@ static int test_printf_isr(void)
     return (0);
 }
 
+static int test_sprintf_repeated(void)
+{
+    char buf[64];
+    ssize_t size;
+    int i;
+
+    /* Formatted the same way every time, with and without the format
+       cache. */
+    for (i = 0; i < 3; i++) {
+        size = std_sprintf(&buf[0],
+                           FSTR("%d: '%-4s' 0x%04x %c!"),
+                           i - 1,
+                           "ab",
+                           0xbe + i,
+                           'z');
+        BTASSERTI(size, ==, 19 + (i == 0));
+    }
+
+    BTASSERTM(&buf[0], "1: 'ab  ' 0x00c0 z!", size + 1);
+
+    /* More conversion specifications than fit in a cache entry. */
+    for (i = 0; i < 2; i++) {
+        size = std_sprintf(&buf[0],
+                           FSTR("%d%d%d%d%d%d%d%d%d%d%s"),
+                           0, 1, 2, 3, 4, 5, 6, 7, 8, 9, "end");
+        BTASSERTI(size, ==, 13);
+        BTASSERTM(&buf[0], "0123456789end", size + 1);
+    }
+
+    /* A format ending in the middle of a conversion specification. */
+    for (i = 0; i < 2; i++) {
+        size = std_sprintf(&buf[0], FSTR("abc %-5"));
+        BTASSERTI(size, ==, 4);
+        BTASSERTM(&buf[0], "abc ", size + 1);
+    }
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+#define PRINTF_BENCHMARK_ROUNDS                         200000
+
+static size_t printf_benchmark_size;
+
+static ssize_t printf_benchmark_write(void *self_p,
+                                      const void *buf_p,
+                                      size_t size)
+{
+    printf_benchmark_size += size;
+
+    return (size);
+}
+
+static void printf_benchmark_print(const char *name_p,
+                                   struct time_t *start_p)
+{
+    struct time_t stop;
+    struct time_t elapsed;
+
+    time_get(&stop);
+    time_subtract(&elapsed, &stop, start_p);
+    std_printf(FSTR("%-10s %5lu ms\r\n"),
+               name_p,
+               (unsigned long)(elapsed.seconds * 1000
+                               + elapsed.nanoseconds / 1000000));
+    time_get(start_p);
+}
+
+static int test_printf_benchmark(void)
+{
+    struct chan_t chan;
+    struct time_t start;
+    char buf[128];
+    long i;
+
+    BTASSERT(chan_init(&chan,
+                       chan_read_null,
+                       printf_benchmark_write,
+                       chan_size_null) == 0);
+
+    std_printf(FSTR("Formatted %d times.\r\n"), PRINTF_BENCHMARK_ROUNDS);
+    time_get(&start);
+
+    for (i = 0; i < PRINTF_BENCHMARK_ROUNDS; i++) {
+        std_sprintf(&buf[0], FSTR("%d %d %ld"), (int)i, -(int)i, 123456789L * i);
+    }
+
+    printf_benchmark_print("%d", &start);
+
+    for (i = 0; i < PRINTF_BENCHMARK_ROUNDS; i++) {
+        std_sprintf(&buf[0], FSTR("name: %s, value: %-8s|"), "foo", "barbaz");
+    }
+
+    printf_benchmark_print("%s", &start);
+
+    for (i = 0; i < PRINTF_BENCHMARK_ROUNDS; i++) {
+        std_sprintf(&buf[0], FSTR("0x%08lx 0x%x"), 2654435761UL * i, (int)i);
+    }
+
+    printf_benchmark_print("%x", &start);
+
+#if CONFIG_FLOAT == 1
+    for (i = 0; i < PRINTF_BENCHMARK_ROUNDS; i++) {
+        std_sprintf(&buf[0], FSTR("%f %f"), 0.001 * i, -12345.678);
+    }
+
+    printf_benchmark_print("%f", &start);
+#endif
+
+    printf_benchmark_size = 0;
+
+    for (i = 0; i < PRINTF_BENCHMARK_ROUNDS; i++) {
+        std_fprintf(&chan,
+                    FSTR("%lu: %s: received %d bytes from 0x%08lx.\r\n"),
+                    (unsigned long)i,
+                    "gateway",
+                    (int)(i & 0xff),
+                    0x20004000UL + i);
+    }
+
+    printf_benchmark_print("fprintf", &start);
+    BTASSERT(printf_benchmark_size > 0);
+
+    return (0);
+}
+
+#endif
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -746,12 +875,16 @@ int main()
         { test_sprintf_double, "test_sprintf_double" },
         { test_sprintf_unsigned, "test_sprintf_unsigned" },
         { test_sprintf_far_string, "test_sprintf_far_string" },
+        { test_sprintf_repeated, "test_sprintf_repeated" },
         { test_strip, "test_strip" },
         { test_libc, "test_libc" },
         { test_strtod, "test_strtod" },
         { test_strtodfp, "test_strtodfp" },
         { test_hexdump, "test_hexdump" },
         { test_printf_isr, "test_printf_isr" },
+#if defined(ARCH_LINUX)
+        { test_printf_benchmark, "test_printf_benchmark" },
+#endif
         { NULL, NULL }
     };
 